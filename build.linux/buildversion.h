@@ -0,0 +1 @@
+#define BUILD_VERSION ""
@@ -0,0 +1,1241 @@
+// auto-generated by /root/repo/support/mkbundle
+// docs/html/faq.html
+static const unsigned char embedded_faq_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0115, 0223, 0101, 0157, 0333, 0060,
+0014, 0205, 0357, 0376, 0025, 0104, 0057, 0151, 0201, 0045, 0375, 0003, 0135, 0212, 0255, 0075,
+0254, 0300, 0260, 0005, 0113, 0260, 0236, 0031, 0211, 0216, 0204, 0311, 0222, 0146, 0322, 0361,
+0272, 0137, 0277, 0047, 0007, 0135, 0233, 0103, 0140, 0130, 0344, 0323, 0367, 0370, 0350, 0073,
+0037, 0317, 0344, 0022, 0253, 0176, 0274, 0012, 0246, 0153, 0137, 0334, 0332, 0344, 0217, 0135,
+0155, 0273, 0356, 0316, 0047, 0374, 0323, 0235, 0267, 0355, 0163, 0170, 0041, 0137, 0104, 0351,
+0160, 0016, 0302, 0136, 0262, 0047, 0057, 0051, 0236, 0145, 0044, 0317, 0306, 0124, 0332, 0323,
+0341, 0141, 0107, 0126, 0150, 0037, 0312, 0154, 0161, 0220, 0173, 0172, 0042, 0013, 0145, 0072,
+0005, 0243, 0150, 0064, 0263, 0166, 0324, 0176, 0107, 0366, 0255, 0154, 0122, 0131, 0072, 0372,
+0062, 0322, 0050, 0234, 0132, 0013, 0251, 0144, 0215, 0006, 0135, 0262, 0221, 0373, 0076, 0272,
+0373, 0005, 0300, 0157, 0073, 0132, 0175, 0071, 0354, 0167, 0053, 0132, 0103, 0123, 0250, 0216,
+0305, 0212, 0053, 0251, 0251, 0370, 0105, 0102, 0015, 0042, 0103, 0314, 0047, 0072, 0374, 0374,
+0320, 0164, 0174, 0173, 0036, 0004, 0160, 0061, 0243, 0140, 0140, 0213, 0045, 0167, 0064, 0125,
+0000, 0303, 0010, 0303, 0302, 0217, 0335, 0003, 0035, 0305, 0146, 0221, 0374, 0316, 0130, 0073,
+0171, 0365, 0320, 0364, 0121, 0333, 0150, 0262, 0016, 0121, 0165, 0321, 0120, 0027, 0304, 0117,
+0011, 0226, 0347, 0150, 0201, 0206, 0011, 0360, 0065, 0011, 0375, 0236, 0144, 0102, 0171, 0311,
+0013, 0343, 0233, 0242, 0106, 0057, 0033, 0072, 0204, 0250, 0000, 0202, 0020, 0216, 0331, 0272,
+0167, 0005, 0216, 0163, 0073, 0321, 0151, 0224, 0245, 0225, 0317, 0034, 0023, 0037, 0041, 0171,
+0004, 0315, 0034, 0075, 0156, 0171, 0005, 0215, 0246, 0222, 0372, 0205, 0022, 0245, 0035, 0372,
+0174, 0344, 0232, 0370, 0005, 0070, 0355, 0345, 0034, 0120, 0344, 0112, 0076, 0211, 0066, 0307,
+0024, 0270, 0126, 0114, 0025, 0175, 0053, 0045, 0071, 0267, 0103, 0256, 0213, 0166, 0351, 0311,
+0217, 0245, 0126, 0014, 0252, 0243, 0044, 0212, 0232, 0241, 0226, 0321, 0070, 0333, 0045, 0325,
+0153, 0235, 0134, 0040, 0126, 0372, 0274, 0356, 0107, 0036, 0104, 0157, 0066, 0324, 0122, 0200,
+0246, 0202, 0007, 0122, 0230, 0244, 0041, 0200, 0045, 0376, 0347, 0117, 0337, 0040, 0023, 0363,
+0257, 0313, 0160, 0037, 0367, 0137, 0033, 0106, 0026, 0327, 0060, 0364, 0062, 0252, 0277, 0062,
+0026, 0252, 0321, 0031, 0234, 0336, 0362, 0344, 0143, 0041, 0036, 0055, 0366, 0354, 0114, 0067,
+0110, 0272, 0042, 0350, 0247, 0006, 0132, 0013, 0146, 0335, 0040, 0261, 0051, 0047, 0061, 0072,
+0107, 0231, 0027, 0132, 0004, 0215, 0044, 0141, 0315, 0135, 0256, 0071, 0106, 0144, 0323, 0002,
+0365, 0161, 0304, 0125, 0351, 0005, 0161, 0167, 0377, 0363, 0333, 0020, 0135, 0177, 0257, 0162,
+0011, 0144, 0220, 0074, 0135, 0306, 0063, 0263, 0271, 0320, 0366, 0203, 0261, 0055, 0153, 0027,
+0030, 0230, 0151, 0221, 0123, 0140, 0302, 0163, 0113, 0171, 0365, 0210, 0345, 0211, 0011, 0366,
+0236, 0336, 0026, 0150, 0165, 0203, 0357, 0342, 0026, 0037, 0315, 0266, 0373, 0007, 0001, 0212,
+0326, 0126, 0073, 0003, 0000, 0000,
+};
+static const unsigned char embedded_br_faq_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_dvb.html
+static const unsigned char embedded_config_dvb_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0355, 0130, 0113, 0157, 0034, 0067,
+0022, 0276, 0367, 0257, 0040, 0174, 0261, 0015, 0214, 0306, 0301, 0146, 0067, 0161, 0014, 0105,
+0200, 0042, 0171, 0027, 0072, 0330, 0311, 0102, 0162, 0202, 0075, 0162, 0232, 0354, 0031, 0256,
+0330, 0144, 0233, 0217, 0031, 0315, 0277, 0317, 0127, 0105, 0366, 0143, 0144, 0133, 0136, 0144,
+0261, 0300, 0036, 0222, 0203, 0063, 0352, 0046, 0353, 0371, 0325, 0127, 0125, 0175, 0256, 0314,
+0136, 0264, 0126, 0306, 0370, 0343, 0263, 0135, 0212, 0147, 0312, 0267, 0147, 0111, 0077, 0244,
+0147, 0027, 0115, 0163, 0256, 0354, 0105, 0043, 0316, 0125, 0272, 0370, 0207, 0166, 0072, 0110,
+0053, 0222, 0334, 0234, 0277, 0302, 0337, 0215, 0020, 0167, 0073, 0055, 0266, 0363, 0143, 0321,
+0172, 0227, 0244, 0161, 0121, 0030, 0327, 0371, 0320, 0313, 0144, 0274, 0023, 0322, 0051, 0021,
+0175, 0257, 0305, 0240, 0303, 0231, 0124, 0162, 0110, 0072, 0210, 0255, 0365, 0033, 0151, 0041,
+0002, 0127, 0072, 0263, 0315, 0201, 0317, 0256, 0033, 0122, 0105, 0012, 0131, 0343, 0245, 0122,
+0342, 0372, 0327, 0237, 0304, 0173, 0235, 0016, 0076, 0334, 0213, 0315, 0121, 0130, 0337, 0226,
+0223, 0353, 0065, 0037, 0122, 0164, 0366, 0227, 0240, 0143, 0064, 0156, 0053, 0322, 0316, 0104,
+0261, 0311, 0051, 0101, 0355, 0301, 0130, 0053, 0006, 0077, 0344, 0101, 0110, 0374, 0341, 0224,
+0077, 0340, 0275, 0114, 0102, 0132, 0353, 0017, 0021, 0277, 0265, 0310, 0021, 0246, 0044, 0057,
+0242, 0266, 0272, 0115, 0220, 0044, 0131, 0237, 0033, 0365, 0311, 0250, 0225, 0200, 0254, 0111,
+0053, 0173, 0074, 0372, 0300, 0032, 0066, 0232, 0225, 0130, 0231, 0160, 0364, 0140, 0322, 0016,
+0122, 0372, 0154, 0223, 0031, 0254, 0176, 0320, 0121, 0164, 0301, 0367, 0244, 0053, 0352, 0121,
+0154, 0344, 0210, 0230, 0276, 0327, 0312, 0340, 0226, 0075, 0212, 0230, 0144, 0110, 0154, 0107,
+0053, 0235, 0100, 0344, 0140, 0120, 0330, 0233, 0126, 0107, 0012, 0010, 0207, 0342, 0235, 0034,
+0330, 0264, 0361, 0005, 0235, 0156, 0167, 0322, 0071, 0155, 0343, 0177, 0030, 0213, 0242, 0105,
+0212, 0041, 0170, 0010, 0210, 0045, 0030, 0244, 0061, 0122, 0110, 0146, 0311, 0224, 0062, 0153,
+0037, 0271, 0101, 0046, 0247, 0140, 0212, 0342, 0275, 0016, 0246, 0073, 0012, 0323, 0161, 0020,
+0353, 0105, 0001, 0165, 0262, 0115, 0031, 0167, 0217, 0024, 0161, 0170, 0012, 0063, 0010, 0044,
+0277, 0216, 0226, 0256, 0305, 0115, 0007, 0050, 0254, 0370, 0132, 0175, 0066, 0105, 0261, 0015,
+0232, 0143, 0110, 0232, 0172, 0071, 0014, 0370, 0011, 0125, 0354, 0105, 0325, 0100, 0136, 0376,
+0313, 0147, 0101, 0101, 0052, 0316, 0320, 0071, 0362, 0365, 0163, 0121, 0201, 0037, 0060, 0212,
+0074, 0353, 0063, 0171, 0260, 0223, 0173, 0015, 0075, 0332, 0011, 0210, 0251, 0061, 0320, 0152,
+0055, 0076, 0270, 0144, 0054, 0131, 0344, 0330, 0054, 0077, 0060, 0150, 0107, 0253, 0224, 0211,
+0162, 0143, 0161, 0256, 0231, 0060, 0131, 0222, 0357, 0144, 0257, 0347, 0250, 0217, 0146, 0221,
+0362, 0255, 0146, 0101, 0270, 0071, 0130, 0171, 0344, 0203, 0234, 0323, 0064, 0103, 0147, 0226,
+0226, 0223, 0127, 0072, 0001, 0174, 0305, 0312, 0131, 0042, 0001, 0215, 0022, 0236, 0002, 0022,
+0324, 0033, 0344, 0324, 0043, 0121, 0237, 0057, 0260, 0215, 0317, 0111, 0170, 0310, 0017, 0325,
+0127, 0271, 0227, 0306, 0222, 0335, 0020, 0344, 0213, 0137, 0221, 0314, 0250, 0010, 0344, 0074,
+0160, 0144, 0333, 0235, 0156, 0357, 0067, 0376, 0201, 0222, 0247, 0035, 0173, 0272, 0022, 0167,
+0373, 0235, 0226, 0112, 0073, 0125, 0242, 0100, 0145, 0001, 0063, 0111, 0131, 0313, 0311, 0055,
+0231, 0202, 0260, 0303, 0250, 0016, 0366, 0044, 0021, 0164, 0253, 0315, 0136, 0307, 0323, 0222,
+0036, 0135, 0357, 0041, 0146, 0157, 0044, 0333, 0262, 0250, 0261, 0031, 0341, 0067, 0312, 0152,
+0206, 0243, 0053, 0260, 0251, 0161, 0370, 0215, 0022, 0343, 0340, 0034, 0345, 0031, 0151, 0325,
+0110, 0044, 0300, 0201, 0020, 0074, 0062, 0223, 0102, 0143, 0134, 0366, 0071, 0302, 0304, 0340,
+0023, 0231, 0050, 0173, 0217, 0133, 0043, 0232, 0047, 0034, 0147, 0247, 0013, 0266, 0164, 0277,
+0200, 0063, 0327, 0003, 0236, 0001, 0275, 0001, 0226, 0044, 0022, 0132, 0121, 0274, 0246, 0040,
+0040, 0146, 0107, 0237, 0303, 0124, 0376, 0014, 0050, 0000, 0011, 0101, 0353, 0043, 0227, 0076,
+0170, 0042, 0001, 0167, 0035, 0151, 0300, 0055, 0340, 0074, 0034, 0111, 0101, 0005, 0021, 0207,
+0174, 0362, 0367, 0132, 0043, 0223, 0210, 0067, 0056, 0155, 0267, 0047, 0056, 0217, 0311, 0171,
+0042, 0047, 0270, 0043, 0172, 0017, 0063, 0227, 0070, 0010, 0272, 0260, 0120, 0362, 0020, 0122,
+0012, 0147, 0320, 0255, 0351, 0114, 0073, 0341, 0216, 0201, 0332, 0233, 0355, 0056, 0211, 0003,
+0042, 0055, 0253, 0202, 0252, 0217, 0035, 0054, 0176, 0021, 0141, 0103, 0012, 0234, 0127, 0344,
+0020, 0360, 0227, 0065, 0241, 0116, 0370, 0240, 0012, 0147, 0156, 0164, 0242, 0050, 0200, 0303,
+0266, 0316, 0307, 0202, 0371, 0061, 0032, 0250, 0124, 0264, 0010, 0360, 0170, 0371, 0167, 0321,
+0104, 0336, 0055, 0070, 0145, 0156, 0044, 0227, 0134, 0245, 0363, 0233, 0212, 0331, 0066, 0207,
+0240, 0135, 0042, 0206, 0144, 0202, 0046, 0166, 0250, 0301, 0247, 0024, 0131, 0023, 0107, 0302,
+0240, 0332, 0333, 0300, 0140, 0120, 0052, 0075, 0202, 0235, 0122, 0154, 0203, 0101, 0171, 0123,
+0107, 0311, 0245, 0243, 0130, 0163, 0161, 0347, 0371, 0010, 0336, 0266, 0332, 0332, 0225, 0120,
+0076, 0303, 0340, 0263, 0326, 0232, 0366, 0236, 0264, 0232, 0264, 0026, 0227, 0035, 0053, 0340,
+0023, 0202, 0153, 0204, 0152, 0032, 0102, 0251, 0101, 0320, 0177, 0234, 0201, 0316, 0312, 0055,
+0031, 0252, 0071, 0074, 0211, 0120, 0037, 0134, 0211, 0114, 0050, 0324, 0205, 0320, 0241, 0140,
+0070, 0041, 0204, 0054, 0150, 0335, 0241, 0120, 0210, 0201, 0252, 0234, 0052, 0030, 0115, 0005,
+0254, 0345, 0373, 0336, 0244, 0332, 0050, 0312, 0013, 0234, 0225, 0260, 0012, 0222, 0346, 0344,
+0017, 0241, 0060, 0267, 0026, 0125, 0306, 0363, 0133, 0312, 0126, 0275, 0360, 0274, 0362, 0075,
+0352, 0173, 0221, 0250, 0312, 0111, 0122, 0134, 0215, 0305, 0316, 0236, 0121, 0252, 0275, 0263,
+0307, 0052, 0210, 0263, 0116, 0247, 0153, 0050, 0210, 0320, 0071, 0036, 0315, 0034, 0072, 0205,
+0054, 0240, 0252, 0330, 0351, 0120, 0360, 0207, 0364, 0120, 0127, 0130, 0325, 0014, 0261, 0151,
+0326, 0070, 0030, 0377, 0002, 0335, 0232, 0205, 0121, 0341, 0262, 0074, 0357, 0106, 0253, 0251,
+0362, 0136, 0256, 0070, 0163, 0263, 0107, 0317, 0257, 0213, 0370, 0061, 0327, 0263, 0067, 0227,
+0245, 0217, 0057, 0303, 0057, 0343, 0075, 0173, 0100, 0026, 0023, 0335, 0204, 0276, 0024, 0147,
+0320, 0037, 0001, 0124, 0144, 0361, 0275, 0117, 0172, 0125, 0043, 0277, 0300, 0165, 0225, 0061,
+0021, 0032, 0321, 0002, 0325, 0147, 0353, 0301, 0002, 0307, 0261, 0336, 0330, 0036, 0172, 0123,
+0206, 0010, 0240, 0032, 0217, 0217, 0224, 0044, 0315, 0111, 0251, 0122, 0076, 0146, 0103, 0366,
+0172, 0032, 0134, 0000, 0170, 0202, 0131, 0303, 0304, 0335, 0172, 0233, 0173, 0127, 0173, 0016,
+0311, 0352, 0074, 0015, 0035, 0024, 0211, 0056, 0273, 0226, 0252, 0065, 0276, 0071, 0235, 0165,
+0336, 0026, 0315, 0225, 0005, 0076, 0070, 0146, 0346, 0251, 0056, 0345, 0134, 0036, 0004, 0111,
+0100, 0316, 0021, 0300, 0000, 0124, 0070, 0113, 0101, 0340, 0154, 0206, 0322, 0004, 0016, 0046,
+0352, 0061, 0320, 0272, 0037, 0174, 0220, 0360, 0154, 0023, 0374, 0075, 0220, 0127, 0265, 0325,
+0211, 0252, 0152, 0033, 0347, 0053, 0156, 0125, 0300, 0350, 0026, 0064, 0356, 0050, 0375, 0043,
+0131, 0307, 0004, 0312, 0357, 0327, 0342, 0112, 0062, 0027, 0163, 0273, 0056, 0340, 0035, 0005,
+0376, 0235, 0003, 0357, 0332, 0143, 0025, 0171, 0245, 0311, 0070, 0114, 0077, 0365, 0361, 0324,
+0001, 0021, 0325, 0247, 0344, 0274, 0363, 0212, 0146, 0051, 0004, 0250, 0012, 0272, 0371, 0244,
+0321, 0261, 0224, 0351, 0030, 0315, 0160, 0152, 0044, 0214, 0257, 0011, 0107, 0106, 0315, 0034,
+0142, 0003, 0323, 0304, 0315, 0165, 0065, 0015, 0141, 0245, 0214, 0127, 0257, 0325, 0176, 0063,
+0167, 0313, 0057, 0113, 0374, 0047, 0306, 0035, 0223, 0106, 0247, 0247, 0072, 0175, 0016, 0346,
+0106, 0003, 0351, 0271, 0372, 0077, 0226, 0063, 0047, 0021, 0370, 0042, 0077, 0336, 0116, 0223,
+0314, 0011, 0071, 0056, 0207, 0263, 0077, 0231, 0361, 0377, 0214, 0031, 0153, 0316, 0070, 0324,
+0025, 0046, 0205, 0051, 0261, 0367, 0030, 0072, 0076, 0015, 0025, 0312, 0140, 0110, 0242, 0254,
+0031, 0207, 0072, 0345, 0204, 0274, 0252, 0132, 0106, 0016, 0302, 0043, 0136, 0031, 0044, 0243,
+0221, 0157, 0162, 0124, 0121, 0200, 0030, 0173, 0144, 0040, 0335, 0377, 0316, 0221, 0022, 0325,
+0141, 0000, 0213, 0032, 0364, 0247, 0142, 0025, 0022, 0167, 0076, 0133, 0305, 0261, 0257, 0134,
+0115, 0114, 0273, 0040, 0247, 0363, 0341, 0342, 0177, 0306, 0120, 0213, 0075, 0340, 0277, 0346,
+0247, 0061, 0244, 0213, 0051, 0173, 0371, 0350, 0017, 0222, 0324, 0125, 0135, 0071, 0026, 0122,
+0257, 0037, 0301, 0274, 0114, 0305, 0034, 0034, 0062, 0033, 0013, 0306, 0311, 0216, 0203, 0107,
+0162, 0332, 0146, 0246, 0111, 0016, 0312, 0225, 0356, 0044, 0030, 0232, 0336, 0205, 0250, 0323,
+0074, 0314, 0135, 0266, 0200, 0277, 0342, 0205, 0314, 0213, 0147, 0157, 0357, 0156, 0157, 0304,
+0333, 0367, 0342, 0333, 0157, 0276, 0021, 0177, 0375, 0356, 0365, 0263, 0262, 0012, 0055, 0057,
+0143, 0205, 0322, 0264, 0377, 0045, 0346, 0213, 0267, 0067, 0167, 0102, 0311, 0044, 0021, 0124,
+0032, 0014, 0157, 0177, 0376, 0356, 0207, 0157, 0277, 0247, 0235, 0005, 0057, 0061, 0144, 0362,
+0372, 0270, 0052, 0333, 0065, 0002, 0050, 0125, 0053, 0121, 0370, 0141, 0261, 0210, 0201, 0035,
+0351, 0332, 0331, 0353, 0327, 0177, 0373, 0341, 0354, 0001, 0375, 0255, 0365, 0144, 0014, 0111,
+0103, 0105, 0210, 0116, 0322, 0356, 0103, 0105, 0026, 0052, 0062, 0341, 0232, 0317, 0214, 0361,
+0304, 0345, 0327, 0231, 0207, 0022, 0224, 0343, 0270, 0171, 0351, 0164, 0142, 0164, 0043, 0106,
+0247, 0111, 0020, 0351, 0073, 0224, 0221, 0335, 0061, 0024, 0352, 0010, 0012, 0130, 0157, 0216,
+0174, 0157, 0141, 0347, 0024, 0101, 0270, 0371, 0005, 0130, 0115, 0001, 0250, 0320, 0256, 0211,
+0015, 0032, 0311, 0006, 0000, 0324, 0114, 0336, 0323, 0222, 0130, 0145, 0336, 0035, 0207, 0061,
+0311, 0364, 0223, 0060, 0071, 0036, 0171, 0002, 0042, 0277, 0004, 0277, 0067, 0240, 0207, 0172,
+0163, 0374, 0363, 0017, 0002, 0356, 0211, 0066, 0273, 0350, 0006, 0047, 0366, 0303, 0265, 0010,
+0215, 0104, 0240, 0163, 0333, 0252, 0255, 0377, 0353, 0275, 0165, 0234, 0021, 0276, 0042, 0161,
+0331, 0124, 0013, 0061, 0116, 0376, 0026, 0026, 0065, 0274, 0112, 0157, 0065, 0177, 0057, 0340,
+0157, 0050, 0274, 0337, 0174, 0262, 0162, 0314, 0035, 0271, 0052, 0033, 0033, 0133, 0245, 0232,
+0113, 0332, 0240, 0124, 0075, 0106, 0061, 0253, 0135, 0052, 0116, 0357, 0027, 0017, 0141, 0050,
+0261, 0070, 0274, 0213, 0244, 0326, 0350, 0226, 0263, 0006, 0160, 0251, 0003, 0261, 0247, 0114,
+0111, 0002, 0035, 0365, 0273, 0000, 0124, 0036, 0001, 0042, 0142, 0067, 0222, 0121, 0267, 0317,
+0120, 0067, 0061, 0225, 0351, 0223, 0024, 0026, 0075, 0176, 0300, 0103, 0034, 0113, 0146, 0102,
+0104, 0317, 0334, 0227, 0265, 0025, 0011, 0131, 0230, 0124, 0345, 0316, 0115, 0005, 0224, 0153,
+0315, 0364, 0351, 0147, 0172, 0034, 0363, 0000, 0326, 0142, 0207, 0316, 0356, 0126, 0374, 0277,
+0053, 0156, 0266, 0364, 0353, 0266, 0231, 0044, 0256, 0147, 0302, 0015, 0134, 0014, 0163, 0333,
+0006, 0075, 0036, 0344, 0221, 0334, 0223, 0212, 0331, 0101, 0362, 0076, 0075, 0106, 0342, 0244,
+0265, 0161, 0075, 0205, 0314, 0213, 0061, 0104, 0336, 0164, 0217, 0016, 0103, 0360, 0140, 0363,
+0226, 0073, 0261, 0073, 0211, 0315, 0102, 0210, 0323, 0132, 0305, 0262, 0267, 0021, 0040, 0350,
+0363, 0011, 0161, 0371, 0162, 0243, 0253, 0037, 0042, 0250, 0263, 0025, 0273, 0241, 0151, 0026,
+0100, 0055, 0372, 0323, 0315, 0036, 0320, 0237, 0006, 0017, 0247, 0226, 0337, 0070, 0310, 0054,
+0376, 0156, 0101, 0253, 0155, 0036, 0174, 0375, 0146, 0163, 0226, 0013, 0243, 0236, 0212, 0032,
+0077, 0267, 0130, 0335, 0045, 0221, 0341, 0104, 0346, 0104, 0303, 0072, 0060, 0205, 0136, 0212,
+0155, 0246, 0263, 0074, 0003, 0324, 0162, 0354, 0162, 0312, 0101, 0257, 0237, 0210, 0064, 0117,
+0037, 0275, 0337, 0077, 0322, 0334, 0024, 0057, 0350, 0224, 0365, 0050, 0335, 0060, 0001, 0145,
+0372, 0124, 0123, 0142, 0361, 0233, 0014, 0024, 0377, 0067, 0340, 0136, 0016, 0066, 0347, 0314,
+0235, 0300, 0367, 0305, 0207, 0333, 0237, 0126, 0102, 0247, 0366, 0045, 0340, 0027, 0170, 0355,
+0031, 0164, 0165, 0360, 0205, 0131, 0027, 0142, 0154, 0026, 0041, 0205, 0235, 0065, 0255, 0057,
+0231, 0132, 0241, 0231, 0030, 0025, 0076, 0051, 0234, 0260, 0276, 0354, 0116, 0344, 0337, 0275,
+0016, 0324, 0270, 0240, 0000, 0340, 0333, 0224, 0344, 0256, 0032, 0324, 0043, 0272, 0253, 0065,
+0367, 0364, 0021, 0221, 0330, 0300, 0204, 0002, 0245, 0232, 0375, 0232, 0347, 0107, 0056, 0374,
+0345, 0215, 0270, 0315, 0240, 0145, 0247, 0116, 0016, 0303, 0230, 0027, 0165, 0362, 0040, 0065,
+0052, 0120, 0065, 0321, 0067, 0133, 0142, 0360, 0204, 0077, 0136, 0012, 0322, 0260, 0227, 0026,
+0321, 0151, 0112, 0047, 0314, 0034, 0213, 0127, 0306, 0241, 0372, 0223, 0320, 0340, 0107, 0152,
+0032, 0273, 0114, 0373, 0340, 0147, 0124, 0124, 0147, 0347, 0010, 0064, 0245, 0130, 0111, 0337,
+0130, 0063, 0144, 0007, 0221, 0051, 0352, 0031, 0203, 0037, 0316, 0320, 0034, 0073, 0016, 0375,
+0075, 0051, 0230, 0206, 0346, 0127, 0312, 0354, 0057, 0232, 0337, 0001, 0254, 0010, 0251, 0377,
+0275, 0026, 0000, 0000,
+};
+static const unsigned char embedded_br_config_dvb_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/overview.html
+static const unsigned char embedded_overview_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0175, 0321, 0261, 0156, 0334, 0060,
+0014, 0006, 0340, 0135, 0117, 0101, 0170, 0350, 0164, 0147, 0337, 0145, 0350, 0220, 0352, 0014,
+0024, 0350, 0320, 0014, 0131, 0222, 0103, 0166, 0132, 0342, 0331, 0152, 0145, 0121, 0240, 0350,
+0134, 0374, 0042, 0171, 0241, 0276, 0130, 0344, 0004, 0101, 0266, 0016, 0202, 0040, 0011, 0004,
+0077, 0376, 0262, 0076, 0074, 0203, 0213, 0130, 0312, 0251, 0231, 0264, 0354, 0075, 0273, 0275,
+0322, 0213, 0066, 0275, 0261, 0271, 0067, 0306, 0130, 0107, 0111, 0111, 0352, 0161, 0072, 0366,
+0277, 0317, 0217, 0160, 0176, 0236, 0010, 0075, 0045, 0017, 0067, 0355, 0361, 0150, 0273, 0172,
+0155, 0276, 0071, 0316, 0353, 0017, 0270, 0071, 0034, 0276, 0303, 0276, 0156, 0307, 0303, 0016,
+0176, 0046, 0057, 0204, 0005, 0376, 0275, 0316, 0230, 0166, 0100, 0012, 0030, 0133, 0073, 0110,
+0277, 0055, 0143, 0303, 0074, 0102, 0321, 0065, 0322, 0251, 0311, 0350, 0175, 0110, 0343, 0055,
+0034, 0362, 0113, 0003, 0105, 0334, 0251, 0251, 0014, 0241, 0302, 0213, 0070, 0052, 0235, 0176,
+0166, 0214, 0074, 0162, 0233, 0323, 0270, 0341, 0272, 0117, 0227, 0371, 0002, 0205, 0002, 0031,
+0105, 0201, 0057, 0240, 0023, 0201, 0035, 0066, 0260, 0355, 0206, 0036, 0262, 0360, 0037, 0162,
+0012, 0023, 0027, 0045, 0017, 0250, 0306, 0042, 0114, 0102, 0227, 0155, 0152, 0315, 0267, 0135,
+0167, 0275, 0136, 0333, 0310, 0211, 0342, 0352, 0330, 0223, 0264, 0216, 0347, 0256, 0006, 0322,
+0364, 0377, 0177, 0267, 0035, 0176, 0044, 0165, 0247, 0160, 0131, 0222, 0323, 0300, 0251, 0052,
+0044, 0314, 0050, 0041, 0256, 0120, 0003, 0100, 0070, 0077, 0325, 0121, 0153, 0030, 0163, 0235,
+0022, 0006, 0164, 0177, 0141, 0323, 0136, 0130, 0336, 0231, 0217, 0023, 0137, 0065, 0314, 0004,
+0367, 0344, 0003, 0346, 0210, 0053, 0011, 0014, 0213, 0032, 0207, 0011, 0006, 0202, 0245, 0124,
+0161, 0121, 0114, 0036, 0067, 0300, 0173, 0035, 0327, 0102, 0201, 0274, 0110, 0346, 0102, 0145,
+0007, 0145, 0161, 0323, 0107, 0257, 0137, 0141, 0014, 0212, 0021, 0236, 0202, 0047, 0206, 0007,
+0162, 0054, 0033, 0267, 0006, 0126, 0177, 0272, 0067, 0157, 0366, 0106, 0347, 0340, 0360, 0001,
+0000, 0000,
+};
+static const unsigned char embedded_br_overview_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/dvrlog.html
+static const unsigned char embedded_dvrlog_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0175, 0122, 0261, 0156, 0033, 0061,
+0014, 0335, 0357, 0053, 0010, 0117, 0015, 0220, 0070, 0173, 0221, 0170, 0352, 0322, 0251, 0100,
+0221, 0026, 0005, 0212, 0014, 0074, 0211, 0076, 0053, 0326, 0211, 0007, 0221, 0147, 0307, 0177,
+0237, 0247, 0163, 0152, 0173, 0352, 0160, 0002, 0116, 0172, 0174, 0174, 0357, 0221, 0117, 0061,
+0035, 0050, 0144, 0066, 0173, 0136, 0355, 0334, 0036, 0242, 0206, 0007, 0227, 0167, 0137, 0155,
+0272, 0227, 0235, 0320, 0267, 0337, 0077, 0051, 0353, 0100, 0061, 0331, 0224, 0371, 0144, 0304,
+0064, 0361, 0040, 0221, 0206, 0232, 0042, 0005, 0055, 0316, 0251, 0244, 0062, 0020, 0347, 0114,
+0026, 0166, 0022, 0347, 0054, 0361, 0236, 0302, 0134, 0253, 0024, 0357, 0270, 0064, 0324, 0070,
+0145, 0161, 0024, 0125, 0011, 0132, 0043, 0340, 0266, 0246, 0306, 0236, 0223, 0071, 0045, 0043,
+0323, 0332, 0236, 0173, 0066, 0234, 0132, 0310, 0234, 0253, 0223, 0247, 0121, 0326, 0335, 0323,
+0264, 0351, 0176, 0231, 0220, 0003, 0337, 0253, 0273, 0216, 0344, 0252, 0271, 0347, 0112, 0137,
+0212, 0372, 0077, 0145, 0050, 0114, 0005, 0040, 0260, 0215, 0134, 0146, 0316, 0167, 0200, 0121,
+0341, 0103, 0032, 0330, 0245, 0353, 0305, 0217, 0042, 0145, 0021, 0157, 0147, 0244, 0054, 0036,
+0320, 0040, 0215, 0003, 0131, 0015, 0317, 0053, 0170, 0257, 0142, 0072, 0327, 0040, 0366, 0030,
+0017, 0025, 0306, 0327, 0123, 0031, 0020, 0105, 0023, 0361, 0242, 0144, 0042, 0064, 0152, 0025,
+0212, 0002, 0337, 0031, 0151, 0364, 0072, 0073, 0062, 0071, 0033, 0203, 0006, 0071, 0300, 0365,
+0075, 0275, 0315, 0060, 0026, 0162, 0012, 0373, 0146, 0047, 0001, 0202, 0034, 0020, 0235, 0116,
+0335, 0074, 0321, 0061, 0041, 0054, 0236, 0046, 0341, 0372, 0165, 0241, 0376, 0257, 0004, 0020,
+0326, 0323, 0215, 0216, 0357, 0237, 0066, 0101, 0106, 0040, 0073, 0351, 0114, 0201, 0113, 0373,
+0202, 0200, 0366, 0072, 0205, 0153, 0334, 0244, 0265, 0111, 0105, 0246, 0334, 0135, 0057, 0221,
+0302, 0124, 0165, 0100, 0077, 0214, 0203, 0140, 0057, 0144, 0375, 0014, 0372, 0314, 0175, 0361,
+0321, 0256, 0141, 0342, 0230, 0174, 0327, 0236, 0273, 0277, 0177, 0136, 0361, 0123, 0242, 0036,
+0251, 0237, 0061, 0222, 0162, 0036, 0323, 0017, 0050, 0130, 0312, 0157, 0172, 0330, 0315, 0370,
+0361, 0204, 0354, 0026, 0367, 0275, 0100, 0351, 0022, 0020, 0367, 0271, 0055, 0102, 0331, 0267,
+0171, 0065, 0362, 0113, 0226, 0043, 0173, 0125, 0333, 0063, 0155, 0023, 0040, 0246, 0027, 0253,
+0350, 0133, 0262, 0162, 0154, 0232, 0142, 0002, 0336, 0363, 0211, 0266, 0265, 0155, 0006, 0352,
+0123, 0161, 0251, 0133, 0016, 0155, 0167, 0036, 0261, 0335, 0233, 0356, 0003, 0347, 0116, 0227,
+0102, 0344, 0002, 0000, 0000,
+};
+static const unsigned char embedded_br_dvrlog_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/features.html
+static const unsigned char embedded_features_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0165, 0126, 0135, 0157, 0033, 0067,
+0020, 0174, 0327, 0257, 0130, 0344, 0311, 0006, 0364, 0001, 0270, 0101, 0121, 0024, 0256, 0001,
+0131, 0126, 0154, 0007, 0121, 0053, 0130, 0212, 0321, 0127, 0352, 0110, 0351, 0030, 0363, 0310,
+0013, 0077, 0356, 0254, 0374, 0372, 0316, 0362, 0164, 0262, 0224, 0072, 0057, 0226, 0045, 0362,
+0166, 0147, 0147, 0147, 0166, 0357, 0132, 0352, 0206, 0012, 0043, 0102, 0370, 0353, 0103, 0031,
+0303, 0110, 0272, 0142, 0024, 0325, 0153, 0374, 0160, 0063, 0030, 0134, 0113, 0203, 0277, 0164,
+0055, 0343, 0315, 0352, 0156, 0375, 0114, 0302, 0112, 0172, 0340, 0177, 0102, 0252, 0153, 0347,
+0043, 0037, 0311, 0233, 0207, 0253, 0337, 0077, 0346, 0243, 0305, 0162, 0176, 0177, 0105, 0215,
+0226, 0312, 0365, 0067, 0224, 0034, 0323, 0164, 0066, 0372, 0155, 0110, 0323, 0351, 0354, 0142,
+0364, 0060, 0277, 0074, 0334, 0274, 0042, 0221, 0244, 0076, 0273, 0167, 0367, 0174, 0213, 0257,
+0233, 0250, 0243, 0121, 0341, 0344, 0340, 0200, 0340, 0321, 0326, 0051, 0122, 0160, 0311, 0027,
+0052, 0014, 0210, 0062, 0070, 0242, 0174, 0206, 0107, 0107, 0353, 0041, 0107, 0030, 0315, 0272,
+0217, 0325, 0341, 0343, 0052, 0347, 0233, 0256, 0127, 0263, 0161, 0167, 0131, 0346, 0207, 0026,
+0311, 0104, 0135, 0033, 0105, 0102, 0212, 0072, 0052, 0037, 0110, 0170, 0165, 0232, 0023, 0167,
+0346, 0242, 0050, 0373, 0163, 0052, 0204, 0045, 0257, 0012, 0245, 0033, 0074, 0143, 0014, 0325,
+0336, 0355, 0274, 0250, 0360, 0134, 0043, 0264, 0021, 0033, 0204, 0162, 0226, 0142, 0251, 0250,
+0110, 0336, 0053, 0033, 0315, 0236, 0143, 0304, 0144, 0225, 0244, 0052, 0275, 0122, 0320, 0025,
+0162, 0012, 0253, 0134, 0012, 0146, 0337, 0201, 0231, 0034, 0320, 0160, 0011, 0031, 0121, 0041,
+0002, 0262, 0323, 0343, 0162, 0375, 0174, 0006, 0367, 0326, 0305, 0222, 0274, 0150, 0051, 0172,
+0141, 0003, 0143, 0244, 0020, 0275, 0342, 0374, 0332, 0322, 0327, 0273, 0145, 0256, 0362, 0347,
+0103, 0076, 0173, 0132, 0057, 0373, 0053, 0034, 0110, 0237, 0022, 0113, 0153, 0300, 0255, 0271,
+0052, 0033, 0000, 0177, 0333, 0135, 0106, 0111, 0051, 0072, 0251, 0242, 0052, 0172, 0046, 0316,
+0200, 0116, 0255, 0060, 0156, 0107, 0353, 0347, 0123, 0200, 0137, 0203, 0266, 0273, 0134, 0376,
+0063, 0267, 0377, 0343, 0027, 0155, 0323, 0353, 0025, 0115, 0227, 0217, 0143, 0232, 0365, 0204,
+0014, 0101, 0221, 0331, 0323, 0162, 0372, 0345, 0034, 0307, 0151, 0012, 0174, 0036, 0065, 0367,
+0117, 0212, 0334, 0362, 0050, 0374, 0116, 0305, 0237, 0133, 0376, 0260, 0136, 0055, 0351, 0342,
+0301, 0125, 0012, 0120, 0150, 0225, 0013, 0146, 0014, 0113, 0357, 0242, 0053, 0234, 0271, 0034,
+0276, 0145, 0240, 0315, 0236, 0126, 0245, 0153, 0243, 0306, 0355, 0205, 0222, 0132, 0120, 0155,
+0304, 0036, 0155, 0145, 0332, 0256, 0005, 0225, 0136, 0155, 0131, 0376, 0261, 0376, 0163, 0062,
+0151, 0333, 0166, 0374, 0272, 0251, 0212, 0261, 0363, 0273, 0311, 0207, 0233, 0177, 0157, 0027,
+0263, 0353, 0211, 0070, 0046, 0146, 0322, 0156, 0223, 0066, 0161, 0004, 0136, 0357, 0364, 0116,
+0107, 0141, 0272, 0252, 0351, 0111, 0025, 0316, 0113, 0345, 0373, 0253, 0117, 0214, 0061, 0050,
+0337, 0344, 0237, 0116, 0113, 0133, 0200, 0140, 0157, 0251, 0125, 0033, 0112, 0270, 0200, 0026,
+0101, 0144, 0133, 0121, 0250, 0301, 0201, 0322, 0271, 0215, 0032, 0212, 0024, 0165, 0155, 0240,
+0212, 0250, 0041, 0056, 0343, 0204, 0104, 0055, 0270, 0352, 0150, 0343, 0135, 0213, 0347, 0306,
+0364, 0267, 0243, 0132, 0354, 0024, 0264, 0271, 0365, 0052, 0224, 0060, 0216, 0363, 0024, 0214,
+0153, 0051, 0325, 0122, 0104, 0025, 0300, 0356, 0255, 0010, 0170, 0016, 0021, 0336, 0253, 0024,
+0126, 0377, 0026, 0306, 0205, 0253, 0120, 0352, 0374, 0065, 0176, 0136, 0161, 0255, 0275, 0347,
+0346, 0042, 0354, 0011, 0351, 0204, 0004, 0267, 0032, 0252, 0102, 0304, 0314, 0131, 0341, 0354,
+0126, 0357, 0222, 0077, 0342, 0235, 0302, 0023, 0101, 0305, 0124, 0237, 0035, 0167, 0300, 0321,
+0154, 0351, 0254, 0242, 0255, 0167, 0125, 0326, 0310, 0206, 0351, 0143, 0131, 0376, 0277, 0176,
+0300, 0235, 0067, 0312, 0302, 0347, 0303, 0354, 0063, 0304, 0214, 0150, 0353, 0301, 0237, 0321,
+0371, 0314, 0000, 0225, 0251, 0312, 0206, 0204, 0075, 0331, 0172, 0074, 0260, 0150, 0253, 0015,
+0227, 0333, 0041, 0377, 0224, 0014, 0244, 0306, 0141, 0167, 0014, 0132, 0122, 0253, 0141, 0041,
+0210, 0346, 0175, 0041, 0214, 0117, 0353, 0050, 0112, 0141, 0255, 0062, 0004, 0376, 0104, 0147,
+0254, 0122, 0151, 0117, 0073, 0357, 0122, 0015, 0054, 0103, 0232, 0057, 0357, 0363, 0357, 0074,
+0011, 0217, 0302, 0103, 0225, 0050, 0133, 0046, 0166, 0015, 0271, 0206, 0305, 0065, 0040, 0266,
+0005, 0360, 0255, 0147, 0113, 0076, 0264, 0260, 0024, 0010, 0101, 0262, 0016, 0344, 0257, 0324,
+0323, 0101, 0271, 0355, 0131, 0352, 0046, 0252, 0077, 0034, 0167, 0054, 0204, 0376, 0273, 0074,
+0031, 0105, 0360, 0310, 0173, 0055, 0256, 0104, 0364, 0056, 0274, 0210, 0203, 0240, 0027, 0207,
+0257, 0164, 0061, 0256, 0136, 0232, 0113, 0356, 0167, 0317, 0335, 0333, 0134, 0074, 0035, 0127,
+0207, 0124, 0157, 0155, 0070, 0161, 0056, 0363, 0345, 0074, 0352, 0300, 0124, 0070, 0316, 0244,
+0213, 0352, 0070, 0136, 0363, 0220, 0207, 0156, 0212, 0227, 0060, 0044, 0025, 0213, 0313, 0034,
+0241, 0307, 0176, 0324, 0231, 0001, 0063, 0336, 0131, 0135, 0260, 0177, 0271, 0032, 0272, 0117,
+0250, 0272, 0247, 0342, 0261, 0342, 0204, 0241, 0353, 0110, 0226, 0021, 0057, 0213, 0137, 0232,
+0267, 0062, 0261, 0341, 0142, 0141, 0336, 0305, 0227, 0365, 0163, 0247, 0150, 0132, 0051, 0341,
+0321, 0132, 0326, 0313, 0121, 0211, 0357, 0010, 0020, 0175, 0010, 0200, 0037, 0362, 0310, 0337,
+0240, 0332, 0242, 0124, 0062, 0031, 0045, 0007, 0264, 0205, 0267, 0216, 0134, 0164, 0212, 0022,
+0175, 0213, 0013, 0370, 0364, 0245, 0257, 0147, 0212, 0011, 0012, 0326, 0121, 0316, 0033, 0165,
+0175, 0055, 0063, 0160, 0004, 0027, 0171, 0204, 0034, 0101, 0335, 0201, 0240, 0344, 0044, 0130,
+0255, 0210, 0276, 0351, 0255, 0312, 0022, 0373, 0236, 0224, 0327, 0350, 0164, 0054, 0105, 0104,
+0066, 0060, 0335, 0105, 0313, 0306, 0330, 0246, 0230, 0355, 0167, 0354, 0076, 0362, 0025, 0145,
+0077, 0205, 0371, 0321, 0375, 0230, 0356, 0071, 0327, 0117, 0260, 0367, 0330, 0240, 0264, 0025,
+0015, 0272, 0026, 0171, 0166, 0216, 0002, 0014, 0161, 0021, 0056, 0317, 0074, 0237, 0167, 0061,
+0333, 0271, 0107, 0275, 0156, 0112, 0230, 0115, 0131, 0166, 0137, 0141, 0222, 0004, 0054, 0203,
+0201, 0300, 0133, 0203, 0321, 0124, 0342, 0033, 0222, 0234, 0256, 0341, 0334, 0235, 0274, 0202,
+0311, 0252, 0330, 0072, 0377, 0002, 0006, 0004, 0054, 0324, 0371, 0211, 0166, 0306, 0155, 0100,
+0366, 0347, 0204, 0040, 0065, 0250, 0353, 0160, 0031, 0167, 0030, 0166, 0271, 0103, 0042, 0347,
+0300, 0220, 0203, 0275, 0207, 0244, 0043, 0267, 0004, 0236, 0342, 0306, 0164, 0263, 0301, 0067,
+0032, 0057, 0003, 0071, 0125, 0136, 0055, 0225, 0250, 0021, 0334, 0141, 0233, 0265, 0245, 0306,
+0366, 0076, 0264, 0020, 0245, 0243, 0176, 0154, 0040, 0222, 0240, 0101, 0346, 0227, 0222, 0306,
+0151, 0011, 0104, 0245, 0150, 0230, 0024, 0343, 0320, 0010, 0324, 0222, 0154, 0012, 0131, 0041,
+0207, 0031, 0220, 0367, 0153, 0106, 0166, 0076, 0055, 0006, 0157, 0073, 0173, 0224, 0365, 0163,
+0366, 0106, 0064, 0000, 0361, 0302, 0106, 0022, 0005, 0320, 0005, 0036, 0240, 0215, 0360, 0232,
+0235, 0024, 0366, 0130, 0360, 0025, 0155, 0321, 0226, 0304, 0046, 0076, 0366, 0173, 0220, 0145,
+0150, 0005, 0346, 0322, 0004, 0023, 0075, 0204, 0066, 0067, 0332, 0312, 0011, 0170, 0175, 0304,
+0176, 0227, 0022, 0367, 0217, 0343, 0155, 0345, 0266, 0261, 0145, 0047, 0165, 0001, 0146, 0253,
+0051, 0112, 0013, 0005, 0204, 0260, 0061, 0250, 0247, 0207, 0361, 0244, 0276, 0047, 0315, 0171,
+0004, 0250, 0100, 0274, 0156, 0027, 0321, 0205, 0125, 0155, 0041, 0052, 0331, 0315, 0152, 0121,
+0127, 0221, 0145, 0224, 0327, 0346, 0331, 0146, 0276, 0174, 0173, 0367, 0212, 0014, 0216, 0073,
+0043, 0214, 0376, 0221, 0377, 0071, 0235, 0230, 0171, 0376, 0342, 0111, 0145, 0063, 0275, 0371,
+0215, 0143, 0375, 0151, 0364, 0007, 0227, 0216, 0310, 0074, 0300, 0040, 0130, 0134, 0324, 0247,
+0201, 0372, 0104, 0343, 0034, 0043, 0113, 0150, 0300, 0304, 0143, 0132, 0360, 0053, 0127, 0016,
+0226, 0207, 0016, 0057, 0132, 0010, 0362, 0374, 0245, 0001, 0353, 0124, 0067, 0067, 0203, 0377,
+0000, 0364, 0227, 0067, 0120, 0300, 0012, 0000, 0000,
+};
+static const unsigned char embedded_br_features_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_dvr.html
+static const unsigned char embedded_config_dvr_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0315, 0127, 0337, 0117, 0334, 0070,
+0020, 0176, 0347, 0257, 0030, 0255, 0204, 0000, 0251, 0233, 0264, 0250, 0352, 0103, 0105, 0127,
+0272, 0102, 0053, 0041, 0035, 0024, 0225, 0266, 0167, 0175, 0164, 0354, 0111, 0142, 0221, 0304,
+0071, 0333, 0331, 0145, 0377, 0373, 0316, 0330, 0116, 0166, 0227, 0105, 0320, 0343, 0345, 0016,
+0011, 0155, 0142, 0317, 0174, 0236, 0157, 0074, 0277, 0162, 0246, 0364, 0022, 0144, 0043, 0234,
+0373, 0060, 0253, 0275, 0233, 0053, 0043, 0347, 0036, 0357, 0375, 0154, 0161, 0160, 0000, 0147,
+0272, 0255, 0300, 0131, 0371, 0141, 0106, 0313, 0026, 0235, 0031, 0254, 0104, 0227, 0113, 0323,
+0225, 0272, 0122, 0113, 0353, 0105, 0221, 0365, 0135, 0025, 0145, 0373, 0305, 0001, 0174, 0253,
+0265, 0003, 0132, 0005, 0372, 0031, 0034, 0052, 0360, 0006, 0242, 0364, 0140, 0021, 0114, 0217,
+0126, 0170, 0155, 0072, 0060, 0045, 0370, 0032, 0341, 0102, 0127, 0332, 0213, 0006, 0176, 0150,
+0205, 0006, 0276, 0242, 0064, 0126, 0241, 0315, 0016, 0340, 0322, 0063, 0102, 0147, 0174, 0104,
+0051, 0215, 0005, 0047, 0153, 0124, 0103, 0243, 0273, 0012, 0350, 0115, 0250, 0126, 0167, 0332,
+0371, 0015, 0236, 0356, 0210, 0211, 0126, 0003, 0301, 0331, 0000, 0104, 0222, 0056, 0033, 0015,
+0073, 0117, 0106, 0044, 0361, 0236, 0177, 0334, 0173, 0332, 0124, 0015, 0355, 0322, 0217, 0137,
+0174, 0035, 0265, 0300, 0255, 0235, 0307, 0026, 0172, 0341, 0353, 0260, 0247, 0026, 0067, 0364,
+0310, 0134, 0126, 0065, 0022, 0217, 0157, 0313, 0032, 0205, 0302, 0116, 0301, 0112, 0067, 0015,
+0254, 0254, 0366, 0230, 0016, 0045, 0143, 0161, 0211, 0235, 0167, 0031, 0134, 0226, 0104, 0275,
+0355, 0115, 0307, 0257, 0144, 0041, 0101, 0361, 0037, 0363, 0146, 0144, 0120, 0006, 0043, 0105,
+0274, 0047, 0042, 0257, 0036, 0242, 0172, 0273, 0016, 0336, 0263, 0050, 0010, 0235, 0264, 0132,
+0046, 0023, 0054, 0275, 0370, 0361, 0025, 0376, 0064, 0025, 0035, 0351, 0011, 0233, 0011, 0171,
+0335, 0042, 0034, 0053, 0261, 0166, 0047, 0311, 0342, 0157, 0274, 0342, 0153, 0341, 0037, 0342,
+0336, 0041, 0366, 0344, 0054, 0162, 0151, 0033, 0235, 0041, 0012, 0063, 0370, 0140, 0326, 0344,
+0067, 0332, 0117, 0326, 0152, 0062, 0135, 0167, 0036, 0155, 0107, 0176, 0125, 0202, 0256, 0126,
+0070, 0314, 0340, 0332, 0170, 0055, 0023, 0076, 0153, 0012, 0351, 0067, 0216, 0347, 0013, 0323,
+0015, 0306, 0343, 0210, 0140, 0202, 0052, 0020, 0024, 0066, 0144, 0262, 0142, 0067, 0166, 0101,
+0257, 0041, 0026, 0104, 0201, 0250, 0322, 0165, 0247, 0335, 0211, 0346, 0225, 0270, 0103, 0160,
+0103, 0061, 0127, 0232, 0200, 0275, 0261, 0232, 0034, 0106, 0041, 0104, 0166, 0254, 0023, 0113,
+0366, 0161, 0215, 0362, 0016, 0325, 0236, 0377, 0222, 0343, 0004, 0164, 0270, 0202, 0021, 0141,
+0075, 0352, 0023, 0051, 0066, 0040, 0231, 0146, 0037, 0273, 0372, 0014, 0276, 0164, 0315, 0232,
+0205, 0135, 0064, 0130, 0164, 0153, 0137, 0007, 0357, 0270, 0015, 0323, 0160, 0026, 0121, 0113,
+0110, 0361, 0124, 0225, 0121, 0046, 0040, 0104, 0037, 0217, 0301, 0276, 0261, 0141, 0324, 0071,
+0372, 0111, 0177, 0363, 0253, 0253, 0371, 0305, 0305, 0021, 0034, 0137, 0336, 0176, 0001, 0347,
+0105, 0247, 0204, 0125, 0047, 0317, 0372, 0100, 0326, 0242, 0353, 0260, 0371, 0027, 0176, 0330,
+0365, 0101, 0322, 0217, 0314, 0034, 0003, 0167, 0125, 0342, 0260, 0025, 0300, 0205, 0341, 0270,
+0347, 0244, 0046, 0273, 0002, 0213, 0243, 0075, 0127, 0036, 0305, 0243, 0013, 0163, 0317, 0216,
+0301, 0116, 0024, 0015, 0231, 0261, 0025, 0355, 0024, 0066, 0070, 0337, 0147, 0337, 0013, 0113,
+0347, 0160, 0214, 0207, 0224, 0100, 0073, 0037, 0155, 0232, 0144, 0237, 0017, 0005, 0257, 0175,
+0203, 0057, 0166, 0102, 0320, 0176, 0306, 0005, 0221, 0301, 0072, 0337, 0063, 0156, 0242, 0115,
+0246, 0020, 0025, 0020, 0215, 0063, 0023, 0175, 0122, 0063, 0156, 0014, 0257, 0155, 0243, 0167,
+0331, 0273, 0030, 0034, 0034, 0374, 0173, 0234, 0057, 0073, 0331, 0014, 0012, 0247, 0233, 0352,
+0004, 0145, 0064, 0207, 0355, 0357, 0121, 0326, 0111, 0235, 0355, 0017, 0252, 0051, 0014, 0107,
+0270, 0235, 0004, 0010, 0174, 0043, 0162, 0026, 0213, 0270, 0350, 0373, 0206, 0355, 0245, 0353,
+0111, 0101, 0200, 0161, 0137, 0005, 0127, 0321, 0117, 0004, 0010, 0251, 0236, 0120, 0102, 0214,
+0230, 0151, 0065, 0131, 0354, 0035, 0066, 0345, 0036, 0053, 0016, 0212, 0027, 0262, 0011, 0252,
+0334, 0022, 0036, 0326, 0254, 0377, 0224, 0120, 0050, 0301, 0057, 0043, 0024, 0124, 0377, 0167,
+0204, 0260, 0327, 0316, 0250, 0227, 0162, 0162, 0050, 0034, 0067, 0027, 0332, 0333, 0006, 0232,
+0370, 0304, 0324, 0073, 0326, 0045, 0245, 0265, 0254, 0103, 0103, 0342, 0362, 0041, 0226, 0102,
+0067, 0234, 0102, 0047, 0223, 0075, 0067, 0306, 0371, 0171, 0157, 0015, 0115, 0036, 0216, 0174,
+0104, 0075, 0265, 0045, 0324, 0144, 0315, 0171, 0174, 0143, 0122, 0166, 0240, 0343, 0112, 0152,
+0125, 0104, 0215, 0106, 0203, 0120, 0251, 0305, 0306, 0235, 0261, 0044, 0047, 0355, 0061, 0015,
+0307, 0372, 0117, 0252, 0144, 0135, 0041, 0344, 0135, 0145, 0315, 0100, 0373, 0054, 0303, 0325,
+0354, 0036, 0345, 0340, 0123, 0123, 0007, 0062, 0126, 0154, 0337, 0217, 0343, 0336, 0151, 0151,
+0073, 0301, 0360, 0134, 0322, 0001, 0132, 0113, 0017, 0106, 0312, 0301, 0132, 0356, 0004, 0337,
+0135, 0364, 0310, 0041, 0246, 0255, 0330, 0026, 0174, 0150, 0067, 0236, 0213, 0116, 0350, 0363,
+0354, 0323, 0204, 0303, 0241, 0020, 0104, 0335, 0253, 0240, 0031, 0325, 0222, 0054, 0133, 0325,
+0366, 0176, 0315, 0326, 0154, 0154, 0211, 0224, 0047, 0113, 0310, 0247, 0354, 0256, 0162, 0150,
+0032, 0052, 0050, 0161, 0355, 0254, 0260, 0013, 0376, 0117, 0257, 0267, 0103, 0337, 0223, 0361,
+0143, 0223, 0212, 0350, 0356, 0375, 0226, 0304, 0231, 0347, 0213, 0170, 0164, 0070, 0244, 0210,
+0343, 0111, 0355, 0303, 0354, 0365, 0154, 0224, 0146, 0171, 0072, 0300, 0327, 0213, 0317, 0001,
+0361, 0054, 0247, 0107, 0176, 0275, 0100, 0047, 0255, 0016, 0023, 0327, 0264, 0366, 0351, 0136,
+0264, 0075, 0141, 0057, 0105, 0063, 0140, 0134, 0315, 0275, 0175, 0010, 0245, 0026, 0207, 0045,
+0255, 0253, 0360, 0370, 0231, 0270, 0304, 0301, 0211, 0357, 0172, 0044, 0076, 0155, 0347, 0265,
+0151, 0061, 0247, 0151, 0321, 0346, 0141, 0232, 0164, 0371, 0065, 0256, 0134, 0326, 0336, 0055,
+0243, 0310, 0343, 0360, 0305, 0244, 0377, 0221, 0346, 0232, 0261, 0114, 0356, 0243, 0377, 0016,
+0226, 0234, 0244, 0317, 0267, 0052, 0366, 0346, 0200, 0217, 0347, 0260, 0062, 0266, 0121, 0117,
+0141, 0234, 0117, 0342, 0177, 0325, 0343, 0354, 0247, 0142, 0203, 0330, 0067, 0212, 0311, 0076,
+0005, 0346, 0047, 0311, 0033, 0153, 0052, 0053, 0332, 0230, 0164, 0073, 0244, 0236, 0322, 0127,
+0173, 0372, 0152, 0347, 0052, 0067, 0050, 0041, 0135, 0134, 0354, 0160, 0131, 0226, 0075, 0005,
+0272, 0071, 0376, 0123, 0210, 0352, 0226, 0302, 0124, 0124, 0233, 0325, 0077, 0142, 0106, 0101,
+0261, 0206, 0347, 0370, 0335, 0116, 0112, 0267, 0136, 0130, 0037, 0313, 0050, 0115, 0120, 0155,
+0277, 0163, 0211, 0257, 0340, 0373, 0365, 0345, 0337, 0124, 0205, 0214, 0254, 0047, 0215, 0067,
+0247, 0247, 0157, 0337, 0236, 0276, 0071, 0175, 0375, 0372, 0251, 0023, 0076, 0155, 0235, 0140,
+0372, 0027, 0034, 0360, 0356, 0335, 0043, 0007, 0320, 0063, 0047, 0326, 0142, 0053, 0057, 0323,
+0343, 0230, 0026, 0003, 0273, 0344, 0075, 0344, 0034, 0356, 0271, 0067, 0171, 0131, 0266, 0075,
+0126, 0060, 0327, 0160, 0130, 0302, 0174, 0051, 0251, 0232, 0112, 0150, 0164, 0161, 0177, 0372,
+0356, 0055, 0314, 0105, 0174, 0227, 0246, 0137, 0303, 0054, 0352, 0254, 0064, 0345, 0311, 0252,
+0346, 0357, 0022, 0327, 0013, 0211, 0371, 0141, 0061, 0333, 0072, 0347, 0247, 0031, 0150, 0054,
+0216, 0237, 0147, 0344, 0145, 0370, 0147, 0060, 0236, 0072, 0011, 0227, 0035, 0047, 0105, 0217,
+0333, 0252, 0216, 0013, 0315, 0232, 0024, 0126, 0202, 0032, 0320, 0356, 0006, 0327, 0167, 0232,
+0175, 0252, 0241, 0245, 0346, 0104, 0165, 0346, 0054, 0017, 0237, 0123, 0034, 0377, 0125, 0354,
+0114, 0064, 0063, 0247, 0301, 0303, 0161, 0117, 0010, 0125, 0317, 0101, 0073, 0070, 0317, 0103,
+0120, 0370, 0064, 0264, 0155, 0274, 0356, 0236, 0076, 0060, 0135, 0250, 0206, 0334, 0044, 0216,
+0156, 0305, 0022, 0247, 0157, 0307, 0360, 0245, 0162, 0004, 0305, 0340, 0075, 0065, 0225, 0002,
+0251, 0150, 0121, 0121, 0025, 0167, 0054, 0216, 0145, 0111, 0223, 0123, 0166, 0100, 0207, 0353,
+0345, 0342, 0340, 0027, 0027, 0104, 0306, 0265, 0321, 0016, 0000, 0000,
+};
+static const unsigned char embedded_br_config_dvr_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_xmltv.html
+static const unsigned char embedded_config_xmltv_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0155, 0124, 0113, 0157, 0333, 0060,
+0014, 0276, 0347, 0127, 0020, 0275, 0164, 0003, 0126, 0347, 0136, 0244, 0271, 0024, 0173, 0034,
+0266, 0123, 0263, 0307, 0225, 0266, 0150, 0113, 0250, 0054, 0031, 0042, 0155, 0067, 0377, 0176,
+0224, 0245, 0244, 0055, 0266, 0134, 0214, 0110, 0344, 0367, 0042, 0355, 0203, 0161, 0013, 0164,
+0036, 0231, 0037, 0156, 0254, 0360, 0235, 0211, 0335, 0235, 0320, 0213, 0334, 0034, 0167, 0073,
+0070, 0270, 0161, 0000, 0116, 0335, 0303, 0215, 0036, 0047, 0342, 0070, 0247, 0216, 0170, 0377,
+0062, 0172, 0131, 0004, 0333, 0146, 0012, 0103, 0251, 0233, 0216, 0073, 0070, 0131, 0307, 0240,
+0247, 0240, 0217, 0231, 0311, 0200, 0104, 0350, 0142, 0350, 0335, 0060, 0047, 0202, 0077, 0077,
+0276, 0337, 0235, 0176, 0065, 0360, 0045, 0046, 0030, 0243, 0036, 0270, 0320, 0307, 0064, 0242,
+0270, 0030, 0000, 0333, 0070, 0113, 0055, 0331, 0001, 0006, 0003, 0116, 0066, 0220, 0117, 0060,
+0171, 0102, 0046, 0130, 0034, 0073, 0001, 0145, 0102, 0260, 0211, 0372, 0254, 0125, 0246, 0373,
+0375, 0176, 0135, 0327, 0146, 0223, 0323, 0304, 0244, 0132, 0376, 0167, 0172, 0330, 0343, 0261,
+0271, 0210, 0174, 0254, 0202, 0012, 0157, 0234, 0362, 0203, 0357, 0365, 0322, 0170, 0275, 0325,
+0207, 0034, 0213, 0014, 0170, 0332, 0314, 0156, 0147, 0346, 0370, 0104, 0236, 0072, 0201, 0325,
+0272, 0316, 0302, 0220, 0260, 0155, 0051, 0145, 0177, 0052, 0261, 0321, 0222, 0374, 0373, 0155,
+0051, 0200, 0130, 0002, 0223, 0342, 0004, 0046, 0256, 0001, 0274, 0143, 0311, 0151, 0114, 0032,
+0135, 0016, 0344, 0264, 0130, 0102, 0103, 0152, 0157, 0165, 0336, 0353, 0015, 0317, 0004, 0010,
+0334, 0141, 0250, 0040, 0032, 0011, 0340, 0202, 0316, 0143, 0353, 0351, 0102, 0304, 0020, 0013,
+0262, 0215, 0212, 0307, 0147, 0026, 0032, 0233, 0022, 0267, 0002, 0317, 0136, 0012, 0134, 0113,
+0120, 0121, 0072, 0354, 0254, 0322, 0271, 0322, 0265, 0122, 0233, 0165, 0046, 0375, 0057, 0224,
+0172, 0354, 0050, 0067, 0317, 0374, 0011, 0134, 0017, 0347, 0070, 0103, 0240, 0062, 0054, 0005,
+0123, 0045, 0140, 0124, 0224, 0304, 0012, 0205, 0172, 0273, 0372, 0263, 0366, 0262, 0240, 0367,
+0132, 0170, 0161, 0237, 0073, 0307, 0131, 0005, 0045, 0362, 0021, 0315, 0225, 0352, 0015, 0113,
+0305, 0370, 0160, 0262, 0224, 0007, 0316, 0020, 0342, 0133, 0062, 0301, 0044, 0157, 0062, 0321,
+0221, 0223, 0357, 0077, 0346, 0121, 0275, 0006, 0232, 0131, 0270, 0204, 0217, 0127, 0352, 0177,
+0366, 0147, 0363, 0077, 0151, 0354, 0363, 0244, 0300, 0003, 0046, 0343, 0302, 0160, 0211, 0164,
+0116, 0052, 0055, 0135, 0127, 0261, 0116, 0276, 0337, 0004, 0127, 0304, 0215, 0063, 0317, 0376,
+0153, 0302, 0352, 0140, 0101, 0137, 0147, 0377, 0115, 0027, 0201, 0065, 0135, 0131, 0111, 0005,
+0021, 0326, 0015, 0270, 0366, 0174, 0016, 0257, 0303, 0052, 0264, 0271, 0353, 0147, 0320, 0031,
+0164, 0317, 0312, 0242, 0276, 0153, 0320, 0253, 0143, 0233, 0275, 0033, 0307, 0357, 0132, 0362,
+0012, 0035, 0366, 0145, 0003, 0037, 0055, 0206, 0201, 0070, 0227, 0141, 0070, 0127, 0235, 0372,
+0002, 0060, 0211, 0150, 0051, 0227, 0314, 0165, 0326, 0233, 0237, 0064, 0152, 0232, 0355, 0271,
+0154, 0230, 0136, 0347, 0142, 0005, 0271, 0175, 0302, 0205, 0336, 0073, 0276, 0205, 0166, 0026,
+0121, 0347, 0055, 0365, 0071, 0076, 0301, 0347, 0134, 0117, 0175, 0257, 0331, 0156, 0257, 0307,
+0136, 0277, 0004, 0307, 0335, 0137, 0067, 0264, 0215, 0345, 0020, 0004, 0000, 0000,
+};
+static const unsigned char embedded_br_config_xmltv_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_access.html
+static const unsigned char embedded_config_access_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0215, 0126, 0301, 0156, 0033, 0067,
+0020, 0275, 0357, 0127, 0020, 0071, 0124, 0166, 0240, 0310, 0111, 0320, 0024, 0155, 0340, 0010,
+0060, 0322, 0264, 0065, 0320, 0026, 0106, 0354, 0066, 0350, 0221, 0132, 0216, 0264, 0254, 0271,
+0344, 0226, 0344, 0112, 0326, 0337, 0367, 0315, 0220, 0332, 0125, 0175, 0010, 0232, 0034, 0022,
+0355, 0016, 0207, 0157, 0336, 0274, 0171, 0263, 0327, 0306, 0356, 0125, 0353, 0164, 0112, 0037,
+0136, 0164, 0071, 0275, 0062, 0241, 0175, 0225, 0351, 0051, 0277, 0130, 0067, 0315, 0075, 0345,
+0154, 0375, 0116, 0215, 0203, 0322, 0155, 0113, 0051, 0251, 0066, 0370, 0034, 0203, 0123, 0066,
+0051, 0355, 0225, 0355, 0207, 0020, 0263, 0366, 0131, 0131, 0157, 0263, 0325, 0116, 0245, 0114,
+0210, 0115, 0052, 0167, 0244, 0322, 0021, 0277, 0372, 0323, 0053, 0167, 0304, 0241, 0346, 0140,
+0015, 0251, 0060, 0220, 0137, 0065, 0315, 0265, 0355, 0167, 0052, 0305, 0366, 0303, 0013, 0334,
+0031, 0051, 0205, 0061, 0342, 0216, 0253, 0162, 0023, 0056, 0332, 0332, 0335, 0152, 0360, 0073,
+0006, 0162, 0075, 0254, 0233, 0057, 0035, 0171, 0365, 0260, 0357, 0110, 0033, 0362, 0106, 0355,
+0051, 0332, 0255, 0245, 0164, 0102, 0006, 0104, 0251, 0005, 0246, 0334, 0305, 0121, 0341, 0072,
+0201, 0100, 0136, 0157, 0034, 0231, 0347, 0350, 0011, 0377, 0340, 0350, 0252, 0171, 0100, 0314,
+0100, 0261, 0267, 0051, 0331, 0340, 0325, 0326, 0351, 0035, 0022, 0106, 0102, 0144, 0277, 0261,
+0036, 0047, 0267, 0041, 0112, 0266, 0136, 0347, 0266, 0143, 0056, 0152, 0252, 0051, 0305, 0215,
+0077, 0177, 0164, 0024, 0034, 0332, 0032, 0225, 0103, 0071, 0243, 0354, 0126, 0240, 0214, 0211,
+0242, 0327, 0075, 0251, 0053, 0065, 0200, 0354, 0103, 0210, 0246, 0004, 0160, 0011, 0250, 0207,
+0143, 0156, 0357, 0124, 0141, 0241, 0321, 0306, 0104, 0316, 0031, 0312, 0341, 0110, 0377, 0214,
+0224, 0244, 0027, 0003, 0121, 0344, 0113, 0016, 0066, 0003, 0217, 0274, 0035, 0042, 0155, 0355,
+0323, 0112, 0130, 0222, 0222, 0052, 0240, 0070, 0072, 0052, 0345, 0070, 0213, 0126, 0030, 0134,
+0115, 0306, 0362, 0177, 0320, 0024, 0245, 0325, 0056, 0132, 0263, 0122, 0140, 0167, 0164, 0353,
+0106, 0135, 0073, 0273, 0176, 0010, 0022, 0201, 0167, 0055, 0071, 0267, 0124, 0046, 0214, 0340,
+0017, 0362, 0260, 0355, 0243, 0002, 0101, 0066, 0257, 0324, 0315, 0066, 0003, 0101, 0211, 0140,
+0040, 0155, 0247, 0375, 0016, 0071, 0155, 0156, 0024, 0377, 0071, 0130, 0074, 0057, 0114, 0006,
+0117, 0134, 0201, 0315, 0114, 0175, 0364, 0070, 0006, 0126, 0042, 0011, 0071, 0326, 0033, 0333,
+0152, 0006, 0223, 0073, 0015, 0001, 0145, 0325, 0101, 0067, 0033, 0042, 0137, 0322, 0324, 0264,
+0053, 0005, 0114, 0350, 0106, 0217, 0000, 0324, 0232, 0250, 0276, 0100, 0250, 0006, 0046, 0044,
+0232, 0045, 0061, 0010, 0145, 0314, 0110, 0111, 0261, 0270, 0327, 0373, 0051, 0176, 0241, 0066,
+0143, 0316, 0301, 0257, 0324, 0255, 0127, 0040, 0277, 0200, 0051, 0057, 0121, 0315, 0307, 0216,
+0332, 0307, 0115, 0170, 0052, 0145, 0035, 0303, 0010, 0360, 0356, 0130, 0362, 0164, 0234, 0206,
+0203, 0053, 0015, 0055, 0061, 0177, 0340, 0242, 0231, 0130, 0103, 0277, 0220, 0304, 0323, 0241,
+0250, 0140, 0171, 0206, 0145, 0161, 0203, 0167, 0362, 0164, 0206, 0300, 0115, 0342, 0340, 0013,
+0352, 0207, 0174, 0274, 0054, 0257, 0317, 0350, 0333, 0000, 0166, 0044, 0141, 0047, 0224, 0036,
+0103, 0075, 0120, 0074, 0047, 0050, 0021, 0076, 0144, 0216, 0022, 0034, 0151, 0322, 0171, 0312,
+0070, 0263, 0052, 0211, 0376, 0102, 0015, 0074, 0020, 0076, 0034, 0246, 0062, 0353, 0130, 0160,
+0215, 0211, 0053, 0342, 0037, 0206, 0222, 0345, 0236, 0354, 0265, 0203, 0306, 0226, 0210, 0045,
+0046, 0266, 0243, 0112, 0142, 0311, 0015, 0354, 0040, 0247, 0012, 0325, 0327, 0362, 0236, 0021,
+0214, 0204, 0272, 0315, 0166, 0017, 0014, 0222, 0171, 0242, 0343, 0214, 0050, 0103, 0216, 0360,
+0132, 0224, 0021, 0125, 0037, 0042, 0235, 0106, 0151, 0211, 0032, 0035, 0265, 0322, 0146, 0010,
+0326, 0243, 0305, 0027, 0233, 0143, 0041, 0235, 0205, 0057, 0274, 0203, 0215, 0002, 0013, 0101,
+0375, 0345, 0122, 0000, 0235, 0121, 0375, 0143, 0311, 0136, 0022, 0221, 0231, 0011, 0277, 0121,
+0103, 0030, 0306, 0341, 0214, 0142, 0235, 0036, 0245, 0315, 0334, 0127, 0366, 0232, 0330, 0363,
+0317, 0170, 0032, 0065, 0114, 0323, 0025, 0217, 0205, 0014, 0025, 0267, 0253, 0015, 0156, 0354,
+0175, 0252, 0142, 0300, 0203, 0155, 0160, 0056, 0034, 0030, 0331, 0166, 0364, 0050, 0073, 0370,
+0364, 0036, 0341, 0106, 0146, 0311, 0344, 0365, 0247, 0322, 0023, 0376, 0141, 0326, 0277, 0351,
+0107, 0252, 0216, 0304, 0046, 0061, 0350, 0230, 0155, 0153, 0007, 0146, 0312, 0372, 0147, 0366,
+0004, 0205, 0156, 0225, 0261, 0111, 0216, 0057, 0347, 0123, 0005, 0074, 0046, 0316, 0172, 0241,
+0231, 0230, 0126, 0271, 0352, 0217, 0352, 0055, 0362, 0323, 0340, 0176, 0365, 0073, 0073, 0015,
+0106, 0217, 0135, 0147, 0311, 0026, 0344, 0303, 0354, 0100, 0110, 0341, 0211, 0114, 0165, 0267,
+0352, 0122, 0131, 0245, 0056, 0214, 0316, 0010, 0012, 0315, 0240, 0220, 0046, 0241, 0074, 0314,
+0277, 0206, 0173, 0104, 0373, 0244, 0056, 0136, 0136, 0116, 0167, 0336, 0125, 0023, 0233, 0357,
+0074, 0075, 0051, 0224, 0212, 0177, 0212, 0113, 0315, 0040, 0316, 0021, 0054, 0136, 0056, 0324,
+0305, 0350, 0361, 0310, 0134, 0226, 0042, 0207, 0071, 0143, 0205, 0262, 0051, 0234, 0045, 0034,
+0231, 0357, 0025, 0263, 0233, 0157, 0275, 0275, 0333, 0177, 0133, 0035, 0160, 0056, 0207, 0273,
+0262, 0321, 0251, 0214, 0117, 0261, 0124, 0066, 0327, 0352, 0252, 0074, 0040, 0240, 0070, 0121,
+0146, 0250, 0257, 0127, 0362, 0367, 0352, 0065, 0163, 0040, 0322, 0050, 0214, 0020, 0346, 0355,
+0310, 0036, 0273, 0233, 0356, 0276, 0317, 0030, 0312, 0036, 0117, 0346, 0353, 0113, 0227, 0247,
+0055, 0204, 0174, 0351, 0024, 0064, 0351, 0242, 0314, 0373, 0142, 0172, 0261, 0070, 0333, 0131,
+0344, 0303, 0270, 0353, 0160, 0016, 0271, 0172, 0026, 0311, 0175, 0027, 0016, 0331, 0202, 0243,
+0213, 0300, 0003, 0377, 0313, 0303, 0375, 0335, 0245, 0002, 0055, 0217, 0023, 0212, 0077, 0261,
+0103, 0203, 0372, 0114, 0255, 0270, 0330, 0327, 0240, 0360, 0274, 0357, 0045, 0072, 0112, 0364,
+0177, 0304, 0312, 0250, 0170, 0215, 0273, 0304, 0146, 0334, 0272, 0021, 0233, 0131, 0033, 0340,
+0303, 0256, 0210, 0232, 0103, 0220, 0263, 0356, 0037, 0075, 0346, 0263, 0034, 0151, 0202, 0362,
+0205, 0066, 0070, 0013, 0161, 0154, 0165, 0173, 0246, 0276, 0317, 0230, 0041, 0361, 0024, 0156,
+0310, 0001, 0061, 0334, 0370, 0071, 0260, 0042, 0304, 0124, 0362, 0335, 0073, 0050, 0371, 0034,
+0064, 0337, 0367, 0351, 0356, 0347, 0351, 0216, 0033, 0306, 0364, 0265, 0052, 0371, 0300, 0107,
+0371, 0134, 0030, 0013, 0156, 0225, 0365, 0146, 0072, 0376, 0021, 0273, 0003, 0343, 0063, 0047,
+0270, 0341, 0261, 0055, 0176, 0161, 0126, 0156, 0220, 0165, 0300, 0222, 0320, 0262, 0156, 0160,
+0104, 0066, 0000, 0370, 0113, 0226, 0167, 0240, 0354, 0132, 0156, 0030, 0366, 0143, 0210, 0042,
+0241, 0214, 0375, 0010, 0044, 0154, 0305, 0142, 0317, 0160, 0243, 0143, 0161, 0100, 0210, 0171,
+0214, 0103, 0110, 0354, 0305, 0327, 0127, 0346, 0344, 0043, 0277, 0122, 0136, 0124, 0306, 0063,
+0367, 0132, 0053, 0027, 0302, 0243, 0302, 0372, 0203, 0117, 0323, 0223, 0356, 0007, 0107, 0357,
+0045, 0362, 0177, 0174, 0033, 0325, 0370, 0372, 0211, 0304, 0207, 0176, 0262, 0061, 0145, 0261,
+0316, 0112, 0052, 0274, 0023, 0165, 0140, 0017, 0107, 0273, 0203, 0151, 0310, 0367, 0303, 0066,
+0206, 0136, 0275, 0371, 0341, 0355, 0352, 0315, 0167, 0337, 0263, 0356, 0325, 0253, 0263, 0137,
+0157, 0337, 0275, 0203, 0065, 0144, 0226, 0133, 0363, 0065, 0105, 0263, 0170, 0216, 0003, 0366,
+0067, 0177, 0326, 0261, 0213, 0036, 0144, 0136, 0321, 0346, 0102, 0022, 0367, 0235, 0335, 0264,
+0161, 0001, 0061, 0252, 0007, 0151, 0132, 0015, 0116, 0037, 0051, 0046, 0056, 0267, 0013, 0054,
+0360, 0033, 0131, 0107, 0242, 0377, 0111, 0365, 0274, 0261, 0006, 0100, 0034, 0262, 0044, 0231,
+0034, 0343, 0233, 0331, 0036, 0352, 0316, 0343, 0311, 0250, 0025, 0136, 0116, 0056, 0235, 0240,
+0121, 0254, 0004, 0341, 0000, 0323, 0216, 0313, 0212, 0366, 0304, 0207, 0160, 0032, 0040, 0345,
+0023, 0264, 0026, 0167, 0350, 0360, 0225, 0146, 0167, 0035, 0006, 0237, 0277, 0142, 0371, 0233,
+0055, 0030, 0273, 0075, 0066, 0263, 0326, 0227, 0212, 0162, 0273, 0344, 0257, 0304, 0116, 0017,
+0251, 0320, 0307, 0332, 0371, 0073, 0154, 0226, 0145, 0205, 0155, 0054, 0344, 0061, 0164, 0130,
+0151, 0253, 0011, 0007, 0130, 0210, 0025, 0006, 0252, 0331, 0333, 0323, 0154, 0075, 0223, 0355,
+0102, 0036, 0056, 0004, 0043, 0306, 0041, 0025, 0035, 0100, 0217, 0354, 0150, 0055, 0246, 0116,
+0324, 0014, 0106, 0233, 0062, 0101, 0251, 0150, 0122, 0263, 0204, 0313, 0147, 0224, 0013, 0073,
+0226, 0346, 0004, 0113, 0230, 0255, 0055, 0254, 0137, 0204, 0020, 0240, 0335, 0257, 0233, 0177,
+0001, 0346, 0304, 0156, 0346, 0351, 0013, 0000, 0000,
+};
+static const unsigned char embedded_br_config_access_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/install.html
+static const unsigned char embedded_install_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0165, 0126, 0135, 0157, 0333, 0106,
+0020, 0174, 0347, 0257, 0130, 0004, 0005, 0144, 0241, 0066, 0205, 0364, 0251, 0061, 0124, 0001,
+0151, 0322, 0064, 0056, 0032, 0304, 0210, 0135, 0364, 0371, 0110, 0056, 0245, 0203, 0111, 0036,
+0161, 0167, 0224, 0243, 0376, 0372, 0316, 0356, 0361, 0103, 0162, 0022, 0300, 0260, 0044, 0336,
+0335, 0336, 0354, 0354, 0314, 0056, 0267, 0225, 0075, 0122, 0331, 0230, 0020, 0176, 0173, 0165,
+0210, 0341, 0246, 0162, 0345, 0115, 0344, 0257, 0361, 0325, 0056, 0273, 0067, 0076, 0006, 0162,
+0065, 0305, 0203, 0015, 0204, 0205, 0241, 0345, 0056, 0232, 0150, 0135, 0107, 0170, 0140, 0232,
+0340, 0310, 0034, 0215, 0155, 0114, 0321, 0060, 0331, 0016, 0373, 0230, 0036, 0217, 0007, 0066,
+0025, 0167, 0025, 0265, 0246, 0243, 0336, 0354, 0071, 0317, 0266, 0375, 0056, 0333, 0126, 0315,
+0056, 0243, 0155, 0025, 0167, 0017, 0021, 0161, 0155, 0267, 0137, 0266, 0312, 0363, 0012, 0253,
+0167, 0065, 0235, 0334, 0200, 0300, 0036, 0317, 0117, 0164, 0060, 0307, 0363, 0170, 0103, 0117,
+0006, 0037, 0176, 0350, 0072, 0071, 0055, 0073, 0113, 0134, 0021, 0236, 0154, 0237, 0020, 0366,
+0210, 0233, 0043, 0026, 0156, 0243, 0167, 0256, 0155, 0145, 0167, 0143, 0073, 0046, 0327, 0013,
+0346, 0160, 0053, 0367, 0010, 0012, 0205, 0161, 0123, 0353, 0027, 0271, 0227, 0076, 0070, 0377,
+0244, 0301, 0013, 0056, 0135, 0313, 0144, 0250, 0060, 0345, 0323, 0336, 0273, 0001, 0317, 0172,
+0357, 0112, 0016, 0201, 0256, 0052, 0303, 0255, 0353, 0326, 0071, 0275, 0347, 0332, 0014, 0115,
+0244, 0316, 0345, 0331, 0024, 0155, 0240, 0041, 0260, 0357, 0114, 0313, 0113, 0330, 0057, 0103,
+0107, 0046, 0320, 0152, 0132, 0131, 0345, 0364, 0271, 0153, 0116, 0144, 0372, 0276, 0261, 0145,
+0142, 0255, 0246, 0112, 0242, 0332, 0377, 0220, 0323, 0022, 0031, 0331, 0104, 0207, 0010, 0070,
+0251, 0254, 0376, 0163, 0367, 0136, 0012, 0361, 0172, 0002, 0101, 0370, 0153, 0135, 0210, 0024,
+0116, 0041, 0162, 0033, 0326, 0013, 0220, 0075, 0011, 0356, 0376, 0273, 0110, 0164, 0205, 0126,
+0363, 0206, 0037, 0000, 0062, 0147, 0210, 0160, 0370, 0002, 0324, 0014, 0151, 0165, 0264, 0025,
+0273, 0125, 0212, 0251, 0373, 0356, 0352, 0157, 0027, 0040, 0033, 0016, 0040, 0052, 0022, 0177,
+0265, 0041, 0136, 0323, 0237, 0310, 0144, 0116, 0143, 0115, 0317, 0266, 0151, 0300, 0272, 0104,
+0255, 0044, 0207, 0355, 0106, 0052, 0224, 0045, 0245, 0114, 0027, 0227, 0256, 0253, 0355, 0176,
+0360, 0052, 0275, 0111, 0054, 0157, 0161, 0360, 0142, 0101, 0024, 0270, 0250, 0005, 0140, 0133,
+0143, 0041, 0127, 0010, 0240, 0242, 0243, 0065, 0144, 0041, 0146, 0156, 0013, 0256, 0052, 0074,
+0170, 0346, 0042, 0043, 0224, 0345, 0310, 0176, 0126, 0024, 0102, 0364, 0316, 0107, 0172, 0363,
+0346, 0327, 0327, 0071, 0375, 0065, 0200, 0336, 0336, 0041, 0204, 0110, 0315, 0123, 0341, 0335,
+0063, 0016, 0200, 0202, 0333, 0121, 0143, 0207, 0030, 0373, 0333, 0315, 0346, 0200, 0072, 0010,
+0231, 0267, 0162, 0156, 0223, 0326, 0062, 0372, 0375, 0204, 0302, 0046, 0370, 0333, 0142, 0307,
+0270, 0347, 0344, 0040, 0305, 0053, 0165, 0115, 0355, 0135, 0113, 0036, 0014, 0104, 0046, 0071,
+0036, 0326, 0352, 0247, 0306, 0075, 0003, 0132, 0075, 0064, 0115, 0106, 0246, 0124, 0321, 0201,
+0160, 0074, 0247, 0232, 0115, 0034, 0074, 0230, 0334, 0000, 0164, 0024, 0367, 0204, 0355, 0246,
+0330, 0115, 0246, 0103, 0066, 0052, 0077, 0374, 0216, 0354, 0153, 0123, 0162, 0216, 0152, 0144,
+0311, 0026, 0122, 0066, 0354, 0251, 0255, 0107, 0102, 0321, 0102, 0336, 0142, 0035, 0204, 0101,
+0165, 0026, 0276, 0324, 0170, 0236, 0223, 0252, 0270, 0053, 0221, 0062, 0274, 0133, 0251, 0014,
+0131, 0242, 0376, 0340, 0242, 0153, 0104, 0152, 0270, 0214, 0262, 0125, 0212, 0377, 0356, 0274,
+0044, 0053, 0372, 0231, 0126, 0157, 0123, 0046, 0130, 0210, 0336, 0065, 0053, 0240, 0062, 0205,
+0232, 0255, 0065, 0117, 0014, 0026, 0114, 0160, 0235, 0112, 0257, 0074, 0230, 0156, 0317, 0041,
+0247, 0017, 0003, 0102, 0171, 0072, 0160, 0323, 0043, 0341, 0313, 0306, 0043, 0226, 0207, 0136,
+0134, 0221, 0052, 0233, 0001, 0111, 0200, 0336, 0146, 0164, 0013, 0003, 0243, 0210, 0036, 0106,
+0276, 0050, 0104, 0047, 0051, 0115, 0372, 0241, 0171, 0101, 0322, 0156, 0034, 0150, 0250, 0066,
+0262, 0007, 0231, 0200, 0326, 0237, 0076, 0176, 0376, 0364, 0307, 0046, 0107, 0113, 0334, 0304,
+0211, 0244, 0051, 0344, 0337, 0156, 0277, 0307, 0311, 0163, 0045, 0232, 0062, 0332, 0243, 0215,
+0247, 0031, 0316, 0271, 0020, 0033, 0354, 0127, 0052, 0305, 0256, 0370, 0001, 0012, 0105, 0157,
+0362, 0015, 0110, 0155, 0203, 0163, 0271, 0204, 0011, 0356, 0132, 0374, 0067, 0156, 0227, 0332,
+0272, 0157, 0363, 0322, 0112, 0251, 0155, 0074, 0227, 0154, 0217, 0051, 0365, 0000, 0001, 0152,
+0300, 0121, 0021, 0205, 0213, 0321, 0265, 0211, 0353, 0253, 0007, 0155, 0022, 0262, 0054, 0175,
+0042, 0345, 0160, 0317, 0276, 0265, 0041, 0010, 0245, 0242, 0261, 0124, 0043, 0165, 0056, 0231,
+0312, 0364, 0270, 0054, 0314, 0155, 0031, 0355, 0306, 0127, 0050, 0110, 0355, 0374, 0231, 0142,
+0160, 0254, 0114, 0065, 0175, 0161, 0116, 0214, 0244, 0230, 0322, 0265, 0066, 0146, 0324, 0212,
+0231, 0120, 0266, 0275, 0067, 0235, 0110, 0145, 0121, 0167, 0204, 0376, 0031, 0126, 0071, 0332,
+0122, 0112, 0377, 0351, 0254, 0251, 0245, 0001, 0140, 0246, 0206, 0222, 0215, 0035, 0345, 0331,
+0306, 0003, 0075, 0173, 0013, 0357, 0234, 0207, 0341, 0113, 0024, 0113, 0310, 0177, 0017, 0334,
+0235, 0317, 0032, 0053, 0122, 0300, 0250, 0020, 0030, 0050, 0376, 0330, 0356, 0350, 0012, 0314,
+0137, 0264, 0017, 0124, 0062, 0302, 0173, 0342, 0110, 0261, 0053, 0066, 0242, 0201, 0171, 0133,
+0014, 0252, 0303, 0036, 0003, 0102, 0325, 0064, 0171, 0114, 0215, 0323, 0330, 0047, 0106, 0077,
+0325, 0242, 0031, 0210, 0101, 0232, 0346, 0132, 0076, 0264, 0140, 0111, 0340, 0332, 0210, 0172,
+0157, 0133, 0343, 0117, 0051, 0245, 0114, 0062, 0230, 0332, 0246, 0235, 0330, 0136, 0312, 0202,
+0160, 0201, 0323, 0326, 0220, 0217, 0123, 0322, 0317, 0364, 0206, 0271, 0015, 0046, 0073, 0050,
+0322, 0272, 0146, 0017, 0317, 0050, 0212, 0151, 0122, 0262, 0125, 0133, 0215, 0050, 0004, 0143,
+0042, 0264, 0225, 0256, 0350, 0303, 0001, 0163, 0124, 0207, 0075, 0222, 0172, 0121, 0320, 0253,
+0015, 0330, 0334, 0124, 0307, 0342, 0232, 0070, 0226, 0153, 0000, 0024, 0361, 0115, 0267, 0276,
+0230, 0373, 0112, 0056, 0111, 0126, 0030, 0310, 0220, 0245, 0104, 0230, 0306, 0362, 0335, 0013,
+0216, 0247, 0102, 0110, 0115, 0335, 0020, 0123, 0013, 0271, 0251, 0127, 0360, 0344, 0136, 0115,
+0077, 0163, 0047, 0043, 0144, 0234, 0224, 0300, 0327, 0071, 0377, 0075, 0066, 0061, 0046, 0067,
+0030, 0060, 0071, 0175, 0061, 0232, 0352, 0164, 0030, 0035, 0076, 0311, 0106, 0342, 0367, 0263,
+0362, 0103, 0066, 0013, 0162, 0224, 0220, 0366, 0066, 0376, 0312, 0345, 0240, 0157, 0050, 0352,
+0044, 0333, 0041, 0164, 0236, 0246, 0233, 0211, 0253, 0324, 0115, 0113, 0023, 0222, 0023, 0125,
+0331, 0322, 0311, 0060, 0116, 0046, 0056, 0312, 0301, 0053, 0371, 0251, 0123, 0206, 0371, 0022,
+0205, 0360, 0075, 0315, 0116, 0132, 0235, 0314, 0371, 0271, 0347, 0064, 0213, 0146, 0017, 0056,
+0254, 0065, 0120, 0041, 0167, 0163, 0200, 0332, 0311, 0330, 0320, 0327, 0251, 0167, 0367, 0351,
+0014, 0025, 0363, 0354, 0221, 0121, 0065, 0244, 0127, 0236, 0306, 0356, 0144, 0100, 0321, 0015,
+0175, 0174, 0174, 0274, 0237, 0146, 0337, 0325, 0105, 0157, 0131, 0057, 0033, 0177, 0321, 0215,
+0017, 0313, 0306, 0207, 0210, 0126, 0335, 0312, 0105, 0170, 0041, 0212, 0256, 0164, 0315, 0132,
+0306, 0265, 0106, 0177, 0004, 0331, 0254, 0112, 0114, 0231, 0303, 0002, 0235, 0123, 0355, 0101,
+0120, 0260, 0015, 0332, 0373, 0110, 0047, 0130, 0023, 0234, 0051, 0150, 0270, 0326, 0102, 0202,
+0341, 0064, 0074, 0344, 0251, 0360, 0240, 0103, 0047, 0364, 0134, 0332, 0332, 0226, 0013, 0272,
+0040, 0272, 0163, 0132, 0130, 0315, 0023, 0242, 0172, 0164, 0340, 0243, 0105, 0231, 0023, 0253,
+0327, 0324, 0067, 0054, 0225, 0221, 0027, 0310, 0061, 0144, 0251, 0166, 0065, 0205, 0310, 0353,
+0345, 0054, 0242, 0154, 0352, 0227, 0227, 0157, 0022, 0220, 0226, 0010, 0037, 0365, 0110, 0357,
+0043, 0370, 0157, 0217, 0273, 0354, 0177, 0153, 0110, 0171, 0000, 0054, 0013, 0000, 0000,
+};
+static const unsigned char embedded_br_install_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/sysreq.html
+static const unsigned char embedded_sysreq_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0175, 0122, 0315, 0212, 0334, 0060,
+0014, 0276, 0373, 0051, 0304, 0234, 0272, 0320, 0111, 0356, 0045, 0015, 0024, 0132, 0330, 0075,
+0024, 0012, 0073, 0354, 0135, 0261, 0225, 0332, 0235, 0304, 0012, 0262, 0234, 0354, 0274, 0375,
+0052, 0031, 0132, 0132, 0026, 0172, 0225, 0365, 0375, 0312, 0135, 0110, 0053, 0370, 0011, 0113,
+0371, 0174, 0212, 0132, 0316, 0201, 0375, 0131, 0351, 0125, 0117, 0275, 0353, 0226, 0336, 0075,
+0215, 0160, 0343, 0012, 0033, 0146, 0005, 0145, 0030, 0152, 0232, 0002, 0350, 0032, 0011, 0003,
+0345, 0000, 0243, 0360, 0014, 0205, 0253, 0170, 0372, 0010, 0313, 0104, 0130, 0010, 0326, 0124,
+0222, 0202, 0353, 0020, 0242, 0320, 0270, 0263, 0352, 0362, 0251, 0155, 0125, 0320, 0067, 0023,
+0147, 0232, 0156, 0236, 0003, 0111, 0343, 0171, 0156, 0115, 0261, 0335, 0322, 0065, 0265, 0221,
+0067, 0345, 0203, 0335, 0106, 0247, 0136, 0143, 0052, 0135, 0213, 0075, 0054, 0370, 0223, 0032,
+0367, 0343, 0316, 0234, 0131, 0223, 0047, 0320, 0210, 0012, 0073, 0012, 0002, 0255, 0064, 0361,
+0062, 0223, 0271, 0063, 0121, 0002, 0316, 0323, 0015, 0114, 0165, 0042, 0257, 0305, 0026, 0011,
+0066, 0226, 0253, 0113, 0031, 0036, 0277, 0175, 0371, 0012, 0037, 0316, 0276, 0212, 0330, 0366,
+0103, 0003, 0117, 0006, 0211, 0134, 0055, 0216, 0321, 0356, 0114, 0011, 0215, 0140, 0256, 0076,
+0376, 0236, 0377, 0025, 0334, 0335, 0203, 0243, 0161, 0037, 0126, 0002, 0254, 0044, 0045, 0161,
+0376, 0267, 0201, 0241, 0352, 0201, 0312, 0346, 0113, 0340, 0232, 0171, 0153, 0216, 0026, 0335,
+0345, 0117, 0143, 0251, 0130, 0046, 0121, 0340, 0361, 0260, 0327, 0015, 0375, 0343, 0345, 0271,
+0153, 0007, 0213, 0052, 0374, 0313, 0154, 0103, 0344, 0242, 0046, 0200, 0372, 0256, 0102, 0253,
+0346, 0135, 0203, 0247, 0376, 0077, 0217, 0173, 0205, 0215, 0273, 0037, 0122, 0141, 0254, 0331,
+0253, 0171, 0066, 0007, 0222, 0146, 0224, 0144, 0135, 0141, 0261, 0120, 0227, 0027, 0030, 0320,
+0137, 0217, 0203, 0262, 0034, 0276, 0236, 0367, 0203, 0244, 0231, 0340, 0073, 0205, 0204, 0166,
+0132, 0274, 0131, 0042, 0313, 0347, 0074, 0146, 0030, 0010, 0352, 0136, 0102, 0121, 0314, 0001,
+0167, 0325, 0003, 0310, 0206, 0024, 0130, 0252, 0054, 0134, 0250, 0130, 0364, 0326, 0076, 0127,
+0357, 0336, 0000, 0104, 0275, 0032, 0303, 0143, 0002, 0000, 0000,
+};
+static const unsigned char embedded_br_sysreq_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_tags.html
+static const unsigned char embedded_config_tags_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0155, 0126, 0301, 0156, 0033, 0071,
+0014, 0275, 0373, 0053, 0210, 0134, 0222, 0000, 0216, 0163, 0057, 0122, 0003, 0101, 0333, 0155,
+0173, 0150, 0121, 0040, 0306, 0002, 0173, 0224, 0107, 0034, 0217, 0020, 0215, 0070, 0053, 0151,
+0354, 0370, 0357, 0367, 0121, 0232, 0031, 0073, 0335, 0372, 0020, 0173, 0106, 0344, 0043, 0371,
+0370, 0110, 0345, 0311, 0272, 0043, 0065, 0336, 0244, 0364, 0361, 0246, 0313, 0351, 0301, 0112,
+0363, 0220, 0371, 0055, 0337, 0154, 0127, 0053, 0172, 0162, 0375, 0201, 0122, 0154, 0076, 0336,
+0340, 0165, 0344, 0044, 0143, 0154, 0070, 0075, 0146, 0163, 0110, 0331, 0354, 0067, 0103, 0070,
+0124, 0263, 0141, 0273, 0242, 0135, 0347, 0022, 0341, 0055, 0341, 0153, 0114, 0154, 0051, 0013,
+0065, 0022, 0132, 0167, 0030, 0043, 0123, 0323, 0231, 0020, 0330, 0223, 0272, 0156, 0140, 0214,
+0057, 0062, 0170, 0077, 0133, 0132, 0156, 0135, 0140, 0062, 0224, 0070, 0223, 0264, 0263, 0275,
+0332, 0376, 0224, 0354, 0032, 0246, 0334, 0231, 0114, 0101, 0162, 0347, 0302, 0201, 0206, 0050,
+0235, 0333, 0273, 0014, 0220, 0013, 0264, 0320, 0136, 0021, 0172, 0356, 0367, 0034, 0025, 0244,
+0037, 0175, 0166, 0203, 0347, 0071, 0352, 0263, 0117, 0262, 0006, 0020, 0043, 0060, 0262, 0014,
+0102, 0221, 0377, 0035, 0135, 0344, 0236, 0103, 0176, 0237, 0257, 0172, 0120, 0053, 0221, 0342,
+0030, 0202, 0106, 0334, 0035, 0073, 0066, 0226, 0203, 0245, 0025, 0041, 0056, 0373, 0166, 0103,
+0337, 0063, 0140, 0326, 0324, 0311, 0211, 0217, 0034, 0327, 0063, 0232, 0045, 0327, 0322, 0131,
+0106, 0365, 0275, 0362, 0313, 0162, 0140, 0215, 0115, 0047, 0227, 0073, 0172, 0201, 0127, 0166,
+0075, 0157, 0026, 0372, 0112, 0320, 0007, 0324, 0177, 0305, 0014, 0062, 0370, 0000, 0203, 0321,
+0303, 0202, 0236, 0274, 0333, 0276, 0260, 0211, 0115, 0307, 0211, 0134, 0320, 0102, 0350, 0313,
+0257, 0257, 0233, 0351, 0350, 0263, 0113, 0203, 0067, 0347, 0053, 0366, 0350, 0020, 0145, 0034,
+0026, 0333, 0071, 0044, 0375, 0140, 0353, 0014, 0251, 0061, 0107, 0215, 0377, 0250, 0370, 0357,
+0363, 0250, 0071, 0170, 0227, 0062, 0262, 0170, 0044, 0070, 0350, 0017, 0105, 0062, 0100, 0165,
+0166, 0103, 0253, 0167, 0171, 0355, 0244, 0330, 0150, 0073, 0330, 0373, 0065, 0131, 0031, 0367,
+0040, 0276, 0361, 0256, 0171, 0045, 0011, 0240, 0154, 0103, 0317, 0155, 0106, 0365, 0325, 0102,
+0371, 0327, 0054, 0017, 0312, 0126, 0006, 0210, 0176, 0116, 0016, 0007, 0255, 0327, 0350, 0002,
+0061, 0240, 0020, 0355, 0160, 0043, 0061, 0300, 0057, 0153, 0267, 0212, 0126, 0134, 0260, 0256,
+0061, 0232, 0117, 0321, 0004, 0242, 0166, 0046, 0241, 0367, 0034, 0046, 0234, 0011, 0170, 0103,
+0073, 0155, 0151, 0337, 0303, 0002, 0365, 0047, 0236, 0016, 0140, 0153, 0220, 0025, 0220, 0056,
+0315, 0031, 0240, 0356, 0124, 0130, 0232, 0060, 0156, 0137, 0314, 0161, 0161, 0270, 0245, 0375,
+0230, 0263, 0004, 0264, 0074, 0220, 0104, 0133, 0323, 0251, 0207, 0050, 0350, 0123, 0307, 0315,
+0353, 0136, 0336, 0152, 0145, 0332, 0171, 0011, 0376, 0074, 0001, 0165, 0212, 0243, 0326, 0023,
+0025, 0220, 0262, 0053, 0174, 0254, 0056, 0324, 0031, 0153, 0001, 0023, 0370, 0104, 0020, 0142,
+0074, 0257, 0257, 0322, 0271, 0175, 0306, 0131, 0171, 0173, 0111, 0102, 0173, 0244, 0306, 0167,
+0334, 0017, 0371, 0174, 0137, 0217, 0257, 0071, 0304, 0034, 0140, 0134, 0013, 0105, 0122, 0173,
+0237, 0070, 0102, 0242, 0212, 0120, 0055, 0060, 0110, 0152, 0125, 0062, 0111, 0000, 0060, 0350,
+0226, 0045, 0114, 0165, 0126, 0105, 0226, 0317, 0077, 0250, 0243, 0061, 0001, 0246, 0247, 0245,
+0124, 0170, 0052, 0232, 0326, 0231, 0264, 0050, 0175, 0260, 0234, 0212, 0350, 0217, 0306, 0217,
+0214, 0161, 0150, 0224, 0015, 0075, 0231, 0231, 0254, 0350, 0110, 0037, 0014, 0031, 0035, 0204,
+0216, 0303, 0124, 0341, 0157, 0054, 0003, 0321, 0064, 0331, 0035, 0221, 0105, 0201, 0136, 0030,
+0271, 0046, 0313, 0262, 0147, 0234, 0027, 0205, 0104, 0352, 0005, 0072, 0125, 0033, 0247, 0261,
+0061, 0227, 0334, 0224, 0156, 0103, 0273, 0001, 0235, 0276, 0333, 0237, 0053, 0363, 0072, 0303,
+0205, 0174, 0020, 0062, 0045, 0006, 0253, 0376, 0176, 0135, 0122, 0272, 0342, 0373, 0163, 0205,
+0257, 0110, 0154, 0057, 0254, 0077, 0323, 0040, 0003, 0215, 0303, 0065, 0321, 0046, 0275, 0226,
+0176, 0317, 0273, 0043, 0366, 0372, 0030, 0313, 0046, 0340, 0224, 0377, 0064, 0134, 0215, 0370,
+0261, 0017, 0151, 0322, 0005, 0136, 0264, 0342, 0275, 0234, 0064, 0277, 0166, 0014, 0250, 0136,
+0102, 0372, 0240, 0016, 0266, 0016, 0227, 0315, 0333, 0057, 0265, 0075, 0345, 0311, 0156, 0177,
+0230, 0327, 0352, 0210, 0061, 0045, 0163, 0064, 0316, 0353, 0351, 0074, 0344, 0050, 0244, 0054,
+0320, 0322, 0364, 0063, 0306, 0267, 0207, 0150, 0333, 0305, 0336, 0245, 0051, 0175, 0025, 0300,
+0334, 0166, 0247, 0173, 0254, 0150, 0266, 0020, 0001, 0066, 0365, 0245, 0342, 0341, 0265, 0116,
+0173, 0331, 0204, 0012, 0141, 0154, 0357, 0002, 0226, 0102, 0064, 0131, 0142, 0155, 0012, 0362,
+0373, 0151, 0172, 0236, 0222, 0323, 0237, 0163, 0170, 0304, 0333, 0140, 0066, 0320, 0133, 0055,
+0156, 0316, 0040, 0250, 0205, 0025, 0116, 0045, 0005, 0207, 0130, 0261, 0325, 0205, 0134, 0266,
+0242, 0011, 0263, 0216, 0315, 0230, 0245, 0067, 0330, 0374, 0250, 0010, 0033, 0300, 0002, 0002,
+0375, 0255, 0013, 0155, 0115, 0234, 0233, 0045, 0372, 0167, 0205, 0010, 0306, 0117, 0031, 0054,
+0127, 0013, 0277, 0015, 0022, 0265, 0222, 0043, 0226, 0335, 0267, 0335, 0313, 0057, 0272, 0233,
+0024, 0373, 0307, 0105, 0170, 0137, 0204, 0240, 0133, 0367, 0042, 0217, 0310, 0245, 0362, 0022,
+0265, 0010, 0250, 0245, 0335, 0337, 0227, 0273, 0111, 0211, 0325, 0356, 0133, 0051, 0265, 0234,
+0134, 0352, 0124, 0011, 0065, 0060, 0231, 0031, 0007, 0105, 0237, 0247, 0131, 0322, 0345, 0246,
+0164, 0233, 0124, 0053, 0107, 0332, 0205, 0367, 0113, 0061, 0220, 0321, 0124, 0310, 0137, 0043,
+0004, 0066, 0230, 0134, 0060, 0341, 0353, 0160, 0164, 0165, 0137, 0016, 0156, 0022, 0172, 0241,
+0271, 0334, 0276, 0032, 0241, 0134, 0201, 0110, 0062, 0160, 0076, 0111, 0174, 0235, 0162, 0360,
+0162, 0220, 0174, 0036, 0370, 0067, 0346, 0024, 0121, 0167, 0147, 0166, 0331, 0317, 0035, 0104,
+0115, 0270, 0203, 0326, 0263, 0022, 0214, 0012, 0362, 0252, 0243, 0065, 0215, 0145, 0207, 0244,
+0161, 0340, 0350, 0372, 0101, 0322, 0242, 0311, 0131, 0140, 0105, 0011, 0020, 0021, 0206, 0146,
+0162, 0127, 0327, 0045, 0370, 0047, 0054, 0146, 0340, 0117, 0121, 0237, 0165, 0006, 0322, 0377,
+0065, 0246, 0265, 0352, 0277, 0004, 0246, 0054, 0162, 0275, 0246, 0213, 0114, 0217, 0056, 0271,
+0105, 0364, 0250, 0134, 0357, 0036, 0025, 0144, 0015, 0215, 0173, 0171, 0021, 0130, 0131, 0174,
+0252, 0253, 0272, 0131, 0230, 0206, 0061, 0152, 0266, 0145, 0064, 0165, 0304, 0360, 0327, 0035,
+0267, 0253, 0377, 0000, 0130, 0203, 0265, 0341, 0010, 0011, 0000, 0000,
+};
+static const unsigned char embedded_br_config_tags_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_channels.html
+static const unsigned char embedded_config_channels_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0265, 0126, 0301, 0156, 0334, 0066,
+0020, 0275, 0373, 0053, 0006, 0271, 0270, 0005, 0354, 0165, 0332, 0042, 0207, 0006, 0216, 0201,
+0064, 0061, 0332, 0000, 0111, 0021, 0304, 0333, 0240, 0127, 0112, 0034, 0255, 0210, 0110, 0244,
+0112, 0122, 0273, 0331, 0176, 0175, 0337, 0014, 0251, 0325, 0072, 0011, 0120, 0364, 0120, 0303,
+0200, 0126, 0042, 0347, 0161, 0346, 0315, 0233, 0031, 0336, 0132, 0267, 0247, 0166, 0060, 0051,
+0275, 0170, 0322, 0347, 0164, 0155, 0103, 0173, 0235, 0371, 0163, 0176, 0162, 0167, 0161, 0101,
+0267, 0156, 0334, 0121, 0212, 0355, 0213, 0047, 0370, 0034, 0071, 0205, 0071, 0266, 0234, 0156,
+0332, 0336, 0170, 0317, 0103, 0066, 0315, 0146, 0362, 0273, 0262, 0023, 0060, 0167, 0027, 0264,
+0355, 0231, 0352, 0152, 0042, 0023, 0231, 0006, 0227, 0062, 0133, 0272, 0041, 0266, 0116, 0176,
+0220, 0363, 0144, 0150, 0027, 0235, 0335, 0220, 0230, 0315, 0003, 0254, 0350, 0166, 0160, 0167,
+0333, 0240, 0173, 0260, 0332, 0362, 0060, 0134, 0221, 0015, 0163, 0063, 0360, 0165, 0073, 0270,
+0366, 0023, 0005, 0117, 0056, 0157, 0350, 0145, 0227, 0071, 0326, 0035, 0344, 0222, 0036, 0265,
+0003, 0252, 0313, 0000, 0221, 0277, 0203, 0303, 0102, 0067, 0230, 0135, 0202, 0011, 0123, 0350,
+0260, 0204, 0155, 0041, 0172, 0330, 0345, 0100, 0021, 0233, 0361, 0160, 0336, 0272, 0326, 0210,
+0077, 0271, 0067, 0031, 0173, 0250, 0067, 0211, 0032, 0146, 0137, 0161, 0052, 0360, 0206, 0340,
+0125, 0033, 0306, 0021, 0073, 0162, 0317, 0211, 0353, 0002, 0366, 0032, 0170, 0005, 0244, 0355,
+0276, 0147, 0143, 0331, 0133, 0232, 0300, 0117, 0222, 0135, 0124, 0061, 0056, 0037, 0314, 0376,
+0144, 0160, 0111, 0315, 0234, 0163, 0360, 0033, 0172, 0343, 0051, 0104, 0133, 0334, 0051, 0213,
+0010, 0350, 0125, 0317, 0355, 0247, 0046, 0174, 0056, 0221, 0035, 0303, 0014, 0367, 0207, 0143,
+0005, 0352, 0005, 0107, 0166, 0127, 0052, 0132, 0026, 0026, 0301, 0307, 0305, 0112, 0235, 0345,
+0201, 0063, 0227, 0240, 0043, 0215, 0001, 0324, 0263, 0317, 0321, 0161, 0272, 0242, 0204, 0265,
+0126, 0003, 0100, 0072, 0074, 0234, 0377, 0256, 0071, 0026, 0060, 0347, 0167, 0005, 0017, 0374,
+0326, 0303, 0260, 0153, 0374, 0376, 0212, 0314, 0243, 0210, 0056, 0137, 0027, 0370, 0202, 0304,
+0166, 0215, 0346, 0045, 0115, 0141, 0232, 0247, 0163, 0372, 0115, 0372, 0244, 0021, 0210, 0307,
+0301, 0167, 0056, 0216, 0362, 0032, 0301, 0375, 0137, 0063, 0047, 0170, 0115, 0267, 0067, 0222,
+0166, 0074, 0247, 0105, 0062, 0141, 0230, 0107, 0237, 0152, 0244, 0370, 0320, 0205, 0141, 0010,
+0007, 0161, 0257, 0233, 0175, 0233, 0135, 0360, 0351, 0271, 0252, 0254, 0310, 0305, 0346, 0273,
+0337, 0347, 0261, 0341, 0250, 0057, 0366, 0356, 0125, 0221, 0034, 0171, 0375, 0210, 0254, 0365,
+0020, 0007, 0376, 0175, 0310, 0064, 0047, 0244, 0031, 0001, 0257, 0231, 0162, 0036, 0052, 0362,
+0146, 0030, 0216, 0127, 0022, 0007, 0105, 0203, 0043, 0143, 0015, 0101, 0026, 0275, 0055, 0062,
+0151, 0370, 0144, 0375, 0333, 0366, 0341, 0275, 0160, 0006, 0122, 0023, 0274, 0003, 0305, 0146,
+0232, 0304, 0077, 0025, 0325, 0030, 0262, 0004, 0001, 0302, 0303, 0120, 0161, 0012, 0101, 0140,
+0137, 0130, 0204, 0225, 0221, 0040, 0112, 0346, 0257, 0210, 0163, 0173, 0261, 0304, 0141, 0106,
+0256, 0121, 0310, 0117, 0221, 0154, 0136, 0213, 0010, 0144, 0056, 0000, 0042, 0163, 0117, 0367,
+0357, 0177, 0325, 0334, 0240, 0102, 0065, 0206, 0022, 0114, 0147, 0120, 0226, 0233, 0172, 0262,
+0220, 0261, 0023, 0327, 0174, 0305, 0063, 0047, 0064, 0033, 0270, 0220, 0122, 0254, 0030, 0052,
+0071, 0270, 0334, 0123, 0152, 0173, 0266, 0363, 0300, 0266, 0102, 0104, 0106, 0311, 0130, 0140,
+0044, 0161, 0165, 0263, 0370, 0372, 0347, 0273, 0267, 0327, 0333, 0217, 0364, 0240, 0155, 0340,
+0033, 0116, 0327, 0365, 0172, 0032, 0244, 0336, 0251, 0020, 0064, 0253, 0165, 0215, 0275, 0101,
+0125, 0133, 0375, 0336, 0232, 0223, 0352, 0252, 0104, 0017, 0275, 0153, 0373, 0057, 0140, 0204,
+0341, 0320, 0144, 0203, 0340, 0255, 0311, 0206, 0272, 0030, 0306, 0015, 0375, 0162, 0204, 0344,
+0073, 0063, 0017, 0171, 0201, 0130, 0363, 0253, 0262, 0027, 0263, 0321, 0144, 0300, 0211, 0147,
+0112, 0005, 0132, 0001, 0017, 0135, 0311, 0171, 0012, 0043, 0147, 0067, 0142, 0037, 0112, 0173,
+0164, 0273, 0176, 0351, 0040, 0302, 0116, 0261, 0153, 0070, 0037, 0320, 0021, 0316, 0043, 0053,
+0015, 0120, 0023, 0040, 0137, 0361, 0145, 0212, 0141, 0357, 0244, 0232, 0223, 0164, 0225, 0045,
+0232, 0031, 0346, 0255, 0111, 0100, 0137, 0342, 0254, 0225, 0216, 0303, 0244, 0026, 0304, 0217,
+0023, 0253, 0133, 0164, 0253, 0112, 0346, 0275, 0021, 0303, 0032, 0267, 0230, 0101, 0201, 0115,
+0230, 0275, 0252, 0321, 0320, 0337, 0034, 0303, 0325, 0251, 0306, 0215, 0077, 0122, 0206, 0355,
+0222, 0167, 0051, 0044, 0171, 0327, 0276, 0253, 0272, 0125, 0235, 0202, 0042, 0067, 0015, 0122,
+0126, 0232, 0117, 0361, 0335, 0345, 0313, 0104, 0363, 0044, 0240, 0232, 0237, 0160, 0250, 0020,
+0362, 0166, 0160, 0251, 0227, 0025, 0040, 0350, 0146, 0245, 0116, 0272, 0002, 0312, 0112, 0320,
+0253, 0133, 0172, 0200, 0170, 0345, 0054, 0262, 0147, 0142, 0053, 0360, 0247, 0032, 0122, 0172,
+0104, 0253, 0356, 0114, 0002, 0352, 0361, 0062, 0035, 0066, 0217, 0375, 0065, 0003, 0010, 0074,
+0051, 0175, 0305, 0061, 0364, 0016, 0123, 0301, 0320, 0064, 0230, 0043, 0052, 0173, 0341, 0354,
+0015, 0212, 0255, 0162, 0366, 0322, 0323, 0037, 0037, 0336, 0242, 0015, 0101, 0323, 0265, 0040,
+0341, 0241, 0033, 0015, 0350, 0216, 0134, 0041, 0165, 0141, 0055, 0253, 0163, 0312, 0034, 0240,
+0024, 0101, 0233, 0127, 0043, 0115, 0016, 0103, 0150, 0316, 0001, 0052, 0300, 0220, 0100, 0227,
+0200, 0054, 0131, 0020, 0247, 0020, 0025, 0350, 0044, 0303, 0212, 0002, 0161, 0154, 0077, 0326,
+0246, 0323, 0071, 0036, 0054, 0242, 0101, 0367, 0052, 0255, 0023, 0074, 0151, 0253, 0327, 0331,
+0046, 0132, 0063, 0176, 0026, 0320, 0123, 0050, 0257, 0077, 0176, 0240, 0367, 0221, 0257, 0037,
+0262, 0211, 0171, 0211, 0351, 0153, 0373, 0064, 0161, 0353, 0272, 0243, 0304, 0146, 0106, 0110,
+0042, 0113, 0321, 0241, 0013, 0104, 0103, 0242, 0343, 0062, 0310, 0122, 0037, 0346, 0141, 0141,
+0017, 0241, 0040, 0372, 0351, 0324, 0315, 0314, 0132, 0326, 0153, 0301, 0113, 0347, 0317, 0175,
+0035, 0245, 0147, 0314, 0310, 0224, 0222, 0256, 0110, 0007, 0130, 0240, 0213, 0325, 0074, 0346,
+0343, 0304, 0364, 0214, 0172, 0351, 0034, 0242, 0256, 0163, 0314, 0062, 0112, 0323, 0127, 0315,
+0104, 0366, 0375, 0370, 0364, 0371, 0323, 0247, 0205, 0341, 0044, 0161, 0226, 0266, 0051, 0226,
+0004, 0243, 0037, 0176, 0176, 0376, 0354, 0131, 0045, 0020, 0354, 0053, 0311, 0141, 0317, 0021,
+0267, 0004, 0126, 0026, 0052, 0322, 0375, 0032, 0156, 0303, 0235, 0314, 0270, 0263, 0106, 0045,
+0074, 0126, 0343, 0307, 0334, 0206, 0224, 0257, 0357, 0275, 0255, 0324, 0076, 0270, 0321, 0015,
+0106, 0051, 0175, 0304, 0174, 0141, 0341, 0033, 0211, 0063, 0326, 0012, 0351, 0112, 0165, 0365,
+0143, 0115, 0300, 0227, 0324, 0013, 0351, 0030, 0014, 0337, 0342, 0374, 0177, 0140, 0126, 0144,
+0205, 0012, 0005, 0271, 0077, 0235, 0310, 0015, 0323, 0143, 0156, 0145, 0361, 0077, 0162, 0153,
+0364, 0226, 0365, 0057, 0324, 0276, 0343, 0210, 0002, 0053, 0123, 0256, 0122, 0173, 0336, 0356,
+0363, 0041, 0254, 0027, 0101, 0365, 0137, 0253, 0274, 0315, 0052, 0176, 0045, 0070, 0111, 0143,
+0251, 0375, 0261, 0072, 0261, 0336, 0070, 0306, 0063, 0170, 0322, 0377, 0057, 0107, 0143, 0351,
+0360, 0272, 0255, 0360, 0343, 0163, 0130, 0362, 0343, 0013, 0303, 0247, 0101, 0124, 0057, 0216,
+0053, 0360, 0371, 0210, 0025, 0027, 0364, 0140, 0275, 0016, 0272, 0264, 0310, 0266, 0136, 0074,
+0344, 0364, 0245, 0065, 0310, 0244, 0337, 0263, 0325, 0276, 0150, 0204, 0156, 0216, 0173, 0207,
+0321, 0053, 0263, 0337, 0353, 0315, 0110, 0157, 0227, 0217, 0156, 0243, 0242, 0010, 0133, 0345,
+0220, 0265, 0345, 0301, 0201, 0174, 0136, 0157, 0267, 0067, 0172, 0255, 0301, 0103, 0357, 0320,
+0365, 0371, 0017, 0256, 0006, 0017, 0321, 0231, 0013, 0000, 0000,
+};
+static const unsigned char embedded_br_config_channels_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/autorec.html
+static const unsigned char embedded_autorec_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0215, 0126, 0115, 0157, 0043, 0067,
+0014, 0275, 0317, 0257, 0040, 0366, 0222, 0054, 0352, 0070, 0350, 0241, 0227, 0302, 0033, 0040,
+0115, 0167, 0213, 0234, 0132, 0164, 0215, 0026, 0075, 0312, 0022, 0147, 0054, 0104, 0043, 0115,
+0365, 0341, 0144, 0376, 0175, 0037, 0245, 0361, 0330, 0010, 0212, 0305, 0346, 0224, 0130, 0344,
+0343, 0343, 0043, 0037, 0235, 0235, 0261, 0047, 0322, 0116, 0245, 0364, 0351, 0303, 0061, 0247,
+0073, 0023, 0364, 0135, 0346, 0267, 0374, 0341, 0241, 0333, 0037, 0231, 0156, 0036, 0113, 0016,
+0243, 0312, 0126, 0323, 0237, 0254, 0103, 0064, 0034, 0157, 0310, 0046, 0052, 0211, 0015, 0345,
+0100, 0072, 0262, 0312, 0114, 0261, 0070, 0116, 0224, 0217, 0052, 0323, 0253, 0165, 0216, 0162,
+0264, 0103, 0247, 0326, 0324, 0130, 0123, 0255, 0037, 0050, 0364, 0304, 0047, 0366, 0071, 0155,
+0351, 0237, 0120, 0110, 0053, 0057, 0120, 0310, 0004, 0046, 0340, 0132, 0040, 0315, 0170, 0352,
+0325, 0051, 0104, 0233, 0271, 0333, 0377, 0105, 0351, 0030, 0136, 0157, 0323, 0307, 0315, 0371,
+0135, 0241, 0304, 0030, 0116, 0026, 0065, 0203, 0047, 0105, 0151, 0142, 0155, 0173, 0024, 0322,
+0107, 0345, 0075, 0273, 0015, 0161, 0326, 0333, 0156, 0067, 0075, 0164, 0317, 0371, 0046, 0041,
+0076, 0005, 0232, 0102, 0112, 0366, 0340, 0370, 0212, 0266, 0272, 0142, 0166, 0120, 0322, 0122,
+0205, 0373, 0267, 0160, 0234, 0311, 0172, 0320, 0342, 0356, 0363, 0037, 0277, 0155, 0351, 0113,
+0210, 0050, 0030, 0031, 0037, 0366, 0041, 0112, 0123, 0022, 0170, 0010, 0045, 0327, 0246, 0067,
+0064, 0071, 0106, 0076, 0340, 0224, 0221, 0054, 0102, 0226, 0220, 0231, 0062, 0307, 0306, 0143,
+0147, 0307, 0201, 0122, 0324, 0237, 0076, 0100, 0341, 0310, 0051, 0224, 0250, 0071, 0335, 0213,
+0106, 0340, 0260, 0235, 0374, 0000, 0305, 0045, 0220, 0104, 0366, 0254, 0006, 0260, 0106, 0075,
+0147, 0123, 0006, 0255, 0173, 0142, 0143, 0345, 0027, 0141, 0245, 0150, 0210, 0326, 0154, 0251,
+0353, 0150, 0127, 0034, 0062, 0150, 0347, 0354, 0303, 0076, 0324, 0030, 0274, 0152, 0166, 0120,
+0300, 0204, 0042, 0315, 0152, 0147, 0365, 0213, 0264, 0145, 0363, 0226, 0036, 0173, 0360, 0131,
+0042, 0144, 0212, 0042, 0327, 0000, 0124, 0233, 0001, 0042, 0077, 0165, 0170, 0275, 0223, 0352,
+0301, 0263, 0114, 0313, 0146, 0204, 0205, 0350, 0221, 0127, 0347, 0123, 0247, 0156, 0275, 0261,
+0132, 0011, 0237, 0072, 0162, 0124, 0075, 0252, 0264, 0100, 0034, 0230, 0375, 0031, 0170, 0113,
+0140, 0245, 0303, 0070, 0132, 0321, 0211, 0041, 0120, 0173, 0110, 0120, 0033, 0254, 0200, 0264,
+0077, 0035, 0041, 0031, 0173, 0103, 0023, 0104, 0071, 0143, 0210, 0202, 0067, 0137, 0325, 0151,
+0215, 0277, 0241, 0103, 0311, 0071, 0370, 0055, 0075, 0173, 0252, 0133, 0130, 0247, 0130, 0037,
+0321, 0317, 0323, 0221, 0365, 0313, 0041, 0274, 0325, 0306, 0026, 0014, 0331, 0241, 0340, 0335,
+0014, 0152, 0247, 0066, 0363, 0105, 0011, 0055, 0123, 0024, 0071, 0272, 0213, 0162, 0312, 0140,
+0251, 0310, 0363, 0053, 0141, 0067, 0343, 0274, 0151, 0154, 0032, 0217, 0107, 0274, 0325, 0117,
+0057, 0044, 0144, 0104, 0010, 0136, 0052, 0335, 0362, 0070, 0345, 0371, 0143, 0013, 0152, 0022,
+0036, 0170, 0131, 0261, 0272, 0121, 0002, 0223, 0070, 0236, 0300, 0032, 0010, 0055, 0302, 0207,
+0054, 0121, 0326, 0057, 0040, 0242, 0063, 0173, 0205, 0221, 0031, 0112, 0031, 0231, 0133, 0132,
+0035, 0342, 0303, 0353, 0332, 0253, 0230, 0013, 0160, 0322, 0150, 0165, 0214, 0254, 0150, 0103,
+0060, 0234, 0254, 0314, 0347, 0244, 0134, 0341, 0264, 0101, 0006, 0213, 0306, 0322, 0102, 0003,
+0006, 0177, 0110, 0244, 0174, 0335, 0120, 0277, 0264, 0130, 0145, 0136, 0020, 0126, 0261, 0201,
+0253, 0164, 0266, 0047, 0361, 0110, 0156, 0275, 0266, 0356, 0256, 0065, 0063, 0354, 0030, 0357,
+0165, 0117, 0026, 0167, 0110, 0214, 0225, 0332, 0011, 0157, 0272, 0316, 0034, 0033, 0354, 0061,
+0357, 0333, 0303, 0334, 0006, 0000, 0253, 0055, 0325, 0352, 0044, 0232, 0072, 0043, 0254, 0255,
+0316, 0073, 0320, 0050, 0377, 0332, 0320, 0033, 0020, 0233, 0213, 0366, 0217, 0060, 0362, 0124,
+0246, 0353, 0205, 0125, 0351, 0245, 0216, 0133, 0206, 0034, 0174, 0157, 0343, 0050, 0177, 0106,
+0154, 0053, 0234, 0234, 0060, 0150, 0332, 0335, 0213, 0121, 0252, 0277, 0144, 0166, 0072, 0270,
+0062, 0372, 0264, 0254, 0006, 0076, 0350, 0203, 0163, 0341, 0125, 0316, 0100, 0137, 0274, 0026,
+0167, 0247, 0237, 0073, 0361, 0227, 0151, 0376, 0062, 0371, 0341, 0163, 0033, 0116, 0375, 0313,
+0310, 0207, 0317, 0175, 0223, 0230, 0233, 0343, 0345, 0004, 0212, 0247, 0252, 0160, 0230, 0036,
+0236, 0001, 0365, 0076, 0140, 0235, 0175, 0275, 0220, 0204, 0256, 0347, 0252, 0356, 0345, 0016,
+0045, 0110, 0040, 0365, 0233, 0324, 0050, 0274, 0267, 0331, 0361, 0245, 0354, 0357, 0262, 0323,
+0270, 0100, 0200, 0116, 0313, 0055, 0005, 0152, 0076, 0326, 0032, 0003, 0112, 0103, 0121, 0311,
+0150, 0133, 0332, 0133, 0047, 0226, 0307, 0215, 0205, 0215, 0161, 0241, 0072, 0271, 0040, 0211,
+0175, 0262, 0302, 0022, 0145, 0207, 0342, 0124, 0044, 0176, 0253, 0322, 0243, 0356, 0132, 0366,
+0251, 0235, 0322, 0377, 0053, 0174, 0056, 0333, 0307, 0060, 0136, 0225, 0135, 0216, 0357, 0173,
+0004, 0071, 0146, 0337, 0205, 0262, 0344, 0243, 0235, 0243, 0305, 0263, 0252, 0347, 0126, 0273,
+0142, 0344, 0102, 0371, 0353, 0376, 0324, 0200, 0231, 0322, 0376, 0174, 0044, 0353, 0227, 0021,
+0356, 0062, 0356, 0142, 0050, 0223, 0210, 0270, 0102, 0311, 0126, 0311, 0241, 0223, 0265, 0030,
+0212, 0330, 0003, 0213, 0050, 0110, 0312, 0214, 0326, 0343, 0270, 0106, 0205, 0003, 0174, 0241,
+0034, 0174, 0006, 0251, 0006, 0364, 0055, 0322, 0007, 0166, 0301, 0017, 0122, 0252, 0171, 0360,
+0054, 0301, 0165, 0376, 0212, 0372, 0067, 0363, 0213, 0121, 0163, 0172, 0007, 0270, 0174, 0231,
+0055, 0210, 0266, 0027, 0234, 0231, 0202, 0326, 0130, 0135, 0370, 0142, 0071, 0300, 0355, 0156,
+0112, 0372, 0226, 0176, 0231, 0341, 0272, 0136, 0025, 0227, 0353, 0041, 0130, 0060, 0105, 0202,
+0121, 0105, 0331, 0063, 0265, 0356, 0337, 0271, 0366, 0327, 0254, 0142, 0026, 0236, 0012, 0224,
+0274, 0371, 0056, 0012, 0002, 0230, 0260, 0137, 0246, 0310, 0065, 0372, 0341, 0356, 0307, 0237,
+0010, 0142, 0225, 0314, 0353, 0260, 0040, 0351, 0171, 0325, 0306, 0113, 0255, 0247, 0345, 0344,
+0035, 0346, 0113, 0231, 0057, 0221, 0141, 0061, 0374, 0103, 0201, 0125, 0144, 0147, 0066, 0227,
+0013, 0050, 0067, 0062, 0114, 0266, 0175, 0243, 0124, 0203, 0274, 0367, 0300, 0325, 0130, 0306,
+0021, 0014, 0277, 0201, 0052, 0226, 0132, 0327, 0000, 0246, 0002, 0105, 0340, 0140, 0003, 0270,
+0272, 0337, 0124, 0367, 0337, 0343, 0177, 0235, 0207, 0356, 0077, 0273, 0243, 0170, 0206, 0362,
+0010, 0000, 0000,
+};
+static const unsigned char embedded_br_autorec_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config.html
+static const unsigned char embedded_config_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0155, 0221, 0101, 0156, 0204, 0060,
+0014, 0105, 0367, 0071, 0205, 0305, 0146, 0132, 0251, 0060, 0373, 0212, 0101, 0102, 0125, 0173,
+0202, 0271, 0200, 0111, 0014, 0104, 0012, 0011, 0212, 0035, 0246, 0163, 0373, 0046, 0100, 0067,
+0125, 0167, 0121, 0276, 0355, 0377, 0276, 0335, 0032, 0273, 0201, 0166, 0310, 0174, 0253, 0146,
+0341, 0332, 0004, 0135, 0013, 0175, 0113, 0325, 0051, 0325, 0256, 0235, 0352, 0235, 0003, 0035,
+0374, 0150, 0247, 0024, 0121, 0154, 0360, 0200, 0336, 0000, 0232, 0305, 0172, 0313, 0162, 0176,
+0205, 0021, 0356, 0333, 0114, 0150, 0050, 0153, 0226, 0113, 0203, 0111, 0132, 0310, 0300, 0146,
+0021, 0144, 0046, 0065, 0044, 0353, 0004, 0254, 0207, 0007, 0015, 0220, 0230, 0142, 0176, 0013,
+0305, 0021, 0065, 0065, 0207, 0321, 0075, 0000, 0152, 0115, 0314, 0245, 0376, 0217, 0245, 0340,
+0000, 0057, 0305, 0327, 0012, 0003, 0247, 0001, 0126, 0364, 0344, 0370, 0025, 0236, 0041, 0201,
+0247, 0354, 0323, 0027, 0240, 0372, 0030, 0320, 0250, 0257, 0020, 0301, 0220, 0240, 0165, 0014,
+0070, 0204, 0044, 0277, 0243, 0363, 0130, 0211, 0301, 0275, 0301, 0352, 0010, 0231, 0200, 0211,
+0166, 0273, 0113, 0277, 0353, 0365, 0307, 0241, 0137, 0262, 0240, 0167, 0347, 0114, 0054, 0163,
+0111, 0064, 0343, 0232, 0171, 0117, 0326, 0117, 0324, 0163, 0341, 0340, 0047, 0013, 0055, 0377,
+0305, 0337, 0341, 0317, 0374, 0005, 0072, 0074, 0366, 0024, 0357, 0107, 0177, 0153, 0227, 0011,
+0070, 0352, 0133, 0225, 0327, 0035, 0211, 0103, 0212, 0331, 0376, 0172, 0364, 0345, 0062, 0156,
+0126, 0077, 0355, 0027, 0270, 0346, 0363, 0164, 0352, 0007, 0221, 0253, 0330, 0144, 0245, 0001,
+0000, 0000,
+};
+static const unsigned char embedded_br_config_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_capmt.html
+static const unsigned char embedded_config_capmt_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0135, 0125, 0115, 0157, 0333, 0070,
+0020, 0275, 0347, 0127, 0014, 0162, 0330, 0044, 0100, 0154, 0347, 0272, 0213, 0304, 0100, 0232,
+0164, 0201, 0002, 0005, 0132, 0264, 0301, 0002, 0173, 0012, 0150, 0162, 0144, 0021, 0241, 0110,
+0225, 0037, 0166, 0375, 0357, 0367, 0015, 0051, 0113, 0306, 0372, 0140, 0133, 0344, 0360, 0361,
+0315, 0233, 0067, 0243, 0107, 0143, 0017, 0244, 0235, 0112, 0351, 0351, 0272, 0317, 0151, 0145,
+0202, 0136, 0145, 0376, 0235, 0257, 0267, 0127, 0127, 0104, 0157, 0207, 0236, 0225, 0141, 0157,
+0050, 0225, 0161, 0014, 0061, 0223, 0016, 0336, 0263, 0316, 0326, 0357, 0051, 0007, 0322, 0052,
+0032, 0234, 0266, 0354, 0163, 0242, 0203, 0125, 0224, 0173, 0306, 0342, 0070, 0144, 0032, 0143,
+0310, 0101, 0007, 0107, 0135, 0210, 0224, 0044, 0324, 0071, 0006, 0116, 0350, 0262, 0126, 0003,
+0031, 0116, 0072, 0252, 0141, 0347, 0200, 0264, 0046, 0334, 0365, 0070, 0156, 0361, 0145, 0207,
+0075, 0245, 0250, 0237, 0256, 0301, 0043, 0162, 0012, 0045, 0152, 0116, 0033, 0134, 0332, 0331,
+0175, 0305, 0135, 0217, 0176, 0137, 0271, 0325, 0370, 0067, 0134, 0227, 0070, 0036, 0070, 0046,
+0122, 0221, 0311, 0331, 0224, 0161, 0311, 0206, 0330, 0130, 0371, 0103, 0326, 0223, 0242, 0175,
+0264, 0246, 0335, 0121, 0034, 0016, 0321, 0243, 0263, 0333, 0267, 0120, 0143, 0260, 0253, 0331,
+0271, 0173, 0062, 0241, 0354, 0034, 0113, 0056, 0372, 0203, 0202, 0047, 0233, 0327, 0364, 0334,
+0145, 0216, 0123, 0004, 0331, 0104, 0272, 0127, 0176, 0017, 0124, 0233, 0001, 0042, 0237, 0243,
+0305, 0106, 0347, 0324, 0076, 0341, 0010, 0123, 0350, 0260, 0205, 0260, 0020, 0075, 0316, 0101,
+0236, 0210, 0140, 0374, 0130, 0157, 0254, 0126, 0302, 0047, 0367, 0052, 0043, 0206, 0172, 0225,
+0150, 0307, 0354, 0047, 0234, 0011, 0170, 0115, 0140, 0245, 0303, 0060, 0040, 0002, 0102, 0046,
+0236, 0066, 0020, 0253, 0300, 0012, 0110, 0113, 0075, 0106, 0250, 0223, 0252, 0334, 0023, 0306,
+0315, 0117, 0165, 0230, 0017, 0334, 0320, 0256, 0344, 0034, 0374, 0232, 0276, 0170, 0012, 0321,
+0064, 0072, 0155, 0023, 0011, 0275, 0364, 0254, 0077, 0166, 0341, 0167, 0313, 0354, 0024, 0012,
+0350, 0273, 0323, 0004, 0324, 0013, 0216, 0104, 0117, 0122, 0150, 0026, 0025, 0241, 0307, 0325,
+0042, 0235, 0062, 0006, 0060, 0236, 0217, 0204, 0312, 0307, 0323, 0375, 0005, 0235, 0233, 0147,
+0354, 0325, 0325, 0205, 0204, 0224, 0111, 0202, 0157, 0171, 0030, 0363, 0351, 0256, 0155, 0137,
+0152, 0270, 0003, 0363, 0310, 0125, 0042, 0150, 0237, 0347, 0252, 0012, 0102, 0213, 0360, 0041,
+0113, 0124, 0145, 0222, 0000, 0240, 0166, 0325, 0115, 0031, 0147, 0326, 0023, 0322, 0277, 0310,
+0103, 0053, 0217, 0320, 0343, 0234, 0052, 0116, 0126, 0113, 0042, 0317, 0044, 0111, 0311, 0003,
+0254, 0147, 0245, 0062, 0007, 0345, 0012, 0247, 0173, 0304, 0262, 0250, 0333, 0363, 0131, 0311,
+0206, 0016, 0372, 0120, 0110, 0171, 0251, 0032, 0373, 0051, 0303, 0377, 0251, 0014, 0104, 0205,
+0146, 0070, 0200, 0105, 0205, 0236, 0025, 0271, 0024, 0313, 0260, 0143, 0354, 0127, 0207, 0104,
+0032, 0002, 0174, 0052, 0061, 0126, 0356, 0116, 0330, 0323, 0265, 0332, 0360, 0256, 0107, 0245,
+0157, 0167, 0247, 0246, 0274, 0164, 0130, 0025, 0037, 0202, 0114, 0304, 0020, 0065, 0334, 0335,
+0127, 0112, 0027, 0172, 0277, 0066, 0370, 0206, 0304, 0146, 0121, 0375, 0231, 0306, 0060, 0122,
+0031, 0057, 0205, 0126, 0351, 0243, 0326, 0133, 0352, 0053, 0115, 0025, 0007, 0171, 0214, 0160,
+0352, 0057, 0150, 0201, 0032, 0323, 0343, 0106, 0232, 0344, 0242, 0277, 0320, 0303, 0145, 0360,
+0151, 0362, 0005, 0026, 0272, 0340, 0134, 0070, 0012, 0277, 0256, 0170, 0144, 0037, 0174, 0372,
+0113, 0016, 0230, 0326, 0134, 0046, 0157, 0077, 0267, 0362, 0324, 0047, 0263, 0375, 0322, 0315,
+0344, 0356, 0347, 0371, 0201, 0254, 0316, 0225, 0027, 0051, 0152, 0237, 0340, 0077, 0070, 0340,
+0250, 0115, 0075, 0126, 0044, 0317, 0310, 0131, 0101, 0027, 0203, 0064, 0316, 0145, 0006, 0134,
+0361, 0013, 0340, 0322, 0022, 0025, 0317, 0330, 0064, 0135, 0101, 0267, 0266, 0073, 0137, 0307,
+0346, 0256, 0302, 0211, 0213, 0120, 0235, 0326, 0233, 0323, 0136, 0053, 0025, 0130, 0277, 0250,
+0301, 0254, 0123, 0320, 0037, 0234, 0351, 0157, 0353, 0340, 0202, 0201, 0247, 0024, 0176, 0266,
+0325, 0156, 0132, 0245, 0143, 0157, 0165, 0057, 0043, 0241, 0244, 0002, 0217, 0235, 0050, 0214,
+0054, 0054, 0245, 0170, 0030, 0156, 0155, 0042, 0256, 0027, 0156, 0347, 0002, 0112, 0321, 0047,
+0355, 0053, 0305, 0352, 0110, 0300, 0244, 0005, 0177, 0246, 0363, 0125, 0146, 0231, 0227, 0241,
+0273, 0350, 0030, 0213, 0367, 0315, 0030, 0150, 0277, 0145, 0250, 0166, 0305, 0271, 0125, 0207,
+0376, 0051, 0342, 0353, 0327, 0177, 0076, 0255, 0136, 0144, 0060, 0127, 0150, 0351, 0010, 0010,
+0353, 0270, 0073, 0117, 0255, 0332, 0204, 0147, 0065, 0177, 0054, 0210, 0237, 0212, 0331, 0163,
+0256, 0107, 0333, 0074, 0223, 0051, 0005, 0206, 0045, 0311, 0314, 0060, 0145, 0030, 0044, 0273,
+0225, 0341, 0203, 0325, 0054, 0115, 0015, 0164, 0233, 0146, 0320, 0342, 0152, 0377, 0312, 0133,
+0240, 0116, 0352, 0167, 0255, 0240, 0346, 0024, 0067, 0004, 0123, 0334, 0214, 0010, 0076, 0060,
+0360, 0312, 0005, 0210, 0043, 0136, 0266, 0101, 0346, 0323, 0342, 0362, 0113, 0021, 0247, 0325,
+0311, 0135, 0347, 0007, 0310, 0363, 0372, 0376, 0375, 0307, 0347, 0257, 0337, 0236, 0137, 0237,
+0066, 0243, 0312, 0375, 0046, 0207, 0315, 0305, 0275, 0002, 0361, 0336, 0040, 0350, 0217, 0063,
+0306, 0146, 0001, 0271, 0144, 0125, 0215, 0043, 0163, 0267, 0370, 0072, 0247, 0053, 0005, 0370,
+0203, 0355, 0001, 0364, 0120, 0253, 0034, 0203, 0133, 0035, 0203, 0350, 0062, 0115, 0342, 0063,
+0312, 0154, 0076, 0111, 0373, 0273, 0274, 0040, 0377, 0174, 0170, 0170, 0230, 0035, 0005, 0114,
+0020, 0230, 0352, 0367, 0054, 0155, 0323, 0232, 0126, 0231, 0301, 0172, 0324, 0067, 0252, 0134,
+0123, 0107, 0203, 0324, 0127, 0121, 0213, 0257, 0323, 0030, 0210, 0311, 0312, 0053, 0311, 0372,
+0126, 0110, 0171, 0135, 0205, 0070, 0167, 0101, 0306, 0053, 0013, 0146, 0022, 0107, 0327, 0131,
+0011, 0177, 0237, 0332, 0060, 0202, 0270, 0045, 0216, 0041, 0161, 0355, 0146, 0111, 0031, 0337,
+0366, 0260, 0275, 0372, 0017, 0137, 0072, 0050, 0350, 0354, 0007, 0000, 0000,
+};
+static const unsigned char embedded_br_config_capmt_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/config_cwc.html
+static const unsigned char embedded_config_cwc_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0135, 0124, 0115, 0157, 0333, 0070,
+0020, 0275, 0347, 0127, 0014, 0162, 0111, 0002, 0270, 0316, 0275, 0110, 0015, 0004, 0111, 0026,
+0055, 0212, 0264, 0005, 0222, 0036, 0366, 0110, 0223, 0043, 0213, 0060, 0105, 0252, 0044, 0145,
+0127, 0377, 0176, 0337, 0220, 0264, 0354, 0115, 0016, 0216, 0310, 0171, 0363, 0070, 0363, 0346,
+0343, 0301, 0330, 0003, 0151, 0247, 0122, 0372, 0162, 0335, 0347, 0364, 0311, 0004, 0375, 0051,
+0363, 0337, 0174, 0275, 0271, 0272, 0242, 0367, 0103, 0317, 0312, 0260, 0067, 0224, 0246, 0161,
+0014, 0061, 0223, 0016, 0336, 0263, 0316, 0326, 0357, 0050, 0007, 0322, 0052, 0302, 0304, 0361,
+0300, 0061, 0121, 0027, 0042, 0045, 0271, 0163, 0216, 0161, 0033, 0272, 0254, 0325, 0100, 0206,
+0223, 0216, 0152, 0330, 0072, 0270, 0254, 0101, 0371, 0060, 0156, 0360, 0143, 0207, 0035, 0245,
+0250, 0277, 0134, 0343, 0271, 0310, 0051, 0114, 0121, 0163, 0272, 0007, 0171, 0147, 0167, 0372,
+0250, 0327, 0243, 0337, 0225, 0000, 0012, 0372, 0275, 0347, 0345, 0021, 0025, 0231, 0234, 0115,
+0031, 0057, 0334, 0023, 0033, 0053, 0037, 0144, 0075, 0051, 0332, 0105, 0153, 0326, 0044, 0076,
+0223, 0203, 0023, 0075, 0070, 0273, 0171, 0017, 0005, 0003, 0253, 0146, 0347, 0126, 0144, 0302,
+0264, 0165, 0214, 0164, 0255, 0336, 0123, 0360, 0144, 0363, 0232, 0036, 0273, 0314, 0261, 0041,
+0310, 0046, 0322, 0275, 0362, 0073, 0260, 0332, 0014, 0022, 0371, 0073, 0132, 0030, 0072, 0247,
+0166, 0011, 0056, 0114, 0241, 0203, 0011, 0260, 0020, 0075, 0374, 0040, 0102, 0004, 0030, 0377,
+0254, 0067, 0126, 0053, 0211, 0047, 0367, 0052, 0003, 0103, 0275, 0112, 0264, 0145, 0366, 0215,
+0247, 0021, 0257, 0011, 0121, 0351, 0060, 0014, 0100, 0344, 0236, 0023, 0067, 0003, 0260, 0012,
+0121, 0201, 0351, 0254, 0372, 0010, 0155, 0222, 0240, 0250, 0161, 0334, 0274, 0251, 0303, 0342,
+0160, 0103, 0333, 0051, 0347, 0340, 0327, 0364, 0315, 0123, 0210, 0246, 0206, 0123, 0215, 0110,
+0350, 0251, 0147, 0275, 0337, 0206, 0277, 0065, 0263, 0071, 0114, 0010, 0337, 0315, 0215, 0250,
+0027, 0036, 0101, 0067, 0051, 0064, 0213, 0212, 0320, 0343, 0352, 0054, 0235, 0062, 0006, 0064,
+0236, 0217, 0304, 0076, 0307, 0171, 0165, 0021, 0316, 0315, 0043, 0154, 0345, 0366, 0034, 0204,
+0224, 0111, 0300, 0267, 0074, 0214, 0171, 0276, 0253, 0346, 0113, 0015, 0267, 0210, 0074, 0162,
+0221, 0010, 0332, 0347, 0245, 0252, 0302, 0120, 0021, 0076, 0144, 0101, 0225, 0110, 0022, 0010,
+0324, 0266, 0264, 0122, 0206, 0317, 0272, 0061, 0375, 0213, 0074, 0264, 0362, 0200, 0036, 0227,
+0124, 0341, 0051, 0154, 0222, 0147, 0222, 0244, 0344, 0200, 0276, 0263, 0122, 0231, 0203, 0162,
+0023, 0247, 0025, 0260, 0054, 0352, 0366, 0174, 0122, 0262, 0262, 0043, 0174, 0050, 0244, 0274,
+0124, 0215, 0175, 0313, 0360, 0203, 0312, 0140, 0124, 0150, 0371, 0003, 0242, 0050, 0324, 0213,
+0042, 0227, 0142, 0031, 0166, 0014, 0173, 0351, 0220, 0110, 0103, 0100, 0237, 0012, 0306, 0312,
+0333, 0011, 0066, 0135, 0252, 0215, 0336, 0365, 0250, 0364, 0355, 0166, 0256, 0312, 0313, 0034,
+0025, 0361, 0041, 0110, 0013, 0014, 0250, 0341, 0156, 0125, 0102, 0272, 0320, 0373, 0271, 0322,
+0127, 0046, 0066, 0147, 0325, 0037, 0151, 0014, 0043, 0115, 0343, 0245, 0320, 0052, 0355, 0113,
+0275, 0245, 0276, 0062, 0122, 0161, 0220, 0143, 0104, 0247, 0376, 0201, 0026, 0250, 0061, 0075,
+0334, 0313, 0220, 0134, 0314, 0227, 0016, 0156, 0032, 0174, 0152, 0175, 0201, 0213, 0056, 0070,
+0027, 0216, 0022, 0137, 0067, 0171, 0144, 0037, 0174, 0372, 0054, 0016, 0246, 0016, 0227, 0311,
+0233, 0227, 0132, 0236, 0162, 0062, 0233, 0157, 0335, 0022, 0334, 0152, 0331, 0022, 0310, 0352,
+0124, 0171, 0221, 0242, 0314, 0011, 0276, 0021, 0003, 0134, 0155, 0352, 0161, 0043, 0171, 0106,
+0316, 0012, 0272, 0030, 0244, 0161, 0052, 0063, 0350, 0046, 0177, 0046, 0074, 0217, 0104, 0341,
+0063, 0066, 0265, 0047, 0350, 0326, 0166, 0247, 0347, 0330, 0334, 0025, 0072, 0351, 0042, 0124,
+0247, 0316, 0146, 0263, 0325, 0122, 0041, 0352, 0257, 0041, 0145, 0257, 0006, 0156, 0141, 0277,
+0325, 0016, 0354, 0333, 0355, 0232, 0236, 0177, 0274, 0221, 0013, 0141, 0077, 0215, 0262, 0014,
+0106, 0216, 0130, 0153, 0103, 0011, 0015, 0311, 0060, 0260, 0363, 0145, 0166, 0052, 0147, 0351,
+0366, 0205, 0375, 0027, 0166, 0344, 0377, 0231, 0337, 0237, 0176, 0221, 0154, 0316, 0023, 0342,
+0067, 0172, 0376, 0342, 0375, 0323, 0121, 0202, 0235, 0022, 0237, 0211, 0260, 0220, 0217, 0230,
+0351, 0006, 0073, 0035, 0077, 0302, 0236, 0137, 0336, 0350, 0073, 0317, 0247, 0032, 0170, 0233,
+0255, 0162, 0044, 0267, 0173, 0236, 0027, 0324, 0357, 0321, 0110, 0357, 0076, 0251, 0205, 0357,
+0237, 0020, 0217, 0262, 0273, 0137, 0174, 0266, 0331, 0361, 0200, 0126, 0245, 0127, 0345, 0325,
+0256, 0175, 0242, 0357, 0224, 0254, 0244, 0333, 0227, 0327, 0327, 0164, 0167, 0232, 0251, 0072,
+0256, 0037, 0151, 0177, 0172, 0376, 0310, 0012, 0247, 0262, 0154, 0250, 0213, 0141, 0050, 0063,
+0041, 0303, 0344, 0031, 0255, 0051, 0313, 0070, 0333, 0341, 0234, 0302, 0023, 0126, 0041, 0336,
+0154, 0024, 0217, 0322, 0165, 0265, 0347, 0225, 0031, 0254, 0307, 0252, 0217, 0052, 0207, 0262,
+0331, 0022, 0227, 0115, 0136, 0361, 0225, 0377, 0140, 0223, 0225, 0215, 0156, 0145, 0237, 0240,
+0136, 0262, 0355, 0103, 0134, 0232, 0050, 0143, 0343, 0043, 0013, 0151, 0210, 0022, 0073, 0332,
+0143, 0256, 0263, 0314, 0064, 0116, 0161, 0014, 0042, 0045, 0206, 0101, 0232, 0032, 0277, 0366,
+0260, 0271, 0372, 0017, 0131, 0306, 0374, 0227, 0020, 0007, 0000, 0000,
+};
+static const unsigned char embedded_br_config_cwc_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/dvr.html
+static const unsigned char embedded_dvr_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0125, 0220, 0315, 0116, 0102, 0101,
+0014, 0205, 0367, 0363, 0024, 0015, 0033, 0064, 0021, 0175, 0001, 0144, 0105, 0174, 0000, 0242,
+0354, 0113, 0247, 0367, 0336, 0046, 0303, 0224, 0114, 0073, 0242, 0157, 0157, 0271, 0040, 0306,
+0335, 0374, 0234, 0163, 0276, 0323, 0256, 0263, 0174, 0002, 0025, 0064, 0173, 0135, 0114, 0156,
+0253, 0254, 0264, 0162, 0376, 0362, 0305, 0046, 0175, 0324, 0314, 0015, 0174, 0142, 0130, 0156,
+0145, 0024, 0307, 0002, 0173, 0311, 0254, 0260, 0143, 0322, 0026, 0177, 0113, 0160, 0074, 0300,
+0267, 0166, 0040, 0254, 0200, 0371, 0050, 0125, 0314, 0303, 0203, 0065, 0103, 0211, 0043, 0230,
+0243, 0167, 0003, 0035, 0222, 0324, 0000, 0111, 0356, 0021, 0322, 0146, 0273, 0324, 0321, 0146,
+0041, 0151, 0035, 0144, 0354, 0215, 0241, 0365, 0302, 0006, 0203, 0136, 0241, 0330, 0135, 0217,
+0350, 0102, 0067, 0003, 0267, 0347, 0264, 0076, 0155, 0322, 0273, 0002, 0022, 0261, 0331, 0254,
+0332, 0356, 0167, 0367, 0026, 0307, 0036, 0310, 0003, 0103, 0321, 0161, 0344, 0014, 0122, 0301,
+0372, 0060, 0010, 0011, 0127, 0277, 0171, 0022, 0065, 0316, 0161, 0025, 0054, 0166, 0215, 0173,
+0013, 0334, 0310, 0225, 0133, 0064, 0373, 0255, 0022, 0124, 0255, 0321, 0372, 0116, 0170, 0260,
+0116, 0023, 0240, 0301, 0171, 0342, 0050, 0172, 0251, 0075, 0351, 0031, 0134, 0143, 0102, 0155,
+0234, 0056, 0272, 0277, 0261, 0236, 0340, 0124, 0030, 0215, 0301, 0230, 0357, 0021, 0306, 0064,
+0247, 0106, 0253, 0313, 0323, 0077, 0124, 0242, 0011, 0117, 0261, 0270, 0307, 0264, 0176, 0211,
+0065, 0155, 0322, 0017, 0232, 0210, 0076, 0222, 0226, 0001, 0000, 0000,
+};
+static const unsigned char embedded_br_dvr_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/epg.html
+static const unsigned char embedded_epg_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0225, 0126, 0301, 0156, 0334, 0066,
+0020, 0275, 0353, 0053, 0006, 0276, 0254, 0003, 0170, 0327, 0100, 0317, 0216, 0201, 0264, 0116,
+0223, 0000, 0115, 0152, 0064, 0133, 0043, 0100, 0341, 0003, 0127, 0244, 0044, 0326, 0022, 0251,
+0222, 0324, 0156, 0366, 0357, 0373, 0146, 0110, 0151, 0167, 0201, 0030, 0105, 0017, 0011, 0340,
+0025, 0071, 0363, 0346, 0315, 0233, 0067, 0274, 0323, 0166, 0117, 0165, 0257, 0142, 0174, 0173,
+0325, 0245, 0270, 0326, 0276, 0136, 0047, 0363, 0075, 0135, 0335, 0127, 0333, 0175, 0147, 0224,
+0066, 0116, 0123, 0247, 0042, 0051, 0332, 0115, 0266, 0117, 0144, 0035, 0275, 0357, 0115, 0235,
+0202, 0167, 0266, 0246, 0307, 0340, 0333, 0240, 0006, 0372, 0060, 0131, 0155, 0066, 0264, 0355,
+0014, 0275, 0177, 0374, 0100, 0026, 0347, 0035, 0037, 0035, 0314, 0340, 0303, 0261, 0322, 0052,
+0251, 0235, 0212, 0206, 0106, 0077, 0116, 0275, 0112, 0106, 0323, 0301, 0246, 0216, 0124, 0337,
+0123, 0302, 0035, 0353, 0032, 0037, 0006, 0225, 0254, 0167, 0244, 0166, 0176, 0112, 0144, 0366,
+0306, 0245, 0110, 0301, 0324, 0306, 0356, 0161, 0274, 0011, 0176, 0250, 0370, 0350, 0303, 0323,
+0317, 0344, 0114, 0072, 0370, 0360, 0022, 0311, 0007, 0371, 0100, 0337, 0076, 0377, 0266, 0175,
+0332, 0124, 0167, 0043, 0120, 0027, 0010, 0110, 0110, 0332, 0306, 0261, 0127, 0107, 0006, 0337,
+0000, 0273, 0011, 0152, 0327, 0003, 0203, 0152, 0021, 0260, 0015, 0126, 0123, 0355, 0135, 0122,
+0326, 0131, 0327, 0056, 0120, 0162, 0342, 0052, 0372, 0300, 0050, 0031, 0264, 0046, 0240, 0212,
+0111, 0205, 0104, 0311, 0016, 0006, 0151, 0354, 0320, 0122, 0014, 0365, 0333, 0053, 0260, 0025,
+0114, 0364, 0123, 0250, 0115, 0274, 0065, 0143, 0273, 0031, 0135, 0013, 0346, 0030, 0307, 0235,
+0356, 0357, 0053, 0272, 0323, 0351, 0376, 0127, 0111, 0315, 0071, 0256, 0201, 0067, 0032, 0025,
+0352, 0016, 0177, 0275, 0341, 0257, 0032, 0147, 0076, 0071, 0111, 0054, 0240, 0375, 0210, 0177,
+0276, 0107, 0336, 0100, 0107, 0077, 0121, 0015, 0032, 0125, 0215, 0350, 0221, 0032, 0244, 0001,
+0121, 0043, 0310, 0151, 0254, 0351, 0165, 0334, 0124, 0314, 0067, 0110, 0125, 0301, 0320, 0304,
+0070, 0223, 0057, 0165, 0336, 0346, 0054, 0270, 0023, 0112, 0101, 0271, 0067, 0314, 0062, 0037,
+0215, 0144, 0207, 0261, 0267, 0265, 0115, 0364, 0356, 0313, 0103, 0105, 0073, 0020, 0152, 0214,
+0053, 0275, 0070, 0113, 0201, 0133, 0350, 0345, 0140, 0224, 0213, 0370, 0250, 0222, 0320, 0224,
+0163, 0340, 0347, 0051, 0046, 0102, 0327, 0352, 0256, 0222, 0114, 0300, 0052, 0311, 0030, 0307,
+0316, 0314, 0354, 0033, 0275, 0341, 0112, 0231, 0015, 0241, 0343, 0257, 0257, 0031, 0133, 0262,
+0251, 0067, 0233, 0315, 0346, 0131, 0176, 0147, 0042, 0050, 0063, 0305, 0164, 0057, 0235, 0050,
+0307, 0062, 0372, 0374, 0131, 0360, 0327, 0254, 0046, 0353, 0242, 0161, 0321, 0046, 0050, 0004,
+0112, 0151, 0241, 0254, 0200, 0050, 0346, 0373, 0210, 0246, 0104, 0150, 0151, 0103, 0237, 0032,
+0241, 0121, 0173, 0267, 0112, 0364, 0342, 0374, 0201, 0016, 0122, 0305, 0174, 0374, 0354, 0060,
+0213, 0066, 0055, 0325, 0042, 0216, 0324, 0073, 0067, 0041, 0035, 0107, 0103, 0177, 0163, 0301,
+0043, 0204, 0000, 0345, 0065, 0202, 0121, 0320, 0241, 0160, 0075, 0203, 0023, 0354, 0212, 0051,
+0360, 0050, 0233, 0256, 0277, 0170, 0250, 0225, 0365, 0313, 0235, 0370, 0256, 0352, 0102, 0030,
+0367, 0177, 0063, 0023, 0362, 0273, 0353, 0217, 0250, 0245, 0356, 0047, 0155, 0250, 0356, 0224,
+0163, 0246, 0277, 0044, 0106, 0116, 0024, 0076, 0347, 0321, 0020, 0341, 0063, 0206, 0150, 0170,
+0036, 0221, 0143, 0276, 0372, 0303, 0270, 0111, 0265, 0377, 0043, 0146, 0011, 0025, 0101, 0227,
+0105, 0257, 0130, 0141, 0045, 0220, 0346, 0261, 0276, 0110, 0313, 0221, 0021, 0157, 0253, 0332,
+0170, 0222, 0042, 0327, 0333, 0006, 0077, 0215, 0254, 0373, 0045, 0032, 0023, 0005, 0206, 0061,
+0166, 0215, 0155, 0247, 0300, 0003, 0166, 0224, 0140, 0112, 0017, 0030, 0303, 0230, 0202, 0112,
+0076, 0274, 0102, 0014, 0146, 0025, 0040, 0057, 0213, 0370, 0354, 0321, 0221, 0013, 0113, 0020,
+0057, 0263, 0215, 0204, 0265, 0263, 0372, 0021, 0004, 0232, 0054, 0021, 0062, 0256, 0131, 0333,
+0042, 0164, 0104, 0202, 0260, 0375, 0041, 0112, 0277, 0227, 0061, 0072, 0215, 0377, 0174, 0225,
+0145, 0300, 0162, 0276, 0025, 0075, 0157, 0273, 0051, 0336, 0220, 0315, 0032, 0363, 0014, 0366,
+0340, 0247, 0136, 0123, 0157, 0137, 0214, 0014, 0101, 0100, 0110, 0003, 0220, 0173, 0153, 0012,
+0271, 0107, 0236, 0342, 0217, 0017, 0353, 0205, 0022, 0374, 0120, 0225, 0153, 0231, 0121, 0132,
+0175, 0174, 0130, 0030, 0133, 0315, 0154, 0377, 0260, 0231, 0153, 0001, 0177, 0043, 0264, 0346,
+0313, 0025, 0255, 0044, 0033, 0335, 0322, 0003, 0174, 0131, 0275, 0162, 0377, 0214, 0313, 0034,
+0203, 0153, 0202, 0151, 0321, 0027, 0237, 0154, 0155, 0116, 0322, 0317, 0203, 0323, 0251, 0275,
+0324, 0043, 0243, 0202, 0341, 0131, 0345, 0021, 0136, 0141, 0045, 0244, 0344, 0335, 0215, 0144,
+0020, 0103, 0265, 0303, 0140, 0264, 0205, 0301, 0367, 0307, 0212, 0246, 0021, 0276, 0317, 0136,
+0223, 0000, 0256, 0041, 0225, 0331, 0345, 0322, 0132, 0043, 0127, 0212, 0221, 0314, 0311, 0313,
+0260, 0136, 0162, 0130, 0367, 0310, 0165, 0156, 0073, 0067, 0145, 0014, 0005, 0213, 0224, 0366,
+0007, 0114, 0060, 0075, 0027, 0060, 0233, 0052, 0273, 0356, 0243, 0152, 0041, 0275, 0352, 0314,
+0144, 0145, 0043, 0301, 0307, 0373, 0076, 0057, 0032, 0331, 0100, 0203, 0162, 0107, 0272, 0356,
+0046, 0247, 0241, 0106, 0036, 0353, 0067, 0227, 0152, 0155, 0046, 0144, 0146, 0153, 0156, 0114,
+0331, 0102, 0004, 0273, 0364, 0270, 0311, 0252, 0343, 0023, 0262, 0173, 0030, 0010, 0244, 0177,
+0260, 0070, 0015, 0353, 0003, 0271, 0305, 0042, 0374, 0024, 0161, 0110, 0376, 0130, 0244, 0050,
+0250, 0347, 0225, 0230, 0135, 0074, 0030, 0014, 0214, 0131, 0366, 0300, 0062, 0226, 0160, 0151,
+0057, 0373, 0153, 0224, 0162, 0144, 0057, 0260, 0273, 0340, 0034, 0100, 0044, 0240, 0051, 0106,
+0304, 0354, 0043, 0324, 0237, 0354, 0212, 0351, 0114, 0173, 0073, 0125, 0277, 0034, 0124, 0320,
+0245, 0032, 0037, 0362, 0037, 0166, 0331, 0071, 0360, 0110, 0166, 0365, 0350, 0117, 0333, 0022,
+0137, 0052, 0204, 0000, 0123, 0244, 0006, 0077, 0101, 0366, 0047, 0364, 0342, 0136, 0247, 0271,
+0255, 0247, 0020, 0170, 0056, 0376, 0231, 0114, 0070, 0316, 0324, 0277, 0027, 0343, 0326, 0006,
+0253, 0265, 0260, 0210, 0065, 0356, 0203, 0346, 0176, 0314, 0355, 0310, 0255, 0256, 0261, 0203,
+0136, 0170, 0276, 0024, 0105, 0174, 0355, 0213, 0351, 0337, 0160, 0301, 0170, 0051, 0214, 0231,
+0320, 0231, 0215, 0034, 0121, 0034, 0150, 0171, 0056, 0124, 0345, 0275, 0260, 0054, 0214, 0123,
+0075, 0145, 0242, 0371, 0013, 0054, 0051, 0060, 0051, 0221, 0261, 0117, 0275, 0071, 0333, 0057,
+0154, 0124, 0147, 0360, 0120, 0227, 0200, 0142, 0262, 0313, 0036, 0202, 0276, 0370, 0063, 0024,
+0047, 0157, 0235, 0223, 0320, 0262, 0152, 0137, 0177, 0015, 0374, 0124, 0236, 0003, 0371, 0334,
+0226, 0265, 0354, 0143, 0316, 0055, 0325, 0025, 0045, 0347, 0137, 0321, 0065, 0021, 0244, 0144,
+0374, 0366, 0214, 0077, 0234, 0306, 0272, 0132, 0162, 0155, 0347, 0133, 0154, 0240, 0316, 0143,
+0217, 0170, 0315, 0015, 0002, 0273, 0363, 0216, 0362, 0043, 0126, 0270, 0212, 0131, 0323, 0077,
+0042, 0053, 0007, 0300, 0156, 0053, 0243, 0170, 0120, 0340, 0253, 0052, 0135, 0173, 0067, 0301,
+0172, 0147, 0042, 0342, 0334, 0250, 0257, 0235, 0114, 0243, 0234, 0266, 0261, 0143, 0022, 0363,
+0041, 0031, 0311, 0163, 0121, 0310, 0043, 0212, 0342, 0150, 0152, 0333, 0340, 0145, 0230, 0025,
+0101, 0327, 0231, 0274, 0052, 0033, 0137, 0243, 0366, 0076, 0330, 0144, 0150, 0373, 0264, 0216,
+0235, 0077, 0334, 0220, 0111, 0365, 0233, 0245, 0200, 0323, 0114, 0257, 0176, 0011, 0006, 0336,
+0101, 0005, 0324, 0354, 0064, 0325, 0054, 0334, 0371, 0241, 0204, 0171, 0230, 0373, 0360, 0156,
+0221, 0014, 0130, 0134, 0304, 0267, 0210, 0043, 0371, 0365, 0316, 0254, 0153, 0011, 0013, 0360,
+0347, 0305, 0122, 0140, 0111, 0360, 0232, 0106, 0162, 0317, 0257, 0241, 0274, 0241, 0302, 0300,
+0102, 0077, 0115, 0246, 0034, 0113, 0352, 0005, 0226, 0146, 0232, 0006, 0156, 0373, 0037, 0022,
+0050, 0111, 0004, 0326, 0245, 0024, 0170, 0343, 0135, 0320, 0055, 0345, 0363, 0303, 0070, 0110,
+0166, 0261, 0110, 0175, 0253, 0341, 0351, 0051, 0157, 0134, 0030, 0024, 0113, 0230, 0047, 0163,
+0365, 0140, 0133, 0313, 0303, 0371, 0204, 0067, 0267, 0247, 0114, 0260, 0011, 0253, 0065, 0157,
+0005, 0161, 0000, 0261, 0157, 0370, 0060, 0062, 0314, 0333, 0051, 0301, 0112, 0174, 0120, 0341,
+0050, 0115, 0347, 0361, 0346, 0261, 0222, 0367, 0060, 0077, 0061, 0057, 0350, 0300, 0255, 0001,
+0125, 0142, 0051, 0263, 0076, 0007, 0156, 0261, 0064, 0012, 0057, 0137, 0331, 0173, 0370, 0337,
+0356, 0357, 0253, 0177, 0001, 0315, 0100, 0257, 0021, 0073, 0014, 0000, 0000,
+};
+static const unsigned char embedded_br_epg_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+// docs/html/dvr_autorec.html
+static const unsigned char embedded_dvr_autorec_html[]={
+0037, 0213, 0010, 0000, 0217, 0356, 0362, 0117, 0002, 0003, 0155, 0313, 0061, 0012, 0200, 0060,
+0014, 0005, 0320, 0075, 0247, 0050, 0335, 0253, 0027, 0250, 0005, 0217, 0042, 0151, 0320, 0017,
+0332, 0100, 0023, 0305, 0343, 0353, 0340, 0350, 0376, 0136, 0256, 0270, 0002, 0357, 0213, 0331,
+0024, 0067, 0267, 0124, 0225, 0223, 0011, 0073, 0264, 0305, 0062, 0237, 0256, 0307, 0342, 0340,
+0320, 0205, 0265, 0127, 0264, 0325, 0362, 0370, 0216, 0102, 0371, 0347, 0271, 0334, 0036, 0013,
+0301, 0102, 0003, 0300, 0062, 0020, 0175, 0372, 0001, 0055, 0355, 0263, 0052, 0146, 0000, 0000,
+0000,
+};
+static const unsigned char embedded_br_dvr_autorec_html[]={
+0074, 0144, 0151, 0166, 0040, 0143, 0154, 0141, 0163, 0163,
+};
+#include <filebundle.h>
+static const struct filebundle_entry filebundle_entries[] = {
+{"faq.html", embedded_faq_html, sizeof(embedded_faq_html),827, "0e79bdc79aea8698", 1341320847, embedded_br_faq_html, sizeof(embedded_br_faq_html)},
+{"config_dvb.html", embedded_config_dvb_html, sizeof(embedded_config_dvb_html),5821, "b90328096079da5c", 1341320847, embedded_br_config_dvb_html, sizeof(embedded_br_config_dvb_html)},
+{"overview.html", embedded_overview_html, sizeof(embedded_overview_html),496, "f91010d7234259ef", 1341320847, embedded_br_overview_html, sizeof(embedded_br_overview_html)},
+{"dvrlog.html", embedded_dvrlog_html, sizeof(embedded_dvrlog_html),740, "da85714824658d24", 1341320847, embedded_br_dvrlog_html, sizeof(embedded_br_dvrlog_html)},
+{"features.html", embedded_features_html, sizeof(embedded_features_html),2752, "2ba87acd569b6047", 1341320847, embedded_br_features_html, sizeof(embedded_br_features_html)},
+{"config_dvr.html", embedded_config_dvr_html, sizeof(embedded_config_dvr_html),3793, "b975a87fd83ea345", 1341320847, embedded_br_config_dvr_html, sizeof(embedded_br_config_dvr_html)},
+{"config_xmltv.html", embedded_config_xmltv_html, sizeof(embedded_config_xmltv_html),1040, "f0406751794b068d", 1341320847, embedded_br_config_xmltv_html, sizeof(embedded_br_config_xmltv_html)},
+{"config_access.html", embedded_config_access_html, sizeof(embedded_config_access_html),3049, "8d62d02a7ab9f93d", 1341320847, embedded_br_config_access_html, sizeof(embedded_br_config_access_html)},
+{"install.html", embedded_install_html, sizeof(embedded_install_html),2860, "068231ea7d168461", 1341320847, embedded_br_install_html, sizeof(embedded_br_install_html)},
+{"sysreq.html", embedded_sysreq_html, sizeof(embedded_sysreq_html),611, "ab3b060e395a957e", 1341320847, embedded_br_sysreq_html, sizeof(embedded_br_sysreq_html)},
+{"config_tags.html", embedded_config_tags_html, sizeof(embedded_config_tags_html),2312, "dd5d8be445b0d099", 1341320847, embedded_br_config_tags_html, sizeof(embedded_br_config_tags_html)},
+{"config_channels.html", embedded_config_channels_html, sizeof(embedded_config_channels_html),2969, "a4caa434c4b6bb40", 1341320847, embedded_br_config_channels_html, sizeof(embedded_br_config_channels_html)},
+{"autorec.html", embedded_autorec_html, sizeof(embedded_autorec_html),2290, "f5864352c0f4732d", 1341320847, embedded_br_autorec_html, sizeof(embedded_br_autorec_html)},
+{"config.html", embedded_config_html, sizeof(embedded_config_html),421, "0f34d3d554223889", 1341320847, embedded_br_config_html, sizeof(embedded_br_config_html)},
+{"config_capmt.html", embedded_config_capmt_html, sizeof(embedded_config_capmt_html),2028, "593590ee2e6698a7", 1341320847, embedded_br_config_capmt_html, sizeof(embedded_br_config_capmt_html)},
+{"config_cwc.html", embedded_config_cwc_html, sizeof(embedded_config_cwc_html),1808, "ceba79cf5e3bf5fe", 1341320847, embedded_br_config_cwc_html, sizeof(embedded_br_config_cwc_html)},
+{"dvr.html", embedded_dvr_html, sizeof(embedded_dvr_html),406, "b999a7990c8f58cf", 1341320847, embedded_br_dvr_html, sizeof(embedded_br_dvr_html)},
+{"epg.html", embedded_epg_html, sizeof(embedded_epg_html),3131, "899fb0f506993d2e", 1341320847, embedded_br_epg_html, sizeof(embedded_br_epg_html)},
+{"dvr_autorec.html", embedded_dvr_autorec_html, sizeof(embedded_dvr_autorec_html),102, "5eb70a5390ad6504", 1341320847, embedded_br_dvr_autorec_html, sizeof(embedded_br_dvr_autorec_html)},
+{(void *)0, 0, 0, 0}};
+
+static struct filebundle fb = {
+  .entries = &filebundle_entries[0],
+  .prefix = "docs/html"
+};
+
+static void  __attribute__((constructor)) filebundle_init(void)
+{
+  extern struct filebundle *filebundles;
+
+  fb.next = filebundles;
+  filebundles = &fb;
+}
+
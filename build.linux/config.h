@@ -0,0 +1,19 @@
+/* Automatically generated by configure, do not edit */
+#define TVHEADEND_DATADIR "/usr/local/share/tvheadend"
+#define CONFIG_CWC 1
+#define ENABLE_CWC 1
+#define ENABLE_AVAHI 0
+#define CONFIG_MMX 1
+#define ENABLE_MMX 1
+#define CONFIG_SSE2 1
+#define ENABLE_SSE2 1
+#define CONFIG_AVX2 1
+#define ENABLE_AVX2 1
+#define CONFIG_AVX512 1
+#define ENABLE_AVX512 1
+#define CONFIG_LINUXDVB 1
+#define ENABLE_LINUXDVB 1
+#define CONFIG_V4L 1
+#define ENABLE_V4L 1
+#define CONFIG_EXECINFO 1
+#define ENABLE_EXECINFO 1
@@ -0,0 +1,22 @@
+# Automatically generated by configure, do not edit
+TOPDIR=/root/repo
+
+LDFLAGS_cfg +=  -lssl -lcrypto
+CFLAGS_cfg += 
+ARCH=x86_64
+LDFLAGS_cfg += -lpthread
+prefix=/usr/local
+bindir=${DESTDIR}${prefix}/bin
+mandir=${DESTDIR}${prefix}/share/man
+datadir=${DESTDIR}${prefix}/share/tvheadend
+LDFLAGS_cfg += -lpthread -lrt -ldl
+OSENV=posix
+LDFLAGS_cfg += -lm
+CONFIG_CWC=yes
+CONFIG_MMX=yes
+CONFIG_SSE2=yes
+CONFIG_AVX2=yes
+CONFIG_AVX512=yes
+CONFIG_LINUXDVB=yes
+CONFIG_V4L=yes
+CONFIG_EXECINFO=yes
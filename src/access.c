@@ -132,6 +132,21 @@ access_ticket_delete(const char *id)
   return 0;
 }
 
+/**
+ * Push the expiry of a ticket that is still in use
+ */
+int
+access_ticket_refresh(const char *id)
+{
+  access_ticket_t *at;
+
+  if((at = access_ticket_find(id)) == NULL)
+    return -1;
+
+  gtimer_arm(&at->at_timer, access_ticket_timout, at, 60*5);
+  return 0;
+}
+
 /**
  *
  */
@@ -140,10 +155,17 @@ access_ticket_verify(const char *id, const char *resource)
 {
   access_ticket_t *at;
 
+  size_t l;
+
   if((at = access_ticket_find(id)) == NULL)
     return -1;
 
-  if(strcmp(at->at_resource, resource))
+  /* A ticket for a directory is valid for everything below it */
+  l = strlen(at->at_resource);
+  if(l > 0 && at->at_resource[l - 1] == '/') {
+    if(strncmp(at->at_resource, resource, l) || strstr(resource, ".."))
+      return -1;
+  } else if(strcmp(at->at_resource, resource))
     return -1;
 
   return 0;
@@ -68,11 +68,14 @@ typedef struct access_ticket {
 const char* access_ticket_create(const char *resource);
 
 /**
- * Verifies that a given ticket id matches a resource
+ * Verifies that a given ticket id matches a resource. A resource
+ * ending with '/' matches everything below it
  */
 int access_ticket_verify(const char *id, const char *resource);
 
 int access_ticket_delete(const char *ticket_id);
+
+int access_ticket_refresh(const char *ticket_id);
 /**
  * Verifies that the given user in combination with the source ip
  * complies with the requested mask
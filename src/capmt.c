@@ -39,7 +39,7 @@
 #include "tcp.h"
 #include "psi.h"
 #include "tsdemux.h"
-#include "ffdecsa/FFdecsa.h"
+#include "csa.h"
 #include "capmt.h"
 #include "notify.h"
 #include "subscriptions.h"
@@ -132,7 +132,7 @@ typedef struct capmt_service {
   struct capmt_caid_ecm_list ct_caid_ecm;
 
   /**
-   * Status of the key(s) in ct_keys
+   * Status of the key(s) in ct_csa
    */
   enum {
     CT_UNKNOWN,
@@ -140,13 +140,8 @@ typedef struct capmt_service {
     CT_FORBIDDEN
   } ct_keystate;
 
-  /* buffer for keystruct */
-  void    *ct_keys;
-
   /* CSA */
-  int      ct_cluster_size;
-  uint8_t *ct_tsbcluster;
-  int      ct_fill;
+  csa_t   *ct_csa;
 
   /* current sequence number */
   uint16_t ct_seq;
@@ -257,8 +252,7 @@ capmt_service_destroy(th_descrambler_t *td)
 
   LIST_REMOVE(ct, ct_link);
 
-  free_key_struct(ct->ct_keys);
-  free(ct->ct_tsbcluster);
+  csa_destroy(ct->ct_csa);
   free(ct);
 }
 
@@ -307,10 +301,9 @@ handle_ca0(capmt_t* capmt) {
       if(seq != ct->ct_seq)
         continue;
 
-      if (memcmp(even, invalid, 8))
-        set_even_control_word(ct->ct_keys, even);
-      if (memcmp(odd, invalid, 8))
-        set_odd_control_word(ct->ct_keys, odd);
+      csa_set_control_words(ct->ct_csa,
+                            memcmp(even, invalid, 8) ? even : NULL,
+                            memcmp(odd,  invalid, 8) ? odd  : NULL);
 
       if(ct->ct_keystate != CT_RESOLVED)
         tvhlog(LOG_INFO, "capmt", "Obtained key for service \"%s\"",t->s_svcname);
@@ -555,12 +548,9 @@ capmt_table_input(struct th_descrambler *td, struct service *t,
  */
 static int
 capmt_descramble(th_descrambler_t *td, service_t *t, struct elementary_stream *st,
-     const uint8_t *tsb)
+     const uint8_t *tsb, tsbuf_t *tb)
 {
   capmt_service_t *ct = (capmt_service_t *)td;
-  int r, i;
-  unsigned char *vec[3];
-  uint8_t *t0;
 
   if(ct->ct_keystate == CT_FORBIDDEN)
     return 1;
@@ -568,29 +558,19 @@ capmt_descramble(th_descrambler_t *td, service_t *t, struct elementary_stream *s
   if(ct->ct_keystate != CT_RESOLVED)
     return -1;
 
-  memcpy(ct->ct_tsbcluster + ct->ct_fill * 188, tsb, 188);
-  ct->ct_fill++;
-
-  if(ct->ct_fill != ct->ct_cluster_size)
-    return 0;
-
-  ct->ct_fill = 0;
+  csa_descramble(ct->ct_csa, tsb, tb);
+  return 0;
+}
 
-  vec[0] = ct->ct_tsbcluster;
-  vec[1] = ct->ct_tsbcluster + ct->ct_cluster_size * 188;
-  vec[2] = NULL;
+/**
+ *
+ */
+static void
+capmt_flush(th_descrambler_t *td)
+{
+  capmt_service_t *ct = (capmt_service_t *)td;
 
-  while(1) {
-    t0 = vec[0];
-    r = decrypt_packets(ct->ct_keys, vec);
-    if(r == 0)
-      break;
-    for(i = 0; i < r; i++) {
-      ts_recv_packet2(t, t0);
-      t0 += 188;
-    }
-  }
-  return 0;
+  csa_flush(ct->ct_csa);
 }
 
 /**
@@ -618,8 +598,7 @@ capmt_service_start(service_t *t)
 
     /* create new capmt service */
     ct                  = calloc(1, sizeof(capmt_service_t));
-    ct->ct_cluster_size = get_suggested_cluster_size();
-    ct->ct_tsbcluster   = malloc(ct->ct_cluster_size * 188);
+    ct->ct_csa          = csa_create(t);
     ct->ct_seq          = capmt->capmt_seq++;
 
     TAILQ_FOREACH(st, &t->s_components, es_link) {
@@ -640,7 +619,6 @@ capmt_service_start(service_t *t)
       ct->ct_caid_last = -1;
     }
 
-    ct->ct_keys       = get_key_struct();
     ct->ct_capmt      = capmt;
     ct->ct_service  = t;
 
@@ -648,6 +626,7 @@ capmt_service_start(service_t *t)
     td->td_stop       = capmt_service_destroy;
     td->td_table      = capmt_table_input;
     td->td_descramble = capmt_descramble;
+    td->td_flush      = capmt_flush;
     LIST_INSERT_HEAD(&t->s_descramblers, td, td_service_link);
 
     LIST_INSERT_HEAD(&capmt->capmt_services, ct, ct_link);
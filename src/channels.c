@@ -366,6 +366,7 @@ channel_rename(channel_t *ch, const char *newname)
 
   channel_save(ch);
   htsp_channel_update(ch);
+  epg_snapshot_invalidate(ch);
   return 0;
 }
 
@@ -457,6 +458,7 @@ channel_set_icon(channel_t *ch, const char *icon)
   ch->ch_icon = strdup(icon);
   channel_save(ch);
   htsp_channel_update(ch);
+  epg_snapshot_invalidate(ch);
 }
 
 /**
@@ -623,6 +625,7 @@ channel_tag_map(channel_t *ch, channel_tag_t *ct, int check)
   LIST_INSERT_HEAD(&ct->ct_ctms, ctm, ctm_tag_link);
 
   ctm->ctm_mark = 0;
+  epg_snapshot_invalidate(ch);
 
   if(ct->ct_enabled && !ct->ct_internal) {
     htsp_tag_update(ct);
@@ -644,6 +647,7 @@ channel_tag_mapping_destroy(channel_tag_mapping_t *ctm, int flags)
   LIST_REMOVE(ctm, ctm_channel_link);
   LIST_REMOVE(ctm, ctm_tag_link);
   free(ctm);
+  epg_snapshot_invalidate(ch);
 
   if(ct->ct_enabled && !ct->ct_internal) {
     if(flags & CTM_DESTROY_UPDATE_TAG)
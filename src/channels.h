@@ -49,6 +49,7 @@ typedef struct channel {
 
   gtimer_t ch_epg_timer_head;
   gtimer_t ch_epg_timer_current;
+  struct epg_snap_channel *ch_epg_snap; /* Published read snapshot */
   int ch_dvr_extra_time_pre;
   int ch_dvr_extra_time_post;
   int ch_number;  // User configurable number
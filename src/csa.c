@@ -0,0 +1,728 @@
+/*
+ *  tvheadend, CSA descrambling workers
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tvheadend.h"
+#include "service.h"
+#include "tsdemux.h"
+#include "csa.h"
+#include "ffdecsa/FFdecsa.h"
+
+#define CSA_MAX_WORKERS 16
+#define CSA_MAX_QUEUED  16  /* Max clusters queued per descrambler */
+#define CSA_MAX_DELAY   100000 /* Max time (us) a cluster waits to fill up */
+
+TAILQ_HEAD(csa_job_queue, csa_job);
+TAILQ_HEAD(csa_queue, csa);
+
+/**
+ * A full cluster of scrambled packets
+ *
+ * Packets are decrypted in place. Where possible they point straight
+ * into the input buffers (which we hold a reference to), otherwise
+ * they are copied into cj_data.
+ */
+typedef struct csa_job {
+  TAILQ_ENTRY(csa_job) cj_link;
+  int cj_fill;
+  int cj_nbufs;
+  int cj_copied;             /* Packets in cj_data */
+  int cj_cw_update;          /* 0x1 = even, 0x2 = odd */
+  int cj_drain;              /* Decrypt all, hold nothing back */
+  int64_t cj_start;          /* When the first packet was added */
+  uint8_t cj_cw[16];
+  uint8_t **cj_pkts;         /* Packets, in order */
+  tsbuf_t **cj_bufs;         /* Input buffers referenced by cj_pkts */
+  uint8_t *cj_data;
+} csa_job_t;
+
+
+/**
+ *
+ */
+struct csa {
+  service_t *csa_service;
+
+  /**
+   * Protected by s_stream_mutex
+   */
+  csa_job_t *csa_fill;           /* Cluster currently being filled */
+  struct csa_job_queue csa_ready;/* Full, waiting for csa_ready_tb */
+  tsbuf_t *csa_ready_tb;
+
+  /**
+   * Fields below are protected by csa_mutex
+   */
+  TAILQ_ENTRY(csa) csa_link;     /* On csa_runq when !busy && queued */
+  struct csa_job_queue csa_jobs;
+  struct csa_job_queue csa_spare;
+  int csa_queued;
+  int csa_busy;
+  int csa_dead;
+  int64_t csa_held;              /* Packets held back since, 0 if none */
+
+  int csa_cw_update;
+  uint8_t csa_cw[16];
+
+  /**
+   * Decryption state. Only touched by whoever processes the current
+   * cluster (a worker with csa_busy set, or the input thread when
+   * running without workers)
+   */
+  void *csa_keys;
+  struct csa_job_queue csa_carry;/* Clusters with packets left over, */
+  int csa_carry_fill;            /* the last csa_carry_fill of these */
+  uint8_t **csa_pkts;            /* Packets in current batch, in order */
+  uint8_t **csa_vec;             /* Ranges passed to decrypt_packets() */
+  int csa_npkts;
+  int csa_nleft;
+};
+
+
+/**
+ *
+ */
+typedef struct csa_worker {
+  pthread_t cw_tid;
+  int cw_index;
+  avgstat_t cw_rate;
+  uint64_t cw_packets;
+  uint64_t cw_clusters;
+  int64_t cw_busy;               /* usec spent decrypting */
+} csa_worker_t;
+
+
+static pthread_mutex_t csa_mutex;
+static pthread_cond_t csa_cond;
+static struct csa_queue csa_runq;
+static csa_worker_t *csa_workers;
+static csa_worker_t csa_inline;
+static int csa_nworkers;
+static int csa_cluster_size;
+static int csa_parallelism;
+static int csa_queued;
+static int csa_queued_peak;
+static int csa_overflows;
+static uint64_t csa_copied;
+static uint64_t csa_zerocopy;
+static loglimiter_t csa_overflow_loglimit;
+
+
+/**
+ *
+ */
+static csa_job_t *
+csa_job_alloc(csa_t *csa)
+{
+  csa_job_t *cj;
+
+  pthread_mutex_lock(&csa_mutex);
+  if((cj = TAILQ_FIRST(&csa->csa_spare)) != NULL)
+    TAILQ_REMOVE(&csa->csa_spare, cj, cj_link);
+  pthread_mutex_unlock(&csa_mutex);
+
+  if(cj == NULL) {
+    cj = malloc(sizeof(csa_job_t) +
+		csa_cluster_size * (sizeof(uint8_t *) + sizeof(tsbuf_t *)) +
+		csa_cluster_size * 188);
+    cj->cj_pkts = (uint8_t **)(cj + 1);
+    cj->cj_bufs = (tsbuf_t **)(cj->cj_pkts + csa_cluster_size);
+    cj->cj_data = (uint8_t *)(cj->cj_bufs + csa_cluster_size);
+  }
+  cj->cj_fill = 0;
+  cj->cj_nbufs = 0;
+  cj->cj_copied = 0;
+  cj->cj_cw_update = 0;
+  cj->cj_drain = 0;
+  return cj;
+}
+
+
+/**
+ * Drop references to input buffers
+ */
+static void
+csa_job_release(csa_job_t *cj)
+{
+  int i;
+
+  for(i = 0; i < cj->cj_nbufs; i++)
+    tsbuf_ref_dec(cj->cj_bufs[i]);
+  cj->cj_nbufs = 0;
+  cj->cj_fill = 0;
+}
+
+
+/**
+ * csa_mutex must be held
+ */
+static void
+csa_job_recycle(csa_t *csa, csa_job_t *cj)
+{
+  csa_job_release(cj);
+  TAILQ_INSERT_HEAD(&csa->csa_spare, cj, cj_link);
+}
+
+
+/**
+ *
+ */
+static void
+csa_job_free(csa_job_t *cj)
+{
+  csa_job_release(cj);
+  free(cj);
+}
+
+
+/**
+ * Decrypt the packets left over from previous clusters followed
+ * by the given cluster. Returns number of packets (in csa_pkts) that
+ * are ready to be delivered.
+ */
+static int
+csa_decrypt(csa_t *csa, csa_job_t *cj)
+{
+  csa_job_t *pc;
+  uint8_t **vec = csa->csa_vec;
+  int i, n = 0, nv = 0, r, done = 0, skip = -csa->csa_carry_fill;
+
+  if(cj->cj_cw_update & 0x1)
+    set_even_control_word(csa->csa_keys, cj->cj_cw);
+  if(cj->cj_cw_update & 0x2)
+    set_odd_control_word(csa->csa_keys, cj->cj_cw + 8);
+
+  TAILQ_FOREACH(pc, &csa->csa_carry, cj_link)
+    skip += pc->cj_fill;
+  TAILQ_FOREACH(pc, &csa->csa_carry, cj_link) {
+    for(i = 0; i < pc->cj_fill; i++, skip--)
+      if(skip <= 0)
+	csa->csa_pkts[n++] = pc->cj_pkts[i];
+  }
+  for(i = 0; i < cj->cj_fill; i++)
+    csa->csa_pkts[n++] = cj->cj_pkts[i];
+  csa->csa_npkts = n;
+
+  /* Packets adjacent in memory share a range */
+  for(i = 0; i < n; i++) {
+    if(nv > 0 && vec[nv - 1] == csa->csa_pkts[i]) {
+      vec[nv - 1] += 188;
+    } else {
+      vec[nv++] = csa->csa_pkts[i];
+      vec[nv++] = csa->csa_pkts[i] + 188;
+    }
+  }
+  vec[nv] = NULL;
+
+  /**
+   * A parity change in the middle of the batch stops decrypt_packets()
+   * from advancing. Keep going as long as there is enough left to
+   * fill a group, the rest is held back for the next cluster.
+   */
+  while(1) {
+    r = decrypt_packets(csa->csa_keys, vec);
+    done += r;
+    if(r == 0) {
+      csa->csa_nleft = 0;
+      break;
+    }
+    csa->csa_nleft = n - done;
+    if(csa->csa_nleft < csa_parallelism && !cj->cj_drain)
+      break;
+  }
+  return done;
+}
+
+
+/**
+ * Packets still come out once the descrambler is destroyed, unless
+ * the service itself is stopping.
+ *
+ * s_stream_mutex must be held
+ */
+static void
+csa_deliver(csa_t *csa, int r)
+{
+  service_t *t = csa->csa_service;
+  int i;
+
+  if(t->s_status != SERVICE_RUNNING)
+    return;
+
+  for(i = 0; i < r; i++)
+    ts_recv_packet2(t, csa->csa_pkts[i]);
+}
+
+
+/**
+ * Keep the cluster around along with the earlier ones as long as any
+ * of their packets were not decrypted. The held back packets may span
+ * several clusters if these are small.
+ *
+ * csa_mutex must be held
+ */
+static void
+csa_hold_back(csa_t *csa, csa_job_t *cj)
+{
+  csa_job_t *pc;
+  int total = 0;
+
+  TAILQ_INSERT_TAIL(&csa->csa_carry, cj, cj_link);
+  TAILQ_FOREACH(pc, &csa->csa_carry, cj_link)
+    total += pc->cj_fill;
+
+  while((pc = TAILQ_FIRST(&csa->csa_carry)) != NULL &&
+	total - pc->cj_fill >= csa->csa_nleft) {
+    total -= pc->cj_fill;
+    TAILQ_REMOVE(&csa->csa_carry, pc, cj_link);
+    csa_job_recycle(csa, pc);
+  }
+
+  csa->csa_carry_fill = csa->csa_nleft;
+  csa->csa_held = pc != NULL ? pc->cj_start : 0;
+}
+
+
+/**
+ * csa_mutex must be held
+ */
+static void
+csa_account(csa_worker_t *cw, int packets, int64_t busy)
+{
+  cw->cw_packets += packets;
+  cw->cw_clusters++;
+  cw->cw_busy += busy;
+  avgstat_add(&cw->cw_rate, packets, dispatch_clock);
+}
+
+
+/**
+ *
+ */
+static void
+csa_free(csa_t *csa)
+{
+  csa_job_t *cj;
+
+  while((cj = TAILQ_FIRST(&csa->csa_spare)) != NULL) {
+    TAILQ_REMOVE(&csa->csa_spare, cj, cj_link);
+    free(cj);
+  }
+  while((cj = TAILQ_FIRST(&csa->csa_carry)) != NULL) {
+    TAILQ_REMOVE(&csa->csa_carry, cj, cj_link);
+    csa_job_free(cj);
+  }
+  free_key_struct(csa->csa_keys);
+  free(csa->csa_pkts);
+  free(csa->csa_vec);
+  service_unref(csa->csa_service);
+  free(csa);
+}
+
+
+/**
+ *
+ */
+static void *
+csa_worker_thread(void *aux)
+{
+  csa_worker_t *cw = aux;
+  csa_t *csa;
+  csa_job_t *cj;
+  service_t *t;
+  int64_t ts;
+  int r;
+
+  pthread_mutex_lock(&csa_mutex);
+
+  while(1) {
+
+    if((csa = TAILQ_FIRST(&csa_runq)) == NULL) {
+      pthread_cond_wait(&csa_cond, &csa_mutex);
+      continue;
+    }
+
+    TAILQ_REMOVE(&csa_runq, csa, csa_link);
+    cj = TAILQ_FIRST(&csa->csa_jobs);
+    TAILQ_REMOVE(&csa->csa_jobs, cj, cj_link);
+    csa->csa_queued--;
+    csa_queued--;
+    csa->csa_busy = 1;
+    pthread_mutex_unlock(&csa_mutex);
+
+    ts = getmonoclock();
+    r = csa_decrypt(csa, cj);
+    ts = getmonoclock() - ts;
+
+    t = csa->csa_service;
+    pthread_mutex_lock(&t->s_stream_mutex);
+    csa_deliver(csa, r);
+    pthread_mutex_unlock(&t->s_stream_mutex);
+
+    pthread_mutex_lock(&csa_mutex);
+    csa_account(cw, cj->cj_fill, ts);
+    csa_hold_back(csa, cj);
+    csa->csa_busy = 0;
+
+    if(csa->csa_queued > 0)
+      TAILQ_INSERT_TAIL(&csa_runq, csa, csa_link);
+    else if(csa->csa_dead)
+      csa_free(csa);
+  }
+  return NULL;
+}
+
+
+/**
+ * s_stream_mutex must be held
+ */
+static void
+csa_submit(csa_t *csa, csa_job_t *cj)
+{
+  int64_t ts;
+  int r;
+
+  pthread_mutex_lock(&csa_mutex);
+
+  cj->cj_cw_update = csa->csa_cw_update;
+  memcpy(cj->cj_cw, csa->csa_cw, 16);
+  csa->csa_cw_update = 0;
+
+  csa_copied += cj->cj_copied;
+  csa_zerocopy += cj->cj_fill - cj->cj_copied;
+
+  if(csa_nworkers == 0) {
+    pthread_mutex_unlock(&csa_mutex);
+
+    ts = getmonoclock();
+    r = csa_decrypt(csa, cj);
+    ts = getmonoclock() - ts;
+    csa_deliver(csa, r);
+
+    pthread_mutex_lock(&csa_mutex);
+    csa_account(&csa_inline, cj->cj_fill, ts);
+    csa_hold_back(csa, cj);
+    pthread_mutex_unlock(&csa_mutex);
+    return;
+  }
+
+  if(csa->csa_queued >= CSA_MAX_QUEUED && !cj->cj_drain) {
+    /* Workers can't keep up, drop this cluster but keep the keys */
+    csa->csa_cw_update = cj->cj_cw_update;
+    csa_job_recycle(csa, cj);
+    csa_overflows++;
+    pthread_mutex_unlock(&csa_mutex);
+    limitedlog(&csa_overflow_loglimit, "csa",
+	       service_nicename(csa->csa_service), "Descrambler queue full");
+    return;
+  }
+
+  TAILQ_INSERT_TAIL(&csa->csa_jobs, cj, cj_link);
+  csa->csa_queued++;
+  csa_queued++;
+  csa_queued_peak = MAX(csa_queued_peak, csa_queued);
+
+  if(!csa->csa_busy && csa->csa_queued == 1) {
+    TAILQ_INSERT_TAIL(&csa_runq, csa, csa_link);
+    pthread_cond_signal(&csa_cond);
+  }
+  pthread_mutex_unlock(&csa_mutex);
+}
+
+
+/**
+ * Submit clusters that were waiting for their input buffer to be
+ * delivered to all services.
+ *
+ * s_stream_mutex must be held
+ */
+static void
+csa_flush_ready(csa_t *csa)
+{
+  csa_job_t *cj;
+
+  while((cj = TAILQ_FIRST(&csa->csa_ready)) != NULL) {
+    TAILQ_REMOVE(&csa->csa_ready, cj, cj_link);
+    csa_submit(csa, cj);
+  }
+
+  if(csa->csa_ready_tb != NULL) {
+    tsbuf_ref_dec(csa->csa_ready_tb);
+    csa->csa_ready_tb = NULL;
+  }
+}
+
+
+/**
+ * s_stream_mutex must be held
+ *
+ * Packets in an input buffer (tb) are claimed and decrypted in place.
+ * Decryption of a cluster can't start until the input has moved on to
+ * the next buffer, until then other services may still want to copy
+ * packets we have claimed.
+ */
+void
+csa_descramble(csa_t *csa, const uint8_t *tsb, tsbuf_t *tb)
+{
+  csa_job_t *cj;
+  uint8_t *pkt;
+
+  if(tb != csa->csa_ready_tb)
+    csa_flush_ready(csa);
+
+  if((cj = csa->csa_fill) == NULL)
+    cj = csa->csa_fill = csa_job_alloc(csa);
+  if(cj->cj_fill == 0)
+    cj->cj_start = getmonoclock();
+
+  if(tb != NULL && tsbuf_claim(tb, tsb)) {
+    if(cj->cj_nbufs == 0 || cj->cj_bufs[cj->cj_nbufs - 1] != tb) {
+      tsbuf_ref_inc(tb);
+      cj->cj_bufs[cj->cj_nbufs++] = tb;
+    }
+    pkt = tb->tb_data + (tsb - tb->tb_data);
+  } else {
+    pkt = cj->cj_data + cj->cj_fill * 188;
+    memcpy(pkt, tsb, 188);
+    cj->cj_copied++;
+  }
+
+  cj->cj_pkts[cj->cj_fill++] = pkt;
+
+  if(cj->cj_fill != csa_cluster_size)
+    return;
+
+  csa->csa_fill = NULL;
+
+  if(tb == NULL) {
+    csa_submit(csa, cj);
+    return;
+  }
+
+  TAILQ_INSERT_TAIL(&csa->csa_ready, cj, cj_link);
+  if(csa->csa_ready_tb == NULL) {
+    tsbuf_ref_inc(tb);
+    csa->csa_ready_tb = tb;
+  }
+}
+
+
+/**
+ * s_stream_mutex must be held
+ *
+ * Called once the input has delivered a whole buffer to all services.
+ * Full clusters are submitted right away. A partly filled one is
+ * submitted when it has waited for more packets for too long, so a
+ * quiet stream does not hold back what has already arrived. The same
+ * goes for packets the last cluster left over, these are pushed out
+ * by an empty cluster.
+ */
+void
+csa_flush(csa_t *csa)
+{
+  csa_job_t *cj = csa->csa_fill;
+  int64_t now;
+
+  csa_flush_ready(csa);
+
+  now = getmonoclock();
+
+  if(cj != NULL && cj->cj_fill > 0) {
+    if(now - cj->cj_start < CSA_MAX_DELAY)
+      return;
+  } else {
+    pthread_mutex_lock(&csa_mutex);
+    if(csa->csa_held == 0 || now - csa->csa_held < CSA_MAX_DELAY) {
+      pthread_mutex_unlock(&csa_mutex);
+      return;
+    }
+    csa->csa_held = 0;
+    pthread_mutex_unlock(&csa_mutex);
+
+    if(cj == NULL)
+      cj = csa_job_alloc(csa);
+  }
+
+  csa->csa_fill = NULL;
+  cj->cj_drain = 1;
+  csa_submit(csa, cj);
+}
+
+
+/**
+ * Control words are applied from the next cluster on. NULL leaves
+ * the current word untouched.
+ */
+void
+csa_set_control_words(csa_t *csa, const uint8_t *even, const uint8_t *odd)
+{
+  pthread_mutex_lock(&csa_mutex);
+  if(even != NULL) {
+    memcpy(csa->csa_cw, even, 8);
+    csa->csa_cw_update |= 0x1;
+  }
+  if(odd != NULL) {
+    memcpy(csa->csa_cw + 8, odd, 8);
+    csa->csa_cw_update |= 0x2;
+  }
+  pthread_mutex_unlock(&csa_mutex);
+}
+
+
+/**
+ *
+ */
+csa_t *
+csa_create(service_t *t)
+{
+  csa_t *csa = calloc(1, sizeof(csa_t));
+
+  service_ref(t);
+  csa->csa_service = t;
+  csa->csa_keys = get_key_struct();
+  csa->csa_pkts = malloc(2 * csa_cluster_size * sizeof(uint8_t *));
+  csa->csa_vec = malloc((4 * csa_cluster_size + 1) * sizeof(uint8_t *));
+  TAILQ_INIT(&csa->csa_ready);
+  TAILQ_INIT(&csa->csa_jobs);
+  TAILQ_INIT(&csa->csa_spare);
+  TAILQ_INIT(&csa->csa_carry);
+  return csa;
+}
+
+
+/**
+ * s_stream_mutex must be held
+ *
+ * Whatever has been collected is still decrypted and pushed out, the
+ * last cluster holds nothing back. If workers have clusters left to
+ * do the last one of them frees the descrambler.
+ */
+void
+csa_destroy(csa_t *csa)
+{
+  csa_job_t *cj;
+  int done;
+
+  csa_flush_ready(csa);
+
+  if((cj = csa->csa_fill) == NULL)
+    cj = csa_job_alloc(csa);
+  csa->csa_fill = NULL;
+  cj->cj_drain = 1;
+  csa_submit(csa, cj);
+
+  pthread_mutex_lock(&csa_mutex);
+  csa->csa_dead = 1;
+  done = !csa->csa_busy && csa->csa_queued == 0;
+  pthread_mutex_unlock(&csa_mutex);
+
+  if(done)
+    csa_free(csa);
+}
+
+
+/**
+ *
+ */
+static void
+csa_dump_worker(htsbuf_queue_t *hq, csa_worker_t *cw, const char *name)
+{
+  htsbuf_qprintf(hq, "  %-10s %8u pkts/s  %12"PRIu64" packets  "
+		 "%10"PRIu64" clusters  %6"PRId64" us/cluster\n",
+		 name,
+		 avgstat_read(&cw->cw_rate, 10, dispatch_clock) / 10,
+		 cw->cw_packets, cw->cw_clusters,
+		 cw->cw_clusters ? cw->cw_busy / (int64_t)cw->cw_clusters : 0);
+}
+
+
+/**
+ *
+ */
+void
+csa_dump(htsbuf_queue_t *hq)
+{
+  char name[32];
+  int i;
+
+  pthread_mutex_lock(&csa_mutex);
+
+  htsbuf_qprintf(hq, "Workers: %d  Cluster size: %d  Parallelism: %d\n",
+		 csa_nworkers, csa_cluster_size, csa_parallelism);
+  htsbuf_qprintf(hq, "Queued clusters: %d (peak %d)  Dropped clusters: %d\n",
+		 csa_queued, csa_queued_peak, csa_overflows);
+  htsbuf_qprintf(hq, "Packets decrypted in place: %"PRIu64"  copied: %"PRIu64"\n",
+		 csa_zerocopy, csa_copied);
+
+  if(csa_nworkers == 0)
+    csa_dump_worker(hq, &csa_inline, "inline");
+
+  for(i = 0; i < csa_nworkers; i++) {
+    snprintf(name, sizeof(name), "worker %d", i);
+    csa_dump_worker(hq, &csa_workers[i], name);
+  }
+
+  pthread_mutex_unlock(&csa_mutex);
+}
+
+
+/**
+ * workers < 0 means one worker per CPU, 0 descrambles in the input threads
+ */
+void
+csa_init(int workers)
+{
+  pthread_attr_t attr;
+  csa_worker_t *cw;
+  int i;
+
+  pthread_mutex_init(&csa_mutex, NULL);
+  pthread_cond_init(&csa_cond, NULL);
+  TAILQ_INIT(&csa_runq);
+
+  csa_parallelism  = get_internal_parallelism();
+  csa_cluster_size = get_suggested_cluster_size();
+
+  if(workers < 0)
+    workers = sysconf(_SC_NPROCESSORS_ONLN);
+  csa_nworkers = MIN(MAX(workers, 0), CSA_MAX_WORKERS);
+
+  avgstat_init(&csa_inline.cw_rate, 10);
+  csa_workers = calloc(csa_nworkers, sizeof(csa_worker_t));
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  for(i = 0; i < csa_nworkers; i++) {
+    cw = &csa_workers[i];
+    cw->cw_index = i;
+    avgstat_init(&cw->cw_rate, 10);
+    pthread_create(&cw->cw_tid, &attr, csa_worker_thread, cw);
+  }
+  pthread_attr_destroy(&attr);
+
+  if(csa_nworkers)
+    tvhlog(LOG_INFO, "csa", "Using %d descrambling worker threads",
+	   csa_nworkers);
+  else
+    tvhlog(LOG_INFO, "csa", "Descrambling in input threads");
+}
@@ -0,0 +1,54 @@
+/*
+ *  tvheadend, CSA descrambling workers
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CSA_H_
+#define CSA_H_
+
+#include "htsbuf.h"
+#include "tsdemux.h"
+
+struct service;
+
+/**
+ * Per-descrambler CSA state
+ *
+ * Scrambled packets are collected into clusters which are decrypted
+ * either inline or by the worker pool. Decrypted packets are fed back
+ * into the service (ts_recv_packet2()) in the order they were received.
+ *
+ * Packets that come with an input buffer (tsbuf_t) are decrypted in
+ * place, others are copied.
+ */
+typedef struct csa csa_t;
+
+void csa_init(int workers);
+
+csa_t *csa_create(struct service *t);
+
+void csa_destroy(csa_t *csa);
+
+void csa_set_control_words(csa_t *csa, const uint8_t *even,
+			   const uint8_t *odd);
+
+void csa_descramble(csa_t *csa, const uint8_t *tsb, tsbuf_t *tb);
+
+void csa_flush(csa_t *csa);
+
+void csa_dump(htsbuf_queue_t *hq);
+
+#endif /* CSA_H_ */
@@ -27,12 +27,15 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 
 #include "tvheadend.h"
 #include "tcp.h"
 #include "psi.h"
 #include "tsdemux.h"
-#include "ffdecsa/FFdecsa.h"
+#include "csa.h"
 #include "cwc.h"
 #include "notify.h"
 #include "atomic.h"
@@ -99,6 +102,16 @@ TAILQ_HEAD(cwc_message_queue, cwc_message);
 LIST_HEAD(ecm_section_list, ecm_section);
 static struct cwc_queue cwcs;
 static pthread_cond_t cwc_config_changed;
+
+/**
+ * Logged in sessions, all served by one I/O thread.
+ * Protected by cwc_mutex
+ */
+static LIST_HEAD(, cwc) cwc_io_sessions;
+static int cwc_io_epollfd;
+static int cwc_io_pipe[2];
+
+#define CWC_IO_IOVECS 32
 static pthread_mutex_t cwc_mutex;
 static char *crypt_md5(const char *pw, const char *salt);
 
@@ -113,6 +126,9 @@ typedef struct ecm_section {
   char es_nok;
   char es_pending;
   int64_t es_time;  // time request was sent
+  int64_t es_changed; // time the ECM last changed
+  int64_t es_period;  // observed crypto period, 0 if unknown
+  uint32_t es_provider;
   size_t es_ecmsize;
   uint8_t es_ecm[4070];
 
@@ -144,10 +160,15 @@ typedef struct cwc_service {
 
   LIST_ENTRY(cwc_service) cs_link;
 
+  /**
+   * Fields below are protected by the service's s_stream_mutex.
+   * The descrambler reads them for every packet with it held, ECM
+   * replies take it after cwc_mutex.
+   */
   int cs_okchannel;
 
   /**
-   * Status of the key(s) in cs_keys
+   * Status of the key(s) in cs_csa
    */
   enum {
     CS_UNKNOWN,
@@ -156,18 +177,27 @@ typedef struct cwc_service {
     CS_IDLE
   } cs_keystate;
 
-  void *cs_keys;
-
-
   uint8_t cs_cw[16];
-  int cs_pending_cw_update;
+
+  /**
+   * Key timing, to see how far ahead of the parity change new
+   * control words arrive. Parity is the scrambling control bits
+   * (0x80 even, 0xc0 odd) of the last scrambled packet
+   */
+  int cs_parity;
+  int64_t cs_parity_changed;
+  int64_t cs_period;         /* Observed crypto period */
+  int64_t cs_cw_time[2];     /* When even/odd word last changed */
+  int64_t cs_margin_last;    /* Word arrival to parity change */
+  int64_t cs_margin_min;
+  int cs_margins;
+  int cs_late;               /* Words that arrived after the change */
+  int cs_ecm_unsent;         /* New ECM seen while disconnected */
 
   /**
    * CSA
    */
-  int cs_cluster_size;
-  uint8_t *cs_tsbcluster;
-  int cs_fill;
+  csa_t *cs_csa;
 
   LIST_HEAD(, ecm_pid) cs_pids;
 
@@ -192,6 +222,40 @@ typedef struct cwc_provider {
   uint8_t sa[8];
 } cwc_provider_t;
 
+/**
+ * Forwarded EMM, for duplicate suppression
+ */
+typedef struct emm_cache_entry {
+  LIST_ENTRY(emm_cache_entry) eme_hash_link;
+  TAILQ_ENTRY(emm_cache_entry) eme_lru_link;
+  uint32_t eme_crc;
+  int eme_len;
+  time_t eme_time;
+} emm_cache_entry_t;
+
+#define EMM_CACHE_HASH_SIZE   64
+#define EMM_CACHE_MAX_ENTRIES 512
+
+/* Seconds a forwarded EMM counts as a duplicate, per card type.
+   Only Viaccess assembles shared EMMs from a carousel that repeats the
+   same parts over and over, other types are not deduplicated */
+#define EMM_DEDUP_VIACCESS    600
+
+/**
+ * EMM address rule, derived from the card data reply.
+ * An EMM matches if (data[er_offset + i] & er_mask[i]) == er_data[i]
+ * for all i < er_len. er_tid 0 matches any table id.
+ */
+typedef struct emm_rule {
+  uint8_t er_tid;
+  uint8_t er_offset;
+  uint8_t er_len;
+  uint8_t er_data[7];
+  uint8_t er_mask[7];
+} emm_rule_t;
+
+#define EMM_RULES_MAX 64
+
 /**
  *
  */
@@ -204,10 +268,27 @@ typedef struct cwc {
   pthread_cond_t cwc_cond;
 
   pthread_mutex_t cwc_writer_mutex; 
-  pthread_cond_t cwc_writer_cond; 
   int cwc_writer_running;
   struct cwc_message_queue cwc_writeq;
 
+  /* Session I/O, served by cwc_io_thread() once logged in */
+  LIST_ENTRY(cwc) cwc_io_link;
+  int cwc_io_attached;
+  int cwc_io_error;
+  int cwc_io_events;
+  int cwc_io_woff;           /* Bytes of first queued message written */
+  int64_t cwc_io_last_rx;
+  int64_t cwc_io_last_tx;
+  uint64_t cwc_io_writes;
+  uint64_t cwc_io_msgs;
+
+  /* ECM request to reply latency, bucket n is < (25 << n) ms */
+#define CWC_ECM_HIST_BUCKETS 8
+  uint32_t cwc_ecm_hist[CWC_ECM_HIST_BUCKETS];
+  uint32_t cwc_ecm_replies;
+  int64_t cwc_ecm_total;
+  int64_t cwc_ecm_max;
+
   TAILQ_ENTRY(cwc) cwc_link; /* Linkage protected via cwc_mutex */
 
   struct cwc_service_list cwc_services;
@@ -218,7 +299,7 @@ typedef struct cwc {
 
   DES_key_schedule cwc_k1, cwc_k2;
 
-  uint8_t cwc_buf[256];
+  uint8_t cwc_buf[CWS_NETMSGSIZE + 2];
   int cwc_bufptr;
 
   /* Card Unique Address */
@@ -231,14 +312,27 @@ typedef struct cwc {
   /* Emm forwarding */
   int cwc_forward_emm;
 
+  /* Emm pre-filter (bit n = table id 0x80 + n). Table ids in
+     cwc_emm_tids reach the card handler if they are also in
+     cwc_emm_global or match one of the address rules */
+  uint16_t cwc_emm_tids;
+  uint16_t cwc_emm_global;
+  emm_rule_t cwc_emm_rules[EMM_RULES_MAX];
+  int cwc_emm_nrules;
+  int cwc_emm_dedup_ttl;       /* 0 = no duplicate suppression */
+
   /* Emm duplicate cache */
-  struct {
-#define EMM_CACHE_SIZE (1<<5)
-#define EMM_CACHE_MASK (EMM_CACHE_SIZE-1)
-    uint32_t cache[EMM_CACHE_SIZE];
-    uint32_t w;
-    uint32_t n;
-  } cwc_emm_cache;
+  LIST_HEAD(, emm_cache_entry) cwc_emm_hash[EMM_CACHE_HASH_SIZE];
+  TAILQ_HEAD(, emm_cache_entry) cwc_emm_lru;
+  int cwc_emm_entries;
+
+  /* Emm statistics, since last card data reply */
+  time_t cwc_emm_since;
+  uint64_t cwc_emm_seen;
+  uint64_t cwc_emm_filtered;   /* Dropped by table id */
+  uint64_t cwc_emm_unaddressed;/* Dropped by address rules */
+  uint64_t cwc_emm_dups;
+  uint64_t cwc_emm_forwarded;
 
   /* Viaccess EMM assemble state */
   struct {
@@ -282,7 +376,10 @@ typedef struct cwc {
  */
 
 static void cwc_service_destroy(th_descrambler_t *td);
+static void update_keys(cwc_service_t *ct, int mask);
 static void cwc_detect_card_type(cwc_t *cwc);
+static void cwc_emm_cache_flush(cwc_t *cwc);
+static void cwc_emm_filter_setup(cwc_t *cwc);
 void cwc_emm_conax(cwc_t *cwc, uint8_t *data, int len);
 void cwc_emm_irdeto(cwc_t *cwc, uint8_t *data, int len);
 void cwc_emm_dre(cwc_t *cwc, uint8_t *data, int len);
@@ -452,6 +549,18 @@ des_make_session_key(cwc_t *cwc)
   DES_set_key_unchecked((DES_cblock *)(spread+8), &cwc->cwc_k2);
 }
 
+/**
+ * Kick the I/O thread
+ */
+static void
+cwc_io_wakeup(void)
+{
+  char c = 0;
+
+  if(write(cwc_io_pipe[1], &c, 1) == -1 && errno != EAGAIN)
+    tvhlog(LOG_ERR, "cwc", "I/O thread wakeup failed: %s", strerror(errno));
+}
+
 /**
  * Note, this function is called from multiple threads so beware of
  * locking / race issues (Note how we use atomic_add() to generate
@@ -494,8 +603,10 @@ cwc_send_msg(cwc_t *cwc, const uint8_t *msg, size_t len, int sid, int enq)
   if(enq) {
     cm->cm_len = len;
     pthread_mutex_lock(&cwc->cwc_writer_mutex);
+    /* The I/O thread flushes the whole queue, only wake it once */
+    if(TAILQ_EMPTY(&cwc->cwc_writeq))
+      cwc_io_wakeup();
     TAILQ_INSERT_TAIL(&cwc->cwc_writeq, cm, cm_link);
-    pthread_cond_signal(&cwc->cwc_writer_cond);
     pthread_mutex_unlock(&cwc->cwc_writer_mutex);
   } else {
     n = write(cwc->cwc_fd, buf, len);
@@ -538,7 +649,7 @@ cwc_send_ka(cwc_t *cwc)
   buf[1] = 0;
   buf[2] = 0;
 
-  cwc_send_msg(cwc, buf, 3, 0, 0);
+  cwc_send_msg(cwc, buf, 3, 0, 1);
 }
 
 /**
@@ -635,6 +746,14 @@ cwc_decode_card_data_reply(cwc_t *cwc, uint8_t *msg, int len)
   }
 
   cwc->cwc_forward_emm = 0;
+  cwc_emm_cache_flush(cwc);
+  cwc->cwc_emm_since = dispatch_clock;
+  cwc->cwc_emm_seen = 0;
+  cwc->cwc_emm_filtered = 0;
+  cwc->cwc_emm_unaddressed = 0;
+  cwc->cwc_emm_dups = 0;
+  cwc->cwc_emm_forwarded = 0;
+
   if (cwc->cwc_emm) {
     int emm_allowed = (cwc->cwc_ua[0] || cwc->cwc_ua[1] ||
 		       cwc->cwc_ua[2] || cwc->cwc_ua[3] ||
@@ -649,6 +768,7 @@ cwc_decode_card_data_reply(cwc_t *cwc, uint8_t *msg, int len)
       tvhlog(LOG_INFO, "cwc", "%s:%i: Will forward EMMs",
 	     cwc->cwc_hostname, cwc->cwc_port);
       cwc->cwc_forward_emm = 1;
+      cwc_emm_filter_setup(cwc);
     } else {
       tvhlog(LOG_INFO, "cwc", 
 	     "%s:%i: Will not forward EMMs (unsupported CA system)",
@@ -749,6 +869,307 @@ cwc_send_login(cwc_t *cwc)
 
 
 
+/**
+ * ECM -> control word cache
+ *
+ * Shared by all services and card servers. Services watching the same
+ * ECM stream (regional variants, same channel on several adapters) get
+ * their keys without another round trip to the card server.
+ */
+#define ECM_CACHE_HASH_SIZE   256
+#define ECM_CACHE_MAX_ENTRIES 1024
+#define ECM_CACHE_TTL_DEFAULT (20 * 1000000LL) /* Crypto period unknown */
+#define ECM_CACHE_TTL_MIN     (5 * 1000000LL)
+#define ECM_CACHE_TTL_MAX     (60 * 1000000LL)
+
+typedef struct ecm_cache_entry {
+  LIST_ENTRY(ecm_cache_entry) ece_hash_link;
+  TAILQ_ENTRY(ecm_cache_entry) ece_age_link;
+  uint16_t ece_caid;
+  uint32_t ece_provider;
+  uint32_t ece_crc;
+  int64_t ece_expire;
+  uint8_t ece_cw[16];
+  size_t ece_ecmsize;
+  uint8_t ece_ecm[0];
+} ecm_cache_entry_t;
+
+static pthread_mutex_t ecm_cache_mutex;
+static LIST_HEAD(, ecm_cache_entry) ecm_cache_hash[ECM_CACHE_HASH_SIZE];
+static TAILQ_HEAD(, ecm_cache_entry) ecm_cache_age;
+static int ecm_cache_entries;
+static uint64_t ecm_cache_hits;
+static uint64_t ecm_cache_misses;
+static uint64_t ecm_cache_expired;
+
+
+/**
+ * ecm_cache_mutex must be held
+ */
+static void
+ecm_cache_remove(ecm_cache_entry_t *ece)
+{
+  LIST_REMOVE(ece, ece_hash_link);
+  TAILQ_REMOVE(&ecm_cache_age, ece, ece_age_link);
+  ecm_cache_entries--;
+  free(ece);
+}
+
+
+/**
+ * Lookup control words for the given ECM. Returns 0 on hit
+ */
+static int
+ecm_cache_lookup(uint16_t caid, uint32_t provider,
+		 const uint8_t *ecm, size_t len, uint8_t *cw)
+{
+  ecm_cache_entry_t *ece;
+  uint32_t crc = crc32((uint8_t *)ecm, len, 0xffffffff);
+  int64_t now = getmonoclock();
+  int r = -1;
+
+  pthread_mutex_lock(&ecm_cache_mutex);
+
+  LIST_FOREACH(ece, &ecm_cache_hash[crc % ECM_CACHE_HASH_SIZE], ece_hash_link)
+    if(ece->ece_crc == crc && ece->ece_caid == caid &&
+       ece->ece_provider == provider && ece->ece_ecmsize == len &&
+       !memcmp(ece->ece_ecm, ecm, len))
+      break;
+
+  if(ece != NULL && ece->ece_expire < now) {
+    ecm_cache_remove(ece);
+    ecm_cache_expired++;
+    ece = NULL;
+  }
+
+  if(ece != NULL) {
+    memcpy(cw, ece->ece_cw, 16);
+    ecm_cache_hits++;
+    r = 0;
+  } else {
+    ecm_cache_misses++;
+  }
+
+  pthread_mutex_unlock(&ecm_cache_mutex);
+  return r;
+}
+
+
+/**
+ * 'period' is the observed crypto period, 0 if unknown
+ */
+static void
+ecm_cache_insert(uint16_t caid, uint32_t provider,
+		 const uint8_t *ecm, size_t len, const uint8_t *cw,
+		 int64_t period)
+{
+  ecm_cache_entry_t *ece;
+  uint32_t crc = crc32((uint8_t *)ecm, len, 0xffffffff);
+  int64_t now = getmonoclock();
+  int64_t ttl;
+
+  /* An ECM is broadcast for about two crypto periods */
+  ttl = period ? 2 * period : ECM_CACHE_TTL_DEFAULT;
+  ttl = MIN(MAX(ttl, ECM_CACHE_TTL_MIN), ECM_CACHE_TTL_MAX);
+
+  pthread_mutex_lock(&ecm_cache_mutex);
+
+  LIST_FOREACH(ece, &ecm_cache_hash[crc % ECM_CACHE_HASH_SIZE], ece_hash_link)
+    if(ece->ece_crc == crc && ece->ece_caid == caid &&
+       ece->ece_provider == provider && ece->ece_ecmsize == len &&
+       !memcmp(ece->ece_ecm, ecm, len))
+      break;
+
+  if(ece != NULL) {
+    TAILQ_REMOVE(&ecm_cache_age, ece, ece_age_link);
+  } else {
+    /* Make room, oldest entries first */
+    while((ece = TAILQ_FIRST(&ecm_cache_age)) != NULL &&
+	  (ecm_cache_entries >= ECM_CACHE_MAX_ENTRIES ||
+	   ece->ece_expire < now)) {
+      if(ece->ece_expire < now)
+	ecm_cache_expired++;
+      ecm_cache_remove(ece);
+    }
+
+    ece = malloc(sizeof(ecm_cache_entry_t) + len);
+    ece->ece_caid = caid;
+    ece->ece_provider = provider;
+    ece->ece_crc = crc;
+    ece->ece_ecmsize = len;
+    memcpy(ece->ece_ecm, ecm, len);
+    LIST_INSERT_HEAD(&ecm_cache_hash[crc % ECM_CACHE_HASH_SIZE],
+		     ece, ece_hash_link);
+    ecm_cache_entries++;
+  }
+
+  memcpy(ece->ece_cw, cw, 16);
+  ece->ece_expire = now + ttl;
+  TAILQ_INSERT_TAIL(&ecm_cache_age, ece, ece_age_link);
+
+  pthread_mutex_unlock(&ecm_cache_mutex);
+}
+
+
+/**
+ *
+ */
+void
+cwc_ecm_cache_dump(htsbuf_queue_t *hq)
+{
+  uint64_t total;
+
+  pthread_mutex_lock(&ecm_cache_mutex);
+  total = ecm_cache_hits + ecm_cache_misses;
+  htsbuf_qprintf(hq, "Entries: %d  Hits: %"PRIu64"  Misses: %"PRIu64
+		 "  Hit rate: %d%%  Expired: %"PRIu64"\n",
+		 ecm_cache_entries, ecm_cache_hits, ecm_cache_misses,
+		 total ? (int)(ecm_cache_hits * 100 / total) : 0,
+		 ecm_cache_expired);
+  pthread_mutex_unlock(&ecm_cache_mutex);
+}
+
+
+/**
+ * Key timing per service, for statedump
+ */
+void
+cwc_key_timing_dump(htsbuf_queue_t *hq)
+{
+  static const char *keystates[] = {
+    [CS_UNKNOWN]   = "unknown",
+    [CS_RESOLVED]  = "resolved",
+    [CS_FORBIDDEN] = "forbidden",
+    [CS_IDLE]      = "idle",
+  };
+  cwc_t *cwc;
+  cwc_service_t *ct;
+
+  pthread_mutex_lock(&cwc_mutex);
+  TAILQ_FOREACH(cwc, &cwcs, cwc_link) {
+    LIST_FOREACH(ct, &cwc->cwc_services, cs_link) {
+      pthread_mutex_lock(&ct->cs_service->s_stream_mutex);
+      htsbuf_qprintf(hq, "%s (%s:%d): %s  Period: %lld ms  "
+		     "Margin last: %lld ms  min: %lld ms  Late: %d\n",
+		     ct->cs_service->s_svcname ?: "<noname>",
+		     cwc->cwc_hostname, cwc->cwc_port,
+		     keystates[ct->cs_keystate],
+		     ct->cs_period / 1000LL,
+		     ct->cs_margin_last / 1000LL,
+		     ct->cs_margin_min / 1000LL,
+		     ct->cs_late);
+      pthread_mutex_unlock(&ct->cs_service->s_stream_mutex);
+    }
+  }
+  pthread_mutex_unlock(&cwc_mutex);
+}
+
+
+/**
+ * New control words from the card server (or the ECM cache).
+ *
+ * Only words that changed are handed to the CSA so the one for the
+ * parity currently on air is left alone. Zero words are ignored.
+ *
+ * s_stream_mutex is held
+ */
+static void
+cwc_new_cw(cwc_service_t *ct, const uint8_t *cw)
+{
+  static const uint8_t zero[8];
+  int64_t now = getmonoclock();
+  int i, mask = 0;
+
+  for(i = 0; i < 2; i++) {
+    if(!memcmp(cw + i * 8, zero, 8) ||
+       !memcmp(cw + i * 8, ct->cs_cw + i * 8, 8))
+      continue;
+
+    memcpy(ct->cs_cw + i * 8, cw + i * 8, 8);
+    ct->cs_cw_time[i] = now;
+    mask |= 1 << i;
+
+    if(ct->cs_keystate == CS_RESOLVED &&
+       ct->cs_parity == (i ? 0xc0 : 0x80)) {
+      ct->cs_late++;
+      tvhlog(LOG_WARNING, "cwc",
+	     "%s control word for service \"%s\" arrived %lld ms "
+	     "after parity change",
+	     i ? "Odd" : "Even", ct->cs_service->s_svcname,
+	     (now - ct->cs_parity_changed) / 1000LL);
+    }
+  }
+
+  ct->cs_ecm_unsent = 0;
+  update_keys(ct, mask);
+}
+
+
+/**
+ * Track scrambling control parity
+ *
+ * s_stream_mutex is held
+ */
+static void
+cwc_parity_change(cwc_service_t *ct, int parity)
+{
+  int64_t now = getmonoclock(), cwt, margin;
+  int i = parity == 0xc0;
+
+  if(ct->cs_parity != 0) {
+    if(ct->cs_parity_changed)
+      ct->cs_period = now - ct->cs_parity_changed;
+
+    /* Word for the new parity arrived during the last period */
+    cwt = ct->cs_cw_time[i];
+    if(cwt > ct->cs_parity_changed) {
+      margin = now - cwt;
+      ct->cs_margin_last = margin;
+      if(ct->cs_margins == 0 || margin < ct->cs_margin_min)
+	ct->cs_margin_min = margin;
+      ct->cs_margins++;
+      tvhlog(LOG_DEBUG, "cwc",
+	     "%s control word for service \"%s\" was ready %lld ms "
+	     "before parity change",
+	     i ? "Odd" : "Even", ct->cs_service->s_svcname,
+	     margin / 1000LL);
+    }
+
+    if(ct->cs_ecm_unsent && ct->cs_keystate == CS_RESOLVED) {
+      tvhlog(LOG_INFO, "cwc",
+	     "No key for new crypto period of service \"%s\"",
+	     ct->cs_service->s_svcname);
+      ct->cs_keystate = CS_UNKNOWN;
+    }
+  }
+
+  ct->cs_parity = parity;
+  ct->cs_parity_changed = now;
+}
+
+
+/**
+ * Account ECM request to reply latency (ms)
+ */
+static void
+cwc_ecm_latency(cwc_t *cwc, int64_t delay)
+{
+  int i;
+
+  for(i = 0; i < CWC_ECM_HIST_BUCKETS - 1; i++)
+    if(delay < (25 << i))
+      break;
+  cwc->cwc_ecm_hist[i]++;
+  cwc->cwc_ecm_replies++;
+  cwc->cwc_ecm_total += delay;
+  cwc->cwc_ecm_max = MAX(cwc->cwc_ecm_max, delay);
+}
+
+
+/**
+ * cwc_mutex is held
+ * s_stream_mutex is held
+ */
 static void
 handle_ecm_reply(cwc_service_t *ct, ecm_section_t *es, uint8_t *msg,
 		 int len, int seq)
@@ -768,6 +1189,7 @@ handle_ecm_reply(cwc_service_t *ct, ecm_section_t *es, uint8_t *msg,
   }
 
   es->es_pending = 0;
+  cwc_ecm_latency(ct->cs_cwc, delay);
 
   if(len < 19) {
     
@@ -862,9 +1284,11 @@ forbid:
 	     t->s_svcname, delay, ct->cs_cwc->cwc_hostname,
 	     ct->cs_cwc->cwc_port);
 
+    cwc_new_cw(ct, msg + 3);
     ct->cs_keystate = CS_RESOLVED;
-    memcpy(ct->cs_cw, msg + 3, 16);
-    ct->cs_pending_cw_update = 1;
+
+    ecm_cache_insert(ct->cs_cwc->cwc_caid, es->es_provider,
+		     es->es_ecm, es->es_ecmsize, msg + 3, es->es_period);
   }
 }
 
@@ -894,7 +1318,9 @@ cwc_running_reply(cwc_t *cwc, uint8_t msgtype, uint8_t *msg, int len)
 	  es = ep->ep_sections[i];
 	  if(es != NULL) {
 	    if(es->es_seq == seq && es->es_pending) {
+	      pthread_mutex_lock(&ct->cs_service->s_stream_mutex);
 	      handle_ecm_reply(ct, es, msg, len, seq);
+	      pthread_mutex_unlock(&ct->cs_service->s_stream_mutex);
 	      return 0;
 	    }
 	  }
@@ -976,47 +1402,322 @@ cwc_read_message(cwc_t *cwc, const char *state, int timeout)
   return msglen;
 }
 
+/**
+ * Drop all queued messages
+ */
+static void
+cwc_writeq_flush(cwc_t *cwc)
+{
+  cwc_message_t *cm;
+
+  pthread_mutex_lock(&cwc->cwc_writer_mutex);
+  while((cm = TAILQ_FIRST(&cwc->cwc_writeq)) != NULL) {
+    TAILQ_REMOVE(&cwc->cwc_writeq, cm, cm_link);
+    free(cm);
+  }
+  cwc->cwc_io_woff = 0;
+  pthread_mutex_unlock(&cwc->cwc_writer_mutex);
+}
+
 /**
  *
  */
-static void *
-cwc_writer_thread(void *aux)
+static void
+cwc_io_set_events(cwc_t *cwc, int events)
 {
-  cwc_t *cwc = aux;
+  struct epoll_event ev;
+
+  if(cwc->cwc_io_events == events)
+    return;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = cwc;
+  epoll_ctl(cwc_io_epollfd, EPOLL_CTL_MOD, cwc->cwc_fd, &ev);
+  cwc->cwc_io_events = events;
+}
+
+/**
+ * Hand a logged in session over to the I/O thread
+ *
+ * cwc_mutex is held
+ */
+static void
+cwc_io_attach(cwc_t *cwc)
+{
+  struct epoll_event ev;
+
+  /* Anything queued before the session key was set is useless */
+  cwc_writeq_flush(cwc);
+
+  fcntl(cwc->cwc_fd, F_SETFL, fcntl(cwc->cwc_fd, F_GETFL) | O_NONBLOCK);
+
+  cwc->cwc_bufptr = 0;
+  cwc->cwc_io_error = 0;
+  cwc->cwc_io_attached = 1;
+  cwc->cwc_io_events = EPOLLIN;
+  cwc->cwc_io_last_rx = cwc->cwc_io_last_tx = getmonoclock();
+
+  pthread_mutex_lock(&cwc->cwc_writer_mutex);
+  cwc->cwc_writer_running = 1;
+  pthread_mutex_unlock(&cwc->cwc_writer_mutex);
+
+  LIST_INSERT_HEAD(&cwc_io_sessions, cwc, cwc_io_link);
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = cwc->cwc_io_events;
+  ev.data.ptr = cwc;
+  epoll_ctl(cwc_io_epollfd, EPOLL_CTL_ADD, cwc->cwc_fd, &ev);
+
+  cwc_io_wakeup();
+}
+
+/**
+ * Called from the I/O thread only, so no events for this session are
+ * in flight once it returns
+ *
+ * cwc_mutex is held
+ */
+static void
+cwc_io_detach(cwc_t *cwc)
+{
+  epoll_ctl(cwc_io_epollfd, EPOLL_CTL_DEL, cwc->cwc_fd, NULL);
+  LIST_REMOVE(cwc, cwc_io_link);
+
+  pthread_mutex_lock(&cwc->cwc_writer_mutex);
+  cwc->cwc_writer_running = 0;
+  pthread_mutex_unlock(&cwc->cwc_writer_mutex);
+  cwc_writeq_flush(cwc);
+
+  cwc->cwc_io_attached = 0;
+  pthread_cond_signal(&cwc->cwc_cond);
+}
+
+/**
+ * Write as much of the queue as the socket takes, in one writev()
+ *
+ * cwc_mutex is held
+ */
+static void
+cwc_io_write(cwc_t *cwc)
+{
+  struct iovec iov[CWC_IO_IOVECS];
   cwc_message_t *cm;
-  struct timespec ts;
-  int r;
+  ssize_t w;
+  int n = 0, r, empty;
 
+  /* Only this thread removes messages, so they stay put while unlocked */
   pthread_mutex_lock(&cwc->cwc_writer_mutex);
+  TAILQ_FOREACH(cm, &cwc->cwc_writeq, cm_link) {
+    if(n == CWC_IO_IOVECS)
+      break;
+    r = n ? 0 : cwc->cwc_io_woff;
+    iov[n].iov_base = cm->cm_data + r;
+    iov[n].iov_len  = cm->cm_len  - r;
+    n++;
+  }
+  pthread_mutex_unlock(&cwc->cwc_writer_mutex);
 
-  while(cwc->cwc_writer_running) {
+  if(n == 0) {
+    cwc_io_set_events(cwc, EPOLLIN);
+    return;
+  }
 
-    if((cm = TAILQ_FIRST(&cwc->cwc_writeq)) != NULL) {
-      TAILQ_REMOVE(&cwc->cwc_writeq, cm, cm_link);
-      pthread_mutex_unlock(&cwc->cwc_writer_mutex);
-      //      int64_t ts = getmonoclock();
-      r = write(cwc->cwc_fd, cm->cm_data, cm->cm_len);
-      //      printf("Write took %lld usec\n", getmonoclock() - ts);
-      free(cm);
-      pthread_mutex_lock(&cwc->cwc_writer_mutex);
-      continue;
+  w = writev(cwc->cwc_fd, iov, n);
+  if(w == -1) {
+    if(errno == EAGAIN || errno == EINTR) {
+      cwc_io_set_events(cwc, EPOLLIN | EPOLLOUT);
+      return;
     }
+    tvhlog(LOG_INFO, "cwc", "%s:%i: Write error: %s",
+	   cwc->cwc_hostname, cwc->cwc_port, strerror(errno));
+    cwc->cwc_io_error = 1;
+    return;
+  }
 
+  cwc->cwc_io_last_tx = getmonoclock();
+  cwc->cwc_io_writes++;
 
-    /* If nothing is to be sent in CWC_KEEPALIVE_INTERVAL seconds we
-       need to send a keepalive */
-    ts.tv_sec  = time(NULL) + CWC_KEEPALIVE_INTERVAL;
-    ts.tv_nsec = 0;
-    r = pthread_cond_timedwait(&cwc->cwc_writer_cond, 
-			       &cwc->cwc_writer_mutex, &ts);
-    if(r == ETIMEDOUT)
-      cwc_send_ka(cwc);
+  pthread_mutex_lock(&cwc->cwc_writer_mutex);
+  while(w > 0 && (cm = TAILQ_FIRST(&cwc->cwc_writeq)) != NULL) {
+    r = cm->cm_len - cwc->cwc_io_woff;
+    if(w < r) {
+      cwc->cwc_io_woff += w;
+      break;
+    }
+    w -= r;
+    cwc->cwc_io_woff = 0;
+    TAILQ_REMOVE(&cwc->cwc_writeq, cm, cm_link);
+    free(cm);
+    cwc->cwc_io_msgs++;
   }
-
+  empty = TAILQ_EMPTY(&cwc->cwc_writeq);
   pthread_mutex_unlock(&cwc->cwc_writer_mutex);
+
+  cwc_io_set_events(cwc, empty ? EPOLLIN : EPOLLIN | EPOLLOUT);
+}
+
+/**
+ * Read and dispatch whatever complete messages the socket has
+ *
+ * cwc_mutex is held
+ */
+static void
+cwc_io_read(cwc_t *cwc)
+{
+  int need, msglen, r;
+
+  while(1) {
+    if(cwc->cwc_bufptr < 2)
+      need = 2;
+    else
+      need = 2 + ((cwc->cwc_buf[0] << 8) | cwc->cwc_buf[1]);
+
+    r = read(cwc->cwc_fd, cwc->cwc_buf + cwc->cwc_bufptr,
+	     need - cwc->cwc_bufptr);
+    if(r == 0) {
+      tvhlog(LOG_INFO, "cwc", "%s:%i: Connection closed by server",
+	     cwc->cwc_hostname, cwc->cwc_port);
+      cwc->cwc_io_error = 1;
+      return;
+    }
+    if(r == -1) {
+      if(errno == EINTR)
+	continue;
+      if(errno == EAGAIN)
+	return;
+      tvhlog(LOG_INFO, "cwc", "%s:%i: Read error: %s",
+	     cwc->cwc_hostname, cwc->cwc_port, strerror(errno));
+      cwc->cwc_io_error = 1;
+      return;
+    }
+
+    cwc->cwc_io_last_rx = getmonoclock();
+    cwc->cwc_bufptr += r;
+    if(cwc->cwc_bufptr < need)
+      continue;
+
+    if(need == 2) {
+      msglen = (cwc->cwc_buf[0] << 8) | cwc->cwc_buf[1];
+      if(msglen == 0 || msglen >= CWS_NETMSGSIZE) {
+	tvhlog(LOG_INFO, "cwc", "%s:%i: Invalid message size: %d",
+	       cwc->cwc_hostname, cwc->cwc_port, msglen);
+	cwc->cwc_io_error = 1;
+	return;
+      }
+      continue;
+    }
+
+    cwc->cwc_bufptr = 0;
+    if((msglen = des_decrypt(cwc->cwc_buf, need, cwc)) < 15) {
+      tvhlog(LOG_INFO, "cwc", "%s:%i: Decrypt failed",
+	     cwc->cwc_hostname, cwc->cwc_port);
+      cwc->cwc_io_error = 1;
+      return;
+    }
+    cwc_running_reply(cwc, cwc->cwc_buf[12], cwc->cwc_buf, msglen);
+  }
+}
+
+/**
+ * Serves all logged in card server sessions
+ */
+static void *
+cwc_io_thread(void *aux)
+{
+  struct epoll_event ev[16];
+  cwc_t *cwc, *next;
+  int64_t now;
+  char buf[64];
+  int i, n;
+
+  pthread_mutex_lock(&cwc_mutex);
+
+  while(1) {
+    now = getmonoclock();
+
+    for(cwc = LIST_FIRST(&cwc_io_sessions); cwc != NULL; cwc = next) {
+      next = LIST_NEXT(cwc, cwc_io_link);
+
+      if(!cwc->cwc_io_error && cwc_must_break(cwc))
+	cwc->cwc_io_error = 1;
+
+      if(!cwc->cwc_io_error &&
+	 now - cwc->cwc_io_last_rx > CWC_KEEPALIVE_INTERVAL * 2 * 1000000LL) {
+	tvhlog(LOG_INFO, "cwc", "%s:%i: Read timeout",
+	       cwc->cwc_hostname, cwc->cwc_port);
+	cwc->cwc_io_error = 1;
+      }
+
+      /* If nothing was sent in CWC_KEEPALIVE_INTERVAL seconds we
+	 need to send a keepalive */
+      if(!cwc->cwc_io_error &&
+	 now - cwc->cwc_io_last_tx > CWC_KEEPALIVE_INTERVAL * 1000000LL)
+	cwc_send_ka(cwc);
+
+      if(!cwc->cwc_io_error)
+	cwc_io_write(cwc);
+
+      if(cwc->cwc_io_error)
+	cwc_io_detach(cwc);
+    }
+
+    pthread_mutex_unlock(&cwc_mutex);
+    n = epoll_wait(cwc_io_epollfd, ev, 16, 1000);
+    pthread_mutex_lock(&cwc_mutex);
+
+    for(i = 0; i < n; i++) {
+      cwc = ev[i].data.ptr;
+
+      if(cwc == NULL) {
+	while(read(cwc_io_pipe[0], buf, sizeof(buf)) > 0)
+	  ;
+	continue;
+      }
+
+      if(cwc->cwc_io_error)
+	continue;
+
+      if(ev[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+	cwc_io_read(cwc);
+
+      if(!cwc->cwc_io_error && ev[i].events & EPOLLOUT)
+	cwc_io_write(cwc);
+    }
+  }
   return NULL;
 }
 
+/**
+ * Latency statistics, for statedump
+ */
+void
+cwc_io_dump(htsbuf_queue_t *hq)
+{
+  cwc_t *cwc;
+  int i;
+
+  pthread_mutex_lock(&cwc_mutex);
+  TAILQ_FOREACH(cwc, &cwcs, cwc_link) {
+    htsbuf_qprintf(hq, "%s:%d: %s  Writes: %"PRIu64"  Messages: %"PRIu64"\n",
+		   cwc->cwc_hostname, cwc->cwc_port,
+		   cwc->cwc_io_attached ? "active" : "inactive",
+		   cwc->cwc_io_writes, cwc->cwc_io_msgs);
+
+    if(cwc->cwc_ecm_replies == 0)
+      continue;
+
+    htsbuf_qprintf(hq, "  ECM replies: %u  Avg: %lld ms  Max: %lld ms\n  ",
+		   cwc->cwc_ecm_replies,
+		   cwc->cwc_ecm_total / cwc->cwc_ecm_replies,
+		   cwc->cwc_ecm_max);
+    for(i = 0; i < CWC_ECM_HIST_BUCKETS - 1; i++)
+      htsbuf_qprintf(hq, "<%d: %u  ", 25 << i, cwc->cwc_ecm_hist[i]);
+    htsbuf_qprintf(hq, ">=%d: %u\n", 25 << i, cwc->cwc_ecm_hist[i]);
+  }
+  pthread_mutex_unlock(&cwc_mutex);
+}
+
 
 
 /**
@@ -1026,7 +1727,6 @@ static void
 cwc_session(cwc_t *cwc)
 {
   int r;
-  pthread_t writer_thread_id;
 
   /**
    * Get login key
@@ -1077,33 +1777,17 @@ cwc_session(cwc_t *cwc)
   cwc->cwc_retry_delay = 0;
 
   /**
-   * We do all requests from now on in a separate thread
+   * The I/O thread serves the session from now on, wait for it to end
    */
-  cwc->cwc_writer_running = 1;
-  pthread_cond_init(&cwc->cwc_writer_cond, NULL);
-  pthread_mutex_init(&cwc->cwc_writer_mutex, NULL);
-  TAILQ_INIT(&cwc->cwc_writeq);
-  pthread_create(&writer_thread_id, NULL, cwc_writer_thread, cwc);
+  cwc_io_attach(cwc);
 
-  /**
-   * Mainloop
-   */
-  while(!cwc_must_break(cwc)) {
-
-    if((r = cwc_read_message(cwc, "Decoderloop", 
-			     CWC_KEEPALIVE_INTERVAL * 2 * 1000)) < 0)
-      break;
-    cwc_running_reply(cwc, cwc->cwc_buf[12], cwc->cwc_buf, r);
+  while(cwc->cwc_io_attached) {
+    if(cwc_must_break(cwc))
+      cwc_io_wakeup();
+    pthread_cond_wait(&cwc->cwc_cond, &cwc_mutex);
   }
-
-  /**
-   * Collect the writer thread
-   */
-  shutdown(cwc->cwc_fd, SHUT_RDWR);
-  cwc->cwc_writer_running = 0;
-  pthread_cond_signal(&cwc->cwc_writer_cond);
-  pthread_join(writer_thread_id, NULL);
-  tvhlog(LOG_DEBUG, "cwc", "Write thread joined");
+  tvhlog(LOG_DEBUG, "cwc", "%s:%i: Session ended",
+	 cwc->cwc_hostname, cwc->cwc_port);
 }
 
 
@@ -1202,6 +1886,7 @@ cwc_thread(void *aux)
   free((void *)cwc->cwc_password_salted);
   free((void *)cwc->cwc_username);
   free((void *)cwc->cwc_hostname);
+  cwc_emm_cache_flush(cwc);
   free(cwc);
 
   pthread_mutex_unlock(&cwc_mutex);
@@ -1230,25 +1915,268 @@ verify_provider(cwc_t *cwc, uint32_t providerid)
  *
  */
 static void
-cwc_emm_cache_insert(cwc_t *cwc, uint32_t crc)
+cwc_emm_cache_remove(cwc_t *cwc, emm_cache_entry_t *eme)
 {
-  /* evict the oldest entry */
-  cwc->cwc_emm_cache.cache[cwc->cwc_emm_cache.w] = crc;
-  cwc->cwc_emm_cache.w = (cwc->cwc_emm_cache.w+1)&EMM_CACHE_MASK;
-  if (cwc->cwc_emm_cache.n < EMM_CACHE_SIZE)
-    cwc->cwc_emm_cache.n++;
+  LIST_REMOVE(eme, eme_hash_link);
+  TAILQ_REMOVE(&cwc->cwc_emm_lru, eme, eme_lru_link);
+  cwc->cwc_emm_entries--;
+  free(eme);
 }
 
+static void
+cwc_emm_cache_flush(cwc_t *cwc)
+{
+  emm_cache_entry_t *eme;
+
+  while((eme = TAILQ_FIRST(&cwc->cwc_emm_lru)) != NULL)
+    cwc_emm_cache_remove(cwc, eme);
+}
+
+/**
+ * Returns 1 if the EMM was forwarded recently, otherwise remembers it.
+ * Least recently seen entries are evicted first.
+ */
 static int
-cwc_emm_cache_lookup(cwc_t *cwc, uint32_t crc)
+cwc_emm_cache_check(cwc_t *cwc, const uint8_t *data, int len)
+{
+  uint32_t crc = crc32((uint8_t *)data, len, 0xffffffff);
+  emm_cache_entry_t *eme;
+
+  LIST_FOREACH(eme, &cwc->cwc_emm_hash[crc % EMM_CACHE_HASH_SIZE],
+	       eme_hash_link)
+    if(eme->eme_crc == crc && eme->eme_len == len)
+      break;
+
+  if(eme != NULL && eme->eme_time + cwc->cwc_emm_dedup_ttl < dispatch_clock) {
+    cwc_emm_cache_remove(cwc, eme);
+    eme = NULL;
+  }
+
+  if(eme != NULL) {
+    TAILQ_REMOVE(&cwc->cwc_emm_lru, eme, eme_lru_link);
+    TAILQ_INSERT_TAIL(&cwc->cwc_emm_lru, eme, eme_lru_link);
+    return 1;
+  }
+
+  if(cwc->cwc_emm_entries >= EMM_CACHE_MAX_ENTRIES)
+    cwc_emm_cache_remove(cwc, TAILQ_FIRST(&cwc->cwc_emm_lru));
+
+  eme = malloc(sizeof(emm_cache_entry_t));
+  eme->eme_crc = crc;
+  eme->eme_len = len;
+  eme->eme_time = dispatch_clock;
+  LIST_INSERT_HEAD(&cwc->cwc_emm_hash[crc % EMM_CACHE_HASH_SIZE], eme,
+		   eme_hash_link);
+  TAILQ_INSERT_TAIL(&cwc->cwc_emm_lru, eme, eme_lru_link);
+  cwc->cwc_emm_entries++;
+  return 0;
+}
+
+/**
+ * Forward an EMM that matched the card, unless the card type suppresses
+ * duplicates and it was sent recently
+ */
+static void
+cwc_emm_send(cwc_t *cwc, const uint8_t *data, int len)
+{
+  if(cwc->cwc_emm_dedup_ttl && cwc_emm_cache_check(cwc, data, len)) {
+    cwc->cwc_emm_dups++;
+    return;
+  }
+
+  cwc->cwc_emm_forwarded++;
+  cwc_send_msg(cwc, data, len, 0, 1);
+}
+
+/**
+ * Add an address rule for table id 'tid' (0 = any), a NULL mask
+ * compares all bits. Table ids with more rules than fit are let through
+ * to the handler unfiltered.
+ */
+#define EMM_TID(x) (1 << ((x) - 0x80))
+
+static void
+cwc_emm_rule_add(cwc_t *cwc, uint8_t tid, int offset,
+		 const uint8_t *addr, const uint8_t *mask, int len)
 {
+  emm_rule_t *er;
   int i;
-  for (i=0; i<cwc->cwc_emm_cache.n; i++)
-    if (cwc->cwc_emm_cache.cache[i] == crc)
+
+  if(cwc->cwc_emm_nrules == EMM_RULES_MAX) {
+    cwc->cwc_emm_global |= tid ? EMM_TID(tid) : 0xffff;
+    return;
+  }
+
+  er = &cwc->cwc_emm_rules[cwc->cwc_emm_nrules++];
+  er->er_tid = tid;
+  er->er_offset = offset;
+  er->er_len = len;
+  for(i = 0; i < len; i++) {
+    er->er_mask[i] = mask ? mask[i] : 0xff;
+    er->er_data[i] = addr[i] & er->er_mask[i];
+  }
+}
+
+/**
+ * Derive the pre-filter from the card type, unique address and provider
+ * shared addresses. Each rule is a necessary condition for the card
+ * handler to forward the EMM, so nothing the handler would send is
+ * dropped here.
+ */
+static void
+cwc_emm_filter_setup(cwc_t *cwc)
+{
+  const uint8_t *ua = cwc->cwc_ua;
+  const cwc_provider_t *p = cwc->cwc_providers;
+  int np = cwc->cwc_num_providers;
+  uint8_t a[3], m;
+  int i;
+
+  cwc->cwc_emm_tids = 0;
+  cwc->cwc_emm_global = 0;
+  cwc->cwc_emm_nrules = 0;
+  cwc->cwc_emm_dedup_ttl = 0;
+
+  switch(cwc->cwc_card_type) {
+  case CARD_CONAX:
+    cwc->cwc_emm_tids = EMM_TID(0x82);
+    for(i = 0; i < np; i++)
+      cwc_emm_rule_add(cwc, 0x82, 3, &p[i].sa[1], NULL, 7);
+    break;
+
+  case CARD_IRDETO:
+    /* Any table id, mode byte is the card or a provider address */
+    cwc->cwc_emm_tids = 0xfffc;
+    m = 0xf8;
+    a[0] = ua[4] << 3;
+    cwc_emm_rule_add(cwc, 0, 3, a, &m, 1);
+    for(i = 0; i < np; i++) {
+      a[0] = p[i].sa[4] << 3;
+      cwc_emm_rule_add(cwc, 0, 3, a, &m, 1);
+    }
+    break;
+
+  case CARD_SECA:
+    cwc->cwc_emm_tids = EMM_TID(0x82) | EMM_TID(0x84);
+    cwc_emm_rule_add(cwc, 0x82, 3, &ua[2], NULL, 6);
+    for(i = 0; i < np; i++)
+      cwc_emm_rule_add(cwc, 0x84, 5, &p[i].sa[5], NULL, 3);
+    break;
+
+  case CARD_VIACCESS:
+    /* Provider id of the shared part is in a nano, the handler checks it */
+    cwc->cwc_emm_tids = EMM_TID(0x8c) | EMM_TID(0x8d) | EMM_TID(0x8e);
+    cwc->cwc_emm_global = EMM_TID(0x8c) | EMM_TID(0x8d);
+    for(i = 0; i < np; i++)
+      cwc_emm_rule_add(cwc, 0x8e, 3, &p[i].sa[4], NULL, 3);
+    cwc->cwc_emm_dedup_ttl = EMM_DEDUP_VIACCESS;
+    break;
+
+  case CARD_DRE:
+    cwc->cwc_emm_tids = EMM_TID(0x86) | EMM_TID(0x87);
+    cwc_emm_rule_add(cwc, 0x87, 3, &ua[4], NULL, 4);
+    for(i = 0; i < np; i++)
+      cwc_emm_rule_add(cwc, 0x86, 40, &p[i].sa[4], NULL, 4);
+    break;
+
+  case CARD_NAGRA:
+    cwc->cwc_emm_tids = EMM_TID(0x82) | EMM_TID(0x83);
+    cwc->cwc_emm_global = EMM_TID(0x82);
+    /* Serial is byte reversed */
+    a[0] = ua[6];
+    a[1] = ua[5];
+    a[2] = ua[4];
+    cwc_emm_rule_add(cwc, 0x83, 3, a, NULL, 3);
+    break;
+
+  case CARD_NDS:
+    /* Any table id, global type or our serial in one of four slots */
+    cwc->cwc_emm_tids = 0xfffc;
+    m = 0xc0;
+    a[0] = 0;
+    cwc_emm_rule_add(cwc, 0, 3, a, &m, 1);
+    for(i = 0; i < 4; i++)
+      cwc_emm_rule_add(cwc, 0, i * 4 + 4, &ua[4], NULL, 3);
+    break;
+
+  case CARD_CRYPTOWORKS:
+    cwc->cwc_emm_tids = EMM_TID(0x82) | EMM_TID(0x84) | EMM_TID(0x86) |
+      EMM_TID(0x88) | EMM_TID(0x89);
+    cwc->cwc_emm_global = EMM_TID(0x86) | EMM_TID(0x88) | EMM_TID(0x89);
+    cwc_emm_rule_add(cwc, 0x82, 5, &ua[3], NULL, 5);
+    cwc_emm_rule_add(cwc, 0x84, 5, &ua[3], NULL, 4);
+    break;
+
+  case CARD_BULCRYPT:
+    cwc->cwc_emm_tids = EMM_TID(0x82) | EMM_TID(0x84) | EMM_TID(0x85) |
+      EMM_TID(0x8a) | EMM_TID(0x8b);
+    cwc_emm_rule_add(cwc, 0x82, 3, &ua[2], NULL, 3);
+    cwc_emm_rule_add(cwc, 0x85, 3, &ua[2], NULL, 3);
+    cwc_emm_rule_add(cwc, 0x84, 3, &ua[2], NULL, 2);
+    cwc_emm_rule_add(cwc, 0x8b, 4, &ua[2], NULL, 2);
+    cwc_emm_rule_add(cwc, 0x8a, 4, &ua[2], NULL, 1);
+    break;
+
+  case CARD_UNKNOWN:
+    break;
+  }
+}
+
+/**
+ * Returns 1 if the EMM may be addressed to this card
+ */
+static int
+cwc_emm_addressed(cwc_t *cwc, const uint8_t *data, int len)
+{
+  const emm_rule_t *er;
+  int i, j;
+
+  if(cwc->cwc_emm_global & EMM_TID(data[0]))
+    return 1;
+
+  for(i = 0; i < cwc->cwc_emm_nrules; i++) {
+    er = &cwc->cwc_emm_rules[i];
+    if((er->er_tid && er->er_tid != data[0]) ||
+       er->er_offset + er->er_len > len)
+      continue;
+    for(j = 0; j < er->er_len; j++)
+      if((data[er->er_offset + j] & er->er_mask[j]) != er->er_data[j])
+	break;
+    if(j == er->er_len)
       return 1;
+  }
   return 0;
 }
 
+/**
+ * EMM statistics per connection, for statedump
+ */
+void
+cwc_emm_dump(htsbuf_queue_t *hq)
+{
+  cwc_t *cwc;
+  time_t t;
+
+  pthread_mutex_lock(&cwc_mutex);
+  TAILQ_FOREACH(cwc, &cwcs, cwc_link) {
+    if(!cwc->cwc_forward_emm)
+      continue;
+    t = MAX(dispatch_clock - cwc->cwc_emm_since, 1);
+    htsbuf_qprintf(hq, "%s:%d: Seen: %"PRIu64"  Filtered: %"PRIu64
+		   " (%"PRIu64"/s)  Unaddressed: %"PRIu64
+		   "  Duplicates: %"PRIu64
+		   "  Forwarded: %"PRIu64" (%"PRIu64"/s)  Cached: %d\n",
+		   cwc->cwc_hostname, cwc->cwc_port,
+		   cwc->cwc_emm_seen,
+		   cwc->cwc_emm_filtered, cwc->cwc_emm_filtered / t,
+		   cwc->cwc_emm_unaddressed,
+		   cwc->cwc_emm_dups,
+		   cwc->cwc_emm_forwarded, cwc->cwc_emm_forwarded / t,
+		   cwc->cwc_emm_entries);
+  }
+  pthread_mutex_unlock(&cwc_mutex);
+}
+
 
 /**
  *
@@ -1272,6 +2200,16 @@ cwc_emm(uint8_t *data, int len, uint16_t caid, void *ca_update_id)
         cwc->cwc_update_time = getmonoclock();
       }
       cwc->cwc_update_id = ca_update_id;
+      cwc->cwc_emm_seen++;
+      if(len < 3 || data[0] < 0x80 || data[0] > 0x8f ||
+	 !(cwc->cwc_emm_tids & EMM_TID(data[0]))) {
+	cwc->cwc_emm_filtered++;
+	continue;
+      }
+      if(!cwc_emm_addressed(cwc, data, len)) {
+	cwc->cwc_emm_unaddressed++;
+	continue;
+      }
       switch (cwc->cwc_card_type) {
       case CARD_CONAX:
 	cwc_emm_conax(cwc, data, len);
@@ -1319,7 +2257,7 @@ cwc_emm_conax(cwc_t *cwc, uint8_t *data, int len)
     int i;
     for (i=0; i < cwc->cwc_num_providers; i++) {
       if (memcmp(&data[3], &cwc->cwc_providers[i].sa[1], 7) == 0) {
-        cwc_send_msg(cwc, data, len, 0, 1);
+        cwc_emm_send(cwc, data, len);
         break;
       }
     }
@@ -1356,7 +2294,7 @@ cwc_emm_irdeto(cwc_t *cwc, uint8_t *data, int len)
   }
   
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 
@@ -1386,7 +2324,7 @@ cwc_emm_seca(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 /**
@@ -1534,8 +2472,6 @@ cwc_emm_viaccess(cwc_t *cwc, uint8_t *data, int mlen)
 
 	ass = (uint8_t*) alloca(len+7);
 	if(ass) {
-	  uint32_t crc;
-
 	  memcpy(ass, data, 7);
 	  if (sort_nanos(ass + 7, tmp, len)) {
 	    return;
@@ -1547,18 +2483,14 @@ cwc_emm_viaccess(cwc_t *cwc, uint8_t *data, int mlen)
 	  ass[2] = len & 0xff;
 	  len += 3;
 
-	  crc = crc32(ass, len, 0xffffffff);
-	  if (!cwc_emm_cache_lookup(cwc, crc)) {
-	    tvhlog(LOG_DEBUG, "cwc",
-		   "Send EMM "
-		   "%02x.%02x.%02x.%02x.%02x.%02x.%02x.%02x"
-		   "...%02x.%02x.%02x.%02x",
-		   ass[0], ass[1], ass[2], ass[3],
-		   ass[4], ass[5], ass[6], ass[7],
-		   ass[len-4], ass[len-3], ass[len-2], ass[len-1]);
-	    cwc_send_msg(cwc, ass, len, 0, 1);
-	    cwc_emm_cache_insert(cwc, crc);
-	  }
+	  tvhlog(LOG_DEBUG, "cwc",
+		 "Send EMM "
+		 "%02x.%02x.%02x.%02x.%02x.%02x.%02x.%02x"
+		 "...%02x.%02x.%02x.%02x",
+		 ass[0], ass[1], ass[2], ass[3],
+		 ass[4], ass[5], ass[6], ass[7],
+		 ass[len-4], ass[len-3], ass[len-2], ass[len-1]);
+	  cwc_emm_send(cwc, ass, len);
 	}
       }
       break;
@@ -1581,6 +2513,8 @@ cwc_table_input(struct th_descrambler *td, struct service *t,
   ecm_section_t *es;
   char chaninfo[32];
   caid_t *c;
+  uint8_t cw[16];
+  int64_t now;
 
   if (ct->cs_keystate == CS_IDLE)
     return;
@@ -1642,14 +2576,47 @@ cwc_table_input(struct th_descrambler *td, struct service *t,
     if(es->es_ecmsize == len && !memcmp(es->es_ecm, data, len))
       break; /* key already sent */
 
+    now = getmonoclock();
+    if(es->es_changed)
+      es->es_period = now - es->es_changed;
+    es->es_changed = now;
+
+    if(ecm_cache_lookup(cwc->cwc_caid, c->providerid, data, len, cw) == 0) {
+      es->es_channel = channel;
+      es->es_section = section;
+      es->es_provider = c->providerid;
+      es->es_pending = 0;
+      es->es_nok = 0;
+      memcpy(es->es_ecm, data, len);
+      es->es_ecmsize = len;
+
+      tvhlog(LOG_DEBUG, "cwc",
+	     "ECM%s section=%d/%d, for service %s found in cache",
+	     chaninfo, section, ep->ep_last_section, t->s_svcname);
+
+      if(ct->cs_keystate != CS_RESOLVED)
+	tvhlog(LOG_INFO, "cwc",
+	       "Obtained key for service \"%s\" from ECM cache",
+	       t->s_svcname);
+
+      cwc_new_cw(ct, cw);
+      ct->cs_keystate = CS_RESOLVED;
+      break;
+    }
+
     if(cwc->cwc_fd == -1) {
-      // New key, but we are not connected (anymore), can not descramble
-      ct->cs_keystate = CS_UNKNOWN;
+      // New key, but we are not connected (anymore). The current keys
+      // are good until the next parity change
+      if(ct->cs_keystate == CS_RESOLVED)
+	ct->cs_ecm_unsent = 1;
+      else
+	ct->cs_keystate = CS_UNKNOWN;
       break;
     }
 
     es->es_channel = channel;
     es->es_section = section;
+    es->es_provider = c->providerid;
     es->es_pending = 1;
 
     memcpy(es->es_ecm, data, len);
@@ -1703,7 +2670,7 @@ cwc_emm_dre(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 void
@@ -1725,7 +2692,7 @@ cwc_emm_nagra(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 void
@@ -1749,7 +2716,7 @@ cwc_emm_nds(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 void
@@ -1791,7 +2758,7 @@ cwc_emm_cryptoworks(cwc_t *cwc, uint8_t *data, int len)
         sort_nanos(composed + 12, tmp, elen);
         composed[1] = ((elen + 9) >> 8) | 0x70;
         composed[2] = (elen + 9) & 0xff;
-        cwc_send_msg(cwc, composed, elen + 12, 0, 1);
+        cwc_emm_send(cwc, composed, elen + 12);
         free(composed);
         free(tmp);
       }
@@ -1808,7 +2775,7 @@ cwc_emm_cryptoworks(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 void
@@ -1833,28 +2800,20 @@ cwc_emm_bulcrypt(cwc_t *cwc, uint8_t *data, int len)
   }
 
   if (match)
-    cwc_send_msg(cwc, data, len, 0, 1);
+    cwc_emm_send(cwc, data, len);
 }
 
 /**
+ * Hand new control words to the CSA, they are picked up by next cluster
  *
+ * mask: 0x1 = even, 0x2 = odd
  */
 static void
-update_keys(cwc_service_t *ct)
+update_keys(cwc_service_t *ct, int mask)
 {
-  int i;
-  ct->cs_pending_cw_update = 0;
-  for(i = 0; i < 8; i++)
-    if(ct->cs_cw[i]) {
-      set_even_control_word(ct->cs_keys, ct->cs_cw);
-      break;
-    }
-  
-  for(i = 0; i < 8; i++)
-    if(ct->cs_cw[8 + i]) {
-      set_odd_control_word(ct->cs_keys, ct->cs_cw + 8);
-      break;
-    }
+  csa_set_control_words(ct->cs_csa,
+			mask & 0x1 ? ct->cs_cw     : NULL,
+			mask & 0x2 ? ct->cs_cw + 8 : NULL);
 }
 
 
@@ -1863,11 +2822,13 @@ update_keys(cwc_service_t *ct)
  */
 static int
 cwc_descramble(th_descrambler_t *td, service_t *t, struct elementary_stream *st,
-	       const uint8_t *tsb)
+	       const uint8_t *tsb, tsbuf_t *tb)
 {
   cwc_service_t *ct = (cwc_service_t *)td;
-  int r;
-  unsigned char *vec[3];
+  int parity = tsb[3] & 0xc0;
+
+  if(parity & 0x80 && parity != ct->cs_parity)
+    cwc_parity_change(ct, parity);
 
   if(ct->cs_keystate == CS_FORBIDDEN)
     return 1;
@@ -1875,49 +2836,19 @@ cwc_descramble(th_descrambler_t *td, service_t *t, struct elementary_stream *st,
   if(ct->cs_keystate != CS_RESOLVED)
     return -1;
 
-  if(ct->cs_fill == 0 && ct->cs_pending_cw_update)
-    update_keys(ct);
-
-  memcpy(ct->cs_tsbcluster + ct->cs_fill * 188, tsb, 188);
-  ct->cs_fill++;
-
-  if(ct->cs_fill != ct->cs_cluster_size)
-    return 0;
-
-  while(1) {
-
-    vec[0] = ct->cs_tsbcluster;
-    vec[1] = ct->cs_tsbcluster + ct->cs_fill * 188;
-    vec[2] = NULL;
-    
-    r = decrypt_packets(ct->cs_keys, vec);
-    if(r > 0) {
-      int i;
-      const uint8_t *t0 = ct->cs_tsbcluster;
-
-      for(i = 0; i < r; i++) {
-	ts_recv_packet2(t, t0);
-	t0 += 188;
-      }
-
-      r = ct->cs_fill - r;
-      assert(r >= 0);
-
-      if(r > 0)
-	memmove(ct->cs_tsbcluster, t0, r * 188);
-      ct->cs_fill = r;
+  csa_descramble(ct->cs_csa, tsb, tb);
+  return 0;
+}
 
-      if(ct->cs_pending_cw_update && r > 0)
-	continue;
-    } else {
-      ct->cs_fill = 0;
-    }
-    break;
-  }
-  if(ct->cs_pending_cw_update)
-    update_keys(ct);
+/**
+ * s_stream_mutex is held
+ */
+static void
+cwc_flush(th_descrambler_t *td)
+{
+  cwc_service_t *ct = (cwc_service_t *)td;
 
-  return 0;
+  csa_flush(ct->cs_csa);
 }
 
 /**
@@ -1942,8 +2873,7 @@ cwc_service_destroy(th_descrambler_t *td)
 
   LIST_REMOVE(ct, cs_link);
 
-  free_key_struct(ct->cs_keys);
-  free(ct->cs_tsbcluster);
+  csa_destroy(ct->cs_csa);
   free(ct);
 }
 
@@ -1987,10 +2917,7 @@ cwc_service_start(service_t *t)
       continue;
 
     ct = calloc(1, sizeof(cwc_service_t));
-    ct->cs_cluster_size = get_suggested_cluster_size();
-    ct->cs_tsbcluster = malloc(ct->cs_cluster_size * 188);
-
-    ct->cs_keys = get_key_struct();
+    ct->cs_csa = csa_create(t);
     ct->cs_cwc = cwc;
     ct->cs_service = t;
     ct->cs_okchannel = -1;
@@ -1999,6 +2926,7 @@ cwc_service_start(service_t *t)
     td->td_stop       = cwc_service_destroy;
     td->td_table      = cwc_table_input;
     td->td_descramble = cwc_descramble;
+    td->td_flush      = cwc_flush;
     LIST_INSERT_HEAD(&t->s_descramblers, td, td_service_link);
 
     LIST_INSERT_HEAD(&cwc->cwc_services, ct, cs_link);
@@ -2057,6 +2985,9 @@ cwc_entry_find(const char *id, int create)
   pthread_cond_init(&cwc->cwc_cond, NULL);
   cwc->cwc_id = strdup(id); 
   cwc->cwc_running = 1;
+  pthread_mutex_init(&cwc->cwc_writer_mutex, NULL);
+  TAILQ_INIT(&cwc->cwc_writeq);
+  TAILQ_INIT(&cwc->cwc_emm_lru);
   TAILQ_INSERT_TAIL(&cwcs, cwc, cwc_link);  
 
   pthread_attr_init(&attr);
@@ -2295,11 +3226,30 @@ void
 cwc_init(void)
 {
   dtable_t *dt;
+  struct epoll_event ev;
+  pthread_t tid;
 
   TAILQ_INIT(&cwcs);
   pthread_mutex_init(&cwc_mutex, NULL);
+  pthread_mutex_init(&ecm_cache_mutex, NULL);
+  TAILQ_INIT(&ecm_cache_age);
   pthread_cond_init(&cwc_config_changed, NULL);
 
+  LIST_INIT(&cwc_io_sessions);
+  cwc_io_epollfd = epoll_create(10);
+  if(pipe(cwc_io_pipe) == -1) {
+    tvhlog(LOG_ERR, "cwc", "Unable to create I/O thread pipe: %s",
+	   strerror(errno));
+  } else {
+    memset(&ev, 0, sizeof(ev));
+    fcntl(cwc_io_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(cwc_io_pipe[1], F_SETFL, O_NONBLOCK);
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    epoll_ctl(cwc_io_epollfd, EPOLL_CTL_ADD, cwc_io_pipe[0], &ev);
+  }
+  pthread_create(&tid, NULL, cwc_io_thread, NULL);
+
   dt = dtable_create(&cwc_dtc, "cwc", NULL);
   dtable_load(dt);
 }
@@ -19,10 +19,20 @@
 #ifndef CWC_H_
 #define CWC_H_
 
+#include "htsbuf.h"
+
 void cwc_init(void);
 
 void cwc_service_start(struct service *t);
 
 void cwc_emm(uint8_t *data, int len, uint16_t caid, void *ca_update_id);
 
+void cwc_ecm_cache_dump(htsbuf_queue_t *hq);
+
+void cwc_key_timing_dump(htsbuf_queue_t *hq);
+
+void cwc_emm_dump(htsbuf_queue_t *hq);
+
+void cwc_io_dump(htsbuf_queue_t *hq);
+
 #endif /* CWC_H_ */
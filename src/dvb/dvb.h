@@ -22,6 +22,7 @@
 #include <linux/dvb/version.h>
 #include <linux/dvb/frontend.h>
 #include "htsmsg.h"
+#include "tsdemux.h"
 
 
 TAILQ_HEAD(th_dvb_adapter_queue, th_dvb_adapter);
@@ -184,6 +185,7 @@ typedef struct th_dvb_adapter {
 
   pthread_mutex_t tda_delivery_mutex;
   struct service_list tda_transports; /* Currently bound transports */
+  tsbuf_pool_t tda_tsbufs;
 
   gtimer_t tda_fe_monitor_timer;
   int tda_fe_monitor_hold;
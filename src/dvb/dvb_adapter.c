@@ -55,6 +55,7 @@ tda_alloc(void)
 {
   th_dvb_adapter_t *tda = calloc(1, sizeof(th_dvb_adapter_t));
   pthread_mutex_init(&tda->tda_delivery_mutex, NULL);
+  tsbuf_pool_init(&tda->tda_tsbufs, 10);
 
   TAILQ_INIT(&tda->tda_scan_queues[0]);
   TAILQ_INIT(&tda->tda_scan_queues[1]);
@@ -538,7 +539,8 @@ dvb_adapter_input_dvr(void *aux)
 {
   th_dvb_adapter_t *tda = aux;
   int fd, i, r;
-  uint8_t tsb[188 * 10];
+  uint8_t *tsb;
+  tsbuf_t *tb;
   service_t *t;
 
   fd = tvh_open(tda->tda_dvr_path, O_RDONLY, 0);
@@ -549,17 +551,19 @@ dvb_adapter_input_dvr(void *aux)
 
 
   while(1) {
-    r = read(fd, tsb, sizeof(tsb));
+    /**
+     * Descramblers may still hold on to earlier buffers, packets
+     * are decrypted in place and delivered later on
+     */
+    tb = tsbuf_pool_get(&tda->tda_tsbufs);
+    tsb = tb->tb_data;
+
+    r = read(fd, tsb, tb->tb_npkts * 188);
 
     pthread_mutex_lock(&tda->tda_delivery_mutex);
-    
-    for(i = 0; i < r; i += 188) {
-      LIST_FOREACH(t, &tda->tda_transports, s_active_link)
-	if(t->s_dvb_mux_instance == tda->tda_mux_current)
-	  ts_recv_packet1(t, tsb + i, NULL);
-    }
 
-    if(tda->tda_dump_fd != -1) {
+    /* Dump the raw mux, before packets get decrypted in place */
+    if(tda->tda_dump_fd != -1 && r > 0) {
       if(write(tda->tda_dump_fd, tsb, r) != r) {
 	tvhlog(LOG_ERR, "dvb",
 	       "\"%s\" unable to write to mux dump file -- %s",
@@ -569,8 +573,19 @@ dvb_adapter_input_dvr(void *aux)
 	tda->tda_dump_fd = -1;
        }
     }
+    
+    for(i = 0; i < r; i += 188) {
+      LIST_FOREACH(t, &tda->tda_transports, s_active_link)
+	if(t->s_dvb_mux_instance == tda->tda_mux_current)
+	  ts_recv_packet1(t, tsb + i, NULL, tb);
+    }
+
+    LIST_FOREACH(t, &tda->tda_transports, s_active_link)
+      if(t->s_dvb_mux_instance == tda->tda_mux_current)
+	ts_recv_flush(t);
 
     pthread_mutex_unlock(&tda->tda_delivery_mutex);
+    tsbuf_ref_dec(tb);
   }
 }
 
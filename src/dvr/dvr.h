@@ -171,10 +171,36 @@ typedef struct dvr_entry {
    */
 
   struct mk_mux *de_mkmux;
+  struct dvr_live *de_live;
 
 } dvr_entry_t;
 
 
+/**
+ * HTTP connection parked on a recording in progress
+ */
+typedef struct dvr_live_reader {
+  LIST_ENTRY(dvr_live_reader) dlr_link;
+  struct http_connection *dlr_hc;
+} dvr_live_reader_t;
+
+
+/**
+ * Recording in progress, lets readers follow the file as it grows.
+ * Readers hold a reference and check dl_size, it is updated whenever
+ * more of the file has been written. Readers that follow the file are
+ * woken up when that happens.
+ */
+typedef struct dvr_live {
+  LIST_ENTRY(dvr_live) dl_link;
+  int dl_refcount;
+  int dl_id;            /* dvr_entry id */
+  off_t dl_size;        /* Written so far, always ends with a cluster */
+  int dl_done;          /* Recording finished, dl_size is final */
+  LIST_HEAD(, dvr_live_reader) dl_readers;
+} dvr_live_t;
+
+
 /**
  * Autorec entry
  */
@@ -264,6 +290,18 @@ dvr_entry_t *dvr_entry_find_by_event_fuzzy(event_t *e);
 
 off_t dvr_get_filesize(dvr_entry_t *de);
 
+dvr_live_t *dvr_live_find(int id);
+
+off_t dvr_live_size(dvr_live_t *dl, int *done);
+
+void dvr_live_follow(dvr_live_t *dl, dvr_live_reader_t *dlr);
+
+void dvr_live_unfollow(dvr_live_t *dl, dvr_live_reader_t *dlr);
+
+void dvr_live_release(dvr_live_t *dl);
+
+void dvr_live_dump(htsbuf_queue_t *hq);
+
 dvr_entry_t *dvr_entry_cancel(dvr_entry_t *de);
 
 void dvr_entry_dec_ref(dvr_entry_t *de);
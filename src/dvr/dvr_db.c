@@ -245,6 +245,7 @@ dvr_entry_link(dvr_entry_t *de)
     gtimer_arm_abs(&de->de_timer, dvr_timer_start_recording, de, preamble);
   }
   htsp_dvr_entry_add(de);
+  epg_snapshot_invalidate(de->de_channel);
 }
 
 
@@ -415,6 +416,7 @@ dvr_entry_remove(dvr_entry_t *de)
   hts_settings_remove("dvr/log/%d", de->de_id);
 
   htsp_dvr_entry_delete(de);
+  epg_snapshot_invalidate(de->de_channel);
 
   gtimer_disarm(&de->de_timer);
 
@@ -624,6 +626,7 @@ dvr_entry_update(dvr_entry_t *de, const char* de_title, int de_start, int de_sto
 
   dvr_entry_save(de);
   htsp_dvr_entry_update(de);
+  epg_snapshot_invalidate(de->de_channel);
   dvr_entry_notify(de);
 
   tvhlog(LOG_INFO, "dvr", "\"%s\" on \"%s\": Updated Timer", de->de_title, de->de_channel->ch_name);
@@ -670,6 +673,7 @@ dvr_stop_recording(dvr_entry_t *de, int stopcode)
 
   dvr_entry_save(de);
   htsp_dvr_entry_update(de);
+  epg_snapshot_invalidate(de->de_channel);
   dvr_entry_notify(de);
 
   gtimer_arm_abs(&de->de_timer, dvr_timer_expire, de, 
@@ -705,6 +709,7 @@ dvr_timer_start_recording(void *aux)
 
   dvr_entry_notify(de);
   htsp_dvr_entry_update(de);
+  epg_snapshot_invalidate(de->de_channel);
   dvr_rec_subscribe(de);
 
   gtimer_arm_abs(&de->de_timer, dvr_timer_stop_recording, de, 
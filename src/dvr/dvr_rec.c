@@ -32,6 +32,7 @@
 #include "service.h"
 #include "plumbing/tsfix.h"
 #include "plumbing/globalheaders.h"
+#include "http.h"
 
 #include "mkmux.h"
 
@@ -41,6 +42,10 @@
 static void *dvr_thread(void *aux);
 static void dvr_spawn_postproc(dvr_entry_t *de, const char *dvr_postproc);
 static void dvr_thread_epilog(dvr_entry_t *de);
+static void dvr_live_stop(dvr_entry_t *de);
+
+static pthread_mutex_t dvr_live_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LIST_HEAD(, dvr_live) dvr_lives;
 
 
 const static int prio2weight[5] = {
@@ -294,6 +299,179 @@ dvr_rec_set_state(dvr_entry_t *de, dvr_rs_state_t newstate, int error)
   dvr_entry_notify(de);
 }
 
+/**
+ * File of the recording has been created
+ */
+static void
+dvr_live_start(dvr_entry_t *de)
+{
+  dvr_live_t *dl;
+
+  if(de->de_live != NULL)
+    dvr_live_stop(de); /* Restarted, the file was truncated */
+
+  dl = calloc(1, sizeof(dvr_live_t));
+  dl->dl_refcount = 1;
+  dl->dl_id = de->de_id;
+  dl->dl_size = mk_mux_size(de->de_mkmux);
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  LIST_INSERT_HEAD(&dvr_lives, dl, dl_link);
+  pthread_mutex_unlock(&dvr_live_mutex);
+  de->de_live = dl;
+}
+
+/**
+ * Have the readers pick up what has been written. dvr_live_mutex is held
+ */
+static void
+dvr_live_wakeup(dvr_live_t *dl)
+{
+  dvr_live_reader_t *dlr;
+
+  LIST_FOREACH(dlr, &dl->dl_readers, dlr_link)
+    http_wakeup(dlr->dlr_hc);
+}
+
+/**
+ * Let readers know if another cluster made it to the file
+ */
+static void
+dvr_live_update(dvr_entry_t *de)
+{
+  dvr_live_t *dl = de->de_live;
+  off_t size;
+
+  if(dl == NULL)
+    return;
+
+  size = mk_mux_size(de->de_mkmux);
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  if(size != dl->dl_size) {
+    dl->dl_size = size;
+    dvr_live_wakeup(dl);
+  }
+  pthread_mutex_unlock(&dvr_live_mutex);
+}
+
+/**
+ * The file is complete, called after mk_mux_close()
+ */
+static void
+dvr_live_stop(dvr_entry_t *de)
+{
+  dvr_live_t *dl = de->de_live;
+  off_t size;
+
+  if(dl == NULL)
+    return;
+
+  de->de_live = NULL;
+  size = dvr_get_filesize(de);
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  if(size > dl->dl_size)
+    dl->dl_size = size; /* Cues */
+  dl->dl_done = 1;
+  LIST_REMOVE(dl, dl_link);
+  dvr_live_wakeup(dl);
+  pthread_mutex_unlock(&dvr_live_mutex);
+
+  dvr_live_release(dl);
+}
+
+/**
+ * Returns the recording with id 'id' if it is being written
+ */
+dvr_live_t *
+dvr_live_find(int id)
+{
+  dvr_live_t *dl;
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  LIST_FOREACH(dl, &dvr_lives, dl_link)
+    if(dl->dl_id == id)
+      break;
+  if(dl != NULL)
+    dl->dl_refcount++;
+  pthread_mutex_unlock(&dvr_live_mutex);
+  return dl;
+}
+
+/**
+ * Returns number of bytes that can be read, '*done' is set once the
+ * recording is finished
+ */
+off_t
+dvr_live_size(dvr_live_t *dl, int *done)
+{
+  off_t size;
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  size = dl->dl_size;
+  *done = dl->dl_done;
+  pthread_mutex_unlock(&dvr_live_mutex);
+  return size;
+}
+
+/**
+ * Wake up the reader's connection as the file grows and once the
+ * recording is done
+ */
+void
+dvr_live_follow(dvr_live_t *dl, dvr_live_reader_t *dlr)
+{
+  pthread_mutex_lock(&dvr_live_mutex);
+  LIST_INSERT_HEAD(&dl->dl_readers, dlr, dlr_link);
+  pthread_mutex_unlock(&dvr_live_mutex);
+}
+
+/**
+ *
+ */
+void
+dvr_live_unfollow(dvr_live_t *dl, dvr_live_reader_t *dlr)
+{
+  pthread_mutex_lock(&dvr_live_mutex);
+  LIST_REMOVE(dlr, dlr_link);
+  pthread_mutex_unlock(&dvr_live_mutex);
+}
+
+/**
+ * Reader is done
+ */
+void
+dvr_live_release(dvr_live_t *dl)
+{
+  int r;
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  r = --dl->dl_refcount;
+  pthread_mutex_unlock(&dvr_live_mutex);
+
+  if(r > 0)
+    return;
+
+  free(dl);
+}
+
+/**
+ *
+ */
+void
+dvr_live_dump(htsbuf_queue_t *hq)
+{
+  dvr_live_t *dl;
+
+  pthread_mutex_lock(&dvr_live_mutex);
+  LIST_FOREACH(dl, &dvr_lives, dl_link)
+    htsbuf_qprintf(hq, "Recording %d: %"PRId64" bytes written, "
+		   "%d readers following\n",
+		   dl->dl_id, (int64_t)dl->dl_size, dl->dl_refcount - 1);
+  pthread_mutex_unlock(&dvr_live_mutex);
+}
+
 /**
  *
  */
@@ -318,6 +496,8 @@ dvr_rec_start(dvr_entry_t *de, const streaming_start_t *ss)
     return;
   }
 
+  dvr_live_start(de);
+
   tvhlog(LOG_INFO, "dvr", "%s from "
 	 "adapter: \"%s\", "
 	 "network: \"%s\", mux: \"%s\", provider: \"%s\", "
@@ -409,6 +589,7 @@ dvr_thread(void *aux)
 	if(de->de_mkmux != NULL) {
 	  mk_mux_write_pkt(de->de_mkmux, sm->sm_data);
 	  sm->sm_data = NULL;
+	  dvr_live_update(de);
 	}
       }
       break;
@@ -483,6 +664,7 @@ dvr_thread(void *aux)
       break;
 
     case SMT_MPEGTS:
+    case SMT_SKIP:
       break;
 
     case SMT_EXIT:
@@ -494,6 +676,9 @@ dvr_thread(void *aux)
     pthread_mutex_lock(&sq->sq_mutex);
   }
   pthread_mutex_unlock(&sq->sq_mutex);
+
+  /* Don't leave readers waiting for a file that won't grow */
+  dvr_live_stop(de);
   return NULL;
 }
 
@@ -560,6 +745,8 @@ dvr_thread_epilog(dvr_entry_t *de)
     de->de_mkmux = NULL;
   }
 
+  dvr_live_stop(de);
+
   dvr_config_t *cfg = dvr_config_find_by_name_default(de->de_config_name);
   if(cfg->dvr_postproc)
     dvr_spawn_postproc(de,cfg->dvr_postproc);
@@ -66,6 +66,9 @@ struct mk_cue {
  */
 struct mk_mux {
   int fd;
+  mk_mux_output_t *output;
+  void *opaque;
+  int outflags;
   char *filename;
   int error;
   off_t fdpos; // Current position in file
@@ -81,6 +84,7 @@ struct mk_mux {
   int64_t cluster_tc;
   off_t cluster_pos;
   int cluster_maxsize;
+  int cluster_sync;
 
   off_t segment_header_pos;
 
@@ -352,7 +356,10 @@ mk_write_to_fd(mk_mux_t *mkm, htsbuf_queue_t *hq)
 static void
 mk_write_queue(mk_mux_t *mkm, htsbuf_queue_t *q)
 {
-  if(!mkm->error)
+  if(mkm->output != NULL) {
+    mkm->fdpos += q->hq_size;
+    mkm->output(mkm->opaque, q, mkm->outflags);
+  } else if(!mkm->error)
     mk_write_to_fd(mkm, q);
 
   htsbuf_queue_flush(q);
@@ -722,9 +729,9 @@ mk_mux_create(const char *filename,
   return mkm;
 }
 
-mk_mux_t *
-mk_mux_stream_create(int fd, const struct streaming_start *ss,
-		     const channel_t *ch)
+static mk_mux_t *
+mk_mux_live_create(int fd, mk_mux_output_t *output, void *opaque,
+		   const struct streaming_start *ss, const channel_t *ch)
 {
   mk_mux_t *mkm;
   htsbuf_queue_t q;
@@ -733,6 +740,8 @@ mk_mux_stream_create(int fd, const struct streaming_start *ss,
   getuuid(mkm->uuid);
   mkm->filename = strdup("Live stream");
   mkm->fd = fd;
+  mkm->output = output;
+  mkm->opaque = opaque;
   mkm->cluster_maxsize = 0;
 
   if(ch && ch->ch_name)
@@ -748,11 +757,33 @@ mk_mux_stream_create(int fd, const struct streaming_start *ss,
   htsbuf_appendq(&q, mk_build_segment_header(0));
   htsbuf_appendq(&q, mk_build_segment(mkm, ss));
  
+  mkm->outflags = MK_OUTPUT_HEADER;
   mk_write_queue(mkm, &q);
+  mkm->outflags = 0;
 
   return mkm;
 }
 
+mk_mux_t *
+mk_mux_stream_create(int fd, const struct streaming_start *ss,
+		     const channel_t *ch)
+{
+  return mk_mux_live_create(fd, NULL, NULL, ss, ch);
+}
+
+
+/**
+ * Live stream that is handed to 'output' instead of being written to
+ * a file descriptor. Clusters are passed as a whole, flagged
+ * MK_OUTPUT_SYNC when a client may start playback with them
+ */
+mk_mux_t *
+mk_mux_output_create(const struct streaming_start *ss, const channel_t *ch,
+		     mk_mux_output_t *output, void *opaque)
+{
+  return mk_mux_live_create(-1, output, opaque, ss, ch);
+}
+
 
 /**
  *
@@ -774,8 +805,11 @@ addcue(mk_mux_t *mkm, int64_t pts, int tracknum)
 static void
 mk_close_cluster(mk_mux_t *mkm)
 {
-  if(mkm->cluster != NULL)
+  if(mkm->cluster != NULL) {
+    mkm->outflags = mkm->cluster_sync ? MK_OUTPUT_SYNC : 0;
     mk_write_master(mkm, 0x1f43b675, mkm->cluster);
+    mkm->outflags = 0;
+  }
   mkm->cluster = NULL;
 }
 
@@ -854,6 +888,7 @@ mk_write_frame_i(mk_mux_t *mkm, mk_track *t, th_pkt_t *pkt)
     mkm->cluster = htsbuf_queue_alloc(0);
 
     mkm->cluster_pos = mkm->fdpos;
+    mkm->cluster_sync = vkeyframe || !mkm->has_video;
     mkm->addcue = 1;
 
     ebml_append_uint(mkm->cluster, 0xe7, mkm->cluster_tc);
@@ -949,6 +984,16 @@ mk_write_cues(mk_mux_t *mkm)
   mk_write_master(mkm, 0x1c53bb6b, q);
 }
 
+/**
+ * Bytes written, only complete clusters are written until closed
+ */
+off_t
+mk_mux_size(mk_mux_t *mkm)
+{
+  return mkm->fdpos;
+}
+
+
 /**
  *
  */
@@ -978,7 +1023,8 @@ mk_mux_close(mk_mux_t *mkm)
 	     mkm->filename, strerror(errno));
   }
 
-  close(mkm->fd);
+  if(mkm->fd != -1)
+    close(mkm->fd);
   free(mkm->filename);
   free(mkm->tracks);
   free(mkm->title);
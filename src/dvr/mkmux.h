@@ -26,6 +26,16 @@ struct dvr_entry;
 struct th_pkt;
 struct channel;
 struct event;
+struct htsbuf_queue;
+
+/**
+ * Receiver of muxed output, see mk_mux_output_create()
+ */
+#define MK_OUTPUT_HEADER 0x1  /* Stream header, everything before clusters */
+#define MK_OUTPUT_SYNC   0x2  /* Cluster that can be decoded on its own */
+
+typedef void (mk_mux_output_t)(void *opaque, struct htsbuf_queue *q,
+			       int flags);
 
 mk_mux_t *mk_mux_create(const char *filename,
 			const struct streaming_start *ss,
@@ -36,8 +46,14 @@ mk_mux_t *mk_mux_stream_create(int fd,
 			       const struct streaming_start *ss,
 			       const struct channel *ch);
 
+mk_mux_t *mk_mux_output_create(const struct streaming_start *ss,
+			       const struct channel *ch,
+			       mk_mux_output_t *output, void *opaque);
+
 int mk_mux_write_pkt(mk_mux_t *mkm, struct th_pkt *pkt);
 
+off_t mk_mux_size(mk_mux_t *mkm);
+
 int mk_mux_append_meta(mk_mux_t *mkm, struct event *e);
 
 void mk_mux_close(mk_mux_t *mk_mux);
@@ -24,6 +24,8 @@
 #include <string.h>
 #include <regex.h>
 #include <assert.h>
+#include <limits.h>
+#include <inttypes.h>
 
 #include "tvheadend.h"
 #include "channels.h"
@@ -32,18 +34,21 @@
 #include "dvr/dvr.h"
 #include "htsp.h"
 #include "htsmsg_binary.h"
+#include "atomic.h"
 
 #define EPG_MAX_AGE 86400
 
 #define EPG_GLOBAL_HASH_WIDTH 1024
 #define EPG_GLOBAL_HASH_MASK (EPG_GLOBAL_HASH_WIDTH - 1)
 static struct event_list epg_hash[EPG_GLOBAL_HASH_WIDTH];
+static uint32_t epg_event_tally;
 
 static void epg_expire_event_from_channel(void *opauqe);
 static void epg_ch_check_current_event(void *aux);
 /* helper function to fuzzy compare two events */
 static int epg_event_cmp_overlap(event_t *e1, event_t *e2);
 static void epg_erase_duplicates(event_t *e, channel_t *ch);
+static void epg_snapshot_publish(void);
 
 
 static int
@@ -113,6 +118,17 @@ epg_ch_check_current_event(void *aux)
 }
 
 
+/**
+ * Called whenever the data of an event changed
+ */
+static void
+epg_event_changed(event_t *e)
+{
+  if(e->e_channel != NULL)
+    epg_snapshot_invalidate(e->e_channel);
+}
+
+
 /**
  *
  */
@@ -133,6 +149,8 @@ epg_event_set_title(event_t *e, const char *title)
     return 0;
   free(e->e_title);
   e->e_title = strdup(title);
+  epg_text_update(e);
+  epg_event_changed(e);
   return 1;
 }
 
@@ -153,6 +171,8 @@ epg_event_set_desc(event_t *e, const char *desc)
   }
   free(e->e_desc);
   e->e_desc = strdup(desc);
+  epg_text_update(e);
+  epg_event_changed(e);
   return 1;
 }
 
@@ -178,6 +198,7 @@ epg_event_set_ext_desc(event_t *e, int ext_dn, const char *desc)
     strcpy(tmp, desc);
 
   e->e_ext_desc = tmp;
+  epg_event_changed(e);
   return 1;
 }
 
@@ -203,6 +224,7 @@ epg_event_set_ext_item(event_t *e, int ext_dn, const char *item)
     strcpy(tmp, item);
 
   e->e_ext_item = tmp;
+  epg_event_changed(e);
   return 1;
 }
 
@@ -228,6 +250,7 @@ epg_event_set_ext_text(event_t *e, int ext_dn, const char *text)
     strcpy(tmp, text);
 
   e->e_ext_text = tmp;
+  epg_event_changed(e);
   return 1;
 }
 
@@ -241,6 +264,7 @@ epg_event_set_content_type(event_t *e, uint8_t type)
     return 0;
 
   e->e_content_type = type;
+  epg_event_changed(e);
   return 1;
 }
 
@@ -262,6 +286,7 @@ epg_event_set_episode(event_t *e, epg_episode_t *ee)
   e->e_episode.ee_part    = ee->ee_part;
 
   tvh_str_set(&e->e_episode.ee_onscreen, ee->ee_onscreen);
+  epg_event_changed(e);
   return 1;
 }
 
@@ -278,6 +303,7 @@ epg_event_destroy(event_t *e)
   free(e->e_ext_item);
   free(e->e_ext_text);
   free(e->e_episode.ee_onscreen);
+  free(e->e_words);
   LIST_REMOVE(e, e_global_link);
   free(e);
 }
@@ -310,6 +336,7 @@ epg_remove_event_from_channel(channel_t *ch, event_t *e)
   RB_REMOVE(&ch->ch_epg_events, e, e_channel_link);
   e->e_channel = NULL;
   epg_event_unref(e);
+  epg_snapshot_invalidate(ch);
 
   if(ch->ch_epg_current == e) {
     epg_set_current(ch, NULL, n);
@@ -337,7 +364,6 @@ epg_event_create(channel_t *ch, time_t start, time_t stop, int dvb_id,
 {
   static event_t *skel;
   event_t *e;
-  static int tally;
 
   if(created != NULL)
     *created = 0;
@@ -365,7 +391,7 @@ epg_event_create(channel_t *ch, time_t start, time_t stop, int dvb_id,
     e = skel;
     skel = NULL;
 
-    e->e_id = ++tally;
+    e->e_id = ++epg_event_tally;
     e->e_stop = stop;
     e->e_dvb_id = dvb_id;
 
@@ -374,6 +400,7 @@ epg_event_create(channel_t *ch, time_t start, time_t stop, int dvb_id,
 
     e->e_refcount = 1;
     e->e_channel = ch;
+    epg_snapshot_invalidate(ch);
 
     if(e == RB_FIRST(&ch->ch_epg_events)) {
       /* First in temporal order, arm expiration timer */
@@ -402,6 +429,7 @@ epg_event_create(channel_t *ch, time_t start, time_t stop, int dvb_id,
       printf("     New %s", ctime(&stop));
 #endif
       e->e_stop = stop;
+      epg_snapshot_invalidate(ch);
 
       if(e == ch->ch_epg_current) {
 	gtimer_arm_abs(&ch->ch_epg_timer_current, epg_ch_check_current_event,
@@ -536,6 +564,9 @@ epg_unlink_from_channel(channel_t *ch)
   gtimer_disarm(&ch->ch_epg_timer_head);
   gtimer_disarm(&ch->ch_epg_timer_current);
 
+  /* Published epochs keep their own reference to the channel data */
+  epg_snapshot_invalidate(ch);
+
 }
 
 
@@ -705,6 +736,8 @@ epg_init(void)
   
   RB_FOREACH(ch, &channel_name_tree, ch_name_link)
     epg_ch_check_current_event(ch);
+
+  epg_snapshot_publish();
 }
 
 
@@ -778,14 +811,11 @@ epg_save(void)
  *
  */
 static void
-eqr_add(epg_query_result_t *eqr, event_t *e, regex_t *preg, time_t now)
+eqr_add(epg_query_result_t *eqr, event_t *e, time_t now)
 {
   if(e->e_title == NULL)
     return;
 
-  if(preg != NULL && regexec(preg, e->e_title, 0, NULL, 0))
-    return;
-
   if(e->e_stop < now)
     return; /* Already passed */
 
@@ -805,20 +835,53 @@ eqr_add(epg_query_result_t *eqr, event_t *e, regex_t *preg, time_t now)
  */
 static void
 epg_query_add_channel(epg_query_result_t *eqr, channel_t *ch,
-		      uint8_t content_type, regex_t *preg, time_t now)
+		      uint8_t content_type, time_t now)
 {
   event_t *e;
 
   if(content_type == 0) {
     RB_FOREACH(e, &ch->ch_epg_events, e_channel_link)
-      eqr_add(eqr, e, preg, now);
+      eqr_add(eqr, e, now);
   } else {
     RB_FOREACH(e, &ch->ch_epg_events, e_channel_link)
       if(content_type == e->e_content_type)
-	eqr_add(eqr, e, preg, now);
+	eqr_add(eqr, e, now);
   }
 }
 
+/**
+ * Title searches run on the snapshot, pending changes are published
+ * first so the result matches the EPG as of now
+ */
+static void
+epg_query_snapshot(epg_query_result_t *eqr, channel_t *ch, channel_tag_t *ct,
+		   uint8_t content_type, const char *title, time_t now)
+{
+  epg_snapshot_t *es;
+  epg_snap_filter_t esf;
+  epg_snap_result_t esr;
+  event_t *e;
+  int i;
+
+  if((es = epg_snapshot_refresh()) == NULL)
+    return;
+
+  memset(&esf, 0, sizeof(esf));
+  esf.esf_ch_id = ch != NULL ? ch->ch_id : -1;
+  esf.esf_tag_id = ct != NULL ? ct->ct_identifier : -1;
+  esf.esf_content_type = content_type;
+  esf.esf_title = title;
+  esf.esf_from = now;
+
+  if(!epg_snapshot_page(es, &esr, &esf, NULL, 0, NULL))
+    for(i = 0; i < esr.esr_entries; i++)
+      if((e = epg_event_find_by_id(esr.esr_array[i]->ese_id)) != NULL)
+	eqr_add(eqr, e, now);
+
+  epg_snapshot_query_free(&esr);
+  epg_snapshot_release(es);
+}
+
 /**
  *
  */
@@ -828,34 +891,30 @@ epg_query0(epg_query_result_t *eqr, channel_t *ch, channel_tag_t *ct,
 {
   channel_tag_mapping_t *ctm;
   time_t now;
-  regex_t preg0, *preg;
 
   lock_assert(&global_lock);
   memset(eqr, 0, sizeof(epg_query_result_t));
   time(&now);
 
   if(title != NULL) {
-    if(regcomp(&preg0, title, REG_ICASE | REG_EXTENDED | REG_NOSUB))
-      return;
-    preg = &preg0;
-  } else {
-    preg = NULL;
+    epg_query_snapshot(eqr, ch, ct, content_type, title, now);
+    return;
   }
 
   if(ch != NULL && ct == NULL) {
-    epg_query_add_channel(eqr, ch, content_type, preg, now);
+    epg_query_add_channel(eqr, ch, content_type, now);
     return;
   }
   
   if(ct != NULL) {
     LIST_FOREACH(ctm, &ct->ct_ctms, ctm_tag_link)
       if(ch == NULL || ctm->ctm_channel == ch)
-	epg_query_add_channel(eqr, ctm->ctm_channel, content_type, preg, now);
+	epg_query_add_channel(eqr, ctm->ctm_channel, content_type, now);
     return;
   }
 
   RB_FOREACH(ch, &channel_name_tree, ch_name_link)
-    epg_query_add_channel(eqr, ch, content_type, preg, now);
+    epg_query_add_channel(eqr, ch, content_type, now);
 }
 
 /**
@@ -908,3 +967,944 @@ epg_query_sort(epg_query_result_t *eqr)
 
   qsort(eqr->eqr_array, eqr->eqr_entries, sizeof(event_t *), sf);
 }
+
+
+/**
+ * EPG read snapshot
+ */
+#define EPG_SNAPSHOT_DELAY 1 /* seconds */
+#define EPG_SNAP_BLOCK     64 /* Events per block of the stop index */
+
+static pthread_mutex_t epg_snap_mutex = PTHREAD_MUTEX_INITIALIZER;
+static epg_snapshot_t *epg_snap_current;
+static gtimer_t epg_snap_timer;
+static uint32_t epg_snap_epoch;
+static int epg_snap_rebuilt;
+static int64_t epg_snap_buildtime;
+
+/**
+ *
+ */
+static size_t
+esc_strsize(const char *s)
+{
+  return s != NULL ? strlen(s) + 1 : 0;
+}
+
+/**
+ *
+ */
+static const char *
+esc_strcpy(char **wp, const char *s)
+{
+  char *r = *wp;
+  size_t l;
+
+  if(s == NULL)
+    return NULL;
+  l = strlen(s) + 1;
+  memcpy(r, s, l);
+  *wp += l;
+  return r;
+}
+
+/**
+ *
+ */
+static int
+ese_id_cmp(const void *A, const void *B)
+{
+  const epg_snap_event_t *a = *(epg_snap_event_t **)A;
+  const epg_snap_event_t *b = *(epg_snap_event_t **)B;
+  return a->ese_id < b->ese_id ? -1 : a->ese_id > b->ese_id;
+}
+
+/**
+ * Page order, start time first. Event start times are unique within
+ * a channel so this is a total order
+ */
+typedef struct epg_snap_key {
+  time_t start;
+  int ch_id;
+  uint32_t id;
+} epg_snap_key_t;
+
+static int
+esk_cmp(const epg_snap_key_t *k, const epg_snap_event_t *e)
+{
+  if(k->start != e->ese_start)
+    return k->start < e->ese_start ? -1 : 1;
+  if(k->ch_id != e->ese_channel->esc_id)
+    return k->ch_id < e->ese_channel->esc_id ? -1 : 1;
+  if(k->id != e->ese_id)
+    return k->id < e->ese_id ? -1 : 1;
+  return 0;
+}
+
+static void
+esk_set(epg_snap_key_t *k, const epg_snap_event_t *e)
+{
+  k->start = e->ese_start;
+  k->ch_id = e->ese_channel->esc_id;
+  k->id    = e->ese_id;
+}
+
+static int
+ese_page_cmp(const void *A, const void *B)
+{
+  epg_snap_key_t k;
+
+  esk_set(&k, *(epg_snap_event_t **)A);
+  return esk_cmp(&k, *(epg_snap_event_t **)B);
+}
+
+/**
+ * Content type, then temporal order
+ */
+static int
+ese_type_cmp(const void *A, const void *B)
+{
+  const epg_snap_event_t *a = *(epg_snap_event_t **)A;
+  const epg_snap_event_t *b = *(epg_snap_event_t **)B;
+
+  if(a->ese_content_type != b->ese_content_type)
+    return a->ese_content_type < b->ese_content_type ? -1 : 1;
+  return a < b ? -1 : a > b;
+}
+
+/**
+ * Copy the EPG of a channel, all strings go into a single allocation
+ */
+static epg_snap_channel_t *
+epg_snap_channel_build(channel_t *ch)
+{
+  epg_snap_channel_t *esc;
+  epg_snap_event_t *ese;
+  channel_tag_mapping_t *ctm;
+  dvr_entry_t *de;
+  event_t *e;
+  size_t strsize;
+  char *wp;
+  int i, n;
+
+  esc = calloc(1, sizeof(epg_snap_channel_t));
+  esc->esc_refcount = 1;
+  esc->esc_id = ch->ch_id;
+
+  strsize = esc_strsize(ch->ch_name) + esc_strsize(ch->ch_icon);
+
+  RB_FOREACH(e, &ch->ch_epg_events, e_channel_link) {
+    esc->esc_nevents++;
+    strsize +=
+      esc_strsize(e->e_title) +
+      esc_strsize(e->e_desc) +
+      esc_strsize(e->e_ext_desc) +
+      esc_strsize(e->e_ext_item) +
+      esc_strsize(e->e_ext_text) +
+      esc_strsize(e->e_episode.ee_onscreen);
+  }
+
+  LIST_FOREACH(ctm, &ch->ch_ctms, ctm_channel_link)
+    esc->esc_ntags++;
+
+  esc->esc_events = calloc(esc->esc_nevents + 1, sizeof(epg_snap_event_t));
+  esc->esc_byid = malloc((esc->esc_nevents + 1) * sizeof(epg_snap_event_t *));
+  esc->esc_maxstop = malloc((esc->esc_nevents + 1) * sizeof(time_t));
+  esc->esc_titled = malloc((esc->esc_nevents + 1) * sizeof(int));
+  esc->esc_bytype = malloc((esc->esc_nevents + 1) *
+			   sizeof(epg_snap_event_t *));
+  esc->esc_tags = malloc((esc->esc_ntags + 1) * sizeof(int));
+  esc->esc_strings = wp = malloc(strsize + 1);
+
+  esc->esc_name = esc_strcpy(&wp, ch->ch_name);
+  esc->esc_icon = esc_strcpy(&wp, ch->ch_icon);
+
+  i = 0;
+  LIST_FOREACH(ctm, &ch->ch_ctms, ctm_channel_link)
+    esc->esc_tags[i++] = ctm->ctm_tag->ct_identifier;
+
+  i = n = 0;
+  RB_FOREACH(e, &ch->ch_epg_events, e_channel_link) {
+    ese = &esc->esc_events[i];
+
+    ese->ese_channel      = esc;
+    ese->ese_id           = e->e_id;
+    ese->ese_start        = e->e_start;
+    ese->ese_stop         = e->e_stop;
+    ese->ese_content_type = e->e_content_type;
+
+    ese->ese_title    = esc_strcpy(&wp, e->e_title);
+    ese->ese_desc     = esc_strcpy(&wp, e->e_desc);
+    ese->ese_ext_desc = esc_strcpy(&wp, e->e_ext_desc);
+    ese->ese_ext_item = esc_strcpy(&wp, e->e_ext_item);
+    ese->ese_ext_text = esc_strcpy(&wp, e->e_ext_text);
+    ese->ese_episode  = esc_strcpy(&wp, e->e_episode.ee_onscreen);
+
+    if((de = dvr_entry_find_by_event(e)) != NULL) {
+      ese->ese_dvr_id    = de->de_id;
+      ese->ese_dvr_state = dvr_entry_schedstatus(de);
+    }
+
+    esc->esc_maxstop[i] = i > 0 ? MAX(esc->esc_maxstop[i - 1], e->e_stop) :
+      e->e_stop;
+    esc->esc_titled[i] = n;
+    if(ese->ese_title != NULL)
+      esc->esc_bytype[n++] = ese;
+    esc->esc_byid[i++] = ese;
+  }
+  esc->esc_titled[i] = n;
+
+  qsort(esc->esc_byid, esc->esc_nevents, sizeof(epg_snap_event_t *),
+	ese_id_cmp);
+  qsort(esc->esc_bytype, n, sizeof(epg_snap_event_t *), ese_type_cmp);
+
+  epg_text_index_build(esc, ch);
+  return esc;
+}
+
+/**
+ *
+ */
+static void
+epg_snap_channel_release(epg_snap_channel_t *esc)
+{
+  if(atomic_add(&esc->esc_refcount, -1) > 1)
+    return;
+
+  free(esc->esc_events);
+  free(esc->esc_byid);
+  free(esc->esc_maxstop);
+  free(esc->esc_titled);
+  free(esc->esc_bytype);
+  free(esc->esc_tags);
+  free(esc->esc_strings);
+  epg_text_index_free(esc);
+  free(esc);
+}
+
+/**
+ *
+ */
+void
+epg_snapshot_release(epg_snapshot_t *es)
+{
+  int i;
+
+  if(atomic_add(&es->es_refcount, -1) > 1)
+    return;
+
+  for(i = 0; i < es->es_nchannels; i++)
+    epg_snap_channel_release(es->es_channels[i]);
+  free(es->es_channels);
+  free(es->es_bytime);
+  free(es->es_maxstop);
+  free(es->es_blockstop);
+  free(es);
+}
+
+/**
+ * Global index over all events of an epoch.
+ *
+ * Along with it the latest stop time up to each event, the first event
+ * that overlaps a window is found with a binary search on that, and the
+ * latest stop within each block of events so blocks that ended before
+ * the window can be skipped
+ */
+static void
+epg_snapshot_build_index(epg_snapshot_t *es)
+{
+  epg_snap_channel_t *esc;
+  time_t stop;
+  int i, j, n = 0;
+
+  es->es_bytime = malloc((es->es_nevents + 1) * sizeof(epg_snap_event_t *));
+  es->es_maxstop = malloc((es->es_nevents + 1) * sizeof(time_t));
+  es->es_blockstop = malloc((es->es_nevents / EPG_SNAP_BLOCK + 1) *
+			    sizeof(time_t));
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    esc = es->es_channels[i];
+    for(j = 0; j < esc->esc_nevents; j++)
+      es->es_bytime[n++] = &esc->esc_events[j];
+  }
+
+  qsort(es->es_bytime, n, sizeof(epg_snap_event_t *), ese_page_cmp);
+
+  for(i = 0; i < n; i++) {
+    stop = es->es_bytime[i]->ese_stop;
+    es->es_maxstop[i] = i > 0 ? MAX(es->es_maxstop[i - 1], stop) : stop;
+    if(i % EPG_SNAP_BLOCK == 0 || stop > es->es_blockstop[i / EPG_SNAP_BLOCK])
+      es->es_blockstop[i / EPG_SNAP_BLOCK] = stop;
+  }
+}
+
+/**
+ * Build and publish a new epoch, the previous one goes away once its
+ * last reader is done with it
+ */
+static void
+epg_snapshot_publish(void)
+{
+  epg_snapshot_t *es, *old;
+  channel_t *ch;
+  int64_t ts = getmonoclock();
+  int n = 0, rebuilt = 0;
+
+  lock_assert(&global_lock);
+
+  gtimer_disarm(&epg_snap_timer);
+
+  RB_FOREACH(ch, &channel_name_tree, ch_name_link)
+    n++;
+
+  es = calloc(1, sizeof(epg_snapshot_t));
+  es->es_refcount = 1;
+  es->es_epoch = ++epg_snap_epoch;
+  es->es_created = dispatch_clock;
+  es->es_max_id = epg_event_tally;
+  es->es_channels = malloc((n + 1) * sizeof(epg_snap_channel_t *));
+
+  RB_FOREACH(ch, &channel_name_tree, ch_name_link) {
+    if(ch->ch_epg_snap == NULL) {
+      ch->ch_epg_snap = epg_snap_channel_build(ch);
+      rebuilt++;
+    }
+    atomic_add(&ch->ch_epg_snap->esc_refcount, 1);
+    es->es_channels[es->es_nchannels++] = ch->ch_epg_snap;
+    es->es_nevents += ch->ch_epg_snap->esc_nevents;
+  }
+
+  epg_snapshot_build_index(es);
+
+  pthread_mutex_lock(&epg_snap_mutex);
+  old = epg_snap_current;
+  epg_snap_current = es;
+  pthread_mutex_unlock(&epg_snap_mutex);
+
+  if(old != NULL)
+    epg_snapshot_release(old);
+
+  epg_snap_rebuilt = rebuilt;
+  epg_snap_buildtime = getmonoclock() - ts;
+}
+
+/**
+ *
+ */
+static void
+epg_snapshot_timer(void *aux)
+{
+  epg_snapshot_publish();
+}
+
+/**
+ * Channel EPG, name, icon, tags or DVR entries changed
+ */
+void
+epg_snapshot_invalidate(channel_t *ch)
+{
+  lock_assert(&global_lock);
+
+  if(ch->ch_epg_snap != NULL) {
+    epg_snap_channel_release(ch->ch_epg_snap);
+    ch->ch_epg_snap = NULL;
+  }
+
+  if(epg_snap_timer.gti_callback == NULL)
+    gtimer_arm(&epg_snap_timer, epg_snapshot_timer, NULL,
+	       EPG_SNAPSHOT_DELAY);
+}
+
+/**
+ * Get a reference to the current epoch, does not need global_lock.
+ * Returns NULL until the first epoch is published.
+ */
+epg_snapshot_t *
+epg_snapshot_get(void)
+{
+  epg_snapshot_t *es;
+
+  pthread_mutex_lock(&epg_snap_mutex);
+  if((es = epg_snap_current) != NULL)
+    atomic_add(&es->es_refcount, 1);
+  pthread_mutex_unlock(&epg_snap_mutex);
+  return es;
+}
+
+/**
+ * Like epg_snapshot_get() but publish pending changes first
+ */
+epg_snapshot_t *
+epg_snapshot_refresh(void)
+{
+  lock_assert(&global_lock);
+
+  if(epg_snap_current == NULL || epg_snap_timer.gti_callback != NULL)
+    epg_snapshot_publish();
+  return epg_snapshot_get();
+}
+
+/**
+ *
+ */
+epg_snap_channel_t *
+epg_snapshot_find_channel(epg_snapshot_t *es, const char *name)
+{
+  int i;
+
+  for(i = 0; i < es->es_nchannels; i++)
+    if(es->es_channels[i]->esc_name != NULL &&
+       !strcmp(es->es_channels[i]->esc_name, name))
+      return es->es_channels[i];
+  return NULL;
+}
+
+/**
+ *
+ */
+epg_snap_event_t *
+epg_snapshot_find_by_id(epg_snapshot_t *es, uint32_t id)
+{
+  epg_snap_channel_t *esc;
+  epg_snap_event_t **v;
+  int i, lo, hi, mid;
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    esc = es->es_channels[i];
+    v = esc->esc_byid;
+
+    if(esc->esc_nevents == 0 ||
+       id < v[0]->ese_id || id > v[esc->esc_nevents - 1]->ese_id)
+      continue;
+
+    lo = 0;
+    hi = esc->esc_nevents - 1;
+    while(lo <= hi) {
+      mid = (lo + hi) / 2;
+      if(v[mid]->ese_id == id)
+	return v[mid];
+      if(v[mid]->ese_id < id)
+	lo = mid + 1;
+      else
+	hi = mid - 1;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Following event on the same channel
+ */
+epg_snap_event_t *
+epg_snapshot_next(const epg_snap_event_t *ese)
+{
+  const epg_snap_channel_t *esc = ese->ese_channel;
+  int i = ese - esc->esc_events;
+
+  return i + 1 < esc->esc_nevents ? &esc->esc_events[i + 1] : NULL;
+}
+
+/**
+ *
+ */
+static int
+esc_has_tag(const epg_snap_channel_t *esc, int tag_id)
+{
+  int i;
+
+  for(i = 0; i < esc->esc_ntags; i++)
+    if(esc->esc_tags[i] == tag_id)
+      return 1;
+  return 0;
+}
+
+/**
+ *
+ */
+static int
+esf_match(const epg_snap_filter_t *esf, const epg_snap_event_t *ese,
+	  regex_t *preg)
+{
+  const epg_snap_channel_t *esc = ese->ese_channel;
+
+  if(ese->ese_title == NULL || ese->ese_stop <= esf->esf_from)
+    return 0;
+  if(esf->esf_ch_id != -1 && esc->esc_id != esf->esf_ch_id)
+    return 0;
+  if(esf->esf_tag_id != -1 && !esc_has_tag(esc, esf->esf_tag_id))
+    return 0;
+  if(esf->esf_content_type && ese->ese_content_type != esf->esf_content_type)
+    return 0;
+  if(preg != NULL && regexec(preg, ese->ese_title, 0, NULL, 0))
+    return 0;
+  return 1;
+}
+
+/**
+ * Returns 1 when the page is done
+ */
+static int
+esr_visit(epg_snap_result_t *esr, const epg_snap_filter_t *esf,
+	  regex_t *preg, epg_snap_event_t *ese, int limit)
+{
+  if(esf->esf_to && ese->ese_start >= esf->esf_to)
+    return 1;
+
+  if(esf_match(esf, ese, preg)) {
+    if(esr->esr_entries == esr->esr_alloced) {
+      esr->esr_alloced = MAX(100, esr->esr_alloced * 2);
+      esr->esr_array = realloc(esr->esr_array,
+			       esr->esr_alloced * sizeof(epg_snap_event_t *));
+    }
+    esr->esr_array[esr->esr_entries++] = ese;
+  }
+  return limit && esr->esr_entries >= limit;
+}
+
+/**
+ * First event that ends after 'from', and no event before it does.
+ * 'maxstop' holds the latest stop time up to each event
+ */
+static int
+esr_first_running(const time_t *maxstop, int n, time_t from)
+{
+  int lo = 0, hi = n, mid;
+
+  while(lo < hi) {
+    mid = (lo + hi) / 2;
+    if(maxstop[mid] <= from)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * First event of a channel after 'k' that overlaps the window,
+ * 'k' NULL for the first page
+ */
+static int
+esc_upper(const epg_snap_channel_t *esc, const epg_snap_key_t *k,
+	  time_t from)
+{
+  int lo = esr_first_running(esc->esc_maxstop, esc->esc_nevents, from);
+  int hi = esc->esc_nevents, mid;
+
+  while(k != NULL && lo < hi) {
+    mid = (lo + hi) / 2;
+    if(esk_cmp(k, &esc->esc_events[mid]) >= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * First event in the global index after 'k' that overlaps the window,
+ * 'k' NULL for the first page
+ */
+static int
+es_upper(const epg_snapshot_t *es, const epg_snap_key_t *k, time_t from)
+{
+  int lo = esr_first_running(es->es_maxstop, es->es_nevents, from);
+  int hi = es->es_nevents, mid;
+
+  while(k != NULL && lo < hi) {
+    mid = (lo + hi) / 2;
+    if(esk_cmp(k, es->es_bytime[mid]) >= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Heap of channels ordered by their next event, for the tag merge
+ */
+typedef struct epg_snap_heap {
+  epg_snap_channel_t **esh_esc;
+  int *esh_pos;   /* Next event of each channel */
+  int *esh_heap;  /* Channel indices, earliest next event first */
+  int esh_n;
+} epg_snap_heap_t;
+
+static epg_snap_event_t *
+esh_event(const epg_snap_heap_t *esh, int i)
+{
+  int c = esh->esh_heap[i];
+  return &esh->esh_esc[c]->esc_events[esh->esh_pos[c]];
+}
+
+static void
+esh_down(epg_snap_heap_t *esh, int i)
+{
+  epg_snap_key_t k;
+  int c, t;
+
+  while((c = 2 * i + 1) < esh->esh_n) {
+    if(c + 1 < esh->esh_n) {
+      esk_set(&k, esh_event(esh, c + 1));
+      if(esk_cmp(&k, esh_event(esh, c)) < 0)
+	c++;
+    }
+    esk_set(&k, esh_event(esh, i));
+    if(esk_cmp(&k, esh_event(esh, c)) < 0)
+      break;
+    t = esh->esh_heap[i];
+    esh->esh_heap[i] = esh->esh_heap[c];
+    esh->esh_heap[c] = t;
+    i = c;
+  }
+}
+
+/**
+ * Tag filter, merge the channels carrying the tag
+ */
+static void
+epg_snapshot_page_tag(epg_snapshot_t *es, epg_snap_result_t *esr,
+		      const epg_snap_filter_t *esf, regex_t *preg,
+		      const epg_snap_key_t *k, int limit)
+{
+  epg_snap_heap_t esh;
+  epg_snap_channel_t *esc;
+  int i, c, n = 0;
+
+  esh.esh_esc = malloc((es->es_nchannels + 1) * sizeof(epg_snap_channel_t *));
+  esh.esh_pos = malloc((es->es_nchannels + 1) * sizeof(int));
+  esh.esh_heap = malloc((es->es_nchannels + 1) * sizeof(int));
+  esh.esh_n = 0;
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    esc = es->es_channels[i];
+    if(!esc_has_tag(esc, esf->esf_tag_id))
+      continue;
+    esh.esh_esc[n] = esc;
+    esh.esh_pos[n] = esc_upper(esc, k, esf->esf_from);
+    if(esh.esh_pos[n] < esc->esc_nevents)
+      esh.esh_heap[esh.esh_n++] = n;
+    n++;
+  }
+
+  for(i = esh.esh_n / 2 - 1; i >= 0; i--)
+    esh_down(&esh, i);
+
+  while(esh.esh_n > 0) {
+    if(esr_visit(esr, esf, preg, esh_event(&esh, 0), limit))
+      break;
+    c = esh.esh_heap[0];
+    if(++esh.esh_pos[c] == esh.esh_esc[c]->esc_nevents)
+      esh.esh_heap[0] = esh.esh_heap[--esh.esh_n];
+    esh_down(&esh, 0);
+  }
+
+  free(esh.esh_esc);
+  free(esh.esh_pos);
+  free(esh.esh_heap);
+}
+
+/**
+ * Text filter, sort the events found in the word index
+ */
+static void
+epg_snapshot_page_text(epg_snapshot_t *es, epg_snap_result_t *esr,
+		       const epg_snap_filter_t *esf, epg_text_query_t *tq,
+		       const epg_snap_key_t *k, int limit)
+{
+  epg_snap_channel_t *esc;
+  epg_snap_result_t c;
+  int i, lo, hi, mid;
+
+  memset(&c, 0, sizeof(c));
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    esc = es->es_channels[i];
+    if(esf->esf_ch_id != -1 && esc->esc_id != esf->esf_ch_id)
+      continue;
+    if(esf->esf_tag_id != -1 && !esc_has_tag(esc, esf->esf_tag_id))
+      continue;
+    epg_text_query_match(tq, esc, &c);
+  }
+
+  qsort(c.esr_array, c.esr_entries, sizeof(epg_snap_event_t *),
+	ese_page_cmp);
+
+  lo = 0;
+  hi = c.esr_entries;
+  while(k != NULL && lo < hi) {
+    mid = (lo + hi) / 2;
+    if(esk_cmp(k, c.esr_array[mid]) >= 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  for(i = lo; i < c.esr_entries; i++)
+    if(esr_visit(esr, esf, NULL, c.esr_array[i], limit))
+      break;
+
+  free(c.esr_array);
+}
+
+/**
+ *
+ */
+int
+epg_snapshot_page(epg_snapshot_t *es, epg_snap_result_t *esr,
+		  const epg_snap_filter_t *esf, const char *cursor,
+		  int limit, char *next)
+{
+  epg_snap_channel_t *esc = NULL;
+  epg_snap_key_t kc, *k = NULL;
+  epg_snap_event_t *ese;
+  regex_t preg0, *preg = NULL;
+  epg_text_query_t *tq;
+  uint64_t start;
+  unsigned int ch_id;
+  int i;
+
+  memset(esr, 0, sizeof(epg_snap_result_t));
+  if(next != NULL)
+    next[0] = 0;
+
+  if(cursor != NULL && *cursor) {
+    if(sscanf(cursor, "%"SCNx64".%x.%"SCNx32, &start, &ch_id, &kc.id) != 3)
+      return -1;
+    kc.start = start;
+    kc.ch_id = ch_id;
+    k = &kc;
+  }
+
+  if(esf->esf_title != NULL) {
+    if((tq = epg_text_query_create(esf->esf_title, esf->esf_words,
+				   esf->esf_fulltext)) != NULL) {
+      epg_snapshot_page_text(es, esr, esf, tq, k, limit);
+      epg_text_query_destroy(tq);
+      goto done;
+    }
+    if(regcomp(&preg0, esf->esf_title, REG_ICASE | REG_EXTENDED | REG_NOSUB))
+      return -1;
+    preg = &preg0;
+  }
+
+  if(esf->esf_ch_id != -1) {
+    /* Only one channel to look at */
+    for(i = 0; i < es->es_nchannels; i++)
+      if(es->es_channels[i]->esc_id == esf->esf_ch_id)
+	esc = es->es_channels[i];
+
+    if(esc != NULL)
+      for(i = esc_upper(esc, k, esf->esf_from); i < esc->esc_nevents; i++)
+	if(esr_visit(esr, esf, preg, &esc->esc_events[i], limit))
+	  break;
+
+  } else if(esf->esf_tag_id != -1) {
+    epg_snapshot_page_tag(es, esr, esf, preg, k, limit);
+
+  } else {
+    for(i = es_upper(es, k, esf->esf_from); i < es->es_nevents; i++) {
+      ese = es->es_bytime[i];
+      if(ese->ese_start < esf->esf_from && i % EPG_SNAP_BLOCK == 0 &&
+	 es->es_blockstop[i / EPG_SNAP_BLOCK] <= esf->esf_from) {
+	/* The whole block ended before the window */
+	i += EPG_SNAP_BLOCK - 1;
+	continue;
+      }
+      if(esr_visit(esr, esf, preg, ese, limit))
+	break;
+    }
+  }
+
+  if(preg != NULL)
+    regfree(preg);
+
+ done:
+  if(next != NULL && limit && esr->esr_entries == limit) {
+    esk_set(&kc, esr->esr_array[limit - 1]);
+    snprintf(next, EPG_CURSOR_SIZE, "%"PRIx64".%x.%"PRIx32,
+	     (uint64_t)kc.start, kc.ch_id, kc.id);
+  }
+  return 0;
+}
+
+/**
+ * First event of a channel that starts at or after 't'
+ */
+static int
+esc_first_start(const epg_snap_channel_t *esc, time_t t)
+{
+  int lo = 0, hi = esc->esc_nevents, mid;
+
+  while(lo < hi) {
+    mid = (lo + hi) / 2;
+    if(esc->esc_events[mid].ese_start < t)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Titled events of content type 'ct' before event 'pos'
+ */
+static int
+esc_type_before(const epg_snap_channel_t *esc, uint8_t ct, int pos)
+{
+  const epg_snap_event_t *e = &esc->esc_events[pos], *b;
+  int lo = 0, hi = esc->esc_titled[esc->esc_nevents], mid;
+
+  while(lo < hi) {
+    mid = (lo + hi) / 2;
+    b = esc->esc_bytype[mid];
+    if(b->ese_content_type < ct || (b->ese_content_type == ct && b < e))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * Events of a channel that match the filter, text filters aside.
+ *
+ * Events from the first one running at 'from' up to the first one
+ * starting at 'to' are counted with the titled and content type
+ * indices. Of those, only events that started before 'from' may have
+ * ended already, normally that is just the one running
+ */
+static int
+esc_count(const epg_snap_channel_t *esc, const epg_snap_filter_t *esf)
+{
+  const epg_snap_event_t *ese;
+  uint8_t ct = esf->esf_content_type;
+  int lo = esr_first_running(esc->esc_maxstop, esc->esc_nevents,
+			     esf->esf_from);
+  int hi = esf->esf_to ? esc_first_start(esc, esf->esf_to) : esc->esc_nevents;
+  int i, mid, n;
+
+  if(hi <= lo)
+    return 0;
+
+  if(ct)
+    n = esc_type_before(esc, ct, hi) - esc_type_before(esc, ct, lo);
+  else
+    n = esc->esc_titled[hi] - esc->esc_titled[lo];
+
+  mid = MIN(hi, esc_first_start(esc, esf->esf_from + 1));
+  for(i = lo; i < mid; i++) {
+    ese = &esc->esc_events[i];
+    if(ese->ese_title != NULL && ese->ese_stop <= esf->esf_from &&
+       (!ct || ese->ese_content_type == ct))
+      n--;
+  }
+  return n;
+}
+
+/**
+ * Number of events epg_snapshot_page() finds with 'esf' when it is not
+ * limited, -1 if a text filter is set. Those have to be walked
+ */
+int
+epg_snapshot_count(epg_snapshot_t *es, const epg_snap_filter_t *esf)
+{
+  epg_snap_channel_t *esc;
+  int i, n = 0;
+
+  if(esf->esf_title != NULL)
+    return -1;
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    esc = es->es_channels[i];
+    if(esf->esf_ch_id != -1 && esc->esc_id != esf->esf_ch_id)
+      continue;
+    if(esf->esf_tag_id != -1 && !esc_has_tag(esc, esf->esf_tag_id))
+      continue;
+    n += esc_count(esc, esf);
+  }
+  return n;
+}
+
+/**
+ * All events that have not ended, in page order. -1 for ch_id or
+ * tag_id matches all
+ */
+void
+epg_snapshot_query(epg_snapshot_t *es, epg_snap_result_t *esr,
+		   int ch_id, int tag_id, uint8_t content_type,
+		   const char *title)
+{
+  epg_snap_filter_t esf;
+
+  memset(&esf, 0, sizeof(esf));
+  esf.esf_ch_id = ch_id;
+  esf.esf_tag_id = tag_id;
+  esf.esf_content_type = content_type;
+  esf.esf_title = title;
+  esf.esf_from = time(NULL);
+
+  epg_snapshot_page(es, esr, &esf, NULL, 0, NULL);
+}
+
+/**
+ *
+ */
+void
+epg_snapshot_query_free(epg_snap_result_t *esr)
+{
+  free(esr->esr_array);
+}
+
+/**
+ *
+ */
+static int
+epg_snap_sort_start_ascending(const void *A, const void *B)
+{
+  const epg_snap_event_t *a = *(epg_snap_event_t **)A;
+  const epg_snap_event_t *b = *(epg_snap_event_t **)B;
+
+  if(a->ese_start < b->ese_start)
+    return -1;
+  return a->ese_start > b->ese_start;
+}
+
+/**
+ *
+ */
+void
+epg_snapshot_query_sort(epg_snap_result_t *esr)
+{
+  qsort(esr->esr_array, esr->esr_entries, sizeof(epg_snap_event_t *),
+	epg_snap_sort_start_ascending);
+}
+
+/**
+ *
+ */
+void
+epg_snapshot_dump(htsbuf_queue_t *hq)
+{
+  epg_snapshot_t *es;
+  int i, nterms = 0, npostings = 0;
+
+  if((es = epg_snapshot_get()) == NULL)
+    return;
+
+  for(i = 0; i < es->es_nchannels; i++) {
+    nterms += es->es_channels[i]->esc_nterms;
+    npostings += es->es_channels[i]->esc_npostings;
+  }
+
+  htsbuf_qprintf(hq, "Epoch: %u  Age: %ld s  Channels: %d  Events: %d\n",
+		 es->es_epoch, (long)(dispatch_clock - es->es_created),
+		 es->es_nchannels, es->es_nevents);
+  htsbuf_qprintf(hq, "Channels rebuilt: %d  Build time: %lld us%s\n",
+		 epg_snap_rebuilt, (long long)epg_snap_buildtime,
+		 epg_snap_timer.gti_callback != NULL ? "  (update pending)" : "");
+  htsbuf_qprintf(hq, "Word index: %d terms  %d postings\n",
+		 nterms, npostings);
+  epg_snapshot_release(es);
+}
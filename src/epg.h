@@ -21,6 +21,7 @@
 
 #include "channels.h"
 #include "settings.h"
+#include "htsbuf.h"
 
 
 
@@ -57,6 +58,10 @@ typedef struct event {
   char *e_ext_item;/* UTF-8 encoded (from extended descriptor) */
   char *e_ext_text;/* UTF-8 encoded (from extended descriptor) */
 
+  char *e_words;   /* Normalized title and description words, see epg_text.c */
+  uint16_t e_nwords_title;
+  uint16_t e_nwords;
+
   int e_dvb_id;
 
   epg_episode_t e_episode;
@@ -136,4 +141,152 @@ void epg_query(epg_query_result_t *eqr, const char *channel, const char *tag,
 void epg_query_free(epg_query_result_t *eqr);
 void epg_query_sort(epg_query_result_t *eqr);
 
+
+/**
+ * EPG read snapshot
+ *
+ * Immutable copy of the EPG, together with the channel and DVR state
+ * the query interfaces report, that can be read without global_lock.
+ *
+ * Changes invalidate the snapshot of the affected channel and a new
+ * epoch is published (under global_lock) at most EPG_SNAPSHOT_DELAY
+ * seconds later. Channels that did not change are shared with the
+ * previous epoch. Readers keep a reference for as long as they look
+ * at the data, the last reference frees it.
+ */
+typedef struct epg_snap_event {
+  struct epg_snap_channel *ese_channel;
+
+  uint32_t ese_id;
+  time_t ese_start;
+  time_t ese_stop;
+  uint8_t ese_content_type;
+
+  const char *ese_title;
+  const char *ese_desc;
+  const char *ese_ext_desc;
+  const char *ese_ext_item;
+  const char *ese_ext_text;
+  const char *ese_episode;
+
+  int ese_dvr_id;
+  const char *ese_dvr_state; /* NULL if no DVR entry matches the event */
+} epg_snap_event_t;
+
+typedef struct epg_snap_channel {
+  int esc_refcount;
+
+  int esc_id;
+  const char *esc_name;
+  const char *esc_icon;
+
+  int esc_ntags;
+  int *esc_tags;
+
+  int esc_nevents;
+  epg_snap_event_t *esc_events;   /* In temporal order */
+  epg_snap_event_t **esc_byid;    /* Sorted by event id */
+  time_t *esc_maxstop;            /* Latest stop up to each event */
+  int *esc_titled;                /* Titled events before each event */
+  struct epg_snap_event **esc_bytype; /* Titled, by content type */
+
+  char *esc_strings;
+
+  int esc_nterms;                 /* Word index, see epg_text.c */
+  int esc_npostings;
+  struct epg_snap_term *esc_terms;
+  struct epg_snap_posting *esc_postings;
+  char *esc_words;
+} epg_snap_channel_t;
+
+typedef struct epg_snapshot {
+  int es_refcount;
+  uint32_t es_epoch;
+  time_t es_created;
+  uint32_t es_max_id;   /* Highest event id that existed when published */
+
+  int es_nchannels;
+  int es_nevents;
+  epg_snap_channel_t **es_channels; /* In channel name order */
+
+  epg_snap_event_t **es_bytime;     /* All events, in page order */
+  time_t *es_maxstop;               /* Latest stop up to each event */
+  time_t *es_blockstop;             /* Latest stop in each block */
+} epg_snapshot_t;
+
+typedef struct epg_snap_result {
+  epg_snap_event_t **esr_array;
+  int esr_entries;
+  int esr_alloced;
+} epg_snap_result_t;
+
+void epg_snapshot_invalidate(channel_t *ch);
+
+epg_snapshot_t *epg_snapshot_get(void);
+
+epg_snapshot_t *epg_snapshot_refresh(void);
+
+void epg_snapshot_release(epg_snapshot_t *es);
+
+epg_snap_channel_t *epg_snapshot_find_channel(epg_snapshot_t *es,
+					      const char *name);
+
+epg_snap_event_t *epg_snapshot_find_by_id(epg_snapshot_t *es, uint32_t id);
+
+epg_snap_event_t *epg_snapshot_next(const epg_snap_event_t *ese);
+
+void epg_snapshot_query(epg_snapshot_t *es, epg_snap_result_t *esr,
+			int ch_id, int tag_id, uint8_t content_type,
+			const char *title);
+void epg_snapshot_query_free(epg_snap_result_t *esr);
+void epg_snapshot_query_sort(epg_snap_result_t *esr);
+
+/**
+ * Paged EPG query
+ *
+ * Events are returned in page order (start time, channel id, event id)
+ * and must overlap the window [from, to), 'to' 0 means no end.
+ * Pages are continued with the cursor returned by the previous page,
+ * cursors stay valid across epochs.
+ */
+typedef struct epg_snap_filter {
+  int esf_ch_id;            /* -1 matches all */
+  int esf_tag_id;           /* -1 matches all */
+  uint8_t esf_content_type; /* 0 matches all */
+  const char *esf_title;    /* Text query, NULL matches all */
+  int esf_words;            /* esf_title is a word query, see epg_text.c */
+  int esf_fulltext;         /* Search descriptions too, word queries only */
+  time_t esf_from;
+  time_t esf_to;
+} epg_snap_filter_t;
+
+#define EPG_CURSOR_SIZE 48
+
+int epg_snapshot_page(epg_snapshot_t *es, epg_snap_result_t *esr,
+		      const epg_snap_filter_t *esf, const char *cursor,
+		      int limit, char *next);
+
+int epg_snapshot_count(epg_snapshot_t *es, const epg_snap_filter_t *esf);
+
+void epg_snapshot_dump(htsbuf_queue_t *hq);
+
+/**
+ * Full text search, see epg_text.c
+ */
+typedef struct epg_text_query epg_text_query_t;
+
+void epg_text_update(event_t *e);
+
+void epg_text_index_build(epg_snap_channel_t *esc, channel_t *ch);
+
+void epg_text_index_free(epg_snap_channel_t *esc);
+
+epg_text_query_t *epg_text_query_create(const char *query, int words,
+					int fulltext);
+
+void epg_text_query_match(epg_text_query_t *tq, epg_snap_channel_t *esc,
+			  epg_snap_result_t *esr);
+
+void epg_text_query_destroy(epg_text_query_t *tq);
+
 #endif /* EPG_H */
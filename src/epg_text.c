@@ -0,0 +1,625 @@
+/*
+ *  Electronic Program Guide - Full text search
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Titles and descriptions are split into normalized words when they
+ * are set, each snapshot channel keeps an inverted index over the
+ * words of its events. It is rebuilt together with the rest of the
+ * channel snapshot, from the already split words.
+ *
+ * Queries are regular expressions on the title. Words the expression
+ * requires at a word start ("^news", "the late") are looked up in the
+ * index and the expression is only run on the events having them.
+ *
+ * Word queries, asked for explicitly, have this syntax:
+ *
+ *   late news     Events with words starting with 'late' and 'news'
+ *   "late show"   Events where the word 'late' is directly followed by
+ *                 the word 'show', a trailing * makes a word a prefix
+ *
+ * Word queries with anything else in them are taken as regular
+ * expressions too.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <regex.h>
+
+#include "tvheadend.h"
+#include "epg.h"
+
+#define EPG_WORD_MAX    32    /* Longer words are cut */
+#define EPG_WORDS_MAX   1024  /* Per event */
+#define EPG_QUERY_TERMS 16
+
+#define EPG_FIELD_TITLE 0
+#define EPG_FIELD_DESC  1
+
+typedef struct epg_snap_term {
+  const char *est_word;
+  uint32_t est_first;     /* Postings, ordered by event, field, position */
+  uint32_t est_count;
+} epg_snap_term_t;
+
+typedef struct epg_snap_posting {
+  uint32_t esp_event;     /* Index in esc_events */
+  uint16_t esp_pos;
+  uint8_t esp_field;
+} epg_snap_posting_t;
+
+typedef struct epg_text_term {
+  char ett_word[EPG_WORD_MAX];
+  int ett_prefix;
+  int ett_follows;        /* Must directly follow the previous term */
+} epg_text_term_t;
+
+struct epg_text_query {
+  int tq_nterms;
+  epg_text_term_t tq_terms[EPG_QUERY_TERMS];
+  int tq_fulltext;
+  regex_t *tq_preg;       /* Run on the candidates, if set */
+  regex_t tq_preg0;
+};
+
+
+/**
+ *
+ */
+static inline int
+epg_word_char(uint8_t c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+    (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+
+/**
+ * Copy the word at 's' lower cased to 'd' (EPG_WORD_MAX bytes).
+ * Latin-1 supplement letters (UTF-8 C3 xx) are folded too.
+ *
+ * Returns pointer to the end of the word in 's'
+ */
+static const char *
+epg_word_copy(char *d, const char *s)
+{
+  const uint8_t *p = (const uint8_t *)s;
+  int l = 0;
+
+  for(; epg_word_char(*p); p++) {
+    uint8_t c = *p;
+
+    if(c >= 'A' && c <= 'Z')
+      c += 32;
+    else if(l > 0 && (uint8_t)d[l - 1] == 0xc3 &&
+	    c >= 0x80 && c <= 0x9e && c != 0x97)
+      c += 32;
+
+    if(l < EPG_WORD_MAX - 1)
+      d[l++] = c;
+  }
+  d[l] = 0;
+  return (const char *)p;
+}
+
+
+/**
+ * Append the words of 's' to 'buf', returns number of words
+ */
+static int
+epg_words_add(htsbuf_queue_t *hq, const char *s, int max)
+{
+  char word[EPG_WORD_MAX];
+  int n = 0;
+
+  if(s == NULL)
+    return 0;
+
+  while(*s && n < max) {
+    if(!epg_word_char(*s)) {
+      s++;
+      continue;
+    }
+    s = epg_word_copy(word, s);
+    htsbuf_append(hq, word, strlen(word) + 1);
+    n++;
+  }
+  return n;
+}
+
+
+/**
+ * Title or description of an event changed
+ */
+void
+epg_text_update(event_t *e)
+{
+  htsbuf_queue_t hq;
+
+  htsbuf_queue_init(&hq, 0);
+
+  e->e_nwords_title = epg_words_add(&hq, e->e_title, EPG_WORDS_MAX);
+  e->e_nwords = e->e_nwords_title +
+    epg_words_add(&hq, e->e_desc, EPG_WORDS_MAX - e->e_nwords_title);
+
+  free(e->e_words);
+  e->e_words = malloc(hq.hq_size + 1);
+  htsbuf_read(&hq, e->e_words, hq.hq_size);
+}
+
+
+/**
+ * Words are sorted with the postings for the same word together
+ */
+typedef struct epg_text_build {
+  const char *w;
+  epg_snap_posting_t p;
+} epg_text_build_t;
+
+static int
+etb_cmp(const void *A, const void *B)
+{
+  const epg_text_build_t *a = A, *b = B;
+  int r;
+
+  if((r = strcmp(a->w, b->w)) != 0)
+    return r;
+  if(a->p.esp_event != b->p.esp_event)
+    return a->p.esp_event < b->p.esp_event ? -1 : 1;
+  if(a->p.esp_field != b->p.esp_field)
+    return a->p.esp_field - b->p.esp_field;
+  return a->p.esp_pos - b->p.esp_pos;
+}
+
+
+/**
+ * Build the index of a channel snapshot, the events in 'ch' are in the
+ * same order as esc_events
+ */
+void
+epg_text_index_build(epg_snap_channel_t *esc, channel_t *ch)
+{
+  epg_text_build_t *v;
+  epg_snap_term_t *est = NULL;
+  event_t *e;
+  const char *w;
+  size_t strsize = 0;
+  char *wp;
+  int i, j, n = 0, ev = 0;
+
+  RB_FOREACH(e, &ch->ch_epg_events, e_channel_link)
+    n += e->e_nwords;
+
+  esc->esc_npostings = n;
+  if(n == 0)
+    return;
+
+  v = malloc(n * sizeof(epg_text_build_t));
+
+  n = 0;
+  RB_FOREACH(e, &ch->ch_epg_events, e_channel_link) {
+    w = e->e_words;
+    for(i = 0; i < e->e_nwords; i++) {
+      v[n].w = w;
+      v[n].p.esp_event = ev;
+      v[n].p.esp_field = i < e->e_nwords_title ?
+	EPG_FIELD_TITLE : EPG_FIELD_DESC;
+      v[n].p.esp_pos = i < e->e_nwords_title ? i : i - e->e_nwords_title;
+      w += strlen(w) + 1;
+      n++;
+    }
+    ev++;
+  }
+
+  qsort(v, n, sizeof(epg_text_build_t), etb_cmp);
+
+  for(i = 0; i < n; i++)
+    if(i == 0 || strcmp(v[i].w, v[i - 1].w)) {
+      esc->esc_nterms++;
+      strsize += strlen(v[i].w) + 1;
+    }
+
+  esc->esc_terms = malloc(esc->esc_nterms * sizeof(epg_snap_term_t));
+  esc->esc_postings = malloc(n * sizeof(epg_snap_posting_t));
+  esc->esc_words = wp = malloc(strsize);
+
+  for(i = j = 0; i < n; i++) {
+    if(i == 0 || strcmp(v[i].w, v[i - 1].w)) {
+      est = &esc->esc_terms[j++];
+      est->est_word = wp;
+      est->est_first = i;
+      est->est_count = 0;
+      strcpy(wp, v[i].w);
+      wp += strlen(wp) + 1;
+    }
+    est->est_count++;
+    esc->esc_postings[i] = v[i].p;
+  }
+
+  free(v);
+}
+
+
+/**
+ *
+ */
+void
+epg_text_index_free(epg_snap_channel_t *esc)
+{
+  free(esc->esc_terms);
+  free(esc->esc_postings);
+  free(esc->esc_words);
+}
+
+
+/**
+ * Add a word of a query
+ */
+static int
+epg_text_term_add(epg_text_query_t *tq, const char **sp, int follows)
+{
+  epg_text_term_t *ett;
+
+  if(tq->tq_nterms == EPG_QUERY_TERMS)
+    return -1;
+
+  ett = &tq->tq_terms[tq->tq_nterms++];
+  *sp = epg_word_copy(ett->ett_word, *sp);
+  ett->ett_follows = follows;
+  return 0;
+}
+
+
+/**
+ * A word is only known to start at 's' right after '^' at the start of
+ * the expression or after a plain space. The space or '^' must not be
+ * quantified, "the ?late" or "^*late" don't require a word start. The
+ * quantifier sits between them and the word then, so it is enough to
+ * look at the character right before 's'
+ */
+static int
+epg_regex_word_start(const char *start, const char *s)
+{
+  if(s == start + 1 && start[0] == '^')
+    return 1;
+  return s > start && s[-1] == ' ' && (s - 1 == start || s[-2] != '\\');
+}
+
+
+/**
+ * Quantifiers at 's' allow the character before them to be left out,
+ * as with "?", "*", "+*" or "{0,1}"
+ */
+static int
+epg_regex_optional(const char *s)
+{
+  for(; *s == '?' || *s == '*' || *s == '+' || *s == '{'; s++) {
+    if(*s == '?' || *s == '*')
+      return 1;
+    if(*s == '{') {
+      if(atoi(s + 1) == 0)
+	return 1;
+      while(*s && *s != '}')
+	s++;
+      if(!*s)
+	return 1;
+    }
+  }
+  return 0;
+}
+
+
+/**
+ * Words a regular expression requires at a word start, or -1 if there
+ * is nothing to look for
+ */
+static int
+epg_text_regex_terms(epg_text_query_t *tq, const char *s)
+{
+  const char *start = s, *e;
+  epg_text_term_t *ett;
+  int l;
+
+  if(strchr(s, '|') != NULL)
+    return -1; /* Alternatives, no word is required */
+
+  while(*s) {
+    switch(*s) {
+    case '\\':
+      s += s[1] ? 2 : 1;
+      continue;
+
+    case '[':
+      /* Skip bracket expression, ']' first is part of it */
+      s++;
+      if(*s == '^')
+	s++;
+      if(*s == ']')
+	s++;
+      while(*s && *s != ']')
+	s++;
+      if(*s)
+	s++;
+      continue;
+
+    case '(':
+      /* Groups may be optional, skip */
+      for(l = 0; *s; s++) {
+	if(*s == '\\' && s[1])
+	  s++;
+	else if(*s == '(')
+	  l++;
+	else if(*s == ')' && --l == 0)
+	  break;
+      }
+      if(*s)
+	s++;
+      continue;
+    }
+
+    if(!epg_word_char(*s)) {
+      s++;
+      continue;
+    }
+
+    if(!epg_regex_word_start(start, s)) {
+      while(epg_word_char(*s))
+	s++;
+      continue;
+    }
+
+    if(tq->tq_nterms == EPG_QUERY_TERMS)
+      break;
+
+    ett = &tq->tq_terms[tq->tq_nterms];
+    e = epg_word_copy(ett->ett_word, s);
+
+    /* Quantifiers only apply to the last character */
+    l = strlen(ett->ett_word);
+    if(epg_regex_optional(e))
+      l = e - s - 1 < l ? e - s - 1 : l;
+    if(l > 0) {
+      ett->ett_word[l] = 0;
+      ett->ett_prefix = 1;
+      tq->tq_nterms++;
+    }
+    s = e;
+  }
+  return tq->tq_nterms ? 0 : -1;
+}
+
+
+/**
+ * 'words' selects the word syntax, 'fulltext' searches descriptions too
+ * (word queries only).
+ *
+ * Returns NULL if the index can't help, the caller will have to run the
+ * query as a regular expression on all events
+ */
+epg_text_query_t *
+epg_text_query_create(const char *query, int words, int fulltext)
+{
+  epg_text_query_t *tq = calloc(1, sizeof(epg_text_query_t));
+  const char *s;
+  int phrase = 0, follows = 0;
+
+  tq->tq_fulltext = fulltext;
+
+  for(s = query; words && *s; s++)
+    if(!epg_word_char(*s) && *s != ' ' && *s != '"' && *s != '*')
+      break;
+
+  if(!words || *s) {
+    /* Regular expression, applies to titles only */
+    tq->tq_fulltext = 0;
+    if(epg_text_regex_terms(tq, query) ||
+       regcomp(&tq->tq_preg0, query, REG_ICASE | REG_EXTENDED | REG_NOSUB)) {
+      free(tq);
+      return NULL;
+    }
+    tq->tq_preg = &tq->tq_preg0;
+    return tq;
+  }
+
+  s = query;
+  while(*s) {
+    if(*s == '"') {
+      phrase = !phrase;
+      follows = 0;
+      s++;
+      continue;
+    }
+    if(!epg_word_char(*s)) {
+      s++;
+      continue;
+    }
+
+    if(epg_text_term_add(tq, &s, follows))
+      break;
+
+    /* Words are prefixes unless quoted */
+    tq->tq_terms[tq->tq_nterms - 1].ett_prefix = !phrase || *s == '*';
+    follows = phrase;
+  }
+
+  if(tq->tq_nterms == 0) {
+    free(tq);
+    return NULL;
+  }
+  return tq;
+}
+
+
+/**
+ *
+ */
+void
+epg_text_query_destroy(epg_text_query_t *tq)
+{
+  if(tq->tq_preg != NULL)
+    regfree(tq->tq_preg);
+  free(tq);
+}
+
+
+/**
+ *
+ */
+static int
+esp_cmp(const void *A, const void *B)
+{
+  const epg_snap_posting_t *a = A, *b = B;
+
+  if(a->esp_event != b->esp_event)
+    return a->esp_event < b->esp_event ? -1 : 1;
+  if(a->esp_field != b->esp_field)
+    return a->esp_field - b->esp_field;
+  return a->esp_pos - b->esp_pos;
+}
+
+
+/**
+ * First term >= 'w'
+ */
+static int
+est_lower(const epg_snap_channel_t *esc, const char *w)
+{
+  int lo = 0, hi = esc->esc_nterms, mid;
+
+  while(lo < hi) {
+    mid = (lo + hi) / 2;
+    if(strcmp(esc->esc_terms[mid].est_word, w) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+
+/**
+ * Postings of a query word, ordered by event, field and position
+ *
+ * Returns number of postings
+ */
+static int
+epg_text_postings(const epg_text_query_t *tq, const epg_text_term_t *ett,
+		  const epg_snap_channel_t *esc, epg_snap_posting_t **vp,
+		  int *allocp)
+{
+  const epg_snap_term_t *est;
+  const epg_snap_posting_t *p;
+  size_t l = strlen(ett->ett_word);
+  int i, j, n = 0, terms = 0;
+
+  for(i = est_lower(esc, ett->ett_word); i < esc->esc_nterms; i++) {
+    est = &esc->esc_terms[i];
+    if(ett->ett_prefix ? strncmp(est->est_word, ett->ett_word, l) :
+       strcmp(est->est_word, ett->ett_word))
+      break;
+
+    p = &esc->esc_postings[est->est_first];
+    for(j = 0; j < est->est_count; j++, p++) {
+      if(p->esp_field != EPG_FIELD_TITLE && !tq->tq_fulltext)
+	continue;
+      if(n == *allocp) {
+	*allocp = MAX(64, *allocp * 2);
+	*vp = realloc(*vp, *allocp * sizeof(epg_snap_posting_t));
+      }
+      (*vp)[n++] = *p;
+    }
+    terms++;
+  }
+
+  if(terms > 1)
+    qsort(*vp, n, sizeof(epg_snap_posting_t), esp_cmp);
+  return n;
+}
+
+
+/**
+ * Add the matching events of a channel to 'esr'
+ */
+void
+epg_text_query_match(epg_text_query_t *tq, epg_snap_channel_t *esc,
+		     epg_snap_result_t *esr)
+{
+  epg_snap_posting_t *a = NULL, *b = NULL, *p;
+  epg_snap_event_t *ese;
+  int na = 0, nb, aa = 0, ab = 0, i, j, k, n;
+  const epg_text_term_t *ett;
+  uint32_t last = 0;
+
+  for(k = 0; k < tq->tq_nterms; k++) {
+    ett = &tq->tq_terms[k];
+    nb = epg_text_postings(tq, ett, esc, &b, &ab);
+
+    if(k > 0) {
+      /* Keep the postings of this word that follow up on the previous */
+      for(i = j = n = 0; j < nb; j++) {
+	p = &b[j];
+
+	while(i < na && (a[i].esp_event < p->esp_event ||
+			 (ett->ett_follows &&
+			  a[i].esp_event == p->esp_event &&
+			  (a[i].esp_field < p->esp_field ||
+			   (a[i].esp_field == p->esp_field &&
+			    a[i].esp_pos + 1 < p->esp_pos)))))
+	  i++;
+	if(i == na)
+	  break;
+
+	if(a[i].esp_event != p->esp_event)
+	  continue;
+	if(ett->ett_follows && (a[i].esp_field != p->esp_field ||
+				a[i].esp_pos + 1 != p->esp_pos))
+	  continue;
+	b[n++] = *p;
+      }
+      nb = n;
+    }
+
+    /* Swap, what we kept is what the next word is matched against */
+    p = a; a = b; b = p;
+    n = aa; aa = ab; ab = n;
+    na = nb;
+    if(na == 0)
+      break;
+  }
+
+  for(i = 0; i < na; i++) {
+    if(i > 0 && a[i].esp_event == last)
+      continue;
+    last = a[i].esp_event;
+    ese = &esc->esc_events[last];
+
+    if(tq->tq_preg != NULL &&
+       (ese->ese_title == NULL || regexec(tq->tq_preg, ese->ese_title, 0,
+					  NULL, 0)))
+      continue;
+
+    if(esr->esr_entries == esr->esr_alloced) {
+      esr->esr_alloced = MAX(100, esr->esr_alloced * 2);
+      esr->esr_array = realloc(esr->esr_array,
+			       esr->esr_alloced * sizeof(epg_snap_event_t *));
+    }
+    esr->esr_array[esr->esr_entries++] = ese;
+  }
+
+  free(a);
+  free(b);
+}
@@ -0,0 +1,208 @@
+/*
+ *  EPG full text search self test
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Runs regular expression queries through the word index of a channel
+ * and checks that every title the expression matches is found, the
+ * index may only narrow down the events to run the expression on:
+ *
+ *   - fixed patterns, quantified spaces and anchors among them
+ *   - random patterns from pieces of regular expression syntax
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <regex.h>
+
+#include "tvheadend.h"
+#include "epg.h"
+
+static const char *words[] = {
+  "the", "late", "show", "news", "a", "b", "ab", "lately", "thelate",
+};
+
+#define NWORDS (sizeof(words) / sizeof(words[0]))
+
+static const char *pieces[] = {
+  "the", "late", "news", "a", "b", " ", " ", "?", "*", "+", "{0,1}",
+  "{1}", "^", ".", "(", ")", "\\ ", "[ ]", "x",
+};
+
+#define NPIECES (sizeof(pieces) / sizeof(pieces[0]))
+
+#define NTITLES 2000
+
+static const char *fixed[] = {
+  "the ?late", "the *late", "a {0,1}b", "a {0}b", "the  ?late",
+  "^ ?late", "^ *late", "^(the)?late", "the ?late show", "the( )?late",
+  "the late", "^the late", "^late", "news$", "the ?late|news",
+  "^a+*", " a+*", " newsx+{0,1}", " lately{1}", " latelyy{0}",
+};
+
+#define NFIXED (sizeof(fixed) / sizeof(fixed[0]))
+
+/**
+ *
+ */
+static int
+e_start_cmp(const event_t *a, const event_t *b)
+{
+  return a->e_start - b->e_start;
+}
+
+
+/**
+ * Titles from the word list, joined with and without spaces
+ */
+static epg_snap_channel_t *
+build_channel(channel_t *ch)
+{
+  epg_snap_channel_t *esc = calloc(1, sizeof(epg_snap_channel_t));
+  event_t *e;
+  char title[128];
+  int i, j, n;
+
+  RB_INIT(&ch->ch_epg_events);
+  esc->esc_nevents = NTITLES;
+  esc->esc_events = calloc(NTITLES, sizeof(epg_snap_event_t));
+
+  for(i = 0; i < NTITLES; i++) {
+    title[0] = 0;
+    n = 1 + rand() % 4;
+    for(j = 0; j < n; j++) {
+      if(j > 0 && rand() % 3)
+	strcat(title, rand() % 4 ? " " : "  ");
+      strcat(title, words[rand() % NWORDS]);
+    }
+
+    e = calloc(1, sizeof(event_t));
+    e->e_start = i;
+    e->e_title = strdup(title);
+    epg_text_update(e);
+    RB_INSERT_SORTED(&ch->ch_epg_events, e, e_channel_link, e_start_cmp);
+
+    esc->esc_events[i].ese_channel = esc;
+    esc->esc_events[i].ese_title = e->e_title;
+  }
+
+  epg_text_index_build(esc, ch);
+  return esc;
+}
+
+
+/**
+ * Returns number of matching titles the query misses, or -1 if the
+ * pattern is not a valid expression
+ */
+static int
+check(epg_snap_channel_t *esc, const char *pattern, int *narrowed)
+{
+  epg_text_query_t *tq;
+  epg_snap_result_t esr;
+  regex_t preg;
+  char *found;
+  int i, missed = 0;
+
+  if(regcomp(&preg, pattern, REG_ICASE | REG_EXTENDED | REG_NOSUB))
+    return -1;
+
+  memset(&esr, 0, sizeof(esr));
+  found = calloc(1, esc->esc_nevents);
+
+  if((tq = epg_text_query_create(pattern, 0, 0)) != NULL) {
+    epg_text_query_match(tq, esc, &esr);
+    epg_text_query_destroy(tq);
+    for(i = 0; i < esr.esr_entries; i++)
+      found[esr.esr_array[i] - esc->esc_events] = 1;
+    *narrowed = 1;
+  } else {
+    /* Full scan */
+    memset(found, 1, esc->esc_nevents);
+    *narrowed = 0;
+  }
+
+  for(i = 0; i < esc->esc_nevents; i++) {
+    if(found[i] ||
+       regexec(&preg, esc->esc_events[i].ese_title, 0, NULL, 0))
+      continue;
+    if(missed++ == 0)
+      printf("'%s' misses '%s'\n", pattern, esc->esc_events[i].ese_title);
+  }
+
+  regfree(&preg);
+  free(esr.esr_array);
+  free(found);
+  return missed;
+}
+
+
+/**
+ *
+ */
+int
+main(int argc, char **argv)
+{
+  channel_t ch;
+  epg_snap_channel_t *esc;
+  char pattern[128];
+  int c, i, j, n, r, narrowed, rounds = 20000, errors = 0, indexed = 0;
+
+  while((c = getopt(argc, argv, "n:")) != -1) {
+    switch(c) {
+    case 'n':
+      rounds = atoi(optarg);
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-n random patterns]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  srand(1);
+  memset(&ch, 0, sizeof(ch));
+  esc = build_channel(&ch);
+
+  for(i = 0; i < NFIXED; i++) {
+    if((r = check(esc, fixed[i], &narrowed)) < 0) {
+      printf("'%s' does not compile\n", fixed[i]);
+      errors++;
+      continue;
+    }
+    errors += r > 0;
+    indexed += narrowed;
+  }
+
+  for(i = 0; i < rounds; i++) {
+    pattern[0] = 0;
+    n = 1 + rand() % 6;
+    for(j = 0; j < n; j++)
+      strcat(pattern, pieces[rand() % NPIECES]);
+    if((r = check(esc, pattern, &narrowed)) < 0)
+      continue;
+    errors += r > 0;
+    indexed += narrowed;
+  }
+
+  printf("%d patterns, %d through the index\n", (int)NFIXED + rounds,
+	 indexed);
+  printf("self test: %s\n", errors ? "FAILED" : "ok");
+  return !!errors;
+}
@@ -51,6 +51,8 @@
 #define PARALLEL_128_2MMX    1284
 #define PARALLEL_128_SSE     1285
 #define PARALLEL_128_SSE2    1286
+#define PARALLEL_256_AVX2    2560
+#define PARALLEL_512_AVX512  5120
 
 #include "parallel_generic.h"
 //// conditionals
@@ -87,6 +89,12 @@
 #elif PARALLEL_MODE==PARALLEL_128_SSE2
 #include "parallel_128_sse2.h"
 #define FUNC(x) (x ## _128sse2)
+#elif PARALLEL_MODE==PARALLEL_256_AVX2
+#include "parallel_256_avx2.h"
+#define FUNC(x) (x ## _256avx2)
+#elif PARALLEL_MODE==PARALLEL_512_AVX512
+#include "parallel_512_avx512.h"
+#define FUNC(x) (x ## _512avx512)
 #else
 #error "unknown/undefined parallel mode"
 #endif
@@ -391,6 +399,10 @@ static void block_decypher_group (
     // most difficult part of all
     // - can't be parallelized
     // - can't be synthetized through boolean terms (8 input bits are too many)
+    // unless the backend has a vector lookup for it
+#ifdef BLOCK_SBOX_GROUP
+    if(!BLOCK_SBOX_GROUP(sbox_out,sbox_in,block_sbox))
+#endif
     for(g=0;g<count_all;g++){
       sbox_out[g]=block_sbox[sbox_in[g]];
     }
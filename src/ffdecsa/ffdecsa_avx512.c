@@ -0,0 +1,2 @@
+#define PARALLEL_MODE PARALLEL_512_AVX512
+#include "FFdecsa.c"
@@ -0,0 +1,472 @@
+/*
+ *  FFdecsa self test and benchmark
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Runs every FFdecsa backend compiled into this build against a set of
+ * fixed control word / ciphertext vectors, checks that all backends
+ * produce identical output and then measures throughput for a range
+ * of cluster sizes and even/odd key mixes.
+ *
+ * The vectors are generated deterministically and the expected CRC of
+ * the descrambled output was recorded from the 32int backend, which is
+ * the plain C reference implementation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "config.h"
+
+typedef struct ffdecsa_backend {
+  const char *name;
+  const char *cpu;
+  int (*get_internal_parallelism)(void);
+  int (*get_suggested_cluster_size)(void);
+  void *(*get_key_struct)(void);
+  void (*free_key_struct)(void *keys);
+  void (*set_control_words)(void *keys, const unsigned char *even,
+			    const unsigned char *odd);
+  int (*decrypt_packets)(void *keys, unsigned char **cluster);
+} ffdecsa_backend_t;
+
+#define BACKEND(x, cpu) \
+extern int get_internal_parallelism_##x(void);\
+extern int get_suggested_cluster_size_##x(void);\
+extern void *get_key_struct_##x(void);\
+extern void free_key_struct_##x(void *keys);\
+extern void set_control_words_##x(void *keys, const unsigned char *even, const unsigned char *odd);\
+extern int decrypt_packets_##x(void *keys, unsigned char **cluster);\
+static const ffdecsa_backend_t backend_##x = { \
+  #x, cpu, \
+  &get_internal_parallelism_##x,\
+  &get_suggested_cluster_size_##x,\
+  &get_key_struct_##x,\
+  &free_key_struct_##x,\
+  &set_control_words_##x,\
+  &decrypt_packets_##x\
+};
+
+BACKEND(32int, NULL);
+#ifdef CONFIG_MMX
+BACKEND(64mmx, "mmx");
+#endif
+#ifdef CONFIG_SSE2
+BACKEND(128sse2, "sse2");
+#endif
+#ifdef CONFIG_AVX2
+BACKEND(256avx2, "avx2");
+#endif
+#ifdef CONFIG_AVX512
+BACKEND(512avx512, "avx512f");
+#endif
+
+/* The first entry is the reference all others are compared against */
+static const ffdecsa_backend_t *backends[] = {
+  &backend_32int,
+#ifdef CONFIG_MMX
+  &backend_64mmx,
+#endif
+#ifdef CONFIG_SSE2
+  &backend_128sse2,
+#endif
+#ifdef CONFIG_AVX2
+  &backend_256avx2,
+#endif
+#ifdef CONFIG_AVX512
+  &backend_512avx512,
+#endif
+  NULL
+};
+
+
+/**
+ * How even and odd scrambled packets are interleaved in a vector
+ */
+typedef enum {
+  MIX_EVEN,       /* Only even */
+  MIX_ODD,        /* Only odd */
+  MIX_SWITCH,     /* Key change half way through, as on a CW rollover */
+  MIX_ALTERNATE,  /* Every other packet, worst case for grouping */
+} key_mix_t;
+
+static const char *mixnames[] = {
+  [MIX_EVEN]      = "even",
+  [MIX_ODD]       = "odd",
+  [MIX_SWITCH]    = "switch",
+  [MIX_ALTERNATE] = "alternate",
+};
+
+typedef struct test_vector {
+  uint8_t even[8];
+  uint8_t odd[8];
+  key_mix_t mix;
+  uint32_t seed;
+  uint32_t crc;   /* CRC32 of the descrambled output */
+} test_vector_t;
+
+#define TV_PACKETS 1024
+
+static const test_vector_t vectors[] = {
+  { { 0x12, 0x34, 0x56, 0x9c, 0x78, 0x9a, 0xbc, 0xce },
+    { 0x11, 0x22, 0x33, 0x66, 0x44, 0x55, 0x66, 0xff },
+    MIX_EVEN, 1, 0x7015df19 },
+  { { 0x12, 0x34, 0x56, 0x9c, 0x78, 0x9a, 0xbc, 0xce },
+    { 0x11, 0x22, 0x33, 0x66, 0x44, 0x55, 0x66, 0xff },
+    MIX_ODD, 2, 0x4f6511de },
+  { { 0xa5, 0x5a, 0xc3, 0xc2, 0x3c, 0x0f, 0xf0, 0x3b },
+    { 0x01, 0x02, 0x03, 0x06, 0x04, 0x05, 0x06, 0x0f },
+    MIX_SWITCH, 3, 0xc4237eb2 },
+  { { 0xde, 0xad, 0xbe, 0x49, 0xef, 0xca, 0xfe, 0xb7 },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    MIX_ALTERNATE, 4, 0x3945d51d },
+};
+
+#define NUM_VECTORS (sizeof(vectors) / sizeof(vectors[0]))
+
+
+/**
+ *
+ */
+static uint32_t
+xorshift(uint32_t *s)
+{
+  uint32_t x = *s;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *s = x;
+}
+
+
+/**
+ *
+ */
+static uint32_t
+crc32_le(const uint8_t *data, size_t len)
+{
+  uint32_t crc = 0xffffffff;
+  int i;
+
+  while(len--) {
+    crc ^= *data++;
+    for(i = 0; i < 8; i++)
+      crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+
+/**
+ * Generate scrambled transport packets
+ *
+ * Every 8th packet carries an adaptation field of random length (which
+ * includes the short residue and 'mini' packet cases) and every 32nd
+ * packet is left in the clear.
+ */
+static void
+generate_packets(uint8_t *buf, int npkts, key_mix_t mix, uint32_t seed)
+{
+  uint32_t s = seed * 2654435761U + 1;
+  uint8_t *tsb;
+  int i, j, odd;
+
+  for(i = 0; i < npkts; i++) {
+    tsb = buf + i * 188;
+
+    for(j = 4; j < 188; j++)
+      tsb[j] = xorshift(&s);
+
+    switch(mix) {
+    case MIX_EVEN:      odd = 0; break;
+    case MIX_ODD:       odd = 1; break;
+    case MIX_SWITCH:    odd = i >= npkts / 2; break;
+    case MIX_ALTERNATE: odd = i & 1; break;
+    default:            abort();
+    }
+
+    tsb[0] = 0x47;
+    tsb[1] = 0x01;
+    tsb[2] = 0x00;
+    tsb[3] = (odd ? 0xc0 : 0x80) | 0x10 | (i & 0xf);
+
+    if((i & 31) == 31)
+      tsb[3] &= 0x3f;
+
+    if((i & 7) == 7) {
+      tsb[3] |= 0x20;
+      tsb[4] = xorshift(&s) % 184;
+    }
+  }
+}
+
+
+/**
+ * Descramble all packets in buf, 'clustersize' packets at a time
+ */
+static void
+descramble(const ffdecsa_backend_t *be, void *keys, uint8_t *buf,
+	   int npkts, int clustersize)
+{
+  unsigned char *cluster[3];
+  int i, n;
+
+  for(i = 0; i < npkts; i += n) {
+    n = npkts - i < clustersize ? npkts - i : clustersize;
+    cluster[0] = buf + i * 188;
+    cluster[1] = buf + (i + n) * 188;
+    cluster[2] = NULL;
+
+    while(cluster[0] != NULL)
+      be->decrypt_packets(keys, cluster);
+  }
+}
+
+
+/**
+ *
+ */
+static int
+cpu_supports(const char *cpu)
+{
+  if(cpu == NULL)
+    return 1;
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_cpu_init();
+  if(!strcmp(cpu, "mmx"))     return __builtin_cpu_supports("mmx");
+  if(!strcmp(cpu, "sse2"))    return __builtin_cpu_supports("sse2");
+  if(!strcmp(cpu, "avx2"))    return __builtin_cpu_supports("avx2");
+  if(!strcmp(cpu, "avx512f")) return __builtin_cpu_supports("avx512f");
+#endif
+  return 0;
+}
+
+
+/**
+ *
+ */
+static int64_t
+getclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/**
+ * Check every backend against the test vectors and the reference
+ */
+static int
+selftest(const ffdecsa_backend_t **bel)
+{
+  const ffdecsa_backend_t *be;
+  const test_vector_t *tv;
+  size_t size = TV_PACKETS * 188;
+  uint8_t *src = malloc(size), *ref = malloc(size), *out = malloc(size);
+  void *keys;
+  uint32_t crc;
+  int i, j, cs, errors = 0;
+
+  for(i = 0; i < NUM_VECTORS; i++) {
+    tv = &vectors[i];
+    generate_packets(src, TV_PACKETS, tv->mix, tv->seed);
+
+    for(j = 0; (be = bel[j]) != NULL; j++) {
+      keys = be->get_key_struct();
+      be->set_control_words(keys, tv->even, tv->odd);
+
+      /* Odd cluster size so group boundaries do not line up */
+      cs = be->get_suggested_cluster_size() + 3;
+      memcpy(out, src, size);
+      descramble(be, keys, out, TV_PACKETS, cs);
+      be->free_key_struct(keys);
+
+      crc = crc32_le(out, size);
+
+      if(j == 0)
+	memcpy(ref, out, size);
+
+      if(crc != tv->crc) {
+	printf("vector %d (%s): %-10s FAILED, crc 0x%08x, expected 0x%08x\n",
+	       i, mixnames[tv->mix], be->name, crc, tv->crc);
+	errors++;
+      } else if(j > 0 && memcmp(ref, out, size)) {
+	printf("vector %d (%s): %-10s FAILED, differs from %s\n",
+	       i, mixnames[tv->mix], be->name, bel[0]->name);
+	errors++;
+      } else {
+	printf("vector %d (%s): %-10s ok\n",
+	       i, mixnames[tv->mix], be->name);
+      }
+    }
+  }
+
+  free(src);
+  free(ref);
+  free(out);
+  return errors;
+}
+
+
+#define BENCH_PACKETS 8192
+
+/**
+ * Measure packets/s for a backend, cluster size and key mix
+ */
+static double
+bench(const ffdecsa_backend_t *be, const uint8_t *src, uint8_t *buf,
+      int clustersize, int duration)
+{
+  const test_vector_t *tv = &vectors[0];
+  void *keys = be->get_key_struct();
+  int64_t start, now;
+  long packets = 0;
+
+  be->set_control_words(keys, tv->even, tv->odd);
+
+  start = getclock();
+  do {
+    /* The scrambling bits are cleared by decrypt_packets(), restore
+       the packets before every pass */
+    memcpy(buf, src, BENCH_PACKETS * 188);
+    descramble(be, keys, buf, BENCH_PACKETS, clustersize);
+    packets += BENCH_PACKETS;
+    now = getclock();
+  } while(now - start < duration * 1000LL);
+
+  be->free_key_struct(keys);
+  return packets * 1000000.0 / (now - start);
+}
+
+
+/**
+ *
+ */
+static void
+usage(const char *argv0)
+{
+  int i;
+
+  printf("Usage: %s [options]\n", argv0);
+  printf("\n");
+  printf(" -b <backend>   Only run the given backend\n");
+  printf(" -t <ms>        Duration of each benchmark run [200]\n");
+  printf(" -s             Self test only, skip benchmarks\n");
+  printf("\n");
+  printf("Backends:");
+  for(i = 0; backends[i] != NULL; i++)
+    printf(" %s", backends[i]->name);
+  printf("\n");
+}
+
+
+/**
+ *
+ */
+int
+main(int argc, char **argv)
+{
+  const ffdecsa_backend_t *bel[sizeof(backends) / sizeof(backends[0])];
+  const ffdecsa_backend_t *be;
+  const char *only = NULL;
+  int duration = 200, selftest_only = 0;
+  int c, i, j, m, n, errors, par;
+  int clustersizes[6];
+  uint8_t *src, *buf;
+
+  while((c = getopt(argc, argv, "b:t:sh")) != -1) {
+    switch(c) {
+    case 'b':
+      only = optarg;
+      break;
+    case 't':
+      duration = atoi(optarg);
+      break;
+    case 's':
+      selftest_only = 1;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  /* The reference is always part of the self test */
+  n = 0;
+  for(i = 0; (be = backends[i]) != NULL; i++) {
+    if(i > 0 && only != NULL && strcmp(only, be->name))
+      continue;
+    if(!cpu_supports(be->cpu)) {
+      printf("%s: not supported by this CPU, skipped\n", be->name);
+      continue;
+    }
+    bel[n++] = be;
+  }
+  bel[n] = NULL;
+
+  errors = selftest(bel);
+  if(errors) {
+    printf("%d self test failure(s)\n", errors);
+    return 1;
+  }
+
+  if(selftest_only)
+    return 0;
+
+  src = malloc(BENCH_PACKETS * 188);
+  buf = malloc(BENCH_PACKETS * 188);
+
+  printf("\n%-10s %-10s %8s %12s %10s\n",
+	 "backend", "keys", "cluster", "packets/s", "Mbit/s");
+
+  for(i = 0; (be = bel[i]) != NULL; i++) {
+    if(only != NULL && strcmp(only, be->name))
+      continue;
+
+    par = be->get_internal_parallelism();
+    clustersizes[0] = par;
+    clustersizes[1] = be->get_suggested_cluster_size();
+    clustersizes[2] = par * 2;
+    clustersizes[3] = par * 4;
+    clustersizes[4] = par * 8;
+    clustersizes[5] = 0;
+
+    for(m = MIX_EVEN; m <= MIX_ALTERNATE; m++) {
+      if(m == MIX_ODD)
+	continue; /* Same cost as even */
+
+      generate_packets(src, BENCH_PACKETS, m, 1);
+
+      for(j = 0; clustersizes[j]; j++) {
+	double pps = bench(be, src, buf, clustersizes[j], duration);
+	printf("%-10s %-10s %8d %12.0f %10.1f%s\n",
+	       be->name, mixnames[m], clustersizes[j], pps,
+	       pps * 188 * 8 / 1000000.0,
+	       j == 1 ? "  (suggested)" : "");
+      }
+    }
+  }
+
+  free(src);
+  free(buf);
+  return 0;
+}
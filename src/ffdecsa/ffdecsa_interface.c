@@ -1,7 +1,5 @@
 /*
- * CPU detection code, extracted from mmx.h
- * (c)1997-99 by H. Dietz and R. Fisher
- * Converted to C and improved by Fabrice Bellard.
+ * FFdecsa backend selection
  *
  * This file is part of Tvheadend.
  *
@@ -67,65 +65,15 @@ MAKEFUNCS(64mmx);
 MAKEFUNCS(128sse2);
 #endif
 
-static csafuncs_t current;
-
-
-
-
-#if defined(__x86_64__)
-#    define REG_a "rax"
-#    define REG_b "rbx"
-#    define REG_c "rcx"
-#    define REG_d "rdx"
-#    define REG_D "rdi"
-#    define REG_S "rsi"
-#    define PTR_SIZE "8"
-typedef int64_t x86_reg;
-
-#    define REG_SP "rsp"
-#    define REG_BP "rbp"
-#    define REGBP   rbp
-#    define REGa    rax
-#    define REGb    rbx
-#    define REGc    rcx
-#    define REGd    rdx
-#    define REGSP   rsp
-
-#elif defined(__i386__)
-
-#    define REG_a "eax"
-#    define REG_b "ebx"
-#    define REG_c "ecx"
-#    define REG_d "edx"
-#    define REG_D "edi"
-#    define REG_S "esi"
-#    define PTR_SIZE "4"
-typedef int32_t x86_reg;
-
-#    define REG_SP "esp"
-#    define REG_BP "ebp"
-#    define REGBP   ebp
-#    define REGa    eax
-#    define REGb    ebx
-#    define REGc    ecx
-#    define REGd    edx
-#    define REGSP   esp
-#else
-typedef int x86_reg;
+#ifdef CONFIG_AVX2
+MAKEFUNCS(256avx2);
 #endif
 
+#ifdef CONFIG_AVX512
+MAKEFUNCS(512avx512);
+#endif
 
-
-/* ebx saving is necessary for PIC. gcc seems unable to see it alone */
-#define cpuid(index,eax,ebx,ecx,edx)\
-    __asm__ volatile\
-        ("mov %%"REG_b", %%"REG_S"\n\t"\
-         "cpuid\n\t"\
-         "xchg %%"REG_b", %%"REG_S\
-         : "=a" (eax), "=S" (ebx),\
-           "=c" (ecx), "=d" (edx)\
-         : "0" (index));
-
+static csafuncs_t current;
 
 
 void
@@ -133,60 +81,39 @@ ffdecsa_init(void)
 {
   current = funcs_32int;
 
-
 #if defined(__i386__) || defined(__x86_64__)
-
-  int eax, ebx, ecx, edx;
-  int max_std_level, std_caps=0;
-  
-#if defined(__i386__)
-
-  x86_reg a, c;
-  __asm__ volatile (
-		    /* See if CPUID instruction is supported ... */
-		    /* ... Get copies of EFLAGS into eax and ecx */
-		    "pushfl\n\t"
-		    "pop %0\n\t"
-		    "mov %0, %1\n\t"
-
-		    /* ... Toggle the ID bit in one copy and store */
-		    /*     to the EFLAGS reg */
-		    "xor $0x200000, %0\n\t"
-		    "push %0\n\t"
-		    "popfl\n\t"
-
-		    /* ... Get the (hopefully modified) EFLAGS */
-		    "pushfl\n\t"
-		    "pop %0\n\t"
-		    : "=a" (a), "=c" (c)
-		    :
-		    : "cc"
-		    );
-
-  if (a != c) {
+  __builtin_cpu_init();
+
+#ifdef CONFIG_AVX512
+  if(__builtin_cpu_supports("avx512f")) {
+    current = funcs_512avx512;
+    tvhlog(LOG_INFO, "CSA", "Using AVX-512 512bit parallel descrambling%s",
+	   __builtin_cpu_supports("avx512vbmi") ? " with VBMI S-box" : "");
+    return;
+  }
 #endif
-    cpuid(0, max_std_level, ebx, ecx, edx);
 
-    if(max_std_level >= 1){
-      cpuid(1, eax, ebx, ecx, std_caps);
+#ifdef CONFIG_AVX2
+  if(__builtin_cpu_supports("avx2")) {
+    current = funcs_256avx2;
+    tvhlog(LOG_INFO, "CSA", "Using AVX2 256bit parallel descrambling");
+    return;
+  }
+#endif
 
 #ifdef CONFIG_SSE2
-      if (std_caps & (1<<26)) {
-	current = funcs_128sse2;
-	tvhlog(LOG_INFO, "CSA", "Using SSE2 128bit parallel descrambling");
-	return;
-      }
+  if(__builtin_cpu_supports("sse2")) {
+    current = funcs_128sse2;
+    tvhlog(LOG_INFO, "CSA", "Using SSE2 128bit parallel descrambling");
+    return;
+  }
 #endif
 
 #ifdef CONFIG_MMX
-      if (std_caps & (1<<23)) {
-	current = funcs_64mmx;
-	tvhlog(LOG_INFO, "CSA", "Using MMX 64bit parallel descrambling");
-	return;
-      }
-#endif
-    }
-#if defined(__i386__)
+  if(__builtin_cpu_supports("mmx")) {
+    current = funcs_64mmx;
+    tvhlog(LOG_INFO, "CSA", "Using MMX 64bit parallel descrambling");
+    return;
   }
 #endif
 #endif
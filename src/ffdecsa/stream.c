@@ -432,6 +432,61 @@ static inline void trasp64_128_88cw(unsigned char *data){
   }
 #undef halfrow
 }
+
+//64-256/512------------------------------------------------------
+/* wider groups are handled as QW independent 64 bit columns, each one
+   transposed exactly like the 64-64 case */
+#define TRASP64_QW_STEP(QW,SPAN,EXPRT,EXPRB) \
+  for(j=0;j<64;j+=2*(SPAN)){ \
+    unsigned long long int t,b; \
+    for(i=0;i<(SPAN);i++){ \
+      for(k=0;k<(QW);k++){ \
+        t=qrow[(QW)*(j+i)+k]; \
+        b=qrow[(QW)*(j+(SPAN)+i)+k]; \
+        qrow[(QW)*(j+i)+k]        = EXPRT; \
+        qrow[(QW)*(j+(SPAN)+i)+k] = EXPRB; \
+      } \
+    } \
+  }
+
+static inline void trasp64_wide_88ccw(unsigned char *data, int qw){
+/* 64 rows of qw*64 bits transposition (bytes transp. - 8x8 rotate counterclockwise)*/
+#define qrow ((unsigned long long int *)data)
+  int i,j,k;
+  TRASP64_QW_STEP(qw,32, (t&0x00000000ffffffffULL)      | ((b                      )<<32),
+                           ((t                      )>>32) |  (b&0xffffffff00000000ULL))
+  TRASP64_QW_STEP(qw,16, (t&0x0000ffff0000ffffULL)      | ((b&0x0000ffff0000ffffULL)<<16),
+                           ((t&0xffff0000ffff0000ULL)>>16) |  (b&0xffff0000ffff0000ULL))
+  TRASP64_QW_STEP(qw, 8, (t&0x00ff00ff00ff00ffULL)     | ((b&0x00ff00ff00ff00ffULL)<<8),
+                           ((t&0xff00ff00ff00ff00ULL)>>8) |  (b&0xff00ff00ff00ff00ULL))
+  TRASP64_QW_STEP(qw, 4, ((t&0x0f0f0f0f0f0f0f0fULL)<<4) |  (b&0x0f0f0f0f0f0f0f0fULL),
+                            (t&0xf0f0f0f0f0f0f0f0ULL)     | ((b&0xf0f0f0f0f0f0f0f0ULL)>>4))
+  TRASP64_QW_STEP(qw, 2, ((t&0x3333333333333333ULL)<<2) |  (b&0x3333333333333333ULL),
+                            (t&0xccccccccccccccccULL)     | ((b&0xccccccccccccccccULL)>>2))
+  TRASP64_QW_STEP(qw, 1, ((t&0x5555555555555555ULL)<<1) |  (b&0x5555555555555555ULL),
+                            (t&0xaaaaaaaaaaaaaaaaULL)     | ((b&0xaaaaaaaaaaaaaaaaULL)>>1))
+#undef qrow
+}
+
+static inline void trasp64_wide_88cw(unsigned char *data, int qw){
+/* 64 rows of qw*64 bits transposition (bytes transp. - 8x8 rotate clockwise)*/
+#define qrow ((unsigned long long int *)data)
+  int i,j,k;
+  TRASP64_QW_STEP(qw,32, (t&0x00000000ffffffffULL)      | ((b                      )<<32),
+                           ((t                      )>>32) |  (b&0xffffffff00000000ULL))
+  TRASP64_QW_STEP(qw,16, (t&0x0000ffff0000ffffULL)      | ((b&0x0000ffff0000ffffULL)<<16),
+                           ((t&0xffff0000ffff0000ULL)>>16) |  (b&0xffff0000ffff0000ULL))
+  TRASP64_QW_STEP(qw, 8, (t&0x00ff00ff00ff00ffULL)     | ((b&0x00ff00ff00ff00ffULL)<<8),
+                           ((t&0xff00ff00ff00ff00ULL)>>8) |  (b&0xff00ff00ff00ff00ULL))
+  TRASP64_QW_STEP(qw, 4, ((t&0xf0f0f0f0f0f0f0f0ULL)>>4) |  (b&0xf0f0f0f0f0f0f0f0ULL),
+                            (t&0x0f0f0f0f0f0f0f0fULL)     | ((b&0x0f0f0f0f0f0f0f0fULL)<<4))
+  TRASP64_QW_STEP(qw, 2, ((t&0xccccccccccccccccULL)>>2) |  (b&0xccccccccccccccccULL),
+                            (t&0x3333333333333333ULL)     | ((b&0x3333333333333333ULL)<<2))
+  TRASP64_QW_STEP(qw, 1, ((t&0xaaaaaaaaaaaaaaaaULL)>>1) |  (b&0xaaaaaaaaaaaaaaaaULL),
+                            (t&0x5555555555555555ULL)     | ((b&0x5555555555555555ULL)<<1))
+#undef qrow
+}
+#undef TRASP64_QW_STEP
 #endif
 
 
@@ -489,6 +544,12 @@ trasp64_64_88ccw(sb);
 #if GROUP_PARALLELISM==128
 trasp64_128_88ccw(sb);
 #endif
+#if GROUP_PARALLELISM==256
+trasp64_wide_88ccw(sb,4);
+#endif
+#if GROUP_PARALLELISM==512
+trasp64_wide_88ccw(sb,8);
+#endif
 DBG(dump_mem("stream_postrot",sb,GROUP_PARALLELISM*8,BYPG));
 
 for(j=0;j<64;j++){
@@ -888,6 +949,12 @@ trasp64_64_88cw(cb);
 #if GROUP_PARALLELISM==128
 trasp64_128_88cw(cb);
 #endif
+#if GROUP_PARALLELISM==256
+trasp64_wide_88cw(cb,4);
+#endif
+#if GROUP_PARALLELISM==512
+trasp64_wide_88cw(cb,8);
+#endif
 
 for(j=0;j<64;j++){
   DBG(fprintf(stderr,"postcall postrot cb[%2i]=",j));
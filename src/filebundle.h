@@ -3,6 +3,10 @@ struct filebundle_entry {
   const unsigned char *data;
   int size;
   int original_size; // -1 if file is not compressed
+  const char *etag;  // Hash of the original file
+  long mtime;
+  const unsigned char *br_data; // Brotli compressed, NULL if not available
+  int br_size;
 };
 
 struct filebundle {
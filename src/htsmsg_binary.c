@@ -22,9 +22,25 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include "htsmsg_binary.h"
 
+/**
+ * Binary fields smaller than this are copied even when they could be
+ * referenced
+ */
+#define HTSMSG_BINARY_IOV_MIN 256
+
+typedef struct htsmsg_binary_iov {
+  uint8_t *hbi_ptr;         /* Next free byte in buffer */
+  uint8_t *hbi_end;
+  uint8_t *hbi_seg;         /* Start of current buffer segment */
+  struct iovec *hbi_iov;
+  int hbi_niov;
+  int hbi_maxiov;
+} htsmsg_binary_iov_t;
+
 /*
  *
  */
@@ -280,3 +296,157 @@ htsmsg_binary_serialize(htsmsg_t *msg, void **datap, size_t *lenp, int maxlen)
   *lenp  = len + 4;
   return 0;
 }
+
+
+/*
+ * Close current buffer segment
+ */
+static int
+htsmsg_binary_iov_flush(htsmsg_binary_iov_t *hbi)
+{
+  if(hbi->hbi_ptr == hbi->hbi_seg)
+    return 0;
+  if(hbi->hbi_niov == hbi->hbi_maxiov)
+    return -1;
+
+  hbi->hbi_iov[hbi->hbi_niov].iov_base = hbi->hbi_seg;
+  hbi->hbi_iov[hbi->hbi_niov].iov_len  = hbi->hbi_ptr - hbi->hbi_seg;
+  hbi->hbi_niov++;
+  hbi->hbi_seg = hbi->hbi_ptr;
+  return 0;
+}
+
+
+/*
+ *
+ */
+static int
+htsmsg_binary_write_iov(htsmsg_t *msg, htsmsg_binary_iov_t *hbi)
+{
+  htsmsg_field_t *f;
+  uint64_t u64;
+  uint8_t *ptr;
+  int l, i, namelen;
+
+  TAILQ_FOREACH(f, &msg->hm_fields, hmf_link) {
+    namelen = f->hmf_name ? strlen(f->hmf_name) : 0;
+
+    switch(f->hmf_type) {
+    case HMF_MAP:
+    case HMF_LIST:
+      l = htsmsg_binary_count(&f->hmf_msg);
+      break;
+
+    case HMF_STR:
+      l = strlen(f->hmf_str);
+      break;
+
+    case HMF_BIN:
+      l = f->hmf_binsize;
+      break;
+
+    case HMF_S64:
+      u64 = f->hmf_s64;
+      l = 0;
+      while(u64 != 0) {
+	l++;
+	u64 = u64 >> 8;
+      }
+      break;
+    default:
+      abort();
+    }
+
+    if(hbi->hbi_end - hbi->hbi_ptr < 6 + namelen)
+      return -1;
+
+    ptr = hbi->hbi_ptr;
+    *ptr++ = f->hmf_type;
+    *ptr++ = namelen;
+    *ptr++ = l >> 24;
+    *ptr++ = l >> 16;
+    *ptr++ = l >> 8;
+    *ptr++ = l;
+
+    if(namelen > 0) {
+      memcpy(ptr, f->hmf_name, namelen);
+      ptr += namelen;
+    }
+    hbi->hbi_ptr = ptr;
+
+    if(f->hmf_type == HMF_MAP || f->hmf_type == HMF_LIST) {
+      if(htsmsg_binary_write_iov(&f->hmf_msg, hbi))
+	return -1;
+      continue;
+    }
+
+    if(f->hmf_type == HMF_BIN && !(f->hmf_flags & HMF_ALLOCED) &&
+       l >= HTSMSG_BINARY_IOV_MIN) {
+      if(htsmsg_binary_iov_flush(hbi) || hbi->hbi_niov == hbi->hbi_maxiov)
+	return -1;
+      hbi->hbi_iov[hbi->hbi_niov].iov_base = (void *)f->hmf_bin;
+      hbi->hbi_iov[hbi->hbi_niov].iov_len  = l;
+      hbi->hbi_niov++;
+      continue;
+    }
+
+    if(hbi->hbi_end - ptr < l)
+      return -1;
+
+    switch(f->hmf_type) {
+    case HMF_STR:
+      memcpy(ptr, f->hmf_str, l);
+      break;
+
+    case HMF_BIN:
+      memcpy(ptr, f->hmf_bin, l);
+      break;
+
+    case HMF_S64:
+      u64 = f->hmf_s64;
+      for(i = 0; i < l; i++) {
+	ptr[i] = u64;
+	u64 = u64 >> 8;
+      }
+      break;
+    }
+    hbi->hbi_ptr = ptr + l;
+  }
+  return 0;
+}
+
+
+/*
+ *
+ */
+int
+htsmsg_binary_serialize_iov(htsmsg_t *msg, void *buf, size_t buflen,
+			    struct iovec *iov, int maxiov, size_t *usedp)
+{
+  htsmsg_binary_iov_t hbi;
+  size_t len;
+  uint8_t *data = buf;
+
+  if(buflen < 4)
+    return -1;
+
+  len = htsmsg_binary_count(msg);
+
+  data[0] = len >> 24;
+  data[1] = len >> 16;
+  data[2] = len >> 8;
+  data[3] = len;
+
+  hbi.hbi_seg    = data;
+  hbi.hbi_ptr    = data + 4;
+  hbi.hbi_end    = data + buflen;
+  hbi.hbi_iov    = iov;
+  hbi.hbi_niov   = 0;
+  hbi.hbi_maxiov = maxiov;
+
+  if(htsmsg_binary_write_iov(msg, &hbi) || htsmsg_binary_iov_flush(&hbi))
+    return -1;
+
+  *usedp = hbi.hbi_ptr - data;
+  return hbi.hbi_niov;
+}
@@ -30,4 +30,19 @@ htsmsg_t *htsmsg_binary_deserialize(const void *data, size_t len,
 int htsmsg_binary_serialize(htsmsg_t *msg, void **datap, size_t *lenp,
 			    int maxlen);
 
+/**
+ * Serialize into a caller supplied buffer for writev().
+ *
+ * Binary fields the message does not own (htsmsg_add_binptr()) are
+ * referenced from the iovec instead of being copied, so the message
+ * must stay around until the data is written.
+ *
+ * Returns number of iovecs used and bytes of 'buf' consumed in *usedp,
+ * or -1 if 'buf' or 'iov' is too small.
+ */
+struct iovec;
+
+int htsmsg_binary_serialize_iov(htsmsg_t *msg, void *buf, size_t buflen,
+				struct iovec *iov, int maxiov, size_t *usedp);
+
 #endif /* HTSMSG_BINARY_H_ */
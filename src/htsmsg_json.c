@@ -22,42 +22,173 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "htsmsg_json.h"
 #include "htsbuf.h"
 
+#define JSON_CHUNK_SIZE 65536
+
+/**
+ * Output is written straight into large buffers that are handed over
+ * to the htsbuf queue once full
+ */
+typedef struct json_writer {
+  htsbuf_queue_t *jw_hq;
+  char *jw_buf;
+  size_t jw_len;
+  size_t jw_size;
+} json_writer_t;
+
+/**
+ * Characters that must be escaped in strings
+ */
+static const char json_escape[256] = {
+  ['\b'] = 'b', ['\t'] = 't', ['\n'] = 'n', ['\f'] = 'f', ['\r'] = 'r',
+  [0x01] = 'u', [0x02] = 'u', [0x03] = 'u', [0x04] = 'u', [0x05] = 'u',
+  [0x06] = 'u', [0x07] = 'u', [0x0b] = 'u', [0x0e] = 'u', [0x0f] = 'u',
+  [0x10] = 'u', [0x11] = 'u', [0x12] = 'u', [0x13] = 'u', [0x14] = 'u',
+  [0x15] = 'u', [0x16] = 'u', [0x17] = 'u', [0x18] = 'u', [0x19] = 'u',
+  [0x1a] = 'u', [0x1b] = 'u', [0x1c] = 'u', [0x1d] = 'u', [0x1e] = 'u',
+  [0x1f] = 'u', ['"'] = '"', ['\\'] = '\\',
+};
+
+static const char json_digits[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/**
+ * Hand over the current buffer and start a new one of at least 'len'
+ */
+static void
+jw_flush(json_writer_t *jw, size_t len)
+{
+  if(jw->jw_len > 0)
+    htsbuf_append_prealloc(jw->jw_hq, jw->jw_buf, jw->jw_len);
+  else
+    free(jw->jw_buf);
+
+  jw->jw_size = len > JSON_CHUNK_SIZE ? len : JSON_CHUNK_SIZE;
+  jw->jw_buf = malloc(jw->jw_size);
+  jw->jw_len = 0;
+}
+
+/**
+ * Returns pointer to 'len' bytes of free space
+ */
+static inline char *
+jw_reserve(json_writer_t *jw, size_t len)
+{
+  if(jw->jw_size - jw->jw_len < len)
+    jw_flush(jw, len);
+  return jw->jw_buf + jw->jw_len;
+}
+
+static inline void
+jw_append(json_writer_t *jw, const char *data, size_t len)
+{
+  memcpy(jw_reserve(jw, len), data, len);
+  jw->jw_len += len;
+}
+
+static inline void
+jw_char(json_writer_t *jw, char c)
+{
+  *jw_reserve(jw, 1) = c;
+  jw->jw_len++;
+}
+
+/**
+ * Length of the prefix of 's' that needs no escaping. Checks eight bytes
+ * at a time for control characters, '"' and '\\'
+ */
+static size_t
+json_plain_len(const char *s, size_t len)
+{
+  const uint64_t ones = 0x0101010101010101ULL, highs = ones << 7;
+  size_t i = 0;
+  uint64_t w, q, b;
+
+  for(; i + 8 <= len; i += 8) {
+    memcpy(&w, s + i, 8);
+    q = w ^ (ones * '"');
+    b = w ^ (ones * '\\');
+    if((((w - ones * 0x20) & ~w) | ((q - ones) & ~q) | ((b - ones) & ~b)) &
+       highs)
+      break;
+  }
+
+  while(i < len && !json_escape[(uint8_t)s[i]])
+    i++;
+  return i;
+}
+
 /**
  *
  */
 static void
-htsmsg_json_encode_string(const char *str, htsbuf_queue_t *hq)
+jw_string(json_writer_t *jw, const char *str)
 {
-  const char *s = str;
-
-  htsbuf_append(hq, "\"", 1);
-
-  while(*s != 0) {
-    if(*s == '"' || *s == '\\' || *s == '\n' || *s == '\t' || *s == '\r') {
-      htsbuf_append(hq, str, s - str);
-
-      if(*s == '"')
-	htsbuf_append(hq, "\\\"", 2);
-      else if(*s == '\n') 
-	htsbuf_append(hq, "\\n", 2);
-      else if(*s == '\t') 
-	htsbuf_append(hq, "\\t", 2);
-      else if(*s == '\r')
-	htsbuf_append(hq, "\\r", 2);
-      else
-	htsbuf_append(hq, "\\\\", 2);
-      s++;
-      str = s;
+  size_t len = strlen(str), l;
+  char *d;
+  uint8_t c;
+
+  jw_char(jw, '"');
+
+  while(1) {
+    l = json_plain_len(str, len);
+    jw_append(jw, str, l);
+    str += l;
+    len -= l;
+
+    if(len == 0)
+      break;
+    c = *str;
+
+    d = jw_reserve(jw, 6);
+    d[0] = '\\';
+    d[1] = json_escape[c];
+    if(d[1] == 'u') {
+      d[2] = '0';
+      d[3] = '0';
+      d[4] = "0123456789abcdef"[c >> 4];
+      d[5] = "0123456789abcdef"[c & 15];
+      jw->jw_len += 6;
     } else {
-      s++;
+      jw->jw_len += 2;
     }
+    str++;
+    len--;
   }
-  htsbuf_append(hq, str, s - str);
-  htsbuf_append(hq, "\"", 1);
+
+  jw_char(jw, '"');
+}
+
+/**
+ *
+ */
+static void
+jw_s64(json_writer_t *jw, int64_t v)
+{
+  char buf[24], *p = buf + sizeof(buf);
+  uint64_t u = v < 0 ? -(uint64_t)v : v;
+
+  while(u >= 100) {
+    p -= 2;
+    memcpy(p, json_digits + (u % 100) * 2, 2);
+    u /= 100;
+  }
+  if(u >= 10) {
+    p -= 2;
+    memcpy(p, json_digits + u * 2, 2);
+  } else {
+    *--p = '0' + u;
+  }
+  if(v < 0)
+    *--p = '-';
+
+  jw_append(jw, p, buf + sizeof(buf) - p);
 }
 
 
@@ -68,45 +199,43 @@ htsmsg_json_encode_string(const char *str, htsbuf_queue_t *hq)
  * no matter what current locale says. This is according to the JSON spec.
  */
 static void
-htsmsg_json_write(htsmsg_t *msg, htsbuf_queue_t *hq, int isarray,
+htsmsg_json_write(htsmsg_t *msg, json_writer_t *jw, int isarray,
 		  int indent, int pretty)
 {
   htsmsg_field_t *f;
-  char buf[30];
   static const char *indentor = "\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
 
-  htsbuf_append(hq, isarray ? "[" : "{", 1);
+  jw_char(jw, isarray ? '[' : '{');
 
   TAILQ_FOREACH(f, &msg->hm_fields, hmf_link) {
 
     if(pretty) 
-      htsbuf_append(hq, indentor, indent < 16 ? indent : 16);
+      jw_append(jw, indentor, indent < 16 ? indent : 16);
 
     if(!isarray) {
-      htsmsg_json_encode_string(f->hmf_name ?: "noname", hq);
-      htsbuf_append(hq, ": ", 2);
+      jw_string(jw, f->hmf_name ?: "noname");
+      jw_append(jw, ": ", 2);
     }
 
     switch(f->hmf_type) {
     case HMF_MAP:
-      htsmsg_json_write(&f->hmf_msg, hq, 0, indent + 1, pretty);
+      htsmsg_json_write(&f->hmf_msg, jw, 0, indent + 1, pretty);
       break;
 
     case HMF_LIST:
-      htsmsg_json_write(&f->hmf_msg, hq, 1, indent + 1, pretty);
+      htsmsg_json_write(&f->hmf_msg, jw, 1, indent + 1, pretty);
       break;
 
     case HMF_STR:
-      htsmsg_json_encode_string(f->hmf_str, hq);
+      jw_string(jw, f->hmf_str);
       break;
 
     case HMF_BIN:
-      htsmsg_json_encode_string("binary", hq);
+      jw_string(jw, "binary");
       break;
 
     case HMF_S64:
-      snprintf(buf, sizeof(buf), "%" PRId64, f->hmf_s64);
-      htsbuf_append(hq, buf, strlen(buf));
+      jw_s64(jw, f->hmf_s64);
       break;
 
     default:
@@ -114,12 +243,12 @@ htsmsg_json_write(htsmsg_t *msg, htsbuf_queue_t *hq, int isarray,
     }
 
     if(TAILQ_NEXT(f, hmf_link))
-      htsbuf_append(hq, ",", 1);
+      jw_char(jw, ',');
   }
   
   if(pretty) 
-    htsbuf_append(hq, indentor, indent-1 < 16 ? indent-1 : 16);
-  htsbuf_append(hq, isarray ? "]" : "}", 1);
+    jw_append(jw, indentor, indent-1 < 16 ? indent-1 : 16);
+  jw_char(jw, isarray ? ']' : '}');
 }
 
 /**
@@ -128,9 +257,21 @@ htsmsg_json_write(htsmsg_t *msg, htsbuf_queue_t *hq, int isarray,
 int
 htsmsg_json_serialize(htsmsg_t *msg, htsbuf_queue_t *hq, int pretty)
 {
-  htsmsg_json_write(msg, hq, msg->hm_islist, 2, pretty);
+  json_writer_t jw;
+
+  jw.jw_hq = hq;
+  jw.jw_buf = NULL;
+  jw.jw_len = jw.jw_size = 0;
+
+  htsmsg_json_write(msg, &jw, msg->hm_islist, 2, pretty);
   if(pretty) 
-    htsbuf_append(hq, "\n", 1);
+    jw_char(&jw, '\n');
+
+  /* Give back what the last buffer didn't use */
+  if(jw.jw_len > 0)
+    htsbuf_append_prealloc(hq, realloc(jw.jw_buf, jw.jw_len), jw.jw_len);
+  else
+    free(jw.jw_buf);
   return 0;
 }
 
@@ -0,0 +1,455 @@
+/*
+ *  JSON serializer self test and benchmark
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Checks htsmsg_json_serialize() against fixed escape and number cases
+ * and a parse round trip, then measures it against the previous
+ * htsbuf_append() based writer (kept below for reference) on:
+ *
+ *   - an EPG grid reply, shaped like the one from /epg
+ *   - a dtable reply, shaped like tablemgr get on the channel table
+ *   - any JSON files given with -f, e.g. saved /epg or /tablemgr replies
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "htsmsg_json.h"
+
+typedef struct payload {
+  const char *name;
+  htsmsg_t *msg;
+} payload_t;
+
+static const char *words[] = {
+  "news", "weather", "football", "tennis", "movie", "drama", "comedy",
+  "cooking", "travel", "history", "science", "nature", "music", "quiz",
+  "documentary", "kids", "late", "show", "talk", "rger", "resund",
+};
+
+#define NWORDS (sizeof(words) / sizeof(words[0]))
+
+/**
+ *
+ */
+static int64_t
+getclock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/**
+ * The writer htsmsg_json_serialize() used before
+ */
+static void
+legacy_encode_string(const char *str, htsbuf_queue_t *hq)
+{
+  const char *s = str;
+
+  htsbuf_append(hq, "\"", 1);
+
+  while(*s != 0) {
+    if(*s == '"' || *s == '\\' || *s == '\n' || *s == '\t' || *s == '\r') {
+      htsbuf_append(hq, str, s - str);
+
+      if(*s == '"')
+	htsbuf_append(hq, "\\\"", 2);
+      else if(*s == '\n')
+	htsbuf_append(hq, "\\n", 2);
+      else if(*s == '\t')
+	htsbuf_append(hq, "\\t", 2);
+      else if(*s == '\r')
+	htsbuf_append(hq, "\\r", 2);
+      else
+	htsbuf_append(hq, "\\\\", 2);
+      s++;
+      str = s;
+    } else {
+      s++;
+    }
+  }
+  htsbuf_append(hq, str, s - str);
+  htsbuf_append(hq, "\"", 1);
+}
+
+static void
+legacy_write(htsmsg_t *msg, htsbuf_queue_t *hq, int isarray)
+{
+  htsmsg_field_t *f;
+  char buf[30];
+
+  htsbuf_append(hq, isarray ? "[" : "{", 1);
+
+  TAILQ_FOREACH(f, &msg->hm_fields, hmf_link) {
+    if(!isarray) {
+      legacy_encode_string(f->hmf_name ?: "noname", hq);
+      htsbuf_append(hq, ": ", 2);
+    }
+
+    switch(f->hmf_type) {
+    case HMF_MAP:
+      legacy_write(&f->hmf_msg, hq, 0);
+      break;
+    case HMF_LIST:
+      legacy_write(&f->hmf_msg, hq, 1);
+      break;
+    case HMF_STR:
+      legacy_encode_string(f->hmf_str, hq);
+      break;
+    case HMF_BIN:
+      legacy_encode_string("binary", hq);
+      break;
+    case HMF_S64:
+      snprintf(buf, sizeof(buf), "%" PRId64, f->hmf_s64);
+      htsbuf_append(hq, buf, strlen(buf));
+      break;
+    default:
+      abort();
+    }
+
+    if(TAILQ_NEXT(f, hmf_link))
+      htsbuf_append(hq, ",", 1);
+  }
+  htsbuf_append(hq, isarray ? "]" : "}", 1);
+}
+
+static int
+legacy_serialize(htsmsg_t *msg, htsbuf_queue_t *hq, int pretty)
+{
+  legacy_write(msg, hq, msg->hm_islist);
+  return 0;
+}
+
+
+/**
+ * Serialize to a string
+ */
+static char *
+serialize(htsmsg_t *msg, int (*fn)(htsmsg_t *, htsbuf_queue_t *, int))
+{
+  htsbuf_queue_t hq;
+  char *r;
+  size_t len;
+
+  htsbuf_queue_init(&hq, 0);
+  fn(msg, &hq, 0);
+  len = hq.hq_size;
+  r = malloc(len + 1);
+  htsbuf_read(&hq, r, len);
+  r[len] = 0;
+  return r;
+}
+
+
+/**
+ *
+ */
+static uint32_t
+xorshift(uint32_t *s)
+{
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+}
+
+static void
+add_words(htsmsg_t *m, const char *name, int n, uint32_t *seed)
+{
+  char buf[512];
+  int i, l = 0;
+
+  for(i = 0; i < n && l < sizeof(buf) - 32; i++)
+    l += snprintf(buf + l, sizeof(buf) - l, "%s%s", i ? " " : "",
+		  words[xorshift(seed) % NWORDS]);
+
+  /* Some descriptions carry line breaks and quotes */
+  if(n > 10 && (*seed & 7) == 0)
+    snprintf(buf + l, sizeof(buf) - l, ".\n\"%s\"", words[*seed % NWORDS]);
+
+  htsmsg_add_str(m, name, buf);
+}
+
+/**
+ * 5000 events, like an unpaged /epg reply
+ */
+static htsmsg_t *
+build_epg(void)
+{
+  htsmsg_t *out = htsmsg_create_map(), *array = htsmsg_create_list(), *m;
+  uint32_t seed = 1;
+  char buf[64];
+  int i, start = 1341320000;
+
+  for(i = 0; i < 5000; i++) {
+    m = htsmsg_create_map();
+    snprintf(buf, sizeof(buf), "Channel %d", i % 50);
+    htsmsg_add_str(m, "channel", buf);
+    htsmsg_add_u32(m, "channelid", i % 50 + 1);
+    snprintf(buf, sizeof(buf), "http://logos.example.com/%d.png", i % 50);
+    htsmsg_add_str(m, "chicon", buf);
+    add_words(m, "title", 2 + xorshift(&seed) % 3, &seed);
+    add_words(m, "description", 20 + xorshift(&seed) % 40, &seed);
+    htsmsg_add_u32(m, "id", 100000 + i);
+    htsmsg_add_u32(m, "start", start + (i / 50) * 1800);
+    htsmsg_add_u32(m, "end", start + (i / 50 + 1) * 1800);
+    htsmsg_add_u32(m, "duration", 1800);
+    htsmsg_add_str(m, "contentgrp", "Movie / Drama");
+    htsmsg_add_msg(array, NULL, m);
+  }
+
+  htsmsg_add_u32(out, "totalCount", 5000);
+  htsmsg_add_msg(out, "entries", array);
+  return out;
+}
+
+/**
+ * 500 rows, like tablemgr get on the channel table
+ */
+static htsmsg_t *
+build_dtable(void)
+{
+  htsmsg_t *out = htsmsg_create_map(), *array = htsmsg_create_list(), *m;
+  uint32_t seed = 2;
+  char buf[64];
+  int i;
+
+  for(i = 0; i < 500; i++) {
+    m = htsmsg_create_map();
+    snprintf(buf, sizeof(buf), "Channel %d HD", i);
+    htsmsg_add_str(m, "name", buf);
+    htsmsg_add_u32(m, "chid", i + 1);
+    htsmsg_add_str(m, "tags", i & 1 ? "1,4,7" : "");
+    htsmsg_add_str(m, "xmltvsrc", i & 3 ? "None" : "channel.example.com");
+    snprintf(buf, sizeof(buf), "http://logos.example.com/%d.png", i);
+    htsmsg_add_str(m, "ch_icon", buf);
+    htsmsg_add_s32(m, "epg_pre_start", xorshift(&seed) % 10);
+    htsmsg_add_s32(m, "epg_post_end", -(int)(xorshift(&seed) % 10));
+    htsmsg_add_u32(m, "number", i + 1);
+    htsmsg_add_u32(m, "enabled", 1);
+    htsmsg_add_msg(array, NULL, m);
+  }
+
+  htsmsg_add_msg(out, "entries", array);
+  return out;
+}
+
+/**
+ *
+ */
+static htsmsg_t *
+load_file(const char *path)
+{
+  htsmsg_t *m;
+  FILE *fp;
+  char *buf;
+  long len;
+
+  if((fp = fopen(path, "r")) == NULL) {
+    perror(path);
+    return NULL;
+  }
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  buf = malloc(len + 1);
+  if(fread(buf, 1, len, fp) != len)
+    len = 0;
+  buf[len] = 0;
+  fclose(fp);
+
+  if((m = htsmsg_json_deserialize(buf)) == NULL)
+    fprintf(stderr, "%s: Unable to parse JSON\n", path);
+  free(buf);
+  return m;
+}
+
+
+/**
+ *
+ */
+static int
+check(const char *what, const char *got, const char *expect)
+{
+  if(!strcmp(got, expect))
+    return 0;
+  printf("%s: FAILED\n  got    %s\n  expect %s\n", what, got, expect);
+  return 1;
+}
+
+/**
+ * Fixed cases, and output that parses back to the same message
+ */
+static int
+selftest(payload_t *pl, int npl)
+{
+  static const struct {
+    const char *in, *out;
+  } strings[] = {
+    { "", "\"\"" },
+    { "plain ascii, longer than eight bytes", "\"plain ascii, longer than eight bytes\"" },
+    { "a\"b\\c", "\"a\\\"b\\\\c\"" },
+    { "tab\tnl\ncr\r", "\"tab\\tnl\\ncr\\r\"" },
+    { "\x01\x1f\b\f\x7f", "\"\\u0001\\u001f\\b\\f\x7f\"" },
+    { "01234567\"", "\"01234567\\\"\"" },
+    { "resund rger", "\"resund rger\"" },
+  };
+  static const int64_t numbers[] = {
+    0, 1, 9, 10, 99, 100, -1, -10, 1234567890123LL,
+    INT64_MAX, INT64_MIN,
+  };
+  htsmsg_t *m;
+  char *a, *b, expect[64];
+  int i, errors = 0;
+
+  for(i = 0; i < sizeof(strings) / sizeof(strings[0]); i++) {
+    m = htsmsg_create_list();
+    htsmsg_add_str(m, NULL, strings[i].in);
+    a = serialize(m, htsmsg_json_serialize);
+    snprintf(expect, sizeof(expect), "[%s]", strings[i].out);
+    errors += check("string", a, expect);
+    free(a);
+    htsmsg_destroy(m);
+  }
+
+  for(i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+    m = htsmsg_create_list();
+    htsmsg_add_s64(m, NULL, numbers[i]);
+    a = serialize(m, htsmsg_json_serialize);
+    snprintf(expect, sizeof(expect), "[%"PRId64"]", numbers[i]);
+    errors += check("number", a, expect);
+    free(a);
+    htsmsg_destroy(m);
+  }
+
+  for(i = 0; i < npl; i++) {
+    a = serialize(pl[i].msg, htsmsg_json_serialize);
+    m = htsmsg_json_deserialize(a);
+    b = m != NULL ? serialize(m, htsmsg_json_serialize) : strdup("");
+    errors += check(pl[i].name, b, a);
+    free(a);
+    free(b);
+    if(m != NULL)
+      htsmsg_destroy(m);
+  }
+
+  printf("self test: %s\n", errors ? "FAILED" : "ok");
+  return errors;
+}
+
+
+/**
+ * Returns MB/s
+ */
+static double
+bench(htsmsg_t *msg, int (*fn)(htsmsg_t *, htsbuf_queue_t *, int),
+      int duration, size_t *sizep)
+{
+  htsbuf_queue_t hq;
+  int64_t start, now;
+  double bytes = 0;
+
+  start = getclock();
+  do {
+    htsbuf_queue_init(&hq, 0);
+    fn(msg, &hq, 0);
+    bytes += hq.hq_size;
+    *sizep = hq.hq_size;
+    htsbuf_queue_flush(&hq);
+    now = getclock();
+  } while(now - start < duration * 1000LL);
+
+  return bytes / (now - start);
+}
+
+
+/**
+ *
+ */
+static void
+usage(const char *argv0)
+{
+  printf("Usage: %s [options]\n", argv0);
+  printf("\n");
+  printf(" -f <file>      Also run on the JSON in <file>\n");
+  printf(" -t <ms>        Duration of each benchmark run [500]\n");
+  printf(" -s             Self test only, skip benchmarks\n");
+}
+
+
+/**
+ *
+ */
+int
+main(int argc, char **argv)
+{
+  payload_t pl[16];
+  int c, i, npl = 0, duration = 500, selftest_only = 0;
+  double legacy, current;
+  size_t size;
+
+  pl[npl].name = "epg";
+  pl[npl++].msg = build_epg();
+  pl[npl].name = "dtable";
+  pl[npl++].msg = build_dtable();
+
+  while((c = getopt(argc, argv, "f:t:sh")) != -1) {
+    switch(c) {
+    case 'f':
+      if(npl == sizeof(pl) / sizeof(pl[0]))
+	break;
+      if((pl[npl].msg = load_file(optarg)) == NULL)
+	return 1;
+      pl[npl++].name = optarg;
+      break;
+    case 't':
+      duration = atoi(optarg);
+      break;
+    case 's':
+      selftest_only = 1;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(selftest(pl, npl))
+    return 1;
+
+  if(selftest_only)
+    return 0;
+
+  printf("\n%-24s %10s %12s %12s %8s\n",
+	 "payload", "bytes", "legacy MB/s", "MB/s", "speedup");
+
+  for(i = 0; i < npl; i++) {
+    legacy  = bench(pl[i].msg, legacy_serialize, duration, &size);
+    current = bench(pl[i].msg, htsmsg_json_serialize, duration, &size);
+    printf("%-24s %10zu %12.1f %12.1f %7.2fx\n",
+	   pl[i].name, size, legacy, current, current / legacy);
+  }
+  return 0;
+}
@@ -39,10 +39,13 @@
 #include "streaming.h"
 #include "psi.h"
 #include "htsmsg_binary.h"
+#include "timeshift.h"
 
 #include <sys/statvfs.h>
 #include "settings.h"
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
 
 static void *htsp_server;
 
@@ -50,6 +53,48 @@ static void *htsp_server;
 
 #define HTSP_PRIV_MASK (ACCESS_STREAMING)
 
+/**
+ * Connection I/O is served by a few event loop threads, each owning
+ * its share of the sockets. Requests are executed by a separate pool
+ * as methods may block on global_lock
+ */
+#define HTSP_IO_THREADS     2
+#define HTSP_METHOD_THREADS 4
+#define HTSP_METHOD_BATCH   8   /* Requests per connection per turn */
+#define HTSP_READ_BATCH     64  /* Reads per connection per event */
+#define HTSP_NOACCESS_DELAY 250000 /* us, before a 'noaccess' reply */
+
+/**
+ * Writer batching: at most this many messages / bytes of streaming
+ * payload are dequeued and written with a single writev()
+ */
+#define HTSP_WRITE_BATCH   32
+#define HTSP_WRITE_WINDOW  (256 * 1024)
+#define HTSP_WRITE_IOVECS  (HTSP_WRITE_BATCH * 4)
+#define HTSP_WRITE_BUFSIZE (16 * 1024)
+#define HTSP_WRITE_ROUNDS  4    /* Batches per connection per turn */
+
+/**
+ * Streaming queue control. The queue delay of a subscription is the
+ * DTS distance between its oldest queued and its newest packet.
+ * B-frames are dropped above half the target latency, whole GOPs are
+ * dropped above it. The byte limit is a last resort for streams
+ * without DTS
+ */
+#define HTSP_LATENCY_DEFAULT   2000   /* ms */
+#define HTSP_LATENCY_MIN       100
+#define HTSP_LATENCY_MAX       30000
+#define HTSP_QUEUE_MAX_PAYLOAD (32 * 1024 * 1024)
+#define HTSP_PTS_MASK          0x1ffffffffLL
+
+/**
+ * Async metadata change log. Every broadcast is numbered and the last
+ * HTSP_CHANGELOG_SIZE are kept serialized. A client that enables async
+ * mode with the epoch and version it last saw only gets what it
+ * missed, other clients get all metadata in one 'initialSync' message
+ */
+#define HTSP_CHANGELOG_SIZE 4096
+
 extern char *dvr_storage;
 
 LIST_HEAD(htsp_connection_list, htsp_connection);
@@ -57,9 +102,29 @@ LIST_HEAD(htsp_subscription_list, htsp_subscription);
 
 TAILQ_HEAD(htsp_msg_queue, htsp_msg);
 TAILQ_HEAD(htsp_msg_q_queue, htsp_msg_q);
+TAILQ_HEAD(htsp_connection_queue, htsp_connection);
+TAILQ_HEAD(htsp_inmsg_queue, htsp_inmsg);
 
 static struct htsp_connection_list htsp_async_connections;
 
+/**
+ * Change log, protected by global_lock
+ */
+typedef struct htsp_change {
+  uint32_t hc_version;
+  pktbuf_t *hc_pb;
+} htsp_change_t;
+
+static htsp_change_t htsp_changelog[HTSP_CHANGELOG_SIZE];
+static uint32_t htsp_epoch;
+static uint32_t htsp_version;
+static pktbuf_t *htsp_sync_pb;     /* Cached 'initialSync' */
+static uint32_t htsp_sync_version;
+static int htsp_sync_builds;
+static int htsp_sync_legacy;
+static int htsp_sync_delta;
+static int htsp_sync_bulk;
+
 static void htsp_streaming_input(void *opaque, streaming_message_t *sm);
 
 
@@ -69,7 +134,8 @@ static void htsp_streaming_input(void *opaque, streaming_message_t *sm);
 typedef struct htsp_msg {
   TAILQ_ENTRY(htsp_msg) hm_link;
 
-  htsmsg_t *hm_msg;
+  htsmsg_t *hm_msg;     /* NULL if hm_pb is an already serialized
+			   message shared between connections */
   int hm_payloadsize;         /* For maintaining stats about streaming
 				 buffer depth */
 
@@ -77,6 +143,9 @@ typedef struct htsp_msg {
 			   hm_msg can contain messages that points
 			   to packet payload so to avoid copy we
 			   keep a reference here */
+
+  int64_t hm_dts;       /* Streaming packets only, 90kHz */
+  int hm_frametype;     /* -1 if not a streaming packet */
 } htsp_msg_t;
 
 
@@ -93,12 +162,47 @@ typedef struct htsp_msg_q {
 } htsp_msg_q_t;
 
 
+/**
+ * Received request waiting for the method pool
+ */
+typedef struct htsp_inmsg {
+  TAILQ_ENTRY(htsp_inmsg) him_link;
+  htsmsg_t *him_msg;
+} htsp_inmsg_t;
+
+
+/**
+ * Event loop
+ */
+typedef struct htsp_io {
+  int hio_epollfd;
+  int hio_pipe[2];             /* Wakeup */
+
+  pthread_mutex_t hio_mutex;
+  struct htsp_connection_queue hio_pending; /* Connections with new output */
+} htsp_io_t;
+
+static htsp_io_t htsp_io[HTSP_IO_THREADS];
+static int htsp_io_next;
+
+static void htsp_io_wakeup(htsp_io_t *hio);
+
+/**
+ * Method pool
+ */
+static pthread_mutex_t htsp_method_mutex;
+static pthread_cond_t htsp_method_cond;
+static struct htsp_connection_queue htsp_method_queue;
+static struct htsp_connection_queue htsp_method_delayed; /* By expiry */
+
+
 /**
  *
  */
 typedef struct htsp_connection {
   int htsp_fd;
   struct sockaddr_in *htsp_peer;
+  struct sockaddr_in htsp_peer_addr;
 
   int htsp_version;
 
@@ -114,16 +218,34 @@ typedef struct htsp_connection {
   LIST_ENTRY(htsp_connection) htsp_async_link;
 
   /**
-   * Writer thread
+   * Socket I/O, only touched by the event loop thread
    */
-  pthread_t htsp_writer_thread;
-
-  int htsp_writer_run;
+  htsp_io_t *htsp_io;
+  int htsp_io_events;
+
+  uint8_t htsp_rhdr[4];
+  uint8_t *htsp_rbuf;
+  size_t htsp_rsize;
+  size_t htsp_rlen;
+
+  struct htsp_msg_queue htsp_wbatch;  /* Dequeued for writing */
+  struct htsp_msg *htsp_wstop;        /* First in wbatch not in wiov */
+  struct iovec htsp_wiov[HTSP_WRITE_IOVECS];
+  int htsp_wiov_i;
+  int htsp_wiov_n;
+  uint8_t *htsp_wbuf;
+  void *htsp_wspill;
 
+  /**
+   * Output queues
+   */
   struct htsp_msg_q_queue htsp_active_output_queues;
 
   pthread_mutex_t htsp_out_mutex;
-  pthread_cond_t htsp_out_cond;
+
+  int htsp_io_dead;
+  int htsp_write_pending;             /* On hio_pending */
+  TAILQ_ENTRY(htsp_connection) htsp_pending_link;
 
   htsp_msg_q_t htsp_hmq_ctrl;
   htsp_msg_q_t htsp_hmq_epg;
@@ -138,6 +260,26 @@ typedef struct htsp_connection {
 
   uint8_t htsp_challenge[32];
 
+  /**
+   * Method execution, protected by htsp_method_mutex
+   */
+  struct htsp_inmsg_queue htsp_inq;
+  TAILQ_ENTRY(htsp_connection) htsp_method_link;
+  int htsp_method_queued;  /* Queued or being served */
+  int htsp_initialized;
+  int htsp_closing;
+
+  htsmsg_t *htsp_delayed_reply;  /* Held back, nothing else is served */
+  int64_t htsp_delay_until;
+  TAILQ_ENTRY(htsp_connection) htsp_delay_link;
+
+  /**
+   * global_lock accounting for the request being executed
+   */
+  int64_t htsp_lock_ts;
+  int64_t htsp_lock_wait;
+  int64_t htsp_lock_held;
+
 } htsp_connection_t;
 
 
@@ -152,6 +294,7 @@ typedef struct htsp_subscription {
   int hs_sid;  /* Subscription ID (set by client) */
 
   th_subscription_t *hs_s; // Temporary
+  timeshift_reader_t *hs_tsr; /* Instead of hs_s if timeshifting */
 
   streaming_target_t hs_input;
 
@@ -161,6 +304,16 @@ typedef struct htsp_subscription {
 
   int hs_dropstats[PKT_NTYPES];
 
+  /**
+   * Queue control, only touched from the streaming thread
+   */
+  int64_t hs_latency;    /* Target queue delay (us) */
+  int64_t hs_delay;      /* Last measured queue delay (us) */
+  int hs_video;          /* Has a video component */
+  int hs_skip;           /* Dropping video until the next I-frame */
+  int hs_skip_packets;   /* Dropped since last subscriptionResync */
+  int hs_skip_bytes;
+
 } htsp_subscription_t;
 
 
@@ -190,7 +343,8 @@ htsp_update_logname(htsp_connection_t *htsp)
 static void
 htsp_msg_destroy(htsp_msg_t *hm)
 {
-  htsmsg_destroy(hm->hm_msg);
+  if(hm->hm_msg != NULL)
+    htsmsg_destroy(hm->hm_msg);
   if(hm->hm_pb != NULL)
     pktbuf_ref_dec(hm->hm_pb);
   free(hm);
@@ -226,6 +380,8 @@ htsp_flush_queue(htsp_connection_t *htsp, htsp_msg_q_t *hmq)
     TAILQ_REMOVE(&hmq->hmq_q, hm, hm_link);
     htsp_msg_destroy(hm);
   }
+  hmq->hmq_length = 0;
+  hmq->hmq_payload = 0;
   pthread_mutex_unlock(&htsp->htsp_out_mutex);
 }
 
@@ -237,7 +393,10 @@ static void
 htsp_subscription_destroy(htsp_connection_t *htsp, htsp_subscription_t *hs)
 {
   LIST_REMOVE(hs, hs_link);
-  subscription_unsubscribe(hs->hs_s);
+  if(hs->hs_tsr != NULL)
+    timeshift_reader_destroy(hs->hs_tsr);
+  else
+    subscription_unsubscribe(hs->hs_s);
   htsp_flush_queue(htsp, &hs->hs_q);
   free(hs);
 }
@@ -246,9 +405,8 @@ htsp_subscription_destroy(htsp_connection_t *htsp, htsp_subscription_t *hs)
 /**
  *
  */
-static void
-htsp_send(htsp_connection_t *htsp, htsmsg_t *m, pktbuf_t *pb,
-	  htsp_msg_q_t *hmq, int payloadsize)
+static htsp_msg_t *
+htsp_msg_create(htsmsg_t *m, pktbuf_t *pb, int payloadsize)
 {
   htsp_msg_t *hm = malloc(sizeof(htsp_msg_t));
 
@@ -257,9 +415,26 @@ htsp_send(htsp_connection_t *htsp, htsmsg_t *m, pktbuf_t *pb,
   if(pb != NULL)
     pktbuf_ref_inc(pb);
   hm->hm_payloadsize = payloadsize;
-  
+  hm->hm_dts = PTS_UNSET;
+  hm->hm_frametype = -1;
+  return hm;
+}
+
+
+/**
+ *
+ */
+static void
+htsp_enqueue(htsp_connection_t *htsp, htsp_msg_t *hm, htsp_msg_q_t *hmq)
+{
   pthread_mutex_lock(&htsp->htsp_out_mutex);
 
+  if(htsp->htsp_io_dead) {
+    pthread_mutex_unlock(&htsp->htsp_out_mutex);
+    htsp_msg_destroy(hm);
+    return;
+  }
+
   TAILQ_INSERT_TAIL(&hmq->hmq_q, hm, hm_link);
 
   if(hmq->hmq_length == 0) {
@@ -273,11 +448,29 @@ htsp_send(htsp_connection_t *htsp, htsmsg_t *m, pktbuf_t *pb,
   }
 
   hmq->hmq_length++;
-  hmq->hmq_payload += payloadsize;
-  pthread_cond_signal(&htsp->htsp_out_cond);
+  hmq->hmq_payload += hm->hm_payloadsize;
+
+  if(!htsp->htsp_write_pending) {
+    htsp->htsp_write_pending = 1;
+    pthread_mutex_lock(&htsp->htsp_io->hio_mutex);
+    TAILQ_INSERT_TAIL(&htsp->htsp_io->hio_pending, htsp, htsp_pending_link);
+    pthread_mutex_unlock(&htsp->htsp_io->hio_mutex);
+    htsp_io_wakeup(htsp->htsp_io);
+  }
   pthread_mutex_unlock(&htsp->htsp_out_mutex);
 }
 
+
+/**
+ *
+ */
+static void
+htsp_send(htsp_connection_t *htsp, htsmsg_t *m, pktbuf_t *pb,
+	  htsp_msg_q_t *hmq, int payloadsize)
+{
+  htsp_enqueue(htsp, htsp_msg_create(m, pb, payloadsize), hmq);
+}
+
 /**
  *
  */
@@ -334,7 +527,8 @@ htsp_build_channel(channel_t *ch, const char *method)
 
   htsmsg_add_msg(out, "services", services);
   htsmsg_add_msg(out, "tags", tags);
-  htsmsg_add_str(out, "method", method);
+  if(method != NULL)
+    htsmsg_add_str(out, "method", method);
   return out;
 }
 
@@ -361,7 +555,8 @@ htsp_build_tag(channel_tag_t *ct, const char *method, int include_channels)
     htsmsg_add_msg(out, "members", members);
   }
 
-  htsmsg_add_str(out, "method", method);
+  if(method != NULL)
+    htsmsg_add_str(out, "method", method);
   return out;
 }
 
@@ -409,7 +604,8 @@ htsp_build_dvrentry(dvr_entry_t *de, const char *method)
   htsmsg_add_str(out, "state", s);
   if(error)
     htsmsg_add_str(out, "error", error);
-  htsmsg_add_str(out, "method", method);
+  if(method != NULL)
+    htsmsg_add_str(out, "method", method);
   return out;
 }
 
@@ -426,6 +622,51 @@ htsp_error(const char *err)
 }
 
 
+/**
+ * global_lock for requests, the time spent is accounted to the
+ * request being executed
+ */
+static void
+htsp_lock(htsp_connection_t *htsp)
+{
+  int64_t ts = getmonoclock();
+
+  pthread_mutex_lock(&global_lock);
+  htsp->htsp_lock_ts = getmonoclock();
+  htsp->htsp_lock_wait += htsp->htsp_lock_ts - ts;
+}
+
+static void
+htsp_unlock(htsp_connection_t *htsp)
+{
+  htsp->htsp_lock_held += getmonoclock() - htsp->htsp_lock_ts;
+  pthread_mutex_unlock(&global_lock);
+}
+
+
+/**
+ * EPG read snapshot for the query methods. If 'eventid' is newer than
+ * the current epoch pending changes are published first, clients may
+ * ask for events they just learned about from a channelUpdate
+ */
+static epg_snapshot_t *
+htsp_epg_snapshot(htsp_connection_t *htsp, uint32_t eventid)
+{
+  epg_snapshot_t *es = epg_snapshot_get();
+
+  if(es != NULL) {
+    if(eventid <= es->es_max_id)
+      return es;
+    epg_snapshot_release(es);
+  }
+
+  htsp_lock(htsp);
+  es = epg_snapshot_refresh();
+  htsp_unlock(htsp);
+  return es;
+}
+
+
 /**
  *
  */
@@ -441,8 +682,92 @@ htsp_reply(htsp_connection_t *htsp, htsmsg_t *in, htsmsg_t *out)
 }
 
 
+/**
+ * Send the changes after 'version' from the change log.
+ * Returns -1 if the log does not cover them
+ */
+static int
+htsp_sync_replay(htsp_connection_t *htsp, uint32_t epoch, uint32_t version)
+{
+  htsp_change_t *hc;
+  uint32_t v;
+
+  if(epoch != htsp_epoch || version > htsp_version ||
+     htsp_version - version > HTSP_CHANGELOG_SIZE)
+    return -1;
+
+  for(v = version + 1; v <= htsp_version; v++) {
+    hc = &htsp_changelog[v % HTSP_CHANGELOG_SIZE];
+    if(hc->hc_version != v || hc->hc_pb == NULL)
+      return -1;
+  }
+
+  for(v = version + 1; v <= htsp_version; v++)
+    htsp_send(htsp, NULL, htsp_changelog[v % HTSP_CHANGELOG_SIZE].hc_pb,
+	      &htsp->htsp_hmq_ctrl, 0);
+  return 0;
+}
+
+
+/**
+ * All tags, channels and DVR entries in one message. The serialized
+ * message is kept until the next change, reconnecting clients share it
+ */
+static pktbuf_t *
+htsp_sync_build(void)
+{
+  channel_t *ch;
+  channel_tag_t *ct;
+  dvr_entry_t *de;
+  htsmsg_t *m, *l;
+  void *dptr;
+  size_t dlen;
+
+  if(htsp_sync_pb != NULL && htsp_sync_version == htsp_version)
+    return htsp_sync_pb;
+
+  m = htsmsg_create_map();
+  htsmsg_add_str(m, "method", "initialSync");
+  htsmsg_add_u32(m, "epoch", htsp_epoch);
+  htsmsg_add_u32(m, "version", htsp_version);
+
+  l = htsmsg_create_list();
+  TAILQ_FOREACH(ct, &channel_tags, ct_link)
+    if(ct->ct_enabled && !ct->ct_internal)
+      htsmsg_add_msg(l, NULL, htsp_build_tag(ct, NULL, 1));
+  htsmsg_add_msg(m, "tags", l);
+
+  l = htsmsg_create_list();
+  RB_FOREACH(ch, &channel_name_tree, ch_name_link)
+    htsmsg_add_msg(l, NULL, htsp_build_channel(ch, NULL));
+  htsmsg_add_msg(m, "channels", l);
+
+  l = htsmsg_create_list();
+  LIST_FOREACH(de, &dvrentries, de_global_link)
+    htsmsg_add_msg(l, NULL, htsp_build_dvrentry(de, NULL));
+  htsmsg_add_msg(m, "dvrEntries", l);
+
+  if(htsp_sync_pb != NULL) {
+    pktbuf_ref_dec(htsp_sync_pb);
+    htsp_sync_pb = NULL;
+  }
+
+  if(!htsmsg_binary_serialize(m, &dptr, &dlen, INT32_MAX)) {
+    htsp_sync_pb = pktbuf_make(dptr, dlen);
+    htsp_sync_version = htsp_version;
+    htsp_sync_builds++;
+  }
+  htsmsg_destroy(m);
+  return htsp_sync_pb;
+}
+
+
 /**
  * Switch the HTSP connection into async mode
+ *
+ * If the client passes 'epoch' (and 'version') the initial sync is
+ * either the changes since then or a single 'initialSync' message.
+ * Without, every object is sent as a separate message
  */
 static htsmsg_t *
 htsp_method_async(htsp_connection_t *htsp, htsmsg_t *in)
@@ -451,6 +776,8 @@ htsp_method_async(htsp_connection_t *htsp, htsmsg_t *in)
   channel_tag_t *ct;
   dvr_entry_t *de;
   htsmsg_t *m;
+  pktbuf_t *pb;
+  uint32_t epoch, version;
 
   /* First, just OK the async request */
   htsp_reply(htsp, in, htsmsg_create_map()); 
@@ -460,6 +787,20 @@ htsp_method_async(htsp_connection_t *htsp, htsmsg_t *in)
 
   htsp->htsp_async_mode = 1;
 
+  if(!htsmsg_get_u32(in, "epoch", &epoch)) {
+    version = htsmsg_get_u32_or_default(in, "version", 0);
+
+    if(!htsp_sync_replay(htsp, epoch, version)) {
+      htsp_sync_delta++;
+    } else if((pb = htsp_sync_build()) != NULL) {
+      htsp_send(htsp, NULL, pb, &htsp->htsp_hmq_ctrl, 0);
+      htsp_sync_bulk++;
+    }
+    goto done;
+  }
+
+  htsp_sync_legacy++;
+
   /* Send all enabled and external tags */
   TAILQ_FOREACH(ct, &channel_tags, ct_link)
     if(ct->ct_enabled && !ct->ct_internal)
@@ -478,9 +819,12 @@ htsp_method_async(htsp_connection_t *htsp, htsmsg_t *in)
   LIST_FOREACH(de, &dvrentries, de_global_link)
     htsp_send_message(htsp, htsp_build_dvrentry(de, "dvrEntryAdd"), NULL);
 
+ done:
   /* Notify that initial sync has been completed */
   m = htsmsg_create_map();
   htsmsg_add_str(m, "method", "initialSyncCompleted");
+  htsmsg_add_u32(m, "epoch", htsp_epoch);
+  htsmsg_add_u32(m, "version", htsp_version);
   htsp_send_message(htsp, m, NULL);
 
   /* Insert in list so it will get all updates */
@@ -701,37 +1045,39 @@ htsp_method_epgQuery(htsp_connection_t *htsp, htsmsg_t *in)
   const char *query;
   int c, i;
   uint32_t channelid, tagid, epg_content_dvbcode = 0;
-  channel_t *ch = NULL;
-  channel_tag_t *ct = NULL;
-  epg_query_result_t eqr;
+  int ch_id = -1, tag_id = -1;
+  epg_snapshot_t *es;
+  epg_snap_result_t esr;
   
   //only mandatory parameter is the query
   if( (query = htsmsg_get_str(in, "query")) == NULL )
     return htsp_error("Missing argument 'query'");
   
   if( !(htsmsg_get_u32(in, "channelId", &channelid)) )
-    ch = channel_find_by_identifier(channelid);
+    ch_id = channelid;
 
   if( !(htsmsg_get_u32(in, "tagId", &tagid)) )
-    ct = channel_tag_find_by_identifier(tagid);
+    tag_id = tagid;
 
   htsmsg_get_u32(in, "contentType", &epg_content_dvbcode);
 
   //do the query
-  epg_query0(&eqr, ch, ct, epg_content_dvbcode, query);
-  c = eqr.eqr_entries;
+  es = htsp_epg_snapshot(htsp, 0);
+  epg_snapshot_query(es, &esr, ch_id, tag_id, epg_content_dvbcode, query);
+  c = esr.esr_entries;
 
   // create reply
   out = htsmsg_create_map();
   if( c ) {
     eventIds = htsmsg_create_list();
     for(i = 0; i < c; ++i) {
-        htsmsg_add_u32(eventIds, NULL, eqr.eqr_array[i]->e_id);
+        htsmsg_add_u32(eventIds, NULL, esr.esr_array[i]->ese_id);
     }
     htsmsg_add_msg(out, "eventIds", eventIds);
   }
   
-  epg_query_free(&eqr);
+  epg_snapshot_query_free(&esr);
+  epg_snapshot_release(es);
   
   return out;
 }
@@ -740,61 +1086,121 @@ htsp_method_epgQuery(htsp_connection_t *htsp, htsmsg_t *in)
  *
  */
 static htsmsg_t *
-htsp_build_event(event_t *e)
+htsp_build_event(const epg_snap_event_t *e)
 {
   htsmsg_t *out;
-  event_t *n;
-  dvr_entry_t *de;
+  epg_snap_event_t *n;
 
   out = htsmsg_create_map();
 
-  htsmsg_add_u32(out, "eventId", e->e_id);
-  htsmsg_add_u32(out, "channelId", e->e_channel->ch_id);
-  htsmsg_add_u32(out, "start", e->e_start);
-  htsmsg_add_u32(out, "stop", e->e_stop);
-  if(e->e_title != NULL)
-    htsmsg_add_str(out, "title", e->e_title);
-  if(e->e_desc != NULL)
-    htsmsg_add_str(out, "description", e->e_desc);
-  if(e->e_ext_desc != NULL)
-    htsmsg_add_str(out, "ext_desc", e->e_ext_desc);
-  if(e->e_ext_item != NULL)
-    htsmsg_add_str(out, "ext_item", e->e_ext_item);
-  if(e->e_ext_text != NULL)
-    htsmsg_add_str(out, "ext_text", e->e_ext_text);
-
-  if(e->e_content_type)
-    htsmsg_add_u32(out, "contentType", e->e_content_type);
-
-  if((de = dvr_entry_find_by_event(e)) != NULL) {
-    htsmsg_add_u32(out, "dvrId", de->de_id);
+  htsmsg_add_u32(out, "eventId", e->ese_id);
+  htsmsg_add_u32(out, "channelId", e->ese_channel->esc_id);
+  htsmsg_add_u32(out, "start", e->ese_start);
+  htsmsg_add_u32(out, "stop", e->ese_stop);
+  if(e->ese_title != NULL)
+    htsmsg_add_str(out, "title", e->ese_title);
+  if(e->ese_desc != NULL)
+    htsmsg_add_str(out, "description", e->ese_desc);
+  if(e->ese_ext_desc != NULL)
+    htsmsg_add_str(out, "ext_desc", e->ese_ext_desc);
+  if(e->ese_ext_item != NULL)
+    htsmsg_add_str(out, "ext_item", e->ese_ext_item);
+  if(e->ese_ext_text != NULL)
+    htsmsg_add_str(out, "ext_text", e->ese_ext_text);
+
+  if(e->ese_content_type)
+    htsmsg_add_u32(out, "contentType", e->ese_content_type);
+
+  if(e->ese_dvr_state != NULL) {
+    htsmsg_add_u32(out, "dvrId", e->ese_dvr_id);
   }
 
-  n = RB_NEXT(e, e_channel_link);
+  n = epg_snapshot_next(e);
   if(n != NULL)
-    htsmsg_add_u32(out, "nextEventId", n->e_id);
+    htsmsg_add_u32(out, "nextEventId", n->ese_id);
+
+  return out;
+}
+
+/**
+ * Page through the EPG, events overlapping the window 'start' - 'end'
+ * in start time order. 'cursor' from the previous reply continues.
+ * 'query' is a regular expression on the title, or a word query with
+ * 'words' set
+ */
+static htsmsg_t *
+htsp_epg_page(htsp_connection_t *htsp, htsmsg_t *in)
+{
+  uint32_t u32, limit = 100;
+  htsmsg_t *out, *events;
+  epg_snapshot_t *es;
+  epg_snap_result_t esr;
+  epg_snap_filter_t esf;
+  char next[EPG_CURSOR_SIZE];
+  int i;
+
+  memset(&esf, 0, sizeof(esf));
+  esf.esf_ch_id = htsmsg_get_u32(in, "channelId", &u32) ? -1 : u32;
+  esf.esf_tag_id = htsmsg_get_u32(in, "tagId", &u32) ? -1 : u32;
+  if(!htsmsg_get_u32(in, "contentType", &u32))
+    esf.esf_content_type = u32;
+  esf.esf_title = htsmsg_get_str(in, "query");
+  if(!htsmsg_get_u32(in, "words", &u32))
+    esf.esf_words = u32;
+  if(!htsmsg_get_u32(in, "full", &u32))
+    esf.esf_fulltext = u32;
+  esf.esf_from = htsmsg_get_u32(in, "start", &u32) ? dispatch_clock : u32;
+  if(!htsmsg_get_u32(in, "end", &u32))
+    esf.esf_to = u32;
+  htsmsg_get_u32(in, "maxEvents", &limit);
+  if(limit == 0 || limit > 1000)
+    return htsp_error("Invalid argument 'maxEvents'");
+
+  es = htsp_epg_snapshot(htsp, 0);
+  if(epg_snapshot_page(es, &esr, &esf, htsmsg_get_str(in, "cursor"),
+		       limit, next)) {
+    epg_snapshot_release(es);
+    return htsp_error("Invalid query or cursor");
+  }
+
+  out = htsmsg_create_map();
+  events = htsmsg_create_list();
+  for(i = 0; i < esr.esr_entries; i++)
+    htsmsg_add_msg(events, NULL, htsp_build_event(esr.esr_array[i]));
+
+  epg_snapshot_query_free(&esr);
+  epg_snapshot_release(es);
 
+  htsmsg_add_msg(out, "events", events);
+  if(next[0])
+    htsmsg_add_str(out, "cursor", next);
   return out;
 }
 
 /**
  * Get information about the given event + 
  * n following events
+ *
+ * Without 'eventId' a page of events is returned, see htsp_epg_page()
  */
 static htsmsg_t *
 htsp_method_getEvents(htsp_connection_t *htsp, htsmsg_t *in)
 {
   uint32_t eventid, numFollowing;
   htsmsg_t *out, *events;
-  event_t *e;
+  epg_snapshot_t *es;
+  epg_snap_event_t *e;
 
   if(htsmsg_get_u32(in, "eventId", &eventid))
-    return htsp_error("Missing argument 'eventId'");
+    return htsp_epg_page(htsp, in);
 
   if(htsmsg_get_u32(in, "numFollowing", &numFollowing))
     return htsp_error("Missing argument 'numFollowing'");
 
-  if((e = epg_event_find_by_id(eventid)) == NULL) {
+  es = htsp_epg_snapshot(htsp, eventid);
+
+  if((e = epg_snapshot_find_by_id(es, eventid)) == NULL) {
+    epg_snapshot_release(es);
     return htsp_error("Event does not exist");
   }
 
@@ -803,12 +1209,13 @@ htsp_method_getEvents(htsp_connection_t *htsp, htsmsg_t *in)
   
   htsmsg_add_msg(events, NULL, htsp_build_event(e));
   while( numFollowing-- > 0 ) {
-    e = RB_NEXT(e, e_channel_link);
+    e = epg_snapshot_next(e);
     if( e == NULL ) 
       break;
     htsmsg_add_msg(events, NULL, htsp_build_event(e));
   }
   
+  epg_snapshot_release(es);
   htsmsg_add_msg(out, "events", events);
   return out;
 }
@@ -821,16 +1228,21 @@ static htsmsg_t *
 htsp_method_getEvent(htsp_connection_t *htsp, htsmsg_t *in)
 {
   uint32_t eventid;
-  event_t *e;
+  epg_snapshot_t *es;
+  epg_snap_event_t *e;
   htsmsg_t *out;
   
   if(htsmsg_get_u32(in, "eventId", &eventid))
     return htsp_error("Missing argument 'eventId'");
 
-  if((e = epg_event_find_by_id(eventid)) == NULL)
-    return htsp_error("Event does not exist");
+  es = htsp_epg_snapshot(htsp, eventid);
+
+  if((e = epg_snapshot_find_by_id(es, eventid)) == NULL)
+    out = htsp_error("Event does not exist");
+  else
+    out = htsp_build_event(e);  
 
-  out = htsp_build_event(e);  
+  epg_snapshot_release(es);
   return out;
 }
 
@@ -842,9 +1254,19 @@ htsp_method_getDiskSpace(htsp_connection_t *htsp, htsmsg_t *in)
 {
   htsmsg_t *out;
   struct statvfs diskdata;
-  dvr_config_t *cfg = dvr_config_find_by_name_default("");
+  dvr_config_t *cfg;
+  char *path;
+  int r;
 
-  if(statvfs(cfg->dvr_storage,&diskdata) == -1)
+  /* Don't hold global_lock while the disk spins up */
+  htsp_lock(htsp);
+  cfg = dvr_config_find_by_name_default("");
+  path = strdup(cfg->dvr_storage);
+  htsp_unlock(htsp);
+
+  r = statvfs(path, &diskdata);
+  free(path);
+  if(r == -1)
     return htsp_error("Unable to stat path");
   
   out = htsmsg_create_map();
@@ -881,9 +1303,10 @@ htsp_method_getSysTime(htsp_connection_t *htsp, htsmsg_t *in)
 static htsmsg_t *
 htsp_method_subscribe(htsp_connection_t *htsp, htsmsg_t *in)
 {
-  uint32_t chid, sid, weight;
+  uint32_t chid, sid, weight, latency, timeshift;
   channel_t *ch;
   htsp_subscription_t *hs;
+  htsmsg_t *r;
 
   if(htsmsg_get_u32(in, "channelId", &chid))
     return htsp_error("Missing argument 'channeId'");
@@ -895,12 +1318,17 @@ htsp_method_subscribe(htsp_connection_t *htsp, htsmsg_t *in)
     return htsp_error("Requested channel does not exist");
 
   weight = htsmsg_get_u32_or_default(in, "weight", 150);
+  latency = htsmsg_get_u32_or_default(in, "latency", HTSP_LATENCY_DEFAULT);
+  timeshift = htsmsg_get_u32_or_default(in, "timeshift", 0);
 
   /*
    * We send the reply now to avoid the user getting the 'subscriptionStart'
    * async message before the reply to 'subscribe'.
    */
-  htsp_reply(htsp, in, htsmsg_create_map());
+  r = htsmsg_create_map();
+  if(timeshift)
+    htsmsg_add_u32(r, "timeshift", 1);
+  htsp_reply(htsp, in, r);
 
   /* Initialize the HTSP subscription structure */
 
@@ -910,12 +1338,18 @@ htsp_method_subscribe(htsp_connection_t *htsp, htsmsg_t *in)
   htsp_init_queue(&hs->hs_q, 0);
 
   hs->hs_sid = sid;
+  hs->hs_latency =
+    MIN(MAX(latency, HTSP_LATENCY_MIN), HTSP_LATENCY_MAX) * 1000LL;
   LIST_INSERT_HEAD(&htsp->htsp_subscriptions, hs, hs_link);
   streaming_target_init(&hs->hs_input, htsp_streaming_input, hs, 0);
 
-  hs->hs_s = subscription_create_from_channel(ch, weight,
-					      htsp->htsp_logname,
-					      &hs->hs_input, 0);
+  if(timeshift)
+    hs->hs_tsr = timeshift_reader_create(ch, weight, htsp->htsp_logname,
+					 &hs->hs_input);
+  else
+    hs->hs_s = subscription_create_from_channel(ch, weight,
+						htsp->htsp_logname,
+						&hs->hs_input, 0);
   return NULL;
 }
 
@@ -973,11 +1407,97 @@ htsp_method_change_weight(htsp_connection_t *htsp, htsmsg_t *in)
 
   htsp_reply(htsp, in, htsmsg_create_map());
 
-  subscription_change_weight(hs->hs_s, weight);
+  if(hs->hs_s != NULL)
+    subscription_change_weight(hs->hs_s, weight);
+  return NULL;
+}
+
+
+/**
+ * Find a timeshifted subscription
+ */
+static htsp_subscription_t *
+htsp_find_timeshift(htsp_connection_t *htsp, htsmsg_t *in, htsmsg_t **err)
+{
+  htsp_subscription_t *hs;
+  uint32_t sid;
+
+  if(htsmsg_get_u32(in, "subscriptionId", &sid)) {
+    *err = htsp_error("Missing argument 'subscriptionId'");
+    return NULL;
+  }
+
+  LIST_FOREACH(hs, &htsp->htsp_subscriptions, hs_link)
+    if(hs->hs_sid == sid)
+      break;
+
+  if(hs == NULL)
+    *err = htsp_error("Requested subscription does not exist");
+  else if(hs->hs_tsr == NULL)
+    *err = htsp_error("Subscription is not timeshifted");
+  else
+    return hs;
   return NULL;
 }
 
 
+/**
+ * Pause a timeshifted subscription
+ */
+static htsmsg_t *
+htsp_method_pause(htsp_connection_t *htsp, htsmsg_t *in)
+{
+  htsp_subscription_t *hs;
+  htsmsg_t *err;
+
+  if((hs = htsp_find_timeshift(htsp, in, &err)) == NULL)
+    return err;
+
+  timeshift_pause(hs->hs_tsr);
+  return htsmsg_create_map();
+}
+
+
+/**
+ * Resume a paused subscription
+ */
+static htsmsg_t *
+htsp_method_resume(htsp_connection_t *htsp, htsmsg_t *in)
+{
+  htsp_subscription_t *hs;
+  htsmsg_t *err;
+
+  if((hs = htsp_find_timeshift(htsp, in, &err)) == NULL)
+    return err;
+
+  timeshift_resume(hs->hs_tsr);
+  return htsmsg_create_map();
+}
+
+
+/**
+ * Move playback of a timeshifted subscription by 'time' usec.
+ * Seeking past the end returns to live
+ */
+static htsmsg_t *
+htsp_method_seek(htsp_connection_t *htsp, htsmsg_t *in)
+{
+  htsp_subscription_t *hs;
+  htsmsg_t *err, *out;
+  int64_t offset;
+
+  if((hs = htsp_find_timeshift(htsp, in, &err)) == NULL)
+    return err;
+
+  if(htsmsg_get_s64(in, "time", &offset))
+    return htsp_error("Missing argument 'time'");
+
+  out = htsmsg_create_map();
+  htsmsg_add_s64(out, "shift", timeshift_seek(hs->hs_tsr, offset));
+  return out;
+}
+
+
 /**
  * Try to authenticate
  */
@@ -1045,33 +1565,116 @@ htsp_method_hello(htsp_connection_t *htsp, htsmsg_t *in)
 
 /**
  * HTSP methods
+ *
+ * Methods are called with global_lock held unless flagged
+ * HTSP_METHOD_UNLOCKED, those use htsp_lock() where they need to
  */
+#define HTSP_METHOD_UNLOCKED 0x1
+
 struct {
   const char *name;
   htsmsg_t *(*fn)(htsp_connection_t *htsp, htsmsg_t *in);
   int privmask;
+  int flags;
 } htsp_methods[] = {
   { "hello", htsp_method_hello, 0},
   { "authenticate", htsp_method_authenticate, 0},
   { "enableAsyncMetadata", htsp_method_async, ACCESS_STREAMING},
-  { "getEvent", htsp_method_getEvent, ACCESS_STREAMING},
-  { "getEvents", htsp_method_getEvents, ACCESS_STREAMING},
-  { "getDiskSpace", htsp_method_getDiskSpace, ACCESS_STREAMING},
-  { "getSysTime", htsp_method_getSysTime, ACCESS_STREAMING},
+  { "getEvent", htsp_method_getEvent, ACCESS_STREAMING,
+    HTSP_METHOD_UNLOCKED},
+  { "getEvents", htsp_method_getEvents, ACCESS_STREAMING,
+    HTSP_METHOD_UNLOCKED},
+  { "getDiskSpace", htsp_method_getDiskSpace, ACCESS_STREAMING,
+    HTSP_METHOD_UNLOCKED},
+  { "getSysTime", htsp_method_getSysTime, ACCESS_STREAMING,
+    HTSP_METHOD_UNLOCKED},
   { "subscribe", htsp_method_subscribe, ACCESS_STREAMING},
   { "unsubscribe", htsp_method_unsubscribe, ACCESS_STREAMING},
   { "subscriptionChangeWeight", htsp_method_change_weight, ACCESS_STREAMING},
+  { "subscriptionPause", htsp_method_pause, ACCESS_STREAMING},
+  { "subscriptionResume", htsp_method_resume, ACCESS_STREAMING},
+  { "subscriptionSeek", htsp_method_seek, ACCESS_STREAMING},
   { "addDvrEntry", htsp_method_addDvrEntry, ACCESS_RECORDER},
   { "updateDvrEntry", htsp_method_updateDvrEntry, ACCESS_RECORDER},
   { "cancelDvrEntry", htsp_method_cancelDvrEntry, ACCESS_RECORDER},
   { "deleteDvrEntry", htsp_method_deleteDvrEntry, ACCESS_RECORDER},
-  { "epgQuery", htsp_method_epgQuery, ACCESS_STREAMING},
+  { "epgQuery", htsp_method_epgQuery, ACCESS_STREAMING,
+    HTSP_METHOD_UNLOCKED},
   { "getTicket", htsp_method_getTicket, ACCESS_STREAMING},
 
 };
 
 #define NUM_METHODS (sizeof(htsp_methods) / sizeof(htsp_methods[0]))
 
+/**
+ * Per method timing, all in microseconds
+ */
+typedef struct htsp_method_stats {
+  unsigned int hms_calls;
+  int64_t hms_wait;     /* Waiting for global_lock */
+  int64_t hms_wait_max;
+  int64_t hms_held;     /* Holding global_lock */
+  int64_t hms_held_max;
+  int64_t hms_run;      /* Whole request, including the above */
+  int64_t hms_run_max;
+} htsp_method_stats_t;
+
+static pthread_mutex_t htsp_method_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static htsp_method_stats_t htsp_method_stats[NUM_METHODS];
+
+
+/**
+ *
+ */
+static void
+htsp_method_account(int i, htsp_connection_t *htsp, int64_t run)
+{
+  htsp_method_stats_t *hms = &htsp_method_stats[i];
+
+  pthread_mutex_lock(&htsp_method_stats_mutex);
+  hms->hms_calls++;
+  hms->hms_wait += htsp->htsp_lock_wait;
+  hms->hms_wait_max = MAX(hms->hms_wait_max, htsp->htsp_lock_wait);
+  hms->hms_held += htsp->htsp_lock_held;
+  hms->hms_held_max = MAX(hms->hms_held_max, htsp->htsp_lock_held);
+  hms->hms_run += run;
+  hms->hms_run_max = MAX(hms->hms_run_max, run);
+  pthread_mutex_unlock(&htsp_method_stats_mutex);
+}
+
+
+/**
+ *
+ */
+void
+htsp_method_dump(htsbuf_queue_t *hq)
+{
+  htsp_method_stats_t *hms;
+  int i;
+
+  pthread_mutex_lock(&htsp_method_stats_mutex);
+  for(i = 0; i < NUM_METHODS; i++) {
+    hms = &htsp_method_stats[i];
+    if(hms->hms_calls == 0)
+      continue;
+
+    htsbuf_qprintf(hq, "%-24s %-8s  Calls: %u\n",
+		   htsp_methods[i].name,
+		   htsp_methods[i].flags & HTSP_METHOD_UNLOCKED ?
+		   "unlocked" : "locked", hms->hms_calls);
+    htsbuf_qprintf(hq, "  Lock wait avg/max: %lld/%lld us  "
+		   "Lock held avg/max: %lld/%lld us  "
+		   "Total avg/max: %lld/%lld us\n",
+		   (long long)(hms->hms_wait / hms->hms_calls),
+		   (long long)hms->hms_wait_max,
+		   (long long)(hms->hms_held / hms->hms_calls),
+		   (long long)hms->hms_held_max,
+		   (long long)(hms->hms_run / hms->hms_calls),
+		   (long long)hms->hms_run_max);
+  }
+  pthread_mutex_unlock(&htsp_method_stats_mutex);
+}
+
 
 /**
  * Raise privs by field in message
@@ -1113,61 +1716,117 @@ htsp_authenticate(htsp_connection_t *htsp, htsmsg_t *m)
 
 
 /**
- * timeout is in ms, 0 means infinite timeout
+ * Take next message from the active output queues
+ *
+ * htsp_out_mutex is held
  */
-static int
-htsp_read_message(htsp_connection_t *htsp, htsmsg_t **mp, int timeout)
+static htsp_msg_t *
+htsp_dequeue(htsp_connection_t *htsp)
 {
-  int v;
-  size_t len;
-  uint8_t data[4];
-  void *buf;
+  htsp_msg_q_t *hmq;
+  htsp_msg_t *hm;
 
-  v = timeout ? tcp_read_timeout(htsp->htsp_fd, data, 4, timeout) : 
-    tcp_read(htsp->htsp_fd, data, 4);
+  if((hmq = TAILQ_FIRST(&htsp->htsp_active_output_queues)) == NULL)
+    return NULL;
 
-  if(v != 0)
-    return v;
+  hm = TAILQ_FIRST(&hmq->hmq_q);
+  TAILQ_REMOVE(&hmq->hmq_q, hm, hm_link);
+  hmq->hmq_length--;
+  hmq->hmq_payload -= hm->hm_payloadsize;
 
-  len = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
-  if(len > 1024 * 1024)
-    return EMSGSIZE;
-  if((buf = malloc(len)) == NULL)
-    return ENOMEM;
-
-  v = timeout ? tcp_read_timeout(htsp->htsp_fd, buf, len, timeout) : 
-    tcp_read(htsp->htsp_fd, buf, len);
-  
-  if(v != 0) {
-    free(buf);
-    return v;
+  TAILQ_REMOVE(&htsp->htsp_active_output_queues, hmq, hmq_link);
+  if(hmq->hmq_length) {
+    /* Still messages to be sent, put back in active queues */
+    if(hmq->hmq_strict_prio) {
+      TAILQ_INSERT_HEAD(&htsp->htsp_active_output_queues, hmq, hmq_link);
+    } else {
+      TAILQ_INSERT_TAIL(&htsp->htsp_active_output_queues, hmq, hmq_link);
+    }
   }
-
-  /* buf will be tied to the message.
-   * NB: If the message can not be deserialized buf will be free'd by the
-   * function.
-   */
-  *mp = htsmsg_binary_deserialize(buf, len, buf);
-  if(*mp == NULL)
-    return EBADMSG;
-
-  return 0;
+  return hm;
 }
 
+
 /**
+ * Execute one request
  *
+ * Called from the method pool
  */
-static int
-htsp_read_loop(htsp_connection_t *htsp)
+static void
+htsp_dispatch(htsp_connection_t *htsp, htsmsg_t *m)
 {
-  htsmsg_t *m, *reply;
-  int r, i;
+  htsmsg_t *reply;
   const char *method;
+  int64_t start = getmonoclock();
+  int i = NUM_METHODS, locked = 1;
+  uint32_t seq;
+
+  htsp->htsp_lock_wait = 0;
+  htsp->htsp_lock_held = 0;
+
+  htsp_lock(htsp);
+  htsp_authenticate(htsp, m);
+
+  if((method = htsmsg_get_str(m, "method")) != NULL) {
+    for(i = 0; i < NUM_METHODS; i++) {
+      if(!strcmp(method, htsp_methods[i].name)) {
+
+	if((htsp->htsp_granted_access & htsp_methods[i].privmask) != 
+	   htsp_methods[i].privmask) {
+
+	  htsp_unlock(htsp);
+
+	  /* Classic authentication failed delay, the method pool sends
+	     the reply once it has passed */
+	  reply = htsmsg_create_map();
+	  htsmsg_add_u32(reply, "noaccess", 1);
+	  if(!htsmsg_get_u32(m, "seq", &seq))
+	    htsmsg_add_u32(reply, "seq", seq);
+	  htsp->htsp_delayed_reply = reply;
+	  return;
+
+	} else {
+	  if(htsp_methods[i].flags & HTSP_METHOD_UNLOCKED) {
+	    htsp_unlock(htsp);
+	    locked = 0;
+	  }
+	  reply = htsp_methods[i].fn(htsp, m);
+	}
+	break;
+      }
+    }
+
+    if(i == NUM_METHODS) {
+      reply = htsp_error("Method not found");
+    }
+
+  } else {
+    reply = htsp_error("No 'method' argument");
+  }
+
+  if(locked)
+    htsp_unlock(htsp);
+
+  if(i < NUM_METHODS)
+    htsp_method_account(i, htsp, getmonoclock() - start);
+
+  if(reply != NULL) /* Methods can do all the replying inline */
+    htsp_reply(htsp, m, reply);
+}
 
+
+/**
+ * Set up a new session, called from the method pool
+ */
+static void
+htsp_session_init(htsp_connection_t *htsp)
+{
   if(htsp_generate_challenge(htsp)) {
     tvhlog(LOG_ERR, "htsp", "%s: Unable to generate challenge",
 	   htsp->htsp_logname);
-    return 1;
+    /* The I/O thread sees the connection go away and tears it down */
+    shutdown(htsp->htsp_fd, SHUT_RDWR);
+    return;
   }
 
   pthread_mutex_lock(&global_lock);
@@ -1176,199 +1835,579 @@ htsp_read_loop(htsp_connection_t *htsp)
   pthread_mutex_unlock(&global_lock);
 
   tvhlog(LOG_INFO, "htsp", "Got connection from %s", htsp->htsp_logname);
+}
 
-  /* Session main loop */
 
-  while(1) {
-  readmsg:
-    if((r = htsp_read_message(htsp, &m, 0)) != 0)
-      return r;
+/**
+ * Tear down a session. Called from the method pool once the I/O
+ * thread has dropped the connection, so nobody else refers to it
+ */
+static void
+htsp_session_destroy(htsp_connection_t *htsp)
+{
+  htsp_subscription_t *s;
 
-    pthread_mutex_lock(&global_lock);
-    htsp_authenticate(htsp, m);
+  tvhlog(LOG_INFO, "htsp", "%s: Disconnected", htsp->htsp_logname);
 
-    if((method = htsmsg_get_str(m, "method")) != NULL) {
-      for(i = 0; i < NUM_METHODS; i++) {
-	if(!strcmp(method, htsp_methods[i].name)) {
+  pthread_mutex_lock(&global_lock);
 
-	  if((htsp->htsp_granted_access & htsp_methods[i].privmask) != 
-	     htsp_methods[i].privmask) {
+  /* Beware! Closing subscriptions will invoke a lot of callbacks
+     down in the streaming code. So we do this as early as possible
+     to avoid any weird lockups */
+  while((s = LIST_FIRST(&htsp->htsp_subscriptions)) != NULL) {
+    htsp_subscription_destroy(htsp, s);
+  }
 
-	    pthread_mutex_unlock(&global_lock);
+  if(htsp->htsp_async_mode)
+    LIST_REMOVE(htsp, htsp_async_link);
 
-	    /* Classic authentication failed delay */
-	    usleep(250000);
-	    
-	    reply = htsmsg_create_map();
-	    htsmsg_add_u32(reply, "noaccess", 1);
-	    htsp_reply(htsp, m, reply);
+  pthread_mutex_unlock(&global_lock);
 
-	    htsmsg_destroy(m);
-	    goto readmsg;
+  htsp_flush_queue(htsp, &htsp->htsp_hmq_ctrl);
+  htsp_flush_queue(htsp, &htsp->htsp_hmq_epg);
+  htsp_flush_queue(htsp, &htsp->htsp_hmq_qstatus);
 
-	  } else {
-	    reply = htsp_methods[i].fn(htsp, m);
-	  }
-	  break;
-	}
-      }
+  close(htsp->htsp_fd);
 
-      if(i == NUM_METHODS) {
-	reply = htsp_error("Method not found");
-      }
+  pthread_mutex_destroy(&htsp->htsp_out_mutex);
+  free(htsp->htsp_wbuf);
+  free(htsp->htsp_logname);
+  free(htsp->htsp_peername);
+  free(htsp->htsp_username);
+  free(htsp->htsp_clientname);
+  free(htsp);
+}
+
+
+/**
+ * Queue connection for the method pool
+ *
+ * htsp_method_mutex is held
+ */
+static void
+htsp_method_schedule(htsp_connection_t *htsp)
+{
+  if(htsp->htsp_method_queued)
+    return;
+
+  htsp->htsp_method_queued = 1;
+  TAILQ_INSERT_TAIL(&htsp_method_queue, htsp, htsp_method_link);
+  pthread_cond_signal(&htsp_method_cond);
+}
+
+
+/**
+ * Wait for work, or until the first held back connection is due
+ *
+ * htsp_method_mutex is held
+ */
+static void
+htsp_method_wait(void)
+{
+  htsp_connection_t *htsp = TAILQ_FIRST(&htsp_method_delayed);
+  struct timespec ts;
+  struct timeval tv;
+  int64_t t;
+
+  if(htsp == NULL) {
+    pthread_cond_wait(&htsp_method_cond, &htsp_method_mutex);
+    return;
+  }
+
+  gettimeofday(&tv, NULL);
+  t = tv.tv_sec * 1000000LL + tv.tv_usec +
+    htsp->htsp_delay_until - getmonoclock();
+  ts.tv_sec  = t / 1000000;
+  ts.tv_nsec = (t % 1000000) * 1000;
+  pthread_cond_timedwait(&htsp_method_cond, &htsp_method_mutex, &ts);
+}
+
+
+/**
+ * Method pool worker
+ *
+ * A connection is served by one worker at a time so its requests are
+ * executed in order. A connection with a reply held back stays off the
+ * queue until the reply has been sent
+ */
+static void *
+htsp_method_thread(void *aux)
+{
+  htsp_connection_t *htsp;
+  htsp_inmsg_t *him;
+  htsmsg_t *reply;
+  int n;
+
+  pthread_mutex_lock(&htsp_method_mutex);
 
+  while(1) {
+    if((htsp = TAILQ_FIRST(&htsp_method_delayed)) != NULL &&
+       htsp->htsp_delay_until <= getmonoclock()) {
+      TAILQ_REMOVE(&htsp_method_delayed, htsp, htsp_delay_link);
+      reply = htsp->htsp_delayed_reply;
+      htsp->htsp_delayed_reply = NULL;
+      pthread_mutex_unlock(&htsp_method_mutex);
+      if(htsp->htsp_closing)
+	htsmsg_destroy(reply);
+      else
+	htsp_send_message(htsp, reply, NULL);
+      pthread_mutex_lock(&htsp_method_mutex);
+    } else if((htsp = TAILQ_FIRST(&htsp_method_queue)) != NULL) {
+      TAILQ_REMOVE(&htsp_method_queue, htsp, htsp_method_link);
     } else {
-      reply = htsp_error("No 'method' argument");
+      htsp_method_wait();
+      continue;
+    }
+
+    if(!htsp->htsp_initialized) {
+      htsp->htsp_initialized = 1;
+      pthread_mutex_unlock(&htsp_method_mutex);
+      htsp_session_init(htsp);
+      pthread_mutex_lock(&htsp_method_mutex);
     }
 
-    pthread_mutex_unlock(&global_lock);
+    for(n = 0; n < HTSP_METHOD_BATCH; n++) {
+      if((him = TAILQ_FIRST(&htsp->htsp_inq)) == NULL)
+	break;
+      TAILQ_REMOVE(&htsp->htsp_inq, him, him_link);
+      pthread_mutex_unlock(&htsp_method_mutex);
+
+      /* No point in serving a client that is gone */
+      if(!htsp->htsp_closing)
+	htsp_dispatch(htsp, him->him_msg);
+      htsmsg_destroy(him->him_msg);
+      free(him);
+
+      pthread_mutex_lock(&htsp_method_mutex);
 
-    if(reply != NULL) /* Methods can do all the replying inline */
-      htsp_reply(htsp, m, reply);
+      if(htsp->htsp_delayed_reply != NULL)
+	break;
+    }
+
+    if(htsp->htsp_delayed_reply != NULL) {
+      /* Delays are all the same, so the queue stays sorted */
+      htsp->htsp_delay_until = getmonoclock() + HTSP_NOACCESS_DELAY;
+      TAILQ_INSERT_TAIL(&htsp_method_delayed, htsp, htsp_delay_link);
+      continue;
+    }
 
-    htsmsg_destroy(m);
+    if(TAILQ_FIRST(&htsp->htsp_inq) != NULL) {
+      /* Let others have a go */
+      TAILQ_INSERT_TAIL(&htsp_method_queue, htsp, htsp_method_link);
+      continue;
+    }
+
+    if(htsp->htsp_closing) {
+      pthread_mutex_unlock(&htsp_method_mutex);
+      htsp_session_destroy(htsp);
+      pthread_mutex_lock(&htsp_method_mutex);
+      continue;
+    }
+
+    htsp->htsp_method_queued = 0;
   }
+  return NULL;
 }
 
 
+/**
+ *
+ */
+static void
+htsp_io_wakeup(htsp_io_t *hio)
+{
+  char c = 0;
+
+  if(write(hio->hio_pipe[1], &c, 1) == -1 && errno != EAGAIN)
+    tvhlog(LOG_ERR, "htsp", "I/O thread wakeup failed: %s", strerror(errno));
+}
+
 
 /**
  *
  */
-static void *
-htsp_write_scheduler(void *aux)
+static void
+htsp_io_set_events(htsp_connection_t *htsp, int events)
+{
+  struct epoll_event ev;
+
+  if(htsp->htsp_io_events == events)
+    return;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = htsp;
+  epoll_ctl(htsp->htsp_io->hio_epollfd, EPOLL_CTL_MOD, htsp->htsp_fd, &ev);
+  htsp->htsp_io_events = events;
+}
+
+
+/**
+ * Drop messages that have been written
+ */
+static void
+htsp_io_release(htsp_connection_t *htsp)
 {
-  htsp_connection_t *htsp = aux;
-  int r;
-  htsp_msg_q_t *hmq;
   htsp_msg_t *hm;
-  void *dptr;
-  size_t dlen;
+
+  while((hm = TAILQ_FIRST(&htsp->htsp_wbatch)) != htsp->htsp_wstop) {
+    TAILQ_REMOVE(&htsp->htsp_wbatch, hm, hm_link);
+    htsp_msg_destroy(hm);
+  }
+  free(htsp->htsp_wspill);
+  htsp->htsp_wspill = NULL;
+  htsp->htsp_wiov_i = htsp->htsp_wiov_n = 0;
+}
+
+
+/**
+ * Dequeue as much as fits in the send window and build the iovec.
+ * Headers and small fields are serialized into the connection's
+ * buffer, packet payloads are referenced from their pktbufs.
+ *
+ * Returns number of iovecs to write
+ */
+static int
+htsp_io_fill(htsp_connection_t *htsp)
+{
+  struct iovec *iov = htsp->htsp_wiov;
+  htsp_msg_t *hm;
+  size_t used = 0, len;
+  int n = 0, payload = 0, niov = 0, r;
+
+  TAILQ_FOREACH(hm, &htsp->htsp_wbatch, hm_link) {
+    payload += hm->hm_payloadsize;
+    n++;
+  }
 
   pthread_mutex_lock(&htsp->htsp_out_mutex);
+  while(n < HTSP_WRITE_BATCH && payload < HTSP_WRITE_WINDOW &&
+	(hm = htsp_dequeue(htsp)) != NULL) {
+    TAILQ_INSERT_TAIL(&htsp->htsp_wbatch, hm, hm_link);
+    payload += hm->hm_payloadsize;
+    n++;
+  }
+  pthread_mutex_unlock(&htsp->htsp_out_mutex);
 
-  while(1) {
+  if(n == 0)
+    return 0;
 
-    if((hmq = TAILQ_FIRST(&htsp->htsp_active_output_queues)) == NULL) {
-      /* No active queues at all */
-      if(!htsp->htsp_writer_run)
-	break; /* Should not run anymore, bail out */
-      
-      /* Nothing to be done, go to sleep */
-      pthread_cond_wait(&htsp->htsp_out_cond, &htsp->htsp_out_mutex);
+  if(htsp->htsp_wbuf == NULL)
+    htsp->htsp_wbuf = malloc(HTSP_WRITE_BUFSIZE);
+
+  TAILQ_FOREACH(hm, &htsp->htsp_wbatch, hm_link) {
+    if(hm->hm_msg == NULL) {
+      /* Shared, already serialized */
+      if(niov == HTSP_WRITE_IOVECS)
+	break;
+      iov[niov].iov_base = pktbuf_ptr(hm->hm_pb);
+      iov[niov].iov_len  = pktbuf_len(hm->hm_pb);
+      niov++;
       continue;
     }
+    r = htsmsg_binary_serialize_iov(hm->hm_msg, htsp->htsp_wbuf + used,
+				    HTSP_WRITE_BUFSIZE - used, iov + niov,
+				    HTSP_WRITE_IOVECS - niov, &len);
+    if(r < 0)
+      break;
+    niov += r;
+    used += len;
+  }
+  htsp->htsp_wstop = hm;
+
+  if(hm == TAILQ_FIRST(&htsp->htsp_wbatch)) {
+    /* Does not fit on its own, serialize into a buffer of its own */
+    htsmsg_binary_serialize(hm->hm_msg, &htsp->htsp_wspill, &len, INT32_MAX);
+    iov[0].iov_base = htsp->htsp_wspill;
+    iov[0].iov_len  = len;
+    niov = 1;
+    htsp->htsp_wstop = TAILQ_NEXT(hm, hm_link);
+  }
 
-    hm = TAILQ_FIRST(&hmq->hmq_q);
-    TAILQ_REMOVE(&hmq->hmq_q, hm, hm_link);
-    hmq->hmq_length--;
-    hmq->hmq_payload -= hm->hm_payloadsize;
+  htsp->htsp_wiov_i = 0;
+  htsp->htsp_wiov_n = niov;
+  return niov;
+}
 
-    TAILQ_REMOVE(&htsp->htsp_active_output_queues, hmq, hmq_link);
-    if(hmq->hmq_length) {
-      /* Still messages to be sent, put back in active queues */
-      if(hmq->hmq_strict_prio) {
-	TAILQ_INSERT_HEAD(&htsp->htsp_active_output_queues, hmq, hmq_link);
-      } else {
-	TAILQ_INSERT_TAIL(&htsp->htsp_active_output_queues, hmq, hmq_link);
+
+/**
+ * Write queued output until the socket is full or the queues are
+ * empty. Returns 0 or errno
+ */
+static int
+htsp_io_write(htsp_connection_t *htsp)
+{
+  struct iovec *iov;
+  ssize_t r;
+  int rounds = 0;
+
+  while(1) {
+    if(htsp->htsp_wiov_i == htsp->htsp_wiov_n) {
+      htsp_io_release(htsp);
+
+      if(rounds++ == HTSP_WRITE_ROUNDS) {
+	/* Let other connections have a go, we'll be back */
+	htsp_io_set_events(htsp, EPOLLIN | EPOLLOUT);
+	return 0;
+      }
+
+      if(htsp_io_fill(htsp) == 0) {
+	htsp_io_set_events(htsp, EPOLLIN);
+	return 0;
       }
     }
 
-    pthread_mutex_unlock(&htsp->htsp_out_mutex);
+    iov = htsp->htsp_wiov + htsp->htsp_wiov_i;
+    r = writev(htsp->htsp_fd, iov, htsp->htsp_wiov_n - htsp->htsp_wiov_i);
+    if(r == -1) {
+      if(errno == EINTR)
+	continue;
+      if(errno == EAGAIN) {
+	htsp_io_set_events(htsp, EPOLLIN | EPOLLOUT);
+	return 0;
+      }
+      return errno;
+    }
 
-    r = htsmsg_binary_serialize(hm->hm_msg, &dptr, &dlen, INT32_MAX);
+    /* writev() may stop short, pick up where it did */
+    while(htsp->htsp_wiov_i < htsp->htsp_wiov_n && r >= iov->iov_len) {
+      r -= iov->iov_len;
+      iov++;
+      htsp->htsp_wiov_i++;
+    }
 
-#if 0
-    if(hm->hm_pktref) {
-      usleep(hm->hm_payloadsize * 3);
+    if(htsp->htsp_wiov_i < htsp->htsp_wiov_n) {
+      iov->iov_base = (uint8_t *)iov->iov_base + r;
+      iov->iov_len -= r;
     }
-#endif
-    htsp_msg_destroy(hm);
-   
-    /* ignore return value */ 
-    r = write(htsp->htsp_fd, dptr, dlen);
-    if(r != dlen)
-      tvhlog(LOG_INFO, "htsp", "%s: Write error -- %s", 
-	     htsp->htsp_logname, strerror(errno));
-    free(dptr);
-    pthread_mutex_lock(&htsp->htsp_out_mutex);
-    if(r != dlen) 
-      break;
   }
+}
 
-  pthread_mutex_unlock(&htsp->htsp_out_mutex);
-  return NULL;
+
+/**
+ * Read requests and hand them to the method pool. Returns 0 or errno
+ */
+static int
+htsp_io_read(htsp_connection_t *htsp)
+{
+  htsp_inmsg_t *him;
+  htsmsg_t *m;
+  ssize_t r;
+  size_t len;
+  int n;
+
+  for(n = 0; n < HTSP_READ_BATCH; n++) {
+    if(htsp->htsp_rbuf == NULL) {
+      r = read(htsp->htsp_fd, htsp->htsp_rhdr + htsp->htsp_rlen,
+	       4 - htsp->htsp_rlen);
+    } else {
+      r = read(htsp->htsp_fd, htsp->htsp_rbuf + htsp->htsp_rlen,
+	       htsp->htsp_rsize - htsp->htsp_rlen);
+    }
+
+    if(r == 0)
+      return ECONNRESET;
+    if(r == -1) {
+      if(errno == EINTR)
+	continue;
+      if(errno == EAGAIN)
+	return 0;
+      return errno;
+    }
+    htsp->htsp_rlen += r;
+
+    if(htsp->htsp_rbuf == NULL) {
+      if(htsp->htsp_rlen < 4)
+	continue;
+
+      len = (htsp->htsp_rhdr[0] << 24) | (htsp->htsp_rhdr[1] << 16) |
+	(htsp->htsp_rhdr[2] << 8) | htsp->htsp_rhdr[3];
+      if(len > 1024 * 1024)
+	return EMSGSIZE;
+      if(len == 0)
+	return EBADMSG;
+      if((htsp->htsp_rbuf = malloc(len)) == NULL)
+	return ENOMEM;
+      htsp->htsp_rsize = len;
+      htsp->htsp_rlen = 0;
+      continue;
+    }
+
+    if(htsp->htsp_rlen < htsp->htsp_rsize)
+      continue;
+
+    /* buf will be tied to the message.
+     * NB: If the message can not be deserialized buf will be free'd by the
+     * function.
+     */
+    m = htsmsg_binary_deserialize(htsp->htsp_rbuf, htsp->htsp_rsize,
+				  htsp->htsp_rbuf);
+    htsp->htsp_rbuf = NULL;
+    htsp->htsp_rlen = 0;
+    if(m == NULL)
+      return EBADMSG;
+
+    him = malloc(sizeof(htsp_inmsg_t));
+    him->him_msg = m;
+    pthread_mutex_lock(&htsp_method_mutex);
+    TAILQ_INSERT_TAIL(&htsp->htsp_inq, him, him_link);
+    htsp_method_schedule(htsp);
+    pthread_mutex_unlock(&htsp_method_mutex);
+  }
+  return 0;
 }
 
 
 /**
- *
+ * Connection is gone, hand it to the method pool for teardown.
+ * It must not be touched after this
  */
 static void
-htsp_serve(int fd, void *opaque, struct sockaddr_in *source,
-	   struct sockaddr_in *self)
+htsp_io_close(htsp_connection_t *htsp, int err)
 {
-  htsp_connection_t htsp;
-  char buf[30];
-  htsp_subscription_t *s;
+  htsp_io_t *hio = htsp->htsp_io;
+  htsp_msg_t *hm;
 
-  snprintf(buf, sizeof(buf), "%s", inet_ntoa(source->sin_addr));
+  if(err != ECONNRESET)
+    tvhlog(LOG_INFO, "htsp", "%s: Connection error -- %s",
+	   htsp->htsp_peername, strerror(err));
 
-  memset(&htsp, 0, sizeof(htsp_connection_t));
+  epoll_ctl(hio->hio_epollfd, EPOLL_CTL_DEL, htsp->htsp_fd, NULL);
+
+  pthread_mutex_lock(&htsp->htsp_out_mutex);
+  htsp->htsp_io_dead = 1;
+  if(htsp->htsp_write_pending) {
+    pthread_mutex_lock(&hio->hio_mutex);
+    TAILQ_REMOVE(&hio->hio_pending, htsp, htsp_pending_link);
+    pthread_mutex_unlock(&hio->hio_mutex);
+    htsp->htsp_write_pending = 0;
+  }
+  pthread_mutex_unlock(&htsp->htsp_out_mutex);
 
-  TAILQ_INIT(&htsp.htsp_active_output_queues);
+  htsp->htsp_wstop = NULL;
+  htsp_io_release(htsp);
+  while((hm = TAILQ_FIRST(&htsp->htsp_wbatch)) != NULL) {
+    TAILQ_REMOVE(&htsp->htsp_wbatch, hm, hm_link);
+    htsp_msg_destroy(hm);
+  }
+  free(htsp->htsp_rbuf);
+  htsp->htsp_rbuf = NULL;
 
-  htsp_init_queue(&htsp.htsp_hmq_ctrl, 0);
-  htsp_init_queue(&htsp.htsp_hmq_qstatus, 1);
-  htsp_init_queue(&htsp.htsp_hmq_epg, 0);
+  pthread_mutex_lock(&htsp_method_mutex);
+  htsp->htsp_closing = 1;
+  htsp_method_schedule(htsp);
+  pthread_mutex_unlock(&htsp_method_mutex);
+}
 
-  htsp.htsp_peername = strdup(buf);
-  htsp_update_logname(&htsp);
 
-  htsp.htsp_fd = fd;
-  htsp.htsp_peer = source;
-  htsp.htsp_writer_run = 1;
+/**
+ * Event loop, serves socket I/O for its share of the connections
+ */
+static void *
+htsp_io_thread(void *aux)
+{
+  htsp_io_t *hio = aux;
+  htsp_connection_t *htsp;
+  struct epoll_event ev[32];
+  char buf[64];
+  int i, n, r;
 
-  pthread_create(&htsp.htsp_writer_thread, NULL, htsp_write_scheduler, &htsp);
+  while(1) {
 
-  /**
-   * Reader loop
-   */
+    /* Connections with new output */
+    while(1) {
+      pthread_mutex_lock(&hio->hio_mutex);
+      if((htsp = TAILQ_FIRST(&hio->hio_pending)) != NULL)
+	TAILQ_REMOVE(&hio->hio_pending, htsp, htsp_pending_link);
+      pthread_mutex_unlock(&hio->hio_mutex);
 
-  htsp_read_loop(&htsp);
+      if(htsp == NULL)
+	break;
 
-  tvhlog(LOG_INFO, "htsp", "%s: Disconnected", htsp.htsp_logname);
+      pthread_mutex_lock(&htsp->htsp_out_mutex);
+      htsp->htsp_write_pending = 0;
+      pthread_mutex_unlock(&htsp->htsp_out_mutex);
 
-  /**
-   * Ok, we're back, other end disconnected. Clean up stuff.
-   */
+      if((r = htsp_io_write(htsp)) != 0)
+	htsp_io_close(htsp, r);
+    }
 
-  pthread_mutex_lock(&global_lock);
+    n = epoll_wait(hio->hio_epollfd, ev, 32, -1);
+    if(n == -1) {
+      if(errno != EINTR) {
+	tvhlog(LOG_ERR, "htsp", "epoll() error -- %s, sleeping 1 second",
+	       strerror(errno));
+	sleep(1);
+      }
+      continue;
+    }
 
-  /* Beware! Closing subscriptions will invoke a lot of callbacks
-     down in the streaming code. So we do this as early as possible
-     to avoid any weird lockups */
-  while((s = LIST_FIRST(&htsp.htsp_subscriptions)) != NULL) {
-    htsp_subscription_destroy(&htsp, s);
+    for(i = 0; i < n; i++) {
+      htsp = ev[i].data.ptr;
+
+      if(htsp == NULL) {
+	while(read(hio->hio_pipe[0], buf, sizeof(buf)) > 0)
+	  ;
+	continue;
+      }
+
+      r = 0;
+      if(ev[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+	r = htsp_io_read(htsp);
+      if(r == 0 && ev[i].events & EPOLLOUT)
+	r = htsp_io_write(htsp);
+      if(r != 0)
+	htsp_io_close(htsp, r);
+    }
   }
+  return NULL;
+}
 
-  if(htsp.htsp_async_mode)
-    LIST_REMOVE(&htsp, htsp_async_link);
 
-  pthread_mutex_unlock(&global_lock);
+/**
+ * Called from the TCP accept thread, must not block
+ */
+static void
+htsp_serve(int fd, void *opaque, struct sockaddr_in *source,
+	   struct sockaddr_in *self)
+{
+  htsp_connection_t *htsp = calloc(1, sizeof(htsp_connection_t));
+  struct epoll_event ev;
+  char buf[30];
+
+  snprintf(buf, sizeof(buf), "%s", inet_ntoa(source->sin_addr));
 
-  free(htsp.htsp_logname);
-  free(htsp.htsp_peername);
-  free(htsp.htsp_username);
-  free(htsp.htsp_clientname);
+  TAILQ_INIT(&htsp->htsp_active_output_queues);
 
-  pthread_mutex_lock(&htsp.htsp_out_mutex);
-  htsp.htsp_writer_run = 0;
-  pthread_cond_signal(&htsp.htsp_out_cond);
-  pthread_mutex_unlock(&htsp.htsp_out_mutex);
+  htsp_init_queue(&htsp->htsp_hmq_ctrl, 0);
+  htsp_init_queue(&htsp->htsp_hmq_qstatus, 1);
+  htsp_init_queue(&htsp->htsp_hmq_epg, 0);
 
-  pthread_join(htsp.htsp_writer_thread, NULL);
-  close(fd);
+  htsp->htsp_peername = strdup(buf);
+  htsp_update_logname(htsp);
+
+  htsp->htsp_fd = fd;
+  htsp->htsp_peer_addr = *source;
+  htsp->htsp_peer = &htsp->htsp_peer_addr;
+
+  pthread_mutex_init(&htsp->htsp_out_mutex, NULL);
+  TAILQ_INIT(&htsp->htsp_inq);
+  TAILQ_INIT(&htsp->htsp_wbatch);
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  htsp->htsp_io = &htsp_io[htsp_io_next++ % HTSP_IO_THREADS];
+  htsp->htsp_io_events = EPOLLIN;
+
+  /* Session setup needs global_lock, do it on the method pool */
+  pthread_mutex_lock(&htsp_method_mutex);
+  htsp_method_schedule(htsp);
+  pthread_mutex_unlock(&htsp_method_mutex);
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = htsp->htsp_io_events;
+  ev.data.ptr = htsp;
+  epoll_ctl(htsp->htsp_io->hio_epollfd, EPOLL_CTL_ADD, fd, &ev);
 }
   
 /**
@@ -1377,23 +2416,101 @@ htsp_serve(int fd, void *opaque, struct sockaddr_in *source,
 void
 htsp_init(void)
 {
-  htsp_server = tcp_server_create(9982, htsp_serve, NULL);
+  struct epoll_event ev;
+  htsp_io_t *hio;
+  pthread_t tid;
+  int i;
+
+  htsp_epoch = time(NULL);
+
+  pthread_mutex_init(&htsp_method_mutex, NULL);
+  pthread_cond_init(&htsp_method_cond, NULL);
+  TAILQ_INIT(&htsp_method_queue);
+  TAILQ_INIT(&htsp_method_delayed);
+
+  for(i = 0; i < HTSP_METHOD_THREADS; i++)
+    pthread_create(&tid, NULL, htsp_method_thread, NULL);
+
+  for(i = 0; i < HTSP_IO_THREADS; i++) {
+    hio = &htsp_io[i];
+    pthread_mutex_init(&hio->hio_mutex, NULL);
+    TAILQ_INIT(&hio->hio_pending);
+    hio->hio_epollfd = epoll_create(10);
+
+    if(pipe(hio->hio_pipe) == -1) {
+      tvhlog(LOG_ERR, "htsp", "Unable to create I/O thread pipe: %s",
+	     strerror(errno));
+      continue;
+    }
+    fcntl(hio->hio_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(hio->hio_pipe[1], F_SETFL, O_NONBLOCK);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    epoll_ctl(hio->hio_epollfd, EPOLL_CTL_ADD, hio->hio_pipe[0], &ev);
+
+    pthread_create(&tid, NULL, htsp_io_thread, hio);
+  }
+
+  htsp_server = tcp_server_create_async(9982, htsp_serve, NULL);
 }
 
 /**
- *
+ * Broadcast to all async connections. The message is serialized once
+ * and the result is shared by every connection's queue and the
+ * change log
  */
 static void
 htsp_async_send(htsmsg_t *m)
 {
   htsp_connection_t *htsp;
+  htsp_change_t *hc;
+  void *dptr;
+  size_t dlen;
+
+  lock_assert(&global_lock);
+
+  htsp_version++;
+  htsmsg_add_u32(m, "version", htsp_version);
 
-  LIST_FOREACH(htsp, &htsp_async_connections, htsp_async_link)
-    htsp_send_message(htsp, htsmsg_copy(m), NULL);
+  hc = &htsp_changelog[htsp_version % HTSP_CHANGELOG_SIZE];
+  if(hc->hc_pb != NULL)
+    pktbuf_ref_dec(hc->hc_pb);
+  hc->hc_version = htsp_version;
+  hc->hc_pb = NULL;
+
+  if(!htsmsg_binary_serialize(m, &dptr, &dlen, INT32_MAX)) {
+    hc->hc_pb = pktbuf_make(dptr, dlen);
+    LIST_FOREACH(htsp, &htsp_async_connections, htsp_async_link)
+      htsp_send(htsp, NULL, hc->hc_pb, &htsp->htsp_hmq_ctrl, 0);
+  }
   htsmsg_destroy(m);
 }
 
 
+/**
+ *
+ */
+void
+htsp_sync_dump(htsbuf_queue_t *hq)
+{
+  uint32_t oldest;
+
+  lock_assert(&global_lock);
+
+  oldest = htsp_version > HTSP_CHANGELOG_SIZE ?
+    htsp_version - HTSP_CHANGELOG_SIZE + 1 : 1;
+
+  htsbuf_qprintf(hq, "Epoch: %u  Version: %u  Log covers: %u - %u\n",
+		 htsp_epoch, htsp_version, oldest, htsp_version);
+  htsbuf_qprintf(hq, "Initial syncs: %d legacy, %d delta, %d bulk "
+		 "(%d bulk messages built)\n",
+		 htsp_sync_legacy, htsp_sync_delta, htsp_sync_bulk,
+		 htsp_sync_builds);
+}
+
+
 /**
  * EPG subsystem calls this function when the current event
  * changes for a channel, e may be NULL if there is no current event.
@@ -1523,29 +2640,176 @@ const static char frametypearray[PKT_NTYPES] = {
   [PKT_B_FRAME] = 'B',
 };
 
+/**
+ * DTS distance in microseconds, 0 if 'b' is not older than 'a'
+ */
+static int64_t
+htsp_dts_delay(int64_t a, int64_t b)
+{
+  int64_t d = (a - b) & HTSP_PTS_MASK;
+  return d > HTSP_PTS_MASK / 2 ? 0 : ts_rescale(d, 1000000);
+}
+
+
+/**
+ * Queue delay of a subscription as seen by a packet with 'dts'
+ *
+ * htsp_out_mutex is held
+ */
+static int64_t
+htsp_queue_delay(htsp_subscription_t *hs, int64_t dts)
+{
+  htsp_msg_t *hm;
+
+  if(dts == PTS_UNSET)
+    return hs->hs_delay;
+
+  TAILQ_FOREACH(hm, &hs->hs_q.hmq_q, hm_link)
+    if(hm->hm_dts != PTS_UNSET)
+      return htsp_dts_delay(dts, hm->hm_dts);
+  return 0;
+}
+
+
+/**
+ * Tell the client that packets were dropped, the next packet for the
+ * subscription is a video I-frame (or any packet if there is no video)
+ */
+static htsmsg_t *
+htsp_build_resync(htsp_subscription_t *hs)
+{
+  htsmsg_t *m = htsmsg_create_map();
+
+  htsmsg_add_str(m, "method", "subscriptionResync");
+  htsmsg_add_u32(m, "subscriptionId", hs->hs_sid);
+  htsmsg_add_u32(m, "packets", hs->hs_skip_packets);
+  htsmsg_add_u32(m, "bytes", hs->hs_skip_bytes);
+  hs->hs_skip_packets = 0;
+  hs->hs_skip_bytes = 0;
+  return m;
+}
+
+
+/**
+ * Drop queued packets from the head up to the oldest video I-frame
+ * that leaves at most half the target delay queued, the client is told
+ * right before that I-frame. Without video any packet will do. Without
+ * such resync point (or if 'all' is set) all queued packets are dropped
+ * and video input is skipped until the next I-frame arrives.
+ *
+ * htsp_out_mutex is held, dropped messages are moved to 'dropped'
+ */
+static void
+htsp_drop_gops(htsp_connection_t *htsp, htsp_subscription_t *hs,
+	       int64_t dts, int all, struct htsp_msg_queue *dropped)
+{
+  htsp_msg_q_t *hmq = &hs->hs_q;
+  htsp_msg_t *hm, *next, *keep = NULL;
+  int active = hmq->hmq_length > 0, n = 0;
+
+  if(!all && dts != PTS_UNSET) {
+    TAILQ_FOREACH_REVERSE(hm, &hmq->hmq_q, htsp_msg_queue, hm_link) {
+      if(hm->hm_dts == PTS_UNSET)
+	continue;
+      if(htsp_dts_delay(dts, hm->hm_dts) > hs->hs_latency / 2)
+	break;
+      if(hm->hm_frametype == PKT_I_FRAME ||
+	 (!hs->hs_video && hm->hm_frametype >= 0))
+	keep = hm;
+    }
+  }
+
+  for(hm = TAILQ_FIRST(&hmq->hmq_q); hm != keep; hm = next) {
+    next = TAILQ_NEXT(hm, hm_link);
+    if(hm->hm_frametype < 0)
+      continue; /* Subscription status messages are always delivered */
+
+    hs->hs_dropstats[hm->hm_frametype]++;
+    hs->hs_skip_packets++;
+    hs->hs_skip_bytes += hm->hm_payloadsize;
+
+    TAILQ_REMOVE(&hmq->hmq_q, hm, hm_link);
+    hmq->hmq_length--;
+    hmq->hmq_payload -= hm->hm_payloadsize;
+    TAILQ_INSERT_TAIL(dropped, hm, hm_link);
+    n++;
+  }
+
+  if(keep == NULL) {
+    hs->hs_skip = 1;
+  } else if(n > 0) {
+    hm = htsp_msg_create(htsp_build_resync(hs), NULL, 0);
+    TAILQ_INSERT_BEFORE(keep, hm, hm_link);
+    hmq->hmq_length++;
+  }
+
+  if(active && hmq->hmq_length == 0)
+    TAILQ_REMOVE(&htsp->htsp_active_output_queues, hmq, hmq_link);
+
+  if(n > 0)
+    tvhlog(LOG_DEBUG, "htsp", "%s: Subscription %d: Dropped %d packets, "
+	   "queue delay %lld ms", htsp->htsp_logname, hs->hs_sid, n,
+	   (long long)(hs->hs_delay / 1000));
+}
+
+
 /**
  * Build a htsmsg from a th_pkt and enqueue it on our HTSP service
  */
 static void
 htsp_stream_deliver(htsp_subscription_t *hs, th_pkt_t *pkt)
 {
-  htsmsg_t *m, *n;
+  htsmsg_t *m;
   htsp_msg_t *hm;
   htsp_connection_t *htsp = hs->hs_htsp;
-  int64_t ts;
-  int qlen = hs->hs_q.hmq_payload;
+  struct htsp_msg_queue dropped;
+  int64_t delay;
+  int drop = 0, resync = 0;
 
-  if((qlen > 500000 && pkt->pkt_frametype == PKT_B_FRAME) ||
-     (qlen > 750000 && pkt->pkt_frametype == PKT_P_FRAME) || 
-     (qlen > 1500000)) {
+  TAILQ_INIT(&dropped);
 
-    hs->hs_dropstats[pkt->pkt_frametype]++;
+  pthread_mutex_lock(&htsp->htsp_out_mutex);
+
+  hs->hs_delay = delay = htsp_queue_delay(hs, pkt->pkt_dts);
+
+  if(delay > hs->hs_latency ||
+     hs->hs_q.hmq_payload > HTSP_QUEUE_MAX_PAYLOAD) {
+    htsp_drop_gops(htsp, hs, pkt->pkt_dts, delay <= hs->hs_latency,
+		   &dropped);
+    hs->hs_delay = delay = htsp_queue_delay(hs, pkt->pkt_dts);
+  }
+
+  /* Only video frames carry a frame type, other components are
+     delivered while skipping video. Without video any packet resyncs */
+  if(hs->hs_skip &&
+     (!hs->hs_video || pkt->pkt_frametype == PKT_I_FRAME)) {
+    hs->hs_skip = 0;
+    resync = 1;
+  } else if(hs->hs_skip && pkt->pkt_frametype != 0) {
+    drop = 1;
+    hs->hs_skip_packets++;
+    if(pkt->pkt_payload != NULL)
+      hs->hs_skip_bytes += pktbuf_len(pkt->pkt_payload);
+  } else if(pkt->pkt_frametype == PKT_B_FRAME && delay > hs->hs_latency / 2) {
+    drop = 1;
+  }
+
+  pthread_mutex_unlock(&htsp->htsp_out_mutex);
+
+  while((hm = TAILQ_FIRST(&dropped)) != NULL) {
+    TAILQ_REMOVE(&dropped, hm, hm_link);
+    htsp_msg_destroy(hm);
+  }
 
-    /* Queue size protection */
+  if(drop) {
+    hs->hs_dropstats[pkt->pkt_frametype]++;
     pkt_ref_dec(pkt);
     return;
   }
 
+  if(resync)
+    htsp_send(htsp, htsp_build_resync(hs), NULL, &hs->hs_q, 0);
+
   m = htsmsg_create_map();
  
   htsmsg_add_str(m, "method", "muxpkt");
@@ -1577,7 +2841,10 @@ htsp_stream_deliver(htsp_subscription_t *hs, th_pkt_t *pkt)
    */
   htsmsg_add_binptr(m, "payload", pktbuf_ptr(pkt->pkt_payload),
 		    pktbuf_len(pkt->pkt_payload));
-  htsp_send(htsp, m, pkt->pkt_payload, &hs->hs_q, pktbuf_len(pkt->pkt_payload));
+  hm = htsp_msg_create(m, pkt->pkt_payload, pktbuf_len(pkt->pkt_payload));
+  hm->hm_dts = pkt->pkt_dts;
+  hm->hm_frametype = pkt->pkt_frametype;
+  htsp_enqueue(htsp, hm, &hs->hs_q);
 
   if(hs->hs_last_report != dispatch_clock) {
 
@@ -1590,21 +2857,8 @@ htsp_stream_deliver(htsp_subscription_t *hs, th_pkt_t *pkt)
     htsmsg_add_u32(m, "subscriptionId", hs->hs_sid);
     htsmsg_add_u32(m, "packets", hs->hs_q.hmq_length);
     htsmsg_add_u32(m, "bytes", hs->hs_q.hmq_payload);
-
-    /**
-     * Figure out real time queue delay 
-     */
-    
-    pthread_mutex_lock(&htsp->htsp_out_mutex);
-
-    if(TAILQ_FIRST(&hs->hs_q.hmq_q) == NULL) {
-      htsmsg_add_s64(m, "delay", 0);
-    } else if((hm = TAILQ_FIRST(&hs->hs_q.hmq_q)) != NULL &&
-	      (n = hm->hm_msg) != NULL && !htsmsg_get_s64(n, "dts", &ts) &&
-	      pkt->pkt_dts != PTS_UNSET && ts != PTS_UNSET) {
-      htsmsg_add_s64(m, "delay", pkt->pkt_dts - ts);
-    }
-    pthread_mutex_unlock(&htsp->htsp_out_mutex);
+    htsmsg_add_s64(m, "delay", hs->hs_delay);
+    htsmsg_add_u32(m, "latency", hs->hs_latency / 1000);
 
     htsmsg_add_u32(m, "Bdrops", hs->hs_dropstats[PKT_B_FRAME]);
     htsmsg_add_u32(m, "Pdrops", hs->hs_dropstats[PKT_P_FRAME]);
@@ -1632,6 +2886,8 @@ htsp_subscription_start(htsp_subscription_t *hs, const streaming_start_t *ss)
   int i;
   const source_info_t *si = &ss->ss_si;
 
+  hs->hs_video = 0;
+
   for(i = 0; i < ss->ss_num_components; i++) {
     const streaming_start_component_t *ssc = &ss->ss_components[i];
 
@@ -1666,6 +2922,9 @@ htsp_subscription_start(htsp_subscription_t *hs, const streaming_start_t *ss)
     }
 
     htsmsg_add_msg(streams, NULL, c);
+
+    if(SCT_ISVIDEO(ssc->ssc_type))
+      hs->hs_video = 1;
   }
   
   htsmsg_add_msg(m, "streams", streams);
@@ -1731,6 +2990,27 @@ htsp_subscription_service_status(htsp_subscription_t *hs, int status)
   }
 }
 
+/**
+ * Playback of a timeshifted subscription moved. Whatever is queued
+ * is from the old position
+ */
+static void
+htsp_subscription_skip(htsp_subscription_t *hs, int shift)
+{
+  htsmsg_t *m = htsmsg_create_map();
+
+  htsp_flush_queue(hs->hs_htsp, &hs->hs_q);
+  hs->hs_skip = 0;
+  hs->hs_delay = 0;
+  hs->hs_skip_packets = 0;
+  hs->hs_skip_bytes = 0;
+
+  htsmsg_add_str(m, "method", "subscriptionSkip");
+  htsmsg_add_u32(m, "subscriptionId", hs->hs_sid);
+  htsmsg_add_s64(m, "shift", shift * 1000LL);
+  htsp_send(hs->hs_htsp, m, NULL, &hs->hs_q, 0);
+}
+
 /**
  *
  */
@@ -1761,6 +3041,10 @@ htsp_streaming_input(void *opaque, streaming_message_t *sm)
     htsp_subscription_status(hs,  streaming_code2txt(sm->sm_code));
     break;
 
+  case SMT_SKIP:
+    htsp_subscription_skip(hs, sm->sm_code);
+    break;
+
   case SMT_MPEGTS:
     break;
 
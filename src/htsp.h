@@ -38,4 +38,8 @@ void htsp_dvr_entry_add(dvr_entry_t *de);
 void htsp_dvr_entry_update(dvr_entry_t *de);
 void htsp_dvr_entry_delete(dvr_entry_t *de);
 
+void htsp_method_dump(htsbuf_queue_t *hq);
+
+void htsp_sync_dump(htsbuf_queue_t *hq);
+
 #endif /* HTSP_H_ */
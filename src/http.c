@@ -16,6 +16,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define _GNU_SOURCE /* for strptime() and timegm() */
 #include <pthread.h>
 #include <assert.h>
 #include <stdio.h>
@@ -23,8 +24,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -34,10 +40,50 @@
 #include "http.h"
 #include "access.h"
 
+#define HTTP_WORKER_THREADS 8
+#define HTTP_HEADER_MAX     16384
+#define HTTP_POST_MAX       (16 * 1024 * 1024)
+#define HTTP_IDLE_TIMEOUT   30         /* Waiting for a request (sec) */
+#define HTTP_WRITE_TIMEOUT  60         /* Client not reading (sec) */
+#define HTTP_OUTPUT_FULL    (1 << 20)  /* Parked producers should wait */
+#define HTTP_OUTPUT_MAX     (16 << 20) /* Client is too far behind */
+
+#define HTTP_WORK_REQUEST   0x1
+#define HTTP_WORK_PUMP      0x2
+#define HTTP_WORK_CLOSE     0x4
+
 static void *http_server;
 
 static LIST_HEAD(, http_path) http_paths;
 
+/**
+ * Requests are read and replies written by the event loop, handlers
+ * run on the worker pool. Handlers that wait for events or stream
+ * park the connection, the event loop writes what they produce.
+ *
+ * The work queue and the counters are protected by http_work_mutex,
+ * the pending list handed to the event loop by http_io_mutex
+ */
+static int http_epollfd;
+static int http_pipe[2];   /* Event loop wakeup */
+static LIST_HEAD(, http_connection) http_connections_list;
+
+static pthread_mutex_t http_io_mutex;
+static TAILQ_HEAD(, http_connection) http_pending;
+
+static pthread_mutex_t http_work_mutex;
+static pthread_cond_t http_work_cond;
+static TAILQ_HEAD(, http_connection) http_work_queue;
+
+static int http_connections;
+static int http_queued;
+static int http_queued_max;
+static int http_busy;
+static int http_parked;
+static unsigned int http_accepted;
+static unsigned int http_requests;
+static unsigned int http_timeouts;
+
 static struct strtab HTTP_cmdtab[] = {
   { "GET",        HTTP_CMD_GET },
   { "HEAD",       HTTP_CMD_HEAD },
@@ -125,10 +171,14 @@ http_rc2str(int code)
   switch(code) {
   case HTTP_STATUS_OK:              return "OK";
   case HTTP_STATUS_PARTIAL_CONTENT: return "Partial Content";
+  case HTTP_STATUS_NOT_MODIFIED:    return "Not Modified";
   case HTTP_STATUS_NOT_FOUND:       return "Not found";
   case HTTP_STATUS_UNAUTHORIZED:    return "Unauthorized";
   case HTTP_STATUS_BAD_REQUEST:     return "Bad request";
   case HTTP_STATUS_FOUND:           return "Found";
+  case HTTP_STATUS_UNAVAILABLE:     return "Service Unavailable";
+  case HTTP_STATUS_RANGE_NOT_SATISFIABLE:
+    return "Requested Range Not Satisfiable";
   default:
     return "Unknown returncode";
     break;
@@ -146,16 +196,28 @@ static const char *cachemonths[12] = {
 
 
 /**
- * Transmit a HTTP reply
+ * RFC 1123 date
  */
-void
-http_send_header(http_connection_t *hc, int rc, const char *content, 
-		 int64_t contentlen,
-		 const char *encoding, const char *location, 
-		 int maxage, const char *range,
-		 const char *disposition)
+static void
+http_qprintf_date(htsbuf_queue_t *hq, const char *name, time_t t)
+{
+  struct tm tm0, *tm = gmtime_r(&t, &tm0);
+
+  htsbuf_qprintf(hq, "%s: %s, %02d %s %d %02d:%02d:%02d GMT\r\n", name,
+		 cachedays[tm->tm_wday], tm->tm_mday,
+		 cachemonths[tm->tm_mon], tm->tm_year + 1900,
+		 tm->tm_hour, tm->tm_min, tm->tm_sec);
+}
+
+/**
+ *
+ */
+static void
+http_send_header0(http_connection_t *hc, int rc, const char *content,
+		  int64_t contentlen, const char *encoding,
+		  const char *location, int maxage, const char *range,
+		  const char *disposition, const char *etag, time_t mtime)
 {
-  struct tm tm0, *tm;
   htsbuf_queue_t hdrs;
   time_t t;
 
@@ -171,26 +233,16 @@ http_send_header(http_connection_t *hc, int rc, const char *content,
     htsbuf_qprintf(&hdrs, "Cache-Control: no-cache\r\n");
   } else {
     time(&t);
-
-    tm = gmtime_r(&t, &tm0);
-    htsbuf_qprintf(&hdrs, 
-		"Last-Modified: %s, %02d %s %d %02d:%02d:%02d GMT\r\n",
-		cachedays[tm->tm_wday],	tm->tm_year + 1900,
-		cachemonths[tm->tm_mon], tm->tm_mday,
-		tm->tm_hour, tm->tm_min, tm->tm_sec);
-
-    t += maxage;
-
-    tm = gmtime_r(&t, &tm0);
-    htsbuf_qprintf(&hdrs, 
-		"Expires: %s, %02d %s %d %02d:%02d:%02d GMT\r\n",
-		cachedays[tm->tm_wday],	tm->tm_year + 1900,
-		cachemonths[tm->tm_mon], tm->tm_mday,
-		tm->tm_hour, tm->tm_min, tm->tm_sec);
-      
+    http_qprintf_date(&hdrs, "Last-Modified", mtime ? mtime : t);
+    http_qprintf_date(&hdrs, "Expires", t + maxage);
     htsbuf_qprintf(&hdrs, "Cache-Control: max-age=%d\r\n", maxage);
   }
 
+  if(etag != NULL) {
+    htsbuf_qprintf(&hdrs, "ETag: \"%s\"\r\n", etag);
+    htsbuf_qprintf(&hdrs, "Vary: Accept-Encoding\r\n");
+  }
+
   if(rc == HTTP_STATUS_UNAUTHORIZED)
     htsbuf_qprintf(&hdrs, "WWW-Authenticate: Basic realm=\"tvheadend\"\r\n");
 
@@ -219,7 +271,109 @@ http_send_header(http_connection_t *hc, int rc, const char *content,
   
   htsbuf_qprintf(&hdrs, "\r\n");
 
-  tcp_write_queue(hc->hc_fd, &hdrs);
+  http_push(hc, &hdrs);
+}
+
+/**
+ * Transmit a HTTP reply
+ */
+void
+http_send_header(http_connection_t *hc, int rc, const char *content, 
+		 int64_t contentlen,
+		 const char *encoding, const char *location, 
+		 int maxage, const char *range,
+		 const char *disposition)
+{
+  http_send_header0(hc, rc, content, contentlen, encoding, location,
+		    maxage, range, disposition, NULL, 0);
+}
+
+/**
+ * Transmit a HTTP reply for cacheable content. 'etag' is the entity
+ * tag of the variant sent, 'mtime' when the content last changed
+ */
+void
+http_send_header_static(http_connection_t *hc, int rc, const char *content,
+			int64_t contentlen, const char *encoding,
+			const char *etag, time_t mtime, int maxage)
+{
+  http_send_header0(hc, rc, content, contentlen, encoding, NULL,
+		    maxage, NULL, NULL, etag, mtime);
+}
+
+/**
+ * Returns 1 if the client already has the content, in which case it
+ * should be answered with HTTP_STATUS_NOT_MODIFIED
+ */
+int
+http_not_modified(http_connection_t *hc, const char *etag, time_t mtime)
+{
+  const char *s, *e;
+  struct tm tm;
+  size_t len;
+
+  if(etag != NULL &&
+     (s = http_arg_get(&hc->hc_args, "If-None-Match")) != NULL) {
+    /* Takes precedence over If-Modified-Since */
+    len = strlen(etag);
+    while(*s) {
+      if(*s == '*')
+	return 1;
+      if(!strncmp(s, "W/", 2))
+	s += 2;
+      if(*s == '"') {
+	s++;
+	if((e = strchr(s, '"')) == NULL)
+	  break;
+	if(e - s == len && !strncmp(s, etag, len))
+	  return 1;
+	s = e + 1;
+      } else {
+	s++;
+      }
+    }
+    return 0;
+  }
+
+  if(mtime && (s = http_arg_get(&hc->hc_args, "If-Modified-Since")) != NULL) {
+    memset(&tm, 0, sizeof(tm));
+    if(strptime(s, "%a, %d %b %Y %H:%M:%S", &tm) != NULL &&
+       timegm(&tm) >= mtime)
+      return 1;
+  }
+  return 0;
+}
+
+/**
+ * Returns 1 if the client accepts the content coding 'coding'
+ */
+int
+http_accept_encoding(http_connection_t *hc, const char *coding)
+{
+  const char *s = http_arg_get(&hc->hc_args, "Accept-Encoding");
+  size_t len = strlen(coding), l;
+  float q;
+
+  if(s == NULL)
+    return 0;
+
+  while(*s) {
+    while(*s == ' ' || *s == ',')
+      s++;
+    l = strcspn(s, " ,;");
+
+    if(l == len && !strncasecmp(s, coding, len)) {
+      s += l;
+      while(*s == ' ')
+	s++;
+      /* ;q=0 means not acceptable */
+      if(*s == ';' && sscanf(s, "; q=%f", &q) == 1 && q == 0)
+	return 0;
+      return 1;
+    }
+    s += strcspn(s, ",");
+  }
+  return 0;
 }
 
 
@@ -237,7 +391,7 @@ http_send_reply(http_connection_t *hc, int rc, const char *content,
   if(hc->hc_no_output)
     return;
 
-  tcp_write_queue(hc->hc_fd, &hc->hc_reply);
+  http_push(hc, &hc->hc_reply);
 }
 
 
@@ -385,35 +539,19 @@ http_cmd_get(http_connection_t *hc)
  * Return non-zero if we should disconnect
  */
 static int
-http_cmd_post(http_connection_t *hc, htsbuf_queue_t *spill)
+http_cmd_post(http_connection_t *hc)
 {
   http_path_t *hp;
   char *remain, *args, *v, *argv[2];
   int n;
 
-  /* Set keep-alive status */
-  v = http_arg_get(&hc->hc_args, "Content-Length");
-  if(v == NULL) {
-    /* No content length in POST, make us disconnect */
-    return -1;
-  }
-
-  hc->hc_post_len = atoi(v);
-  if(hc->hc_post_len > 16 * 1024 * 1024) {
-    /* Bail out if POST data > 16 Mb */
-    hc->hc_keep_alive = 0;
-    return -1;
-  }
-
-  /* Allocate space for data, we add a terminating null char to ease
-     string processing on the content */
+  /* The data has already been received by the event loop, we add a
+     terminating null char to ease string processing on the content */
 
   hc->hc_post_data = malloc(hc->hc_post_len + 1);
+  memcpy(hc->hc_post_data, hc->hc_rbuf + hc->hc_hdrlen, hc->hc_post_len);
   hc->hc_post_data[hc->hc_post_len] = 0;
 
-  if(tcp_read_data(hc->hc_fd, hc->hc_post_data, hc->hc_post_len, spill) < 0)
-    return -1;
-
  /* Parse content-type */
   v = http_arg_get(&hc->hc_args, "Content-Type");
   if(v == NULL) {
@@ -442,7 +580,7 @@ http_cmd_post(http_connection_t *hc, htsbuf_queue_t *spill)
  * Process a HTTP request
  */
 static int
-http_process_request(http_connection_t *hc, htsbuf_queue_t *spill)
+http_process_request(http_connection_t *hc)
 {
   switch(hc->hc_cmd) {
   default:
@@ -454,7 +592,7 @@ http_process_request(http_connection_t *hc, htsbuf_queue_t *spill)
     hc->hc_no_output = 1;
     return http_cmd_get(hc);
   case HTTP_CMD_POST:
-    return http_cmd_post(hc, spill);
+    return http_cmd_post(hc);
   }
 }
 
@@ -463,13 +601,13 @@ http_process_request(http_connection_t *hc, htsbuf_queue_t *spill)
  * clean up
  */
 static int
-process_request(http_connection_t *hc, htsbuf_queue_t *spill)
+process_request(http_connection_t *hc)
 {
   char *v, *argv[2];
   int n, rval = -1;
   uint8_t authbuf[150];
   
-  hc->hc_url_orig = tvh_strdupa(hc->hc_url);
+  hc->hc_url_orig = strdup(hc->hc_url);
 
   /* Set keep-alive status */
   v = http_arg_get(&hc->hc_args, "connection");
@@ -518,7 +656,7 @@ process_request(http_connection_t *hc, htsbuf_queue_t *spill)
 
   case HTTP_VERSION_1_0:
   case HTTP_VERSION_1_1:
-    rval = http_process_request(hc, spill);
+    rval = http_process_request(hc);
     break;
   }
   free(hc->hc_representative);
@@ -701,105 +839,906 @@ http_parse_get_args(http_connection_t *hc, char *args)
 
 
 /**
+ * Split off a header line, without its CR LF
+ */
+static char *
+http_next_line(char **bufp)
+{
+  char *line = *bufp, *e;
+
+  if((e = strchr(line, '\n')) != NULL) {
+    *bufp = e + 1;
+  } else {
+    e = line + strlen(line);
+    *bufp = e;
+  }
+  if(e > line && e[-1] == '\r')
+    e--;
+  *e = 0;
+  return line;
+}
+
+
+/**
+ * Parse request line and header once the header is complete. Pointers
+ * into the receive buffer are not kept since it may move while POST
+ * data is received
  *
+ * Returns -1 on error, 0 if more data is needed and 1 when the request
+ * including any POST data has been received
  */
-static void
-http_serve_requests(http_connection_t *hc, htsbuf_queue_t *spill)
+static int
+http_parse_request(http_connection_t *hc)
 {
-  char cmdline[1024];
-  char hdrline[1024];
-  char *argv[3], *c;
+  char *argv[3], *c, *line, *next, *end;
+  size_t i;
   int n;
 
-  htsbuf_queue_init(&hc->hc_reply, 0);
+  if(hc->hc_hdrlen == 0) {
+    /* Look for an empty line, bare LF line endings are accepted */
+    end = NULL;
+    for(i = hc->hc_rscan; i < hc->hc_rlen; i++) {
+      if(hc->hc_rbuf[i] != '\n')
+	continue;
+      if(i + 1 < hc->hc_rlen && hc->hc_rbuf[i + 1] == '\n') {
+	end = hc->hc_rbuf + i + 2;
+	break;
+      }
+      if(i + 2 < hc->hc_rlen && hc->hc_rbuf[i + 1] == '\r' &&
+	 hc->hc_rbuf[i + 2] == '\n') {
+	end = hc->hc_rbuf + i + 3;
+	break;
+      }
+    }
 
-  do {
-    hc->hc_no_output  = 0;
+    if(end == NULL) {
+      if(hc->hc_rlen > HTTP_HEADER_MAX)
+	return -1;
+      hc->hc_rscan = hc->hc_rlen > 2 ? hc->hc_rlen - 2 : 0;
+      return 0;
+    }
 
-    if(tcp_read_line(hc->hc_fd, cmdline, sizeof(cmdline), spill) < 0)
-      return;
+    hc->hc_hdrlen = end - hc->hc_rbuf;
+    end[-1] = 0;
 
-    if((n = http_tokenize(cmdline, argv, 3, -1)) != 3)
-      return;
-    
+    /* Request line */
+    next = hc->hc_rbuf;
+    line = http_next_line(&next);
+
+    if((n = http_tokenize(line, argv, 3, -1)) != 3)
+      return -1;
     if((hc->hc_cmd = str2val(argv[0], HTTP_cmdtab)) == -1)
-      return;
-    hc->hc_url = argv[1];
+      return -1;
     if((hc->hc_version = str2val(argv[2], HTTP_versiontab)) == -1)
-      return;
+      return -1;
+    hc->hc_url = strdup(argv[1]);
 
-    /* parse header */
-    while(1) {
-      if(tcp_read_line(hc->hc_fd, hdrline, sizeof(hdrline), spill) < 0)
-	return;
-
-      if(hdrline[0] == 0)
-	break; /* header complete */
+    /* Header */
+    while(*next) {
+      line = http_next_line(&next);
 
-      if((n = http_tokenize(hdrline, argv, 2, -1)) < 2)
+      if((n = http_tokenize(line, argv, 2, -1)) < 2)
 	continue;
 
       if((c = strrchr(argv[0], ':')) == NULL)
-	return;
+	return -1;
 
       *c = 0;
       http_arg_set(&hc->hc_args, argv[0], argv[1]);
     }
 
-    if(process_request(hc, spill))
-      break;
+    hc->hc_reqlen = hc->hc_hdrlen;
+
+    if(hc->hc_cmd == HTTP_CMD_POST) {
+      /* No content length in POST, make us disconnect */
+      if((c = http_arg_get(&hc->hc_args, "Content-Length")) == NULL)
+	return -1;
+
+      /* Bail out if POST data > 16 Mb */
+      hc->hc_post_len = atoi(c);
+      if(hc->hc_post_len > HTTP_POST_MAX)
+	return -1;
+      hc->hc_reqlen += hc->hc_post_len;
+    }
+  }
+
+  return hc->hc_rlen >= hc->hc_reqlen;
+}
+
+
+/**
+ * Forget about the served request, keeping anything pipelined after it
+ */
+static void
+http_request_done(http_connection_t *hc)
+{
+  size_t skip = hc->hc_reqlen;
 
-    free(hc->hc_post_data);
-    hc->hc_post_data = NULL;
+  free(hc->hc_url);
+  hc->hc_url = NULL;
 
-    http_arg_flush(&hc->hc_args);
-    http_arg_flush(&hc->hc_req_args);
+  free(hc->hc_url_orig);
+  hc->hc_url_orig = NULL;
 
-    htsbuf_queue_flush(&hc->hc_reply);
+  free(hc->hc_post_data);
+  hc->hc_post_data = NULL;
+  hc->hc_post_len = 0;
 
-    free(hc->hc_username);
-    hc->hc_username = NULL;
+  http_arg_flush(&hc->hc_args);
+  http_arg_flush(&hc->hc_req_args);
 
-    free(hc->hc_password);
-    hc->hc_password = NULL;
+  htsbuf_queue_flush(&hc->hc_reply);
 
-  } while(hc->hc_keep_alive);
-  
+  free(hc->hc_username);
+  hc->hc_username = NULL;
+
+  free(hc->hc_password);
+  hc->hc_password = NULL;
+
+  if(hc->hc_out_fd != -1) {
+    close(hc->hc_out_fd);
+    hc->hc_out_fd = -1;
+  }
+
+  /* Some clients send a stray CRLF after POST data */
+  while(skip < hc->hc_rlen &&
+	(hc->hc_rbuf[skip] == '\r' || hc->hc_rbuf[skip] == '\n'))
+    skip++;
+
+  hc->hc_rlen -= skip;
+  memmove(hc->hc_rbuf, hc->hc_rbuf + skip, hc->hc_rlen);
+  hc->hc_rscan = hc->hc_hdrlen = hc->hc_reqlen = 0;
+}
+
+
+/**
+ * Hand work on a connection to the worker pool. Work on a connection
+ * is never done by two workers at once
+ */
+static void
+http_schedule(http_connection_t *hc, int work)
+{
+  pthread_mutex_lock(&http_work_mutex);
+  hc->hc_work |= work;
+  if(!hc->hc_work_queued && !hc->hc_work_running) {
+    hc->hc_work_queued = 1;
+    TAILQ_INSERT_TAIL(&http_work_queue, hc, hc_work_link);
+    http_queued++;
+    if(http_queued > http_queued_max)
+      http_queued_max = http_queued;
+    pthread_cond_signal(&http_work_cond);
+  }
+  pthread_mutex_unlock(&http_work_mutex);
+}
+
+
+/**
+ * Have the event loop look at the connection, for new output or a
+ * finished request. hc_out_mutex is held
+ */
+static void
+http_notify(http_connection_t *hc)
+{
+  char c = 0;
+
+  if(hc->hc_dead || hc->hc_pending)
+    return;
+
+  hc->hc_pending = 1;
+  pthread_mutex_lock(&http_io_mutex);
+  TAILQ_INSERT_TAIL(&http_pending, hc, hc_pending_link);
+  pthread_mutex_unlock(&http_io_mutex);
+
+  if(write(http_pipe[1], &c, 1) == -1 && errno != EAGAIN)
+    tvhlog(LOG_ERR, "HTTP", "I/O thread wakeup failed: %s", strerror(errno));
+}
+
+
+/**
+ * Queue output. Written right away for parked connections, otherwise
+ * once the handler returns
+ *
+ * Returns -1 if the client is gone or too far behind, 1 if a parked
+ * producer should wait for the output to drain, else 0
+ */
+int
+http_push(http_connection_t *hc, htsbuf_queue_t *q)
+{
+  int r;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+
+  if(hc->hc_dead || hc->hc_out.hq_size > HTTP_OUTPUT_MAX) {
+    htsbuf_queue_flush(q);
+    r = -1;
+  } else {
+    htsbuf_appendq(&hc->hc_out, q);
+    r = hc->hc_out.hq_size >= HTTP_OUTPUT_FULL;
+    if(r)
+      hc->hc_out_full = 1;
+    if(hc->hc_parked)
+      http_notify(hc);
+  }
+
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+  return r;
+}
+
+
+/**
+ * Queue a copy of 'data', see http_push()
+ */
+int
+http_write(http_connection_t *hc, const void *data, size_t len)
+{
+  htsbuf_queue_t q;
+
+  if(hc->hc_no_output)
+    return 0;
+
+  htsbuf_queue_init(&q, 0);
+  htsbuf_append(&q, data, len);
+  return http_push(hc, &q);
+}
+
+
+/**
+ * Write 'iov' straight to the socket if nothing is queued ahead of it
+ * on a parked connection, only what the socket doesn't take is copied
+ * to the queue. See http_push() for the return value
+ */
+int
+http_writev(http_connection_t *hc, const struct iovec *iov, int iovcnt)
+{
+  ssize_t r;
+  int n, ret;
+
+  if(hc->hc_no_output)
+    return 0;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+
+  if(hc->hc_dead || hc->hc_out.hq_size > HTTP_OUTPUT_MAX) {
+    pthread_mutex_unlock(&hc->hc_out_mutex);
+    return -1;
+  }
+
+  if(hc->hc_parked && hc->hc_out.hq_size == 0 && hc->hc_out_fd == -1) {
+    while(iovcnt > 0) {
+      n = MIN(iovcnt, IOV_MAX);
+      if((r = writev(hc->hc_fd, iov, n)) == -1) {
+	if(errno == EINTR)
+	  continue;
+	if(errno == EAGAIN || errno == EWOULDBLOCK)
+	  break;
+	pthread_mutex_unlock(&hc->hc_out_mutex);
+	return -1;
+      }
+      hc->hc_out_active = dispatch_clock;
+
+      while(iovcnt > 0 && r >= iov->iov_len) {
+	r -= iov->iov_len;
+	iov++;
+	iovcnt--;
+      }
+      if(r > 0) {
+	/* Partly written, the socket is full */
+	htsbuf_append(&hc->hc_out, iov->iov_base + r, iov->iov_len - r);
+	iov++;
+	iovcnt--;
+	break;
+      }
+    }
+  }
+
+  for(; iovcnt > 0; iov++, iovcnt--)
+    htsbuf_append(&hc->hc_out, iov->iov_base, iov->iov_len);
+
+  ret = 0;
+  if(hc->hc_out.hq_size > 0) {
+    ret = hc->hc_out.hq_size >= HTTP_OUTPUT_FULL;
+    if(ret)
+      hc->hc_out_full = 1;
+    if(hc->hc_parked)
+      http_notify(hc);
+  }
+
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+  return ret;
 }
 
 
 /**
+ * Send bytes 'pos' to 'end' of the file 'fd' after the queued output.
+ * The connection owns 'fd' from now on. Calling it again with the same
+ * file moves the end, nothing may be queued after a file
+ */
+int
+http_send_file(http_connection_t *hc, int fd, off_t pos, off_t end)
+{
+  int r = 0;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+
+  if(hc->hc_out_fd != fd) {
+    if(hc->hc_out_fd != -1)
+      close(hc->hc_out_fd);
+    hc->hc_out_fd = fd;
+    hc->hc_out_pos = pos;
+  }
+  hc->hc_out_end = hc->hc_no_output ? hc->hc_out_pos : end;
+
+  if(hc->hc_dead)
+    r = -1;
+  else if(hc->hc_parked)
+    http_notify(hc);
+
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+  return r;
+}
+
+
+/**
+ * Write what the socket takes. hc_out_mutex is held
  *
+ * Returns -1 on error, 0 if output remains and 1 when all is written
+ */
+static int
+http_out_write(http_connection_t *hc)
+{
+  struct iovec iov[16];
+  htsbuf_data_t *hd;
+  ssize_t r;
+  int n;
+
+  while((hd = TAILQ_FIRST(&hc->hc_out.hq_q)) != NULL) {
+    for(n = 0; hd != NULL && n < 16; hd = TAILQ_NEXT(hd, hd_link), n++) {
+      iov[n].iov_base = hd->hd_data + hd->hd_data_off;
+      iov[n].iov_len  = hd->hd_data_len - hd->hd_data_off;
+    }
+
+    if((r = writev(hc->hc_fd, iov, n)) == -1) {
+      if(errno == EINTR)
+	continue;
+      return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    htsbuf_drop(&hc->hc_out, r);
+    hc->hc_io_active = dispatch_clock;
+  }
+
+  while(hc->hc_out_fd != -1 && hc->hc_out_pos < hc->hc_out_end) {
+    r = sendfile(hc->hc_fd, hc->hc_out_fd, &hc->hc_out_pos,
+		 MIN(hc->hc_out_end - hc->hc_out_pos, 1 << 20));
+    if(r == 0)
+      return -1; /* File is shorter than promised */
+    if(r == -1) {
+      if(errno == EINTR)
+	continue;
+      return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    hc->hc_io_active = dispatch_clock;
+  }
+  return 1;
+}
+
+
+/**
+ * Park the connection when the handler returns, see http.h. The first
+ * pump runs right after the handler
+ */
+void
+http_park(http_connection_t *hc, http_pump_t *pump,
+	  http_release_t *release, void *opaque)
+{
+  hc->hc_pump = pump;
+  hc->hc_release = release;
+  hc->hc_pump_opaque = opaque;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+  hc->hc_parked = 1;
+  http_notify(hc);
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+
+  pthread_mutex_lock(&http_work_mutex);
+  http_parked++;
+  pthread_mutex_unlock(&http_work_mutex);
+
+  http_schedule(hc, HTTP_WORK_PUMP);
+}
+
+
+/**
+ * Run the pump of a parked connection soon
+ */
+void
+http_wakeup(http_connection_t *hc)
+{
+  http_schedule(hc, HTTP_WORK_PUMP);
+}
+
+
+/**
+ * Detach the producer of a parked connection, the reply is complete
+ * once what it has queued is written. 'close' is set if the connection
+ * can't be reused
+ */
+static void
+http_unpark(http_connection_t *hc, int close)
+{
+  if(hc->hc_pump == NULL)
+    return;
+
+  hc->hc_release(hc, hc->hc_pump_opaque);
+  hc->hc_pump = NULL;
+  hc->hc_release = NULL;
+  hc->hc_pump_opaque = NULL;
+
+  pthread_mutex_lock(&http_work_mutex);
+  http_parked--;
+  pthread_mutex_unlock(&http_work_mutex);
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+  hc->hc_parked = 0;
+  hc->hc_served = 1;
+  hc->hc_close = close || !hc->hc_keep_alive;
+  http_notify(hc);
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+}
+
+
+/**
+ * Serve one request, the reply is queued for the event loop
+ */
+static void
+http_serve_request(http_connection_t *hc)
+{
+  int r;
+
+  hc->hc_no_output = 0;
+  r = process_request(hc);
+
+  pthread_mutex_lock(&http_work_mutex);
+  http_requests++;
+  pthread_mutex_unlock(&http_work_mutex);
+
+  /* Parked connections are done when their producer says so */
+  if(hc->hc_pump != NULL)
+    return;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+  hc->hc_served = 1;
+  hc->hc_close = r || !hc->hc_keep_alive;
+  http_notify(hc);
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+}
+
+
+/**
+ * The event loop has dropped the connection and nobody else refers
+ * to it
+ */
+static void
+http_destroy(http_connection_t *hc)
+{
+  http_request_done(hc);
+  htsbuf_queue_flush(&hc->hc_out);
+  close(hc->hc_fd);
+  pthread_mutex_destroy(&hc->hc_out_mutex);
+  free(hc->hc_rbuf);
+  free(hc);
+
+  pthread_mutex_lock(&http_work_mutex);
+  http_connections--;
+  pthread_mutex_unlock(&http_work_mutex);
+}
+
+
+/**
+ * Worker pool
+ */
+static void *
+http_worker_thread(void *aux)
+{
+  http_connection_t *hc;
+  int work, r;
+
+  pthread_mutex_lock(&http_work_mutex);
+
+  while(1) {
+    if((hc = TAILQ_FIRST(&http_work_queue)) == NULL) {
+      pthread_cond_wait(&http_work_cond, &http_work_mutex);
+      continue;
+    }
+    TAILQ_REMOVE(&http_work_queue, hc, hc_work_link);
+    hc->hc_work_queued = 0;
+    hc->hc_work_running = 1;
+    work = hc->hc_work;
+    hc->hc_work = 0;
+    http_queued--;
+    http_busy++;
+    pthread_mutex_unlock(&http_work_mutex);
+
+    if(work & HTTP_WORK_CLOSE) {
+      http_unpark(hc, 1);
+      http_destroy(hc);
+      pthread_mutex_lock(&http_work_mutex);
+      http_busy--;
+      continue;
+    }
+
+    if(work & HTTP_WORK_REQUEST)
+      http_serve_request(hc);
+
+    if(work & HTTP_WORK_PUMP && hc->hc_pump != NULL &&
+       (r = hc->hc_pump(hc, hc->hc_pump_opaque)) != 0)
+      http_unpark(hc, r < 0);
+
+    pthread_mutex_lock(&http_work_mutex);
+    hc->hc_work_running = 0;
+    if(hc->hc_work) {
+      hc->hc_work_queued = 1;
+      TAILQ_INSERT_TAIL(&http_work_queue, hc, hc_work_link);
+      http_queued++;
+    }
+    http_busy--;
+  }
+  return NULL;
+}
+
+
+/**
+ *
+ */
+static void
+http_io_set_events(http_connection_t *hc, int events)
+{
+  struct epoll_event ev;
+
+  if(hc->hc_io_events == events)
+    return;
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = hc;
+  epoll_ctl(http_epollfd, EPOLL_CTL_MOD, hc->hc_fd, &ev);
+  hc->hc_io_events = events;
+}
+
+
+/**
+ * Wait for the reply, and for room to write it if 'output'. A client
+ * that has shut down its sending side may still be waiting for the
+ * reply, after that only a full hangup or an error ends the connection
+ */
+static void
+http_io_wait(http_connection_t *hc, int output)
+{
+  http_io_set_events(hc, (hc->hc_io_rdhup ? EPOLLHUP : EPOLLRDHUP) |
+		     (output ? EPOLLOUT : 0));
+}
+
+
+/**
+ * Connection is gone or done, hand it to the worker pool for teardown.
+ * It must not be touched after this
+ */
+static void
+http_io_close(http_connection_t *hc)
+{
+  epoll_ctl(http_epollfd, EPOLL_CTL_DEL, hc->hc_fd, NULL);
+  LIST_REMOVE(hc, hc_link);
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+  hc->hc_dead = 1;
+  if(hc->hc_pending) {
+    pthread_mutex_lock(&http_io_mutex);
+    TAILQ_REMOVE(&http_pending, hc, hc_pending_link);
+    pthread_mutex_unlock(&http_io_mutex);
+    hc->hc_pending = 0;
+  }
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+
+  http_schedule(hc, HTTP_WORK_CLOSE);
+}
+
+
+/**
+ * Read what is available
+ *
+ * Returns -1 if the connection should be closed, 0 if more data is
+ * needed and 1 if a request is complete
+ */
+static int
+http_io_read(http_connection_t *hc)
+{
+  size_t want;
+  ssize_t r;
+  int p;
+
+  while(1) {
+    want = hc->hc_hdrlen ? hc->hc_reqlen : hc->hc_rlen + 4096;
+    if(want > hc->hc_rsize) {
+      hc->hc_rsize = MAX(want, hc->hc_rsize * 2);
+      hc->hc_rbuf = realloc(hc->hc_rbuf, hc->hc_rsize);
+    }
+
+    r = read(hc->hc_fd, hc->hc_rbuf + hc->hc_rlen, hc->hc_rsize - hc->hc_rlen);
+    if(r == 0)
+      return -1;
+    if(r == -1) {
+      if(errno == EINTR)
+	continue;
+      return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+    hc->hc_rlen += r;
+    hc->hc_io_active = dispatch_clock;
+
+    if((p = http_parse_request(hc)) != 0)
+      return p;
+  }
+}
+
+
+/**
+ * Start on a request, or wait for one
+ *
+ * 'r' is the result of http_io_read() or http_parse_request()
+ */
+static void
+http_io_request(http_connection_t *hc, int r)
+{
+  if(r < 0) {
+    http_io_close(hc);
+  } else if(r > 0) {
+    /* Nothing is read until the reply is done, only hangups matter */
+    hc->hc_io_reading = 0;
+    http_io_wait(hc, 0);
+    http_schedule(hc, HTTP_WORK_REQUEST);
+  } else {
+    hc->hc_io_reading = 1;
+    http_io_set_events(hc, EPOLLIN);
+  }
+}
+
+
+/**
+ * Write queued output and move on once the reply is done
+ */
+static void
+http_io_write(http_connection_t *hc)
+{
+  int r, full, served, close;
+
+  pthread_mutex_lock(&hc->hc_out_mutex);
+
+  if((r = http_out_write(hc)) < 0) {
+    pthread_mutex_unlock(&hc->hc_out_mutex);
+    http_io_close(hc);
+    return;
+  }
+
+  if(r == 0) {
+    pthread_mutex_unlock(&hc->hc_out_mutex);
+    http_io_wait(hc, 1);
+    return;
+  }
+
+  full = hc->hc_out_full;
+  hc->hc_out_full = 0;
+  served = hc->hc_served;
+  close = hc->hc_close;
+  hc->hc_served = hc->hc_close = 0;
+
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+
+  if(!served) {
+    /* Handler or producer is still at it */
+    http_io_wait(hc, 0);
+    if(full)
+      http_schedule(hc, HTTP_WORK_PUMP);
+    return;
+  }
+
+  if(close) {
+    http_io_close(hc);
+    return;
+  }
+
+  http_request_done(hc);
+
+  /* A pipelined request may be waiting in the buffer already */
+  hc->hc_io_active = dispatch_clock;
+  http_io_request(hc, http_parse_request(hc));
+}
+
+
+/**
+ * Once a second: close idle and stuck connections, pump parked ones
+ */
+static void
+http_io_timer(void)
+{
+  http_connection_t *hc, *next;
+  int output, parked;
+  time_t active;
+
+  for(hc = LIST_FIRST(&http_connections_list); hc != NULL; hc = next) {
+    next = LIST_NEXT(hc, hc_link);
+
+    if(hc->hc_io_reading) {
+      if(dispatch_clock - hc->hc_io_active >= HTTP_IDLE_TIMEOUT) {
+	if(hc->hc_rlen > 0)
+	  tvhlog(LOG_DEBUG, "HTTP", "%s: Timeout receiving request",
+		 inet_ntoa(hc->hc_peer->sin_addr));
+	http_timeouts++;
+	http_io_close(hc);
+      }
+      continue;
+    }
+
+    pthread_mutex_lock(&hc->hc_out_mutex);
+    output = hc->hc_out.hq_size > 0 ||
+      (hc->hc_out_fd != -1 && hc->hc_out_pos < hc->hc_out_end);
+    parked = hc->hc_parked;
+    active = MAX(hc->hc_io_active, hc->hc_out_active);
+    pthread_mutex_unlock(&hc->hc_out_mutex);
+
+    if(output && dispatch_clock - active >= HTTP_WRITE_TIMEOUT) {
+      tvhlog(LOG_INFO, "HTTP", "%s: Client stopped reading, disconnecting",
+	     inet_ntoa(hc->hc_peer->sin_addr));
+      http_timeouts++;
+      http_io_close(hc);
+      continue;
+    }
+
+    if(parked)
+      http_schedule(hc, HTTP_WORK_PUMP);
+  }
+}
+
+
+/**
+ * Event loop, reads requests for the worker pool and writes replies
+ */
+static void *
+http_io_thread(void *aux)
+{
+  http_connection_t *hc;
+  struct epoll_event ev[32];
+  time_t last = dispatch_clock;
+  char buf[64];
+  int i, n;
+
+  while(1) {
+
+    /* New connections and connections with new output */
+    while(1) {
+      pthread_mutex_lock(&http_io_mutex);
+      if((hc = TAILQ_FIRST(&http_pending)) != NULL)
+	TAILQ_REMOVE(&http_pending, hc, hc_pending_link);
+      pthread_mutex_unlock(&http_io_mutex);
+
+      if(hc == NULL)
+	break;
+
+      pthread_mutex_lock(&hc->hc_out_mutex);
+      hc->hc_pending = 0;
+      pthread_mutex_unlock(&hc->hc_out_mutex);
+
+      if(hc->hc_io_events == 0) {
+	memset(&ev[0], 0, sizeof(ev[0]));
+	ev[0].events = hc->hc_io_events = EPOLLIN;
+	ev[0].data.ptr = hc;
+	epoll_ctl(http_epollfd, EPOLL_CTL_ADD, hc->hc_fd, &ev[0]);
+	LIST_INSERT_HEAD(&http_connections_list, hc, hc_link);
+	hc->hc_io_reading = 1;
+	hc->hc_io_active = dispatch_clock;
+      } else if(!hc->hc_io_reading) {
+	http_io_write(hc);
+      }
+    }
+
+    if(dispatch_clock != last) {
+      last = dispatch_clock;
+      http_io_timer();
+    }
+
+    n = epoll_wait(http_epollfd, ev, 32, 1000);
+    if(n == -1) {
+      if(errno != EINTR) {
+	tvhlog(LOG_ERR, "HTTP", "epoll() error -- %s, sleeping 1 second",
+	       strerror(errno));
+	sleep(1);
+      }
+      continue;
+    }
+
+    for(i = 0; i < n; i++) {
+      hc = ev[i].data.ptr;
+
+      if(hc == NULL) {
+	while(read(http_pipe[0], buf, sizeof(buf)) > 0)
+	  ;
+	continue;
+      }
+
+      if(hc->hc_io_reading) {
+	http_io_request(hc, http_io_read(hc));
+	continue;
+      }
+
+      if(ev[i].events & (EPOLLERR | EPOLLHUP)) {
+	http_io_close(hc);
+	continue;
+      }
+
+      if(ev[i].events & EPOLLRDHUP) {
+	/* Half closed, the reply is still written */
+	hc->hc_io_rdhup = 1;
+	http_io_wait(hc, hc->hc_io_events & EPOLLOUT);
+      }
+
+      if(ev[i].events & EPOLLOUT)
+	http_io_write(hc);
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * Called from the TCP accept thread, must not block
  */
 static void
 http_serve(int fd, void *opaque, struct sockaddr_in *peer, 
 	   struct sockaddr_in *self)
 {
-  htsbuf_queue_t spill;
-  http_connection_t hc;
-  
-  memset(&hc, 0, sizeof(http_connection_t));
+  http_connection_t *hc = calloc(1, sizeof(http_connection_t));
+
+  TAILQ_INIT(&hc->hc_args);
+  TAILQ_INIT(&hc->hc_req_args);
+  htsbuf_queue_init(&hc->hc_reply, 0);
+  htsbuf_queue_init(&hc->hc_out, 0);
 
-  TAILQ_INIT(&hc.hc_args);
-  TAILQ_INIT(&hc.hc_req_args);
+  hc->hc_fd = fd;
+  hc->hc_peer_addr = *peer;
+  hc->hc_self_addr = *self;
+  hc->hc_peer = &hc->hc_peer_addr;
+  hc->hc_self = &hc->hc_self_addr;
+  hc->hc_out_fd = -1;
 
-  hc.hc_fd = fd;
-  hc.hc_peer = peer;
-  hc.hc_self = self;
+  pthread_mutex_init(&hc->hc_out_mutex, NULL);
 
-  htsbuf_queue_init(&spill, 0);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
 
-  http_serve_requests(&hc, &spill);
+  pthread_mutex_lock(&http_work_mutex);
+  http_connections++;
+  http_accepted++;
+  pthread_mutex_unlock(&http_work_mutex);
 
-  free(hc.hc_post_data);
-  free(hc.hc_username);
-  free(hc.hc_password);
+  /* The event loop picks it up */
+  pthread_mutex_lock(&hc->hc_out_mutex);
+  http_notify(hc);
+  pthread_mutex_unlock(&hc->hc_out_mutex);
+}
 
-  http_arg_flush(&hc.hc_args);
-  http_arg_flush(&hc.hc_req_args);
 
-  htsbuf_queue_flush(&spill);
-  close(fd);
+/**
+ *
+ */
+void
+http_server_dump(htsbuf_queue_t *hq)
+{
+  pthread_mutex_lock(&http_work_mutex);
+  htsbuf_qprintf(hq, "Connections: %d open, %u accepted, %u timed out  "
+		 "Requests: %u\n",
+		 http_connections, http_accepted, http_timeouts,
+		 http_requests);
+  htsbuf_qprintf(hq, "Workers: %d/%d busy  Parked: %d  "
+		 "Queued: %d (max %d)\n",
+		 http_busy, HTTP_WORKER_THREADS, http_parked,
+		 http_queued, http_queued_max);
+  pthread_mutex_unlock(&http_work_mutex);
 }
 
 
@@ -809,5 +1748,36 @@ http_serve(int fd, void *opaque, struct sockaddr_in *peer,
 void
 http_server_init(void)
 {
-  http_server = tcp_server_create(9981, http_serve, NULL);
+  struct epoll_event ev;
+  pthread_t tid;
+  int i;
+
+  pthread_mutex_init(&http_work_mutex, NULL);
+  pthread_cond_init(&http_work_cond, NULL);
+  TAILQ_INIT(&http_work_queue);
+
+  pthread_mutex_init(&http_io_mutex, NULL);
+  TAILQ_INIT(&http_pending);
+
+  http_epollfd = epoll_create(10);
+
+  if(pipe(http_pipe) == -1) {
+    tvhlog(LOG_ERR, "HTTP", "Unable to create I/O thread pipe: %s",
+	   strerror(errno));
+    return;
+  }
+  fcntl(http_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(http_pipe[1], F_SETFL, O_NONBLOCK);
+
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  epoll_ctl(http_epollfd, EPOLL_CTL_ADD, http_pipe[0], &ev);
+
+  pthread_create(&tid, NULL, http_io_thread, NULL);
+
+  for(i = 0; i < HTTP_WORKER_THREADS; i++)
+    pthread_create(&tid, NULL, http_worker_thread, NULL);
+
+  http_server = tcp_server_create_async(9981, http_serve, NULL);
 }
@@ -19,6 +19,8 @@
 #ifndef HTTP_H_
 #define HTTP_H_
 
+#include <netinet/in.h>
+#include <sys/uio.h>
 #include "htsbuf.h"
 
 TAILQ_HEAD(http_arg_list, http_arg);
@@ -32,9 +34,12 @@ typedef struct http_arg {
 #define HTTP_STATUS_OK           200
 #define HTTP_STATUS_PARTIAL_CONTENT 206
 #define HTTP_STATUS_FOUND        302
+#define HTTP_STATUS_NOT_MODIFIED 304
 #define HTTP_STATUS_BAD_REQUEST  400
 #define HTTP_STATUS_UNAUTHORIZED 401
 #define HTTP_STATUS_NOT_FOUND    404
+#define HTTP_STATUS_RANGE_NOT_SATISFIABLE 416
+#define HTTP_STATUS_UNAVAILABLE  503
 
 
 typedef struct http_connection {
@@ -92,6 +97,51 @@ typedef struct http_connection {
 
   struct rtsp *hc_rtsp_session;
 
+  /* Server internals */
+
+  LIST_ENTRY(http_connection) hc_link;     /* Event loop only */
+  int hc_io_events;                        /* Event loop only */
+  int hc_io_reading;                       /* Event loop only */
+  int hc_io_rdhup;                         /* Peer is done sending, likewise */
+  time_t hc_io_active;                     /* Last I/O, event loop only */
+
+  TAILQ_ENTRY(http_connection) hc_work_link; /* Protected by http_work_mutex */
+  int hc_work;                             /* HTTP_WORK_ flags, likewise */
+  int hc_work_queued;
+  int hc_work_running;
+
+  /* Set while parked, used by the workers only */
+  int (*hc_pump)(struct http_connection *hc, void *opaque);
+  void (*hc_release)(struct http_connection *hc, void *opaque);
+  void *hc_pump_opaque;
+
+  /**
+   * Fields below are protected by hc_out_mutex
+   */
+  pthread_mutex_t hc_out_mutex;
+  htsbuf_queue_t hc_out;   /* Output not yet written */
+  int hc_out_fd;           /* File sent after hc_out, -1 if none */
+  off_t hc_out_pos;
+  off_t hc_out_end;
+  time_t hc_out_active;    /* Last write by http_writev() */
+  int hc_out_full;         /* Producer waits for the output to drain */
+  int hc_parked;           /* See http_park() */
+  int hc_served;           /* Request is done once the output is written */
+  int hc_close;            /* Close once the output is written */
+  int hc_dead;             /* Dropped by the event loop */
+  TAILQ_ENTRY(http_connection) hc_pending_link; /* Event loop wakeup */
+  int hc_pending;
+
+  struct sockaddr_in hc_peer_addr;
+  struct sockaddr_in hc_self_addr;
+
+  char *hc_rbuf;           /* Received data, contiguous */
+  size_t hc_rsize;
+  size_t hc_rlen;
+  size_t hc_rscan;         /* Where to resume looking for end of header */
+  size_t hc_hdrlen;        /* Length of parsed header, 0 until complete */
+  size_t hc_reqlen;        /* Length of header and POST data */
+
 } http_connection_t;
 
 
@@ -116,6 +166,15 @@ void http_send_header(http_connection_t *hc, int rc, const char *content,
 		      const char *location, int maxage, const char *range,
 		      const char *disposition);
 
+void http_send_header_static(http_connection_t *hc, int rc,
+			     const char *content, int64_t contentlen,
+			     const char *encoding, const char *etag,
+			     time_t mtime, int maxage);
+
+int http_not_modified(http_connection_t *hc, const char *etag, time_t mtime);
+
+int http_accept_encoding(http_connection_t *hc, const char *coding);
+
 typedef int (http_callback_t)(http_connection_t *hc, 
 			      const char *remain, void *opaque);
 
@@ -135,6 +194,37 @@ http_path_t *http_path_add(const char *path, void *opaque,
 
 void http_server_init(void);
 
+void http_server_dump(htsbuf_queue_t *hq);
+
+int http_push(http_connection_t *hc, htsbuf_queue_t *q);
+
+int http_write(http_connection_t *hc, const void *data, size_t len);
+
+int http_writev(http_connection_t *hc, const struct iovec *iov, int iovcnt);
+
+int http_send_file(http_connection_t *hc, int fd, off_t pos, off_t end);
+
+/**
+ * A parked connection has its reply produced outside the request
+ * handler, by events or as long as a stream lasts. No thread is held
+ * while it waits.
+ *
+ * 'pump' runs on the worker pool after http_wakeup(), once a second and
+ * when output that filled up (http_push() returned 1) has been written.
+ * It returns 0 to stay parked, 1 when the reply is complete and -1 to
+ * close the connection. 'release' runs once when the reply is complete
+ * or the client has gone away, the connection must not be used by the
+ * producer after it returns. Calls are never concurrent
+ */
+typedef int (http_pump_t)(http_connection_t *hc, void *opaque);
+
+typedef void (http_release_t)(http_connection_t *hc, void *opaque);
+
+void http_park(http_connection_t *hc, http_pump_t *pump,
+	       http_release_t *release, void *opaque);
+
+void http_wakeup(http_connection_t *hc);
+
 int http_access_verify(http_connection_t *hc, int mask);
 
 void http_deescape(char *s);
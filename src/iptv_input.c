@@ -113,7 +113,7 @@ iptv_ts_input(service_t *t, const uint8_t *tsb)
     psi_section_reassemble(t->s_pmt_section, tsb, 1, iptv_got_pmt, t);
 
   } else {
-    ts_recv_packet1(t, tsb, NULL);
+    ts_recv_packet1(t, tsb, NULL, NULL);
   } 
 }
 
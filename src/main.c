@@ -49,6 +49,7 @@
 #include "capmt.h"
 #include "dvr/dvr.h"
 #include "htsp.h"
+#include "timeshift.h"
 #include "rawtsinput.h"
 #include "avahi.h"
 #include "iptv_input.h"
@@ -57,6 +58,7 @@
 #include "trap.h"
 #include "settings.h"
 #include "ffdecsa/FFdecsa.h"
+#include "csa.h"
 
 int running;
 time_t dispatch_clock;
@@ -164,6 +166,9 @@ usage(const char *argv0)
 	 "                 to your Tvheadend installation until you edit\n"
 	 "                 the access-control from within the Tvheadend UI\n");
   printf(" -s              Log debug to syslog\n");
+  printf(" -w <workers>    Number of CSA descrambling threads.\n"
+	 "                 Defaults to one per CPU, 0 descrambles in\n"
+	 "                 the input threads\n");
   printf("\n");
   printf("Development options\n");
   printf("\n");
@@ -242,11 +247,12 @@ main(int argc, char **argv)
   char *p, *endp;
   uint32_t adapter_mask = 0xffffffff;
   int crash = 0;
+  int csa_workers = -1;
 
   // make sure the timezone is set
   tzset();
 
-  while((c = getopt(argc, argv, "Aa:fp:u:g:c:Chdr:j:s")) != -1) {
+  while((c = getopt(argc, argv, "Aa:fp:u:g:c:Chdr:j:sw:")) != -1) {
     switch(c) {
     case 'a':
       adapter_mask = 0x0;
@@ -301,6 +307,9 @@ main(int argc, char **argv)
     case 'j':
       join_transport = optarg;
       break;
+    case 'w':
+      csa_workers = atoi(optarg);
+      break;
     default:
       usage(argv[0]);
     }
@@ -396,9 +405,13 @@ main(int argc, char **argv)
 
   dvr_init();
 
+  timeshift_init();
+
   htsp_init();
 
   ffdecsa_init();
+
+  csa_init(csa_workers);
   
   if(rawts_input != NULL)
     rawts_init(rawts_input);
@@ -248,6 +248,7 @@ gh_hold(globalheaders_t *gh, streaming_message_t *sm)
   case SMT_SERVICE_STATUS:
   case SMT_NOSTART:
   case SMT_MPEGTS:
+  case SMT_SKIP:
     streaming_target_deliver2(gh->gh_output, sm);
     break;
   }
@@ -275,6 +276,7 @@ gh_pass(globalheaders_t *gh, streaming_message_t *sm)
   case SMT_SERVICE_STATUS:
   case SMT_NOSTART:
   case SMT_MPEGTS:
+  case SMT_SKIP:
     streaming_target_deliver2(gh->gh_output, sm);
     break;
 
@@ -365,6 +365,7 @@ tsfix_input(void *opaque, streaming_message_t *sm)
   case SMT_SERVICE_STATUS:
   case SMT_NOSTART:
   case SMT_MPEGTS:
+  case SMT_SKIP:
     break;
   }
 
@@ -245,7 +245,7 @@ process_ts_packet(rawts_t *rt, uint8_t *tsb)
   LIST_FOREACH(t, &rt->rt_services, s_group_link) {
     pcr = PTS_UNSET;
 
-    ts_recv_packet1(t, tsb, &pcr);
+    ts_recv_packet1(t, tsb, &pcr, NULL);
 
     if(pcr != PTS_UNSET) {
       
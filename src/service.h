@@ -23,7 +23,7 @@
 
 #include "htsmsg.h"
 
-
+struct tsbuf;
 
 /**
  * Descrambler superclass
@@ -38,10 +38,13 @@ typedef struct th_descrambler {
 		   const uint8_t *section, int section_len);
 
   int (*td_descramble)(struct th_descrambler *d, struct service *t,
-		       struct elementary_stream *st, const uint8_t *tsb);
+		       struct elementary_stream *st, const uint8_t *tsb,
+		       struct tsbuf *tb);
 
   void (*td_stop)(struct th_descrambler *d);
 
+  void (*td_flush)(struct th_descrambler *d); /* Optional */
+
 } th_descrambler_t;
 
 
@@ -185,6 +185,7 @@ streaming_msg_clone(streaming_message_t *src)
   case SMT_STOP:
   case SMT_SERVICE_STATUS:
   case SMT_NOSTART:
+  case SMT_SKIP:
     dst->sm_code = src->sm_code;
     break;
 
@@ -250,6 +251,9 @@ streaming_msg_free(streaming_message_t *sm)
   case SMT_NOSTART:
     break;
 
+  case SMT_SKIP:
+    break;
+
   case SMT_MPEGTS:
     free(sm->sm_data);
     break;
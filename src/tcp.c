@@ -16,6 +16,7 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define _GNU_SOURCE /* for accept4() */
 #include <pthread.h>
 #include <netdb.h>
 #include <sys/epoll.h>
@@ -346,12 +347,15 @@ tcp_read_timeout(int fd, void *buf, size_t len, int timeout)
 /**
  *
  */
+#define TCP_ACCEPT_BATCH 32  /* Connections accepted per server per wakeup */
+
 static int tcp_server_epoll_fd;
 
 typedef struct tcp_server {
   tcp_server_callback_t *start;
   void *opaque;
   int serverfd;
+  int async;    /* Call 'start' from the accept thread */
 } tcp_server_t;
 
 typedef struct tcp_server_launch_t {
@@ -407,8 +411,8 @@ tcp_server_start(void *aux)
 static void *
 tcp_server_loop(void *aux)
 {
-  int r, i;
-  struct epoll_event ev[1];
+  int r, i, n;
+  struct epoll_event ev[8];
   tcp_server_t *ts;
   tcp_server_launch_t *tsl;
   pthread_attr_t attr;
@@ -434,19 +438,27 @@ tcp_server_loop(void *aux)
 	continue;
       }
 
-      if(ev[i].events & EPOLLIN) {
+      if(!(ev[i].events & EPOLLIN))
+	continue;
+
+      /* Drain the backlog, bounded so one server can't starve others */
+      for(n = 0; n < TCP_ACCEPT_BATCH; n++) {
 	tsl = malloc(sizeof(tcp_server_launch_t));
 	tsl->start  = ts->start;
 	tsl->opaque = ts->opaque;
 	slen = sizeof(struct sockaddr_in);
 
-	tsl->fd = accept(ts->serverfd, 
-			 (struct sockaddr *)&tsl->peer, &slen);
+	tsl->fd = accept4(ts->serverfd, 
+			  (struct sockaddr *)&tsl->peer, &slen, SOCK_CLOEXEC);
 	if(tsl->fd == -1) {
-	  perror("accept");
 	  free(tsl);
+	  if(errno == EAGAIN || errno == EWOULDBLOCK)
+	    break;
+	  if(errno == EINTR || errno == ECONNABORTED)
+	    continue;
+	  tvhlog(LOG_ERR, "tcp", "accept() failed -- %s", strerror(errno));
 	  sleep(1);
-	  continue;
+	  break;
 	}
 
 
@@ -457,7 +469,10 @@ tcp_server_loop(void *aux)
 	    continue;
 	}
 
-	pthread_create(&tid, &attr, tcp_server_start, tsl);
+	if(ts->async)
+	  tcp_server_start(tsl);
+	else
+	  pthread_create(&tid, &attr, tcp_server_start, tsl);
       }
     }
   }
@@ -467,8 +482,9 @@ tcp_server_loop(void *aux)
 /**
  *
  */
-void *
-tcp_server_create(int port, tcp_server_callback_t *start, void *opaque)
+static void *
+tcp_server_create0(int port, tcp_server_callback_t *start, void *opaque,
+		   int async)
 {
   int fd, x;
   struct epoll_event e;
@@ -492,12 +508,14 @@ tcp_server_create(int port, tcp_server_callback_t *start, void *opaque)
     return NULL;
   }
 
-  listen(fd, 1);
+  listen(fd, SOMAXCONN);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
 
   ts = malloc(sizeof(tcp_server_t));
   ts->serverfd = fd;
   ts->start = start;
   ts->opaque = opaque;
+  ts->async = async;
 
   
   e.events = EPOLLIN;
@@ -507,6 +525,25 @@ tcp_server_create(int port, tcp_server_callback_t *start, void *opaque)
   return ts;
 }
 
+/**
+ * A thread is started per connection, 'start' runs the session
+ */
+void *
+tcp_server_create(int port, tcp_server_callback_t *start, void *opaque)
+{
+  return tcp_server_create0(port, start, opaque, 0);
+}
+
+/**
+ * 'start' is called from the accept thread and must not block, the
+ * callee takes over the socket and serves it however it likes
+ */
+void *
+tcp_server_create_async(int port, tcp_server_callback_t *start, void *opaque)
+{
+  return tcp_server_create0(port, start, opaque, 1);
+}
+
 /**
  *
  */
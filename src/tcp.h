@@ -32,6 +32,9 @@ typedef void (tcp_server_callback_t)(int fd, void *opaque,
 
 void *tcp_server_create(int port, tcp_server_callback_t *start, void *opaque);
 
+void *tcp_server_create_async(int port, tcp_server_callback_t *start,
+			      void *opaque);
+
 int tcp_read(int fd, void *buf, size_t len);
 
 int tcp_read_line(int fd, char *buf, const size_t bufsize, 
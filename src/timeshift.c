@@ -0,0 +1,1152 @@
+/*
+ *  tvheadend, timeshift buffer
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include "tvheadend.h"
+#include "atomic.h"
+#include "channels.h"
+#include "packet.h"
+#include "streaming.h"
+#include "subscriptions.h"
+#include "settings.h"
+#include "timeshift.h"
+
+#define TIMESHIFT_RAM_DEFAULT    64    /* MB */
+#define TIMESHIFT_DISK_DEFAULT   512   /* MB */
+#define TIMESHIFT_PERIOD_DEFAULT 3600  /* seconds */
+
+LIST_HEAD(timeshift_list, timeshift);
+LIST_HEAD(timeshift_reader_list, timeshift_reader);
+
+/**
+ * A buffered packet, stream start or stream stop
+ *
+ * Packets are either in memory (te_pkt) or stored on disk at te_off.
+ * A packet that had to be dropped leaves an entry with neither
+ */
+typedef struct timeshift_entry {
+  int64_t te_time;             /* getmonoclock() at arrival */
+  th_pkt_t *te_pkt;
+  streaming_start_t *te_ss;
+  off_t te_off;                /* -1 if not on disk */
+  uint32_t te_size;            /* Bytes in memory */
+  uint32_t te_dsize;           /* Bytes on disk */
+  int te_stop;                 /* SMT_STOP, te_code is the reason */
+  int te_code;
+} timeshift_entry_t;
+
+
+/**
+ * I-frame index entry, with the stream start that applies to it
+ */
+typedef struct timeshift_kf {
+  uint64_t kf_seq;
+  streaming_start_t *kf_ss;
+} timeshift_kf_t;
+
+
+/**
+ * On disk packet header, followed by tr_size bytes of payload
+ */
+typedef struct timeshift_record {
+  int64_t tr_dts;
+  int64_t tr_pts;
+  int32_t tr_duration;
+  uint32_t tr_size;
+  uint8_t tr_commercial;
+  uint8_t tr_componentindex;
+  uint8_t tr_frametype;
+  uint8_t tr_field;
+  uint8_t tr_channels;
+  uint8_t tr_sri;
+  uint16_t tr_aspect_num;
+  uint16_t tr_aspect_den;
+} timeshift_record_t;
+
+
+/**
+ *
+ */
+typedef struct timeshift {
+  LIST_ENTRY(timeshift) ts_link;   /* Protected by global_lock */
+  int ts_chid;
+  char *ts_channel;
+  int ts_nreaders;
+
+  th_subscription_t *ts_s;
+  streaming_target_t ts_input;
+  pthread_t ts_tid;
+
+  /**
+   * Fields below are protected by ts_mutex
+   */
+  pthread_mutex_t ts_mutex;
+  pthread_cond_t ts_cond;
+  int ts_running;
+
+  struct timeshift_reader_list ts_readers;
+  streaming_start_t *ts_start;     /* Latest stream start */
+
+  timeshift_entry_t *ts_entries;   /* Ring of ts_size entries */
+  uint64_t ts_size;
+  uint64_t ts_first;               /* Oldest entry */
+  uint64_t ts_last;                /* Next entry to be added */
+  uint64_t ts_spilled;             /* Entries before this are not in RAM */
+
+  timeshift_kf_t *ts_kfs;          /* Ring of ts_kf_size entries */
+  uint64_t ts_kf_size;
+  uint64_t ts_kf_first;
+  uint64_t ts_kf_last;
+
+  size_t ts_ram;                   /* Payload bytes in memory */
+  int ts_fd;
+  off_t ts_woff;                   /* Next write position on disk */
+
+  uint64_t ts_packets;
+  uint64_t ts_written;
+  uint64_t ts_read;
+  uint64_t ts_dropped;             /* Expired due to lack of space */
+} timeshift_t;
+
+
+/**
+ *
+ */
+struct timeshift_reader {
+  LIST_ENTRY(timeshift_reader) tsr_link;
+  timeshift_t *tsr_ts;
+  streaming_target_t *tsr_output;
+  int tsr_id;
+  int tsr_gen;                     /* Bumped on every position change */
+  int tsr_live;
+  int tsr_paused;
+  uint64_t tsr_pos;                /* Next entry to deliver */
+  int64_t tsr_delta;               /* Playback clock is now - tsr_delta */
+  int64_t tsr_ptime;               /* Playback clock when paused */
+  streaming_start_t *tsr_ss;       /* Last stream start delivered */
+};
+
+
+static struct timeshift_list timeshifts;
+static int timeshift_reader_tally;
+
+static char *timeshift_path;
+static size_t timeshift_ram_max;
+static off_t timeshift_disk_max;
+static int64_t timeshift_period;
+
+
+/**
+ *
+ */
+static inline timeshift_entry_t *
+ts_entry(timeshift_t *ts, uint64_t seq)
+{
+  return &ts->ts_entries[seq & (ts->ts_size - 1)];
+}
+
+static inline timeshift_kf_t *
+ts_kf(timeshift_t *ts, uint64_t idx)
+{
+  return &ts->ts_kfs[idx & (ts->ts_kf_size - 1)];
+}
+
+
+/**
+ * Playback clock of a reader
+ */
+static int64_t
+tsr_position(timeshift_reader_t *tsr, int64_t now)
+{
+  if(tsr->tsr_live)
+    return now;
+  if(tsr->tsr_paused)
+    return tsr->tsr_ptime;
+  return now - tsr->tsr_delta;
+}
+
+
+/**
+ *
+ */
+static void
+tsr_deliver_start(timeshift_reader_t *tsr, streaming_start_t *ss)
+{
+  if(ss == NULL || ss == tsr->tsr_ss)
+    return;
+
+  if(tsr->tsr_ss != NULL)
+    streaming_start_unref(tsr->tsr_ss);
+  atomic_add(&ss->ss_refcount, 1);
+  tsr->tsr_ss = ss;
+
+  atomic_add(&ss->ss_refcount, 1);
+  streaming_target_deliver(tsr->tsr_output,
+			   streaming_msg_create_data(SMT_START, ss));
+}
+
+
+/**
+ * The next stream start is delivered again, whatever it is
+ */
+static void
+tsr_deliver_stop(timeshift_reader_t *tsr, int code)
+{
+  if(tsr->tsr_ss != NULL) {
+    streaming_start_unref(tsr->tsr_ss);
+    tsr->tsr_ss = NULL;
+  }
+
+  streaming_target_deliver(tsr->tsr_output,
+			   streaming_msg_create_code(SMT_STOP, code));
+}
+
+
+/**
+ * Drop the oldest entry
+ */
+static void
+ts_expire_one(timeshift_t *ts)
+{
+  timeshift_entry_t *te = ts_entry(ts, ts->ts_first);
+  timeshift_kf_t *kf;
+
+  if(te->te_pkt != NULL) {
+    ts->ts_ram -= te->te_size;
+    pkt_ref_dec(te->te_pkt);
+  }
+  if(te->te_ss != NULL)
+    streaming_start_unref(te->te_ss);
+
+  ts->ts_first++;
+  if(ts->ts_spilled < ts->ts_first)
+    ts->ts_spilled = ts->ts_first;
+
+  while(ts->ts_kf_first < ts->ts_kf_last) {
+    kf = ts_kf(ts, ts->ts_kf_first);
+    if(kf->kf_seq >= ts->ts_first)
+      break;
+    if(kf->kf_ss != NULL)
+      streaming_start_unref(kf->kf_ss);
+    ts->ts_kf_first++;
+  }
+}
+
+
+/**
+ * Drop entries older than the configured period
+ */
+static void
+ts_expire(timeshift_t *ts, int64_t now)
+{
+  while(ts->ts_first < ts->ts_last &&
+	ts_entry(ts, ts->ts_first)->te_time < now - timeshift_period)
+    ts_expire_one(ts);
+}
+
+
+/**
+ *
+ */
+static void
+ts_grow(timeshift_t *ts)
+{
+  timeshift_entry_t *v = calloc(ts->ts_size * 2, sizeof(timeshift_entry_t));
+  uint64_t seq;
+
+  for(seq = ts->ts_first; seq < ts->ts_last; seq++)
+    v[seq & (ts->ts_size * 2 - 1)] = *ts_entry(ts, seq);
+
+  free(ts->ts_entries);
+  ts->ts_entries = v;
+  ts->ts_size *= 2;
+}
+
+
+/**
+ *
+ */
+static void
+ts_add_kf(timeshift_t *ts, uint64_t seq)
+{
+  timeshift_kf_t *v, *kf;
+  uint64_t i;
+
+  if(ts->ts_kf_last - ts->ts_kf_first == ts->ts_kf_size) {
+    v = calloc(ts->ts_kf_size * 2, sizeof(timeshift_kf_t));
+    for(i = ts->ts_kf_first; i < ts->ts_kf_last; i++)
+      v[i & (ts->ts_kf_size * 2 - 1)] = *ts_kf(ts, i);
+    free(ts->ts_kfs);
+    ts->ts_kfs = v;
+    ts->ts_kf_size *= 2;
+  }
+
+  kf = ts_kf(ts, ts->ts_kf_last++);
+  kf->kf_seq = seq;
+  kf->kf_ss = ts->ts_start;
+  if(kf->kf_ss != NULL)
+    atomic_add(&kf->kf_ss->ss_refcount, 1);
+}
+
+
+/**
+ * Find the last keyframe received at or before 'when', or the oldest
+ * one if there is none. Returns -1 if the index is empty
+ */
+static int64_t
+ts_find_kf(timeshift_t *ts, int64_t when)
+{
+  uint64_t lo = ts->ts_kf_first, hi = ts->ts_kf_last, mid;
+
+  if(lo == hi)
+    return -1;
+
+  while(hi - lo > 1) {
+    mid = lo + (hi - lo) / 2;
+    if(ts_entry(ts, ts_kf(ts, mid)->kf_seq)->te_time <= when)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+
+/**
+ * Release the oldest packets in memory, for when the memory limit is
+ * exceeded and they can not be spilled to disk (fast enough). Entries
+ * on disk free no memory, so they are left alone. The released entries
+ * stay in the ring as gaps
+ */
+static void
+ts_drop_ram(timeshift_t *ts, size_t limit)
+{
+  timeshift_entry_t *te;
+
+  while(ts->ts_ram > limit && ts->ts_spilled < ts->ts_last) {
+    te = ts_entry(ts, ts->ts_spilled++);
+    if(te->te_pkt == NULL)
+      continue;
+    ts->ts_ram -= te->te_size;
+    pkt_ref_dec(te->te_pkt);
+    te->te_pkt = NULL;
+    ts->ts_dropped++;
+  }
+}
+
+
+/**
+ * Append a packet, a stream start or (if both are NULL) a stream stop
+ * with reason 'code'
+ */
+static void
+ts_append(timeshift_t *ts, th_pkt_t *pkt, streaming_start_t *ss, int code)
+{
+  timeshift_entry_t *te;
+  int64_t now = getmonoclock();
+
+  if(ts->ts_last - ts->ts_first == ts->ts_size)
+    ts_grow(ts);
+
+  te = ts_entry(ts, ts->ts_last);
+  memset(te, 0, sizeof(timeshift_entry_t));
+  te->te_time = now;
+  te->te_off = -1;
+
+  if(pkt != NULL) {
+    pkt_ref_inc(pkt);
+    te->te_pkt = pkt;
+    te->te_size = pktbuf_len(pkt->pkt_payload);
+    if(pkt->pkt_header != NULL)
+      te->te_size += pktbuf_len(pkt->pkt_header);
+    ts->ts_ram += te->te_size;
+    ts->ts_packets++;
+
+    if(pkt->pkt_frametype == PKT_I_FRAME)
+      ts_add_kf(ts, ts->ts_last);
+  } else if(ss != NULL) {
+    atomic_add(&ss->ss_refcount, 1);
+    te->te_ss = ss;
+  } else {
+    te->te_stop = 1;
+    te->te_code = code;
+  }
+  ts->ts_last++;
+
+  ts_expire(ts, now);
+
+  /**
+   * Without a disk file (or if the spill thread falls far behind)
+   * the memory limit is enforced by dropping packets from memory
+   */
+  ts_drop_ram(ts, (ts->ts_fd == -1 ? 1 : 2) * timeshift_ram_max);
+
+  if(ts->ts_ram > timeshift_ram_max && ts->ts_fd != -1)
+    pthread_cond_signal(&ts->ts_cond);
+}
+
+
+/**
+ * Streaming input from the channel subscription
+ */
+static void
+timeshift_input(void *opaque, streaming_message_t *sm)
+{
+  timeshift_t *ts = opaque;
+  timeshift_reader_t *tsr;
+  streaming_start_t *ss;
+
+  pthread_mutex_lock(&ts->ts_mutex);
+
+  switch(sm->sm_type) {
+  case SMT_PACKET:
+    ts_append(ts, sm->sm_data, NULL, 0);
+    LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+      if(tsr->tsr_live)
+	streaming_target_deliver(tsr->tsr_output, streaming_msg_clone(sm));
+    break;
+
+  case SMT_START:
+    ss = sm->sm_data;
+    if(ts->ts_start != NULL)
+      streaming_start_unref(ts->ts_start);
+    atomic_add(&ss->ss_refcount, 1);
+    ts->ts_start = ss;
+    ts_append(ts, NULL, ss, 0);
+
+    LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+      if(tsr->tsr_live)
+	tsr_deliver_start(tsr, ss);
+    break;
+
+  case SMT_STOP:
+    if(ts->ts_start != NULL) {
+      streaming_start_unref(ts->ts_start);
+      ts->ts_start = NULL;
+    }
+    /* Shifted readers get it when playback reaches it */
+    ts_append(ts, NULL, NULL, sm->sm_code);
+
+    LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+      if(tsr->tsr_live)
+	tsr_deliver_stop(tsr, sm->sm_code);
+    break;
+
+  case SMT_SERVICE_STATUS:
+  case SMT_NOSTART:
+    LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+      streaming_target_deliver(tsr->tsr_output, streaming_msg_clone(sm));
+    break;
+
+  default:
+    break;
+  }
+
+  pthread_mutex_unlock(&ts->ts_mutex);
+  streaming_msg_free(sm);
+}
+
+
+/**
+ * Offset of the oldest entry on disk, or -1 if there is none
+ */
+static off_t
+ts_disk_head(timeshift_t *ts, uint64_t *seqp)
+{
+  uint64_t seq;
+  timeshift_entry_t *te;
+
+  for(seq = ts->ts_first; seq < ts->ts_spilled; seq++) {
+    te = ts_entry(ts, seq);
+    if(te->te_off != -1) {
+      *seqp = seq;
+      return te->te_off;
+    }
+  }
+  return -1;
+}
+
+
+/**
+ * Find room for a record of 'len' bytes on disk, expiring the oldest
+ * entries that are in the way
+ */
+static off_t
+ts_disk_reserve(timeshift_t *ts, size_t len)
+{
+  off_t head, off;
+  uint64_t seq;
+
+  for(;;) {
+    head = ts_disk_head(ts, &seq);
+    off = ts->ts_woff;
+
+    if(head == -1) {
+      if(off + len > timeshift_disk_max)
+	off = 0;
+      break;
+    }
+
+    if(head < off) {
+      if(off + len <= timeshift_disk_max)
+	break;
+      if(len <= head) {
+	off = 0;
+	break;
+      }
+    } else if(off + len <= head) {
+      break;
+    }
+
+    while(ts->ts_first <= seq) {
+      ts_expire_one(ts);
+      ts->ts_dropped++;
+    }
+  }
+
+  ts->ts_woff = off + len;
+  return off;
+}
+
+
+/**
+ * Move the oldest packet still in memory to disk
+ *
+ * Called with ts_mutex held, which is dropped during I/O.
+ * Returns 1 if something was done
+ */
+static int
+ts_spill(timeshift_t *ts)
+{
+  timeshift_entry_t *te;
+  timeshift_record_t tr;
+  th_pkt_t *pkt;
+  struct iovec iov[3];
+  uint64_t seq;
+  size_t len;
+  ssize_t r;
+  off_t off;
+  int n = 0;
+
+  if(ts->ts_fd == -1 || ts->ts_ram <= timeshift_ram_max)
+    return 0;
+
+  while(ts->ts_spilled < ts->ts_last &&
+	ts_entry(ts, ts->ts_spilled)->te_pkt == NULL)
+    ts->ts_spilled++;
+
+  if(ts->ts_spilled == ts->ts_last)
+    return 0;
+
+  seq = ts->ts_spilled;
+  te = ts_entry(ts, seq);
+  pkt = te->te_pkt;
+  len = sizeof(timeshift_record_t) + te->te_size;
+
+  if(len > timeshift_disk_max) {
+    ts->ts_spilled++;
+    return 1;
+  }
+
+  pkt_ref_inc(pkt);
+  off = ts_disk_reserve(ts, len);
+
+  memset(&tr, 0, sizeof(tr));
+  tr.tr_dts            = pkt->pkt_dts;
+  tr.tr_pts            = pkt->pkt_pts;
+  tr.tr_duration       = pkt->pkt_duration;
+  tr.tr_size           = len - sizeof(timeshift_record_t);
+  tr.tr_commercial     = pkt->pkt_commercial;
+  tr.tr_componentindex = pkt->pkt_componentindex;
+  tr.tr_frametype      = pkt->pkt_frametype;
+  tr.tr_field          = pkt->pkt_field;
+  tr.tr_channels       = pkt->pkt_channels;
+  tr.tr_sri            = pkt->pkt_sri;
+  tr.tr_aspect_num     = pkt->pkt_aspect_num;
+  tr.tr_aspect_den     = pkt->pkt_aspect_den;
+
+  iov[n].iov_base = &tr;
+  iov[n].iov_len  = sizeof(tr);
+  n++;
+  if(pkt->pkt_header != NULL) {
+    iov[n].iov_base = pktbuf_ptr(pkt->pkt_header);
+    iov[n].iov_len  = pktbuf_len(pkt->pkt_header);
+    n++;
+  }
+  iov[n].iov_base = pktbuf_ptr(pkt->pkt_payload);
+  iov[n].iov_len  = pktbuf_len(pkt->pkt_payload);
+  n++;
+
+  pthread_mutex_unlock(&ts->ts_mutex);
+  r = pwritev(ts->ts_fd, iov, n, off);
+  pthread_mutex_lock(&ts->ts_mutex);
+
+  if(r != len) {
+    tvhlog(LOG_ERR, "timeshift",
+	   "\"%s\": Unable to write to disk -- %s, "
+	   "continuing in memory only",
+	   ts->ts_channel, r < 0 ? strerror(errno) : "short write");
+    close(ts->ts_fd);
+    ts->ts_fd = -1;
+    pkt_ref_dec(pkt);
+    return 1;
+  }
+
+  ts->ts_written += len;
+
+  /* The entry may have expired (or the ring reallocated) meanwhile */
+  if(seq >= ts->ts_first && ts_entry(ts, seq)->te_pkt == pkt) {
+    te = ts_entry(ts, seq);
+    te->te_off   = off;
+    te->te_dsize = len;
+    te->te_pkt   = NULL;
+    ts->ts_ram  -= te->te_size;
+    pkt_ref_dec(pkt);
+  }
+  if(ts->ts_spilled <= seq)
+    ts->ts_spilled = seq + 1;
+
+  pkt_ref_dec(pkt);
+  return 1;
+}
+
+
+/**
+ * Read a packet back from disk
+ */
+static th_pkt_t *
+ts_read_pkt(int fd, off_t off, size_t len)
+{
+  timeshift_record_t tr;
+  struct iovec iov[2];
+  th_pkt_t *pkt;
+  uint8_t *data;
+
+  if(len < sizeof(tr))
+    return NULL;
+
+  data = malloc(len - sizeof(tr));
+  iov[0].iov_base = &tr;
+  iov[0].iov_len  = sizeof(tr);
+  iov[1].iov_base = data;
+  iov[1].iov_len  = len - sizeof(tr);
+
+  if(preadv(fd, iov, 2, off) != len || tr.tr_size != len - sizeof(tr)) {
+    free(data);
+    return NULL;
+  }
+
+  pkt = pkt_alloc(NULL, 0, tr.tr_pts, tr.tr_dts);
+  pkt->pkt_payload        = pktbuf_make(data, tr.tr_size);
+  pkt->pkt_duration       = tr.tr_duration;
+  pkt->pkt_commercial     = tr.tr_commercial;
+  pkt->pkt_componentindex = tr.tr_componentindex;
+  pkt->pkt_frametype      = tr.tr_frametype;
+  pkt->pkt_field          = tr.tr_field;
+  pkt->pkt_channels       = tr.tr_channels;
+  pkt->pkt_sri            = tr.tr_sri;
+  pkt->pkt_aspect_num     = tr.tr_aspect_num;
+  pkt->pkt_aspect_den     = tr.tr_aspect_den;
+  return pkt;
+}
+
+
+/**
+ * Move a reader to the entry at 'seq' and tell its output about it
+ */
+static void
+tsr_jump(timeshift_t *ts, timeshift_reader_t *tsr, uint64_t seq,
+	 streaming_start_t *ss, int64_t now)
+{
+  int64_t when, shift;
+
+  tsr->tsr_gen++;
+
+  if(seq >= ts->ts_last) {
+    tsr->tsr_pos = ts->ts_last;
+    tsr->tsr_ptime = now;
+    tsr->tsr_live = !tsr->tsr_paused;
+    shift = 0;
+    ss = ts->ts_start;
+  } else {
+    when = ts_entry(ts, seq)->te_time;
+    tsr->tsr_pos = seq;
+    tsr->tsr_ptime = when;
+    tsr->tsr_delta = now - when;
+    tsr->tsr_live = 0;
+    shift = now - when;
+  }
+
+  streaming_target_deliver(tsr->tsr_output,
+			   streaming_msg_create_code(SMT_SKIP, shift / 1000));
+  tsr_deliver_start(tsr, ss);
+}
+
+
+/**
+ * Deliver due entries to the readers that are behind live
+ *
+ * Called with ts_mutex held, which is dropped while reading from disk.
+ * Returns the time until the next entry is due, 0 to be called again
+ * right away or -1 if there is nothing to wait for
+ */
+static int64_t
+ts_play(timeshift_t *ts, int64_t now)
+{
+  timeshift_reader_t *tsr;
+  timeshift_entry_t *te;
+  th_pkt_t *pkt;
+  int64_t next = -1, due, kf;
+  uint64_t seq;
+  uint32_t len;
+  off_t off;
+  int id, gen;
+
+  LIST_FOREACH(tsr, &ts->ts_readers, tsr_link) {
+    if(tsr->tsr_live || tsr->tsr_paused)
+      continue;
+
+    if(tsr->tsr_pos < ts->ts_first) {
+      /* Fell off the end of the buffer */
+      kf = ts_find_kf(ts, 0);
+      tsr_jump(ts, tsr, kf == -1 ? ts->ts_first : ts_kf(ts, kf)->kf_seq,
+	       kf == -1 ? NULL : ts_kf(ts, kf)->kf_ss, now);
+      if(tsr->tsr_live)
+	continue;
+    }
+
+    while(1) {
+      if(tsr->tsr_pos >= ts->ts_last) {
+	tsr->tsr_live = 1;
+	break;
+      }
+
+      te = ts_entry(ts, tsr->tsr_pos);
+      due = te->te_time + tsr->tsr_delta;
+      if(due > now) {
+	if(next == -1 || due - now < next)
+	  next = due - now;
+	break;
+      }
+
+      if(te->te_ss != NULL) {
+	tsr_deliver_start(tsr, te->te_ss);
+      } else if(te->te_stop) {
+	tsr_deliver_stop(tsr, te->te_code);
+      } else if(te->te_pkt != NULL) {
+	streaming_target_deliver(tsr->tsr_output,
+				 streaming_msg_create_pkt(te->te_pkt));
+      } else if(te->te_off != -1 && ts->ts_fd != -1) {
+	seq = tsr->tsr_pos;
+	off = te->te_off;
+	len = te->te_dsize;
+	id  = tsr->tsr_id;
+	gen = tsr->tsr_gen;
+
+	pthread_mutex_unlock(&ts->ts_mutex);
+	pkt = ts_read_pkt(ts->ts_fd, off, len);
+	pthread_mutex_lock(&ts->ts_mutex);
+
+	/* Only deliver if the reader did not move meanwhile */
+	LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+	  if(tsr->tsr_id == id)
+	    break;
+
+	if(tsr == NULL || tsr->tsr_gen != gen || tsr->tsr_pos != seq ||
+	   seq < ts->ts_first) {
+	  if(pkt != NULL)
+	    pkt_ref_dec(pkt);
+	  return 0;
+	}
+
+	if(pkt == NULL) {
+	  tvhlog(LOG_ERR, "timeshift",
+		 "\"%s\": Unable to read from disk", ts->ts_channel);
+	} else {
+	  ts->ts_read += len;
+	  streaming_target_deliver(tsr->tsr_output,
+				   streaming_msg_create_pkt(pkt));
+	  pkt_ref_dec(pkt);
+	}
+	tsr->tsr_pos++;
+	return 0;
+      }
+      tsr->tsr_pos++;
+    }
+  }
+  return next;
+}
+
+
+/**
+ *
+ */
+static void *
+timeshift_thread(void *aux)
+{
+  timeshift_t *ts = aux;
+  struct timeval tv;
+  struct timespec tp;
+  int64_t next, wake;
+
+  pthread_mutex_lock(&ts->ts_mutex);
+
+  while(ts->ts_running) {
+
+    ts_expire(ts, getmonoclock());
+
+    if(ts_spill(ts))
+      continue;
+
+    next = ts_play(ts, getmonoclock());
+    if(next == 0)
+      continue;
+
+    if(next == -1) {
+      pthread_cond_wait(&ts->ts_cond, &ts->ts_mutex);
+    } else {
+      gettimeofday(&tv, NULL);
+      wake = tv.tv_sec * 1000000LL + tv.tv_usec + next;
+      tp.tv_sec  =  wake / 1000000;
+      tp.tv_nsec = (wake % 1000000) * 1000;
+      pthread_cond_timedwait(&ts->ts_cond, &ts->ts_mutex, &tp);
+    }
+  }
+
+  pthread_mutex_unlock(&ts->ts_mutex);
+  return NULL;
+}
+
+
+/**
+ * Open the backing file. It is unlinked right away and only lives as
+ * long as the descriptor
+ */
+static int
+ts_open_disk(timeshift_t *ts)
+{
+  char path[512];
+  int fd, r;
+
+  if(timeshift_disk_max == 0)
+    return -1;
+
+  snprintf(path, sizeof(path), "%s/%d-XXXXXX", timeshift_path, ts->ts_chid);
+
+  if((fd = mkstemp(path)) == -1) {
+    tvhlog(LOG_ERR, "timeshift",
+	   "\"%s\": Unable to create \"%s\" -- %s, using memory only",
+	   ts->ts_channel, path, strerror(errno));
+    return -1;
+  }
+  unlink(path);
+
+  if((r = posix_fallocate(fd, 0, timeshift_disk_max)) != 0) {
+    tvhlog(LOG_ERR, "timeshift",
+	   "\"%s\": Unable to allocate %"PRId64" MB on disk -- %s, "
+	   "using memory only",
+	   ts->ts_channel, (int64_t)timeshift_disk_max >> 20, strerror(r));
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+
+/**
+ *
+ */
+static timeshift_t *
+timeshift_create(channel_t *ch, unsigned int weight, const char *name)
+{
+  timeshift_t *ts = calloc(1, sizeof(timeshift_t));
+
+  ts->ts_chid = ch->ch_id;
+  ts->ts_channel = strdup(ch->ch_name);
+
+  pthread_mutex_init(&ts->ts_mutex, NULL);
+  pthread_cond_init(&ts->ts_cond, NULL);
+
+  ts->ts_size = 1024;
+  ts->ts_entries = calloc(ts->ts_size, sizeof(timeshift_entry_t));
+  ts->ts_kf_size = 64;
+  ts->ts_kfs = calloc(ts->ts_kf_size, sizeof(timeshift_kf_t));
+  ts->ts_fd = ts_open_disk(ts);
+
+  ts->ts_running = 1;
+  pthread_create(&ts->ts_tid, NULL, timeshift_thread, ts);
+
+  LIST_INSERT_HEAD(&timeshifts, ts, ts_link);
+
+  streaming_target_init(&ts->ts_input, timeshift_input, ts, 0);
+  ts->ts_s = subscription_create_from_channel(ch, weight, name,
+					      &ts->ts_input, 0);
+
+  tvhlog(LOG_INFO, "timeshift", "\"%s\": Buffer created%s",
+	 ts->ts_channel, ts->ts_fd == -1 ? " (memory only)" : "");
+  return ts;
+}
+
+
+/**
+ *
+ */
+static void
+timeshift_destroy(timeshift_t *ts)
+{
+  LIST_REMOVE(ts, ts_link);
+
+  if(ts->ts_s != NULL)
+    subscription_unsubscribe(ts->ts_s);
+
+  pthread_mutex_lock(&ts->ts_mutex);
+  ts->ts_running = 0;
+  pthread_cond_signal(&ts->ts_cond);
+  pthread_mutex_unlock(&ts->ts_mutex);
+  pthread_join(ts->ts_tid, NULL);
+
+  while(ts->ts_first < ts->ts_last)
+    ts_expire_one(ts);
+  if(ts->ts_start != NULL)
+    streaming_start_unref(ts->ts_start);
+  if(ts->ts_fd != -1)
+    close(ts->ts_fd);
+
+  tvhlog(LOG_INFO, "timeshift", "\"%s\": Buffer destroyed", ts->ts_channel);
+
+  pthread_mutex_destroy(&ts->ts_mutex);
+  pthread_cond_destroy(&ts->ts_cond);
+  free(ts->ts_entries);
+  free(ts->ts_kfs);
+  free(ts->ts_channel);
+  free(ts);
+}
+
+
+/**
+ *
+ */
+timeshift_reader_t *
+timeshift_reader_create(channel_t *ch, unsigned int weight,
+			const char *name, streaming_target_t *output)
+{
+  timeshift_t *ts;
+  timeshift_reader_t *tsr;
+
+  lock_assert(&global_lock);
+
+  LIST_FOREACH(ts, &timeshifts, ts_link)
+    if(ts->ts_chid == ch->ch_id)
+      break;
+
+  if(ts == NULL)
+    ts = timeshift_create(ch, weight, name);
+
+  tsr = calloc(1, sizeof(timeshift_reader_t));
+  tsr->tsr_ts = ts;
+  tsr->tsr_output = output;
+  tsr->tsr_id = ++timeshift_reader_tally;
+  tsr->tsr_live = 1;
+
+  pthread_mutex_lock(&ts->ts_mutex);
+  LIST_INSERT_HEAD(&ts->ts_readers, tsr, tsr_link);
+  ts->ts_nreaders++;
+  tsr->tsr_pos = ts->ts_last;
+  tsr_deliver_start(tsr, ts->ts_start);
+  pthread_mutex_unlock(&ts->ts_mutex);
+  return tsr;
+}
+
+
+/**
+ *
+ */
+void
+timeshift_reader_destroy(timeshift_reader_t *tsr)
+{
+  timeshift_t *ts = tsr->tsr_ts;
+
+  lock_assert(&global_lock);
+
+  pthread_mutex_lock(&ts->ts_mutex);
+  LIST_REMOVE(tsr, tsr_link);
+  ts->ts_nreaders--;
+  if(tsr->tsr_ss != NULL)
+    streaming_start_unref(tsr->tsr_ss);
+  pthread_mutex_unlock(&ts->ts_mutex);
+  free(tsr);
+
+  if(ts->ts_nreaders == 0)
+    timeshift_destroy(ts);
+}
+
+
+/**
+ *
+ */
+void
+timeshift_pause(timeshift_reader_t *tsr)
+{
+  timeshift_t *ts = tsr->tsr_ts;
+  int64_t now = getmonoclock();
+
+  pthread_mutex_lock(&ts->ts_mutex);
+  if(!tsr->tsr_paused) {
+    tsr->tsr_ptime = tsr_position(tsr, now);
+    if(tsr->tsr_live) {
+      tsr->tsr_pos = ts->ts_last;
+      tsr->tsr_live = 0;
+    }
+    tsr->tsr_paused = 1;
+  }
+  pthread_mutex_unlock(&ts->ts_mutex);
+}
+
+
+/**
+ *
+ */
+void
+timeshift_resume(timeshift_reader_t *tsr)
+{
+  timeshift_t *ts = tsr->tsr_ts;
+
+  pthread_mutex_lock(&ts->ts_mutex);
+  if(tsr->tsr_paused) {
+    tsr->tsr_delta = getmonoclock() - tsr->tsr_ptime;
+    tsr->tsr_paused = 0;
+    pthread_cond_signal(&ts->ts_cond);
+  }
+  pthread_mutex_unlock(&ts->ts_mutex);
+}
+
+
+/**
+ * Move playback by 'offset' usec, continuing from the closest
+ * preceding keyframe. Returns how far behind live playback is
+ */
+int64_t
+timeshift_seek(timeshift_reader_t *tsr, int64_t offset)
+{
+  timeshift_t *ts = tsr->tsr_ts;
+  int64_t now = getmonoclock(), target, kf, shift;
+
+  pthread_mutex_lock(&ts->ts_mutex);
+
+  target = tsr_position(tsr, now) + offset;
+  kf = ts_find_kf(ts, target);
+
+  if(target >= now || ts->ts_first == ts->ts_last)
+    tsr_jump(ts, tsr, ts->ts_last, NULL, now);
+  else if(kf == -1)
+    tsr_jump(ts, tsr, ts->ts_first, NULL, now);
+  else
+    tsr_jump(ts, tsr, ts_kf(ts, kf)->kf_seq, ts_kf(ts, kf)->kf_ss, now);
+
+  shift = now - tsr_position(tsr, now);
+  pthread_cond_signal(&ts->ts_cond);
+  pthread_mutex_unlock(&ts->ts_mutex);
+  return shift;
+}
+
+
+/**
+ *
+ */
+void
+timeshift_dump(htsbuf_queue_t *hq)
+{
+  timeshift_t *ts;
+  timeshift_reader_t *tsr;
+  int64_t now = getmonoclock();
+
+  htsbuf_qprintf(hq, "Path: %s, RAM: %zu MB, Disk: %"PRId64" MB, "
+		 "Period: %"PRId64" s\n",
+		 timeshift_path, timeshift_ram_max >> 20,
+		 (int64_t)timeshift_disk_max >> 20, timeshift_period / 1000000);
+
+  lock_assert(&global_lock);
+
+  LIST_FOREACH(ts, &timeshifts, ts_link) {
+    pthread_mutex_lock(&ts->ts_mutex);
+    htsbuf_qprintf(hq, "  \"%s\": %"PRIu64" entries, %"PRIu64" keyframes, "
+		   "%"PRId64" s buffered, %zu kB in RAM, disk %s\n",
+		   ts->ts_channel, ts->ts_last - ts->ts_first,
+		   ts->ts_kf_last - ts->ts_kf_first,
+		   ts->ts_first == ts->ts_last ? 0 :
+		   (now - ts_entry(ts, ts->ts_first)->te_time) / 1000000,
+		   ts->ts_ram >> 10, ts->ts_fd == -1 ? "off" : "on");
+    htsbuf_qprintf(hq, "    %"PRIu64" packets, %"PRIu64" kB written, "
+		   "%"PRIu64" kB read, %"PRIu64" dropped\n",
+		   ts->ts_packets, ts->ts_written >> 10, ts->ts_read >> 10,
+		   ts->ts_dropped);
+    LIST_FOREACH(tsr, &ts->ts_readers, tsr_link)
+      htsbuf_qprintf(hq, "    Reader %d: %s, %"PRId64" ms behind live\n",
+		     tsr->tsr_id,
+		     tsr->tsr_paused ? "paused" : tsr->tsr_live ? "live" :
+		     "shifted", (now - tsr_position(tsr, now)) / 1000);
+    pthread_mutex_unlock(&ts->ts_mutex);
+  }
+}
+
+
+/**
+ *
+ */
+void
+timeshift_init(void)
+{
+  htsmsg_t *m = hts_settings_load("timeshift");
+  const char *path = NULL;
+  uint32_t u32;
+  char buf[512];
+
+  timeshift_ram_max  = (size_t)TIMESHIFT_RAM_DEFAULT << 20;
+  timeshift_disk_max = (off_t)TIMESHIFT_DISK_DEFAULT << 20;
+  timeshift_period   = TIMESHIFT_PERIOD_DEFAULT * 1000000LL;
+
+  if(m != NULL) {
+    path = htsmsg_get_str(m, "path");
+    if(!htsmsg_get_u32(m, "ram", &u32))
+      timeshift_ram_max = (size_t)u32 << 20;
+    if(!htsmsg_get_u32(m, "disk", &u32))
+      timeshift_disk_max = (off_t)u32 << 20;
+    if(!htsmsg_get_u32(m, "period", &u32) && u32 > 0)
+      timeshift_period = u32 * 1000000LL;
+  }
+
+  if(path == NULL) {
+    snprintf(buf, sizeof(buf), "%s/timeshift",
+	     hts_settings_get_root() ?: "/tmp");
+    path = buf;
+  }
+  timeshift_path = strdup(path);
+  mkdir(timeshift_path, 0700);
+
+  htsmsg_destroy(m);
+}
@@ -0,0 +1,60 @@
+/*
+ *  tvheadend, timeshift buffer
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMESHIFT_H_
+#define TIMESHIFT_H_
+
+#include "htsbuf.h"
+#include "streaming.h"
+
+struct channel;
+
+/**
+ * Timeshift buffer
+ *
+ * There is one buffer per channel, shared by all its readers. It holds
+ * the packets received during the last period, the newest in memory
+ * and older ones in a preallocated disk file, with an index of the
+ * video I-frames.
+ *
+ * A reader either follows live or plays out from an earlier position
+ * at the rate the packets were received. Position changes reach the
+ * reader's output as SMT_SKIP.
+ *
+ * All functions are called with global_lock held
+ */
+typedef struct timeshift_reader timeshift_reader_t;
+
+void timeshift_init(void);
+
+timeshift_reader_t *timeshift_reader_create(struct channel *ch,
+					    unsigned int weight,
+					    const char *name,
+					    streaming_target_t *output);
+
+void timeshift_reader_destroy(timeshift_reader_t *tsr);
+
+void timeshift_pause(timeshift_reader_t *tsr);
+
+void timeshift_resume(timeshift_reader_t *tsr);
+
+int64_t timeshift_seek(timeshift_reader_t *tsr, int64_t offset);
+
+void timeshift_dump(htsbuf_queue_t *hq);
+
+#endif /* TIMESHIFT_H_ */
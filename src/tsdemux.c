@@ -39,6 +39,9 @@
 #include "tsdemux.h"
 #include "parsers.h"
 #include "streaming.h"
+#include "atomic.h"
+
+#define TSBUF_POOL_MAX 256 /* Free buffers kept per pool */
 
 static void ts_remux(service_t *t, const uint8_t *tsb);
 
@@ -179,7 +182,7 @@ ts_extract_pcr(service_t *t, elementary_stream_t *st, const uint8_t *tsb,
  * Process service stream packets, extract PCR and optionally descramble
  */
 void
-ts_recv_packet1(service_t *t, const uint8_t *tsb, int64_t *pcrp)
+ts_recv_packet1(service_t *t, const uint8_t *tsb, int64_t *pcrp, tsbuf_t *tb)
 {
   elementary_stream_t *st;
   int pid, n, m, r;
@@ -234,7 +237,7 @@ ts_recv_packet1(service_t *t, const uint8_t *tsb, int64_t *pcrp)
     LIST_FOREACH(td, &t->s_descramblers, td_service_link) {
       n++;
       
-      r = td->td_descramble(td, t, st, tsb);
+      r = td->td_descramble(td, t, st, tsb, tb);
       if(r == 0) {
 	pthread_mutex_unlock(&t->s_stream_mutex);
 	return;
@@ -259,6 +262,26 @@ ts_recv_packet1(service_t *t, const uint8_t *tsb, int64_t *pcrp)
 }
 
 
+/**
+ * Called by inputs once all packets of a read have been passed to
+ * ts_recv_packet1(), lets descramblers act on what they have buffered
+ */
+void
+ts_recv_flush(service_t *t)
+{
+  th_descrambler_t *td;
+
+  if(t->s_status != SERVICE_RUNNING)
+    return;
+
+  pthread_mutex_lock(&t->s_stream_mutex);
+  LIST_FOREACH(td, &t->s_descramblers, td_service_link)
+    if(td->td_flush != NULL)
+      td->td_flush(td);
+  pthread_mutex_unlock(&t->s_stream_mutex);
+}
+
+
 /*
  * Process transport stream packets, simple version
  */
@@ -287,3 +310,122 @@ ts_remux(service_t *t, const uint8_t *src)
   sm.sm_data = tsb;
   streaming_pad_deliver(&t->s_streaming_pad, &sm);
 }
+
+
+/**
+ *
+ */
+tsbuf_t *
+tsbuf_alloc(int npkts)
+{
+  tsbuf_t *tb = malloc(sizeof(tsbuf_t) + npkts * (188 + 1));
+
+  tb->tb_refcount = 1;
+  tb->tb_npkts = npkts;
+  tb->tb_data = (uint8_t *)(tb + 1);
+  tb->tb_claimed = tb->tb_data + npkts * 188;
+  tb->tb_pool = NULL;
+  memset(tb->tb_claimed, 0, npkts);
+  return tb;
+}
+
+
+/**
+ *
+ */
+void
+tsbuf_pool_init(tsbuf_pool_t *tbp, int npkts)
+{
+  pthread_mutex_init(&tbp->tbp_mutex, NULL);
+  tbp->tbp_free = NULL;
+  tbp->tbp_nfree = 0;
+  tbp->tbp_npkts = npkts;
+}
+
+
+/**
+ * Returns a buffer with one reference and nothing claimed
+ */
+tsbuf_t *
+tsbuf_pool_get(tsbuf_pool_t *tbp)
+{
+  tsbuf_t *tb;
+
+  pthread_mutex_lock(&tbp->tbp_mutex);
+  if((tb = tbp->tbp_free) != NULL) {
+    tbp->tbp_free = tb->tb_next;
+    tbp->tbp_nfree--;
+  }
+  pthread_mutex_unlock(&tbp->tbp_mutex);
+
+  if(tb == NULL) {
+    tb = tsbuf_alloc(tbp->tbp_npkts);
+    tb->tb_pool = tbp;
+  } else {
+    tb->tb_refcount = 1;
+    memset(tb->tb_claimed, 0, tb->tb_npkts);
+  }
+  return tb;
+}
+
+
+/**
+ *
+ */
+static void
+tsbuf_pool_put(tsbuf_pool_t *tbp, tsbuf_t *tb)
+{
+  pthread_mutex_lock(&tbp->tbp_mutex);
+  if(tbp->tbp_nfree < TSBUF_POOL_MAX) {
+    tb->tb_next = tbp->tbp_free;
+    tbp->tbp_free = tb;
+    tbp->tbp_nfree++;
+    tb = NULL;
+  }
+  pthread_mutex_unlock(&tbp->tbp_mutex);
+  free(tb);
+}
+
+
+/**
+ *
+ */
+void
+tsbuf_ref_inc(tsbuf_t *tb)
+{
+  atomic_add(&tb->tb_refcount, 1);
+}
+
+
+/**
+ *
+ */
+void
+tsbuf_ref_dec(tsbuf_t *tb)
+{
+  if((atomic_add(&tb->tb_refcount, -1)) != 1)
+    return;
+
+  if(tb->tb_pool != NULL)
+    tsbuf_pool_put(tb->tb_pool, tb);
+  else
+    free(tb);
+}
+
+
+/**
+ * Claim the packet at 'tsb' for in place processing.
+ * Returns 0 if it has already been claimed by someone else.
+ *
+ * Must be called from the thread delivering the buffer
+ */
+int
+tsbuf_claim(tsbuf_t *tb, const uint8_t *tsb)
+{
+  int i = (tsb - tb->tb_data) / 188;
+
+  if(tb->tb_claimed[i])
+    return 0;
+  tb->tb_claimed[i] = 1;
+  return 1;
+}
@@ -19,8 +19,55 @@
 #ifndef TSDEMUX_H
 #define TSDEMUX_H
 
-void ts_recv_packet1(struct service *t, const uint8_t *tsb, int64_t *pcrp);
+#include <pthread.h>
+
+/**
+ * Transport packets as read from an input, shared by all services
+ * on the mux.
+ *
+ * Descramblers may keep a reference and decrypt packets in place
+ * instead of copying them. A packet can only be claimed by one
+ * descrambler, anyone else must take a copy. The input must not
+ * reuse the buffer while someone else holds a reference.
+ */
+typedef struct tsbuf {
+  int tb_refcount;
+  int tb_npkts;
+  uint8_t *tb_claimed;   /* One flag per packet */
+  uint8_t *tb_data;
+  struct tsbuf_pool *tb_pool;
+  struct tsbuf *tb_next;  /* Link in tbp_free */
+} tsbuf_t;
+
+/**
+ * Buffers go back to their pool once the last reference is dropped,
+ * so an input does not allocate a new one for every read while
+ * descramblers hold on to earlier ones.
+ */
+typedef struct tsbuf_pool {
+  pthread_mutex_t tbp_mutex;
+  tsbuf_t *tbp_free;
+  int tbp_nfree;
+  int tbp_npkts;
+} tsbuf_pool_t;
+
+tsbuf_t *tsbuf_alloc(int npkts);
+
+void tsbuf_pool_init(tsbuf_pool_t *tbp, int npkts);
+
+tsbuf_t *tsbuf_pool_get(tsbuf_pool_t *tbp);
+
+void tsbuf_ref_inc(tsbuf_t *tb);
+
+void tsbuf_ref_dec(tsbuf_t *tb);
+
+int tsbuf_claim(tsbuf_t *tb, const uint8_t *tsb);
+
+void ts_recv_packet1(struct service *t, const uint8_t *tsb, int64_t *pcrp,
+		     tsbuf_t *tb);
 
 void ts_recv_packet2(struct service *t, const uint8_t *tsb);
 
+void ts_recv_flush(struct service *t);
+
 #endif /* TSDEMUX_H */
@@ -0,0 +1,298 @@
+/*
+ *  tvheadend, raw transport stream output
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+#include "tvheadend.h"
+#include "streaming.h"
+#include "psi.h"
+#include "tspass.h"
+
+#define TSPASS_BATCH    256      /* Packets per writev() */
+#define TSPASS_TABLES   100000   /* PAT/PMT interval (usec) */
+#define TSPASS_PMT_MAX  1024
+#define TSPASS_TABLE_PKTS (1 + (TSPASS_PMT_MAX + 1 + 183) / 184)
+
+/**
+ *
+ */
+struct tspass {
+  int tp_fd;
+  int tp_error;
+  tspass_output_t *tp_output;
+  void *tp_opaque;
+
+  uint8_t tp_pids[8192 / 8];    /* Passed PIDs */
+  int tp_pmt_pid;
+  int tp_pmt_version;
+  int tp_pat_cc;
+  int tp_pmt_cc;
+  int tp_pmt_len;
+  uint8_t tp_pmt[TSPASS_PMT_MAX]; /* PMT section, 0 length until started */
+  int64_t tp_tables_sent;
+
+  uint8_t tp_tables[TSPASS_TABLE_PKTS][188]; /* PAT and PMT of this batch */
+
+  int tp_n;
+  struct iovec tp_iov[TSPASS_BATCH];
+  streaming_message_t *tp_msgs[TSPASS_BATCH];
+  int tp_nmsgs;
+};
+
+
+/**
+ *
+ */
+tspass_t *
+tspass_create(int fd)
+{
+  tspass_t *tp = calloc(1, sizeof(tspass_t));
+  tp->tp_fd = fd;
+  return tp;
+}
+
+
+/**
+ *
+ */
+tspass_t *
+tspass_create_output(tspass_output_t *output, void *opaque)
+{
+  tspass_t *tp = tspass_create(-1);
+  tp->tp_output = output;
+  tp->tp_opaque = opaque;
+  return tp;
+}
+
+
+/**
+ *
+ */
+static inline int
+tspass_pid_isset(tspass_t *tp, int pid)
+{
+  return tp->tp_pids[pid >> 3] & (1 << (pid & 7));
+}
+
+static inline void
+tspass_pid_set(tspass_t *tp, int pid)
+{
+  tp->tp_pids[pid >> 3] |= 1 << (pid & 7);
+}
+
+
+/**
+ * New stream start, rebuild the PID filter and the PMT
+ */
+void
+tspass_start(tspass_t *tp, const streaming_start_t *ss)
+{
+  uint32_t crc;
+  int i, pid;
+
+  memset(tp->tp_pids, 0, sizeof(tp->tp_pids));
+
+  /* The source PMT and CA streams are not described by our PMT */
+  for(i = 0; i < ss->ss_num_components; i++)
+    if(ss->ss_components[i].ssc_type != SCT_PMT &&
+       ss->ss_components[i].ssc_type != SCT_CA)
+      tspass_pid_set(tp, ss->ss_components[i].ssc_pid);
+  if(ss->ss_pcr_pid)
+    tspass_pid_set(tp, ss->ss_pcr_pid);
+
+  for(pid = 0xfff; pid > 0x20; pid--)
+    if(!tspass_pid_isset(tp, pid))
+      break;
+  tp->tp_pmt_pid = pid;
+
+  tp->tp_pmt_len = psi_build_pmt((streaming_start_t *)ss, tp->tp_pmt,
+				 sizeof(tp->tp_pmt), ss->ss_pcr_pid ?: 0x1fff);
+  if(tp->tp_pmt_len < 0) {
+    tp->tp_pmt_len = 0;
+    return;
+  }
+
+  /* Let clients see that the program changed */
+  tp->tp_pmt_version = (tp->tp_pmt_version + 1) & 0x1f;
+  tp->tp_pmt[5] = 0xc1 | (tp->tp_pmt_version << 1);
+  crc = crc32(tp->tp_pmt, tp->tp_pmt_len - 4, 0xffffffff);
+  tp->tp_pmt[tp->tp_pmt_len - 4] = crc >> 24;
+  tp->tp_pmt[tp->tp_pmt_len - 3] = crc >> 16;
+  tp->tp_pmt[tp->tp_pmt_len - 2] = crc >> 8;
+  tp->tp_pmt[tp->tp_pmt_len - 1] = crc;
+  tp->tp_tables_sent = 0;
+}
+
+
+/**
+ *
+ */
+void
+tspass_sync(tspass_t *tp)
+{
+  tp->tp_tables_sent = 0;
+}
+
+
+/**
+ * Split a section into transport stream packets, the rest of the last
+ * packet is stuffed. Returns the number of packets
+ */
+static int
+tspass_build_table(uint8_t *tsb, const uint8_t *table, int tlen, int *cc,
+		   int pid)
+{
+  int n = 0, l, first = 1;
+  uint8_t *p;
+
+  while(first || tlen > 0) {
+    tsb[0] = 0x47;
+    tsb[1] = (first ? 0x40 : 0) | (pid >> 8);
+    tsb[2] = pid;
+    tsb[3] = 0x10 | ((*cc)++ & 0xf);
+    p = tsb + 4;
+    if(first)
+      *p++ = 0; /* Pointer field for tables */
+
+    l = MIN(tlen, tsb + 188 - p);
+    memcpy(p, table, l);
+    memset(p + l, 0xff, tsb + 188 - p - l);
+
+    table += l;
+    tlen  -= l;
+    tsb   += 188;
+    first = 0;
+    n++;
+  }
+  return n;
+}
+
+
+/**
+ *
+ */
+static void
+tspass_add_tables(tspass_t *tp)
+{
+  uint8_t pat[188];
+  int i, n, l;
+
+  l = psi_build_pat(NULL, pat, sizeof(pat), tp->tp_pmt_pid);
+  n  = tspass_build_table(tp->tp_tables[0], pat, l, &tp->tp_pat_cc, 0);
+  n += tspass_build_table(tp->tp_tables[n], tp->tp_pmt, tp->tp_pmt_len,
+			  &tp->tp_pmt_cc, tp->tp_pmt_pid);
+
+  for(i = 0; i < n; i++) {
+    tp->tp_iov[tp->tp_n].iov_base = tp->tp_tables[i];
+    tp->tp_iov[tp->tp_n++].iov_len = 188;
+  }
+}
+
+
+/**
+ * Write the current batch
+ */
+int
+tspass_flush(tspass_t *tp)
+{
+  struct iovec *iov = tp->tp_iov;
+  int n = tp->tp_n;
+  ssize_t r;
+
+  if(tp->tp_output != NULL && n > 0) {
+    tp->tp_output(tp->tp_opaque, iov, n);
+    n = 0;
+  }
+
+  while(n > 0 && !tp->tp_error) {
+    if((r = writev(tp->tp_fd, iov, n)) == -1) {
+      if(errno == EINTR)
+	continue;
+      tp->tp_error = errno;
+      break;
+    }
+
+    while(n > 0 && r >= iov->iov_len) {
+      r -= iov->iov_len;
+      iov++;
+      n--;
+    }
+    if(n > 0) {
+      iov->iov_base += r;
+      iov->iov_len  -= r;
+    }
+  }
+
+  while(tp->tp_nmsgs > 0)
+    streaming_msg_free(tp->tp_msgs[--tp->tp_nmsgs]);
+  tp->tp_n = 0;
+  return tp->tp_error ? -1 : 0;
+}
+
+
+/**
+ * Queue a SMT_MPEGTS message for output, the message is consumed
+ */
+int
+tspass_input(tspass_t *tp, streaming_message_t *sm)
+{
+  const uint8_t *tsb = sm->sm_data;
+  int64_t now;
+
+  if(tp->tp_pmt_len == 0 ||
+     !tspass_pid_isset(tp, (tsb[1] & 0x1f) << 8 | tsb[2])) {
+    streaming_msg_free(sm);
+    return 0;
+  }
+
+  if(tp->tp_n + TSPASS_TABLE_PKTS + 1 > TSPASS_BATCH && tspass_flush(tp))
+    goto err;
+
+  now = getmonoclock();
+  if(now - tp->tp_tables_sent >= TSPASS_TABLES) {
+    /* Tables are kept in place until flushed, one set per batch */
+    if(tp->tp_n > 0 && tspass_flush(tp))
+      goto err;
+    tspass_add_tables(tp);
+    tp->tp_tables_sent = now;
+  }
+
+  tp->tp_iov[tp->tp_n].iov_base = sm->sm_data;
+  tp->tp_iov[tp->tp_n++].iov_len = 188;
+  tp->tp_msgs[tp->tp_nmsgs++] = sm;
+  return 0;
+
+ err:
+  streaming_msg_free(sm);
+  return -1;
+}
+
+
+/**
+ *
+ */
+void
+tspass_destroy(tspass_t *tp)
+{
+  tspass_flush(tp);
+  free(tp);
+}
@@ -0,0 +1,60 @@
+/*
+ *  tvheadend, raw transport stream output
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TSPASS_H__
+#define TSPASS_H__
+
+#include "streaming.h"
+
+struct iovec;
+
+/**
+ * Writes the SMT_MPEGTS packets of a raw subscription as a single
+ * program transport stream. Only the PIDs of the last stream start
+ * are passed, with a PAT and PMT of our own inserted regularly.
+ *
+ * Packets are written as they were received, with one writev() per
+ * batch of queued messages.
+ */
+typedef struct tspass tspass_t;
+
+tspass_t *tspass_create(int fd);
+
+/**
+ * Batches are handed to 'output' instead of being written to a file
+ * descriptor. The buffers are only valid during the call
+ */
+typedef void (tspass_output_t)(void *opaque, const struct iovec *iov,
+			       int iovcnt);
+
+tspass_t *tspass_create_output(tspass_output_t *output, void *opaque);
+
+/**
+ * Make the next passed packet start with a PAT and PMT
+ */
+void tspass_sync(tspass_t *tp);
+
+void tspass_start(tspass_t *tp, const streaming_start_t *ss);
+
+int tspass_input(tspass_t *tp, streaming_message_t *sm);
+
+int tspass_flush(tspass_t *tp);
+
+void tspass_destroy(tspass_t *tp);
+
+#endif // TSPASS_H__
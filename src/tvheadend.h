@@ -253,6 +253,14 @@ typedef enum {
    */
   SMT_MPEGTS,
 
+  /**
+   * Playback position changed (timeshift)
+   *
+   * Messages queued before this one are from the old position.
+   * sm_code is the new distance from live in milliseconds
+   */
+  SMT_SKIP,
+
   /**
    * Internal message to exit receiver
    */
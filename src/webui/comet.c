@@ -22,6 +22,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <arpa/inet.h>
 #include <openssl/sha.h>
 
@@ -34,28 +36,102 @@
 #include "access.h"
 
 static pthread_mutex_t comet_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t comet_cond = PTHREAD_COND_INITIALIZER;
 
 #define MAILBOX_UNUSED_TIMEOUT      20
 #define MAILBOX_EMPTY_REPLY_TIMEOUT 10
+#define MAILBOX_HASH_WIDTH          64
+
+#define COMET_RING_SIZE             1024 /* Notifications kept for pollers */
 
 //#define mbdebug(fmt...) printf(fmt);
 #define mbdebug(fmt...)
 
 
-static LIST_HEAD(, comet_mailbox) mailboxes;
+static LIST_HEAD(, comet_mailbox) mailboxes[MAILBOX_HASH_WIDTH];
+static LIST_HEAD(, comet_mailbox) comet_waiters;
+
+LIST_HEAD(comet_wait_list, comet_wait);
+static int comet_mailbox_count;
 
 int mailbox_tally;
 
 typedef struct comet_mailbox {
   char *cmb_boxid; /* SHA-1 hash */
-  htsmsg_t *cmb_messages; /* A vector */
   time_t cmb_last_used;
   LIST_ENTRY(comet_mailbox) cmb_link;
   int cmb_debug;
+
+  uint64_t cmb_seq;           /* Next notification in the ring to deliver */
+  htsbuf_queue_t cmb_private; /* Serialized messages for this box only */
+  int cmb_private_n;
+
+  struct comet_wait_list cmb_waits; /* Polls parked on this box */
+  LIST_ENTRY(comet_mailbox) cmb_wait_link;
 } comet_mailbox_t;
 
 
+/**
+ * A long poll parked in the HTTP event loop
+ */
+typedef struct comet_wait {
+  http_connection_t *cw_hc;
+  comet_mailbox_t *cw_cmb;
+  time_t cw_start;
+  LIST_ENTRY(comet_wait) cw_link;
+} comet_wait_t;
+
+
+/**
+ * Notifications are serialized once and shared by all mailboxes,
+ * each mailbox just keeps track of how far it has come
+ */
+typedef struct comet_msg {
+  char *cm_json;
+  size_t cm_len;
+  int cm_debug;
+} comet_msg_t;
+
+static comet_msg_t comet_ring[COMET_RING_SIZE];
+static uint64_t comet_seq;  /* Sequence number of the next notification */
+static unsigned int comet_lost;
+
+
+/**
+ *
+ */
+static char *
+comet_serialize(htsmsg_t *m, size_t *lenp)
+{
+  htsbuf_queue_t hq;
+  char *json;
+
+  htsbuf_queue_init(&hq, 0);
+  htsmsg_json_serialize(m, &hq, 0);
+  *lenp = hq.hq_size;
+  json = malloc(hq.hq_size + 1);
+  htsbuf_read(&hq, json, hq.hq_size);
+  json[*lenp] = 0;
+  return json;
+}
+
+
+/**
+ * Queue a message for one mailbox only, the message is consumed
+ */
+static void
+comet_private_add(comet_mailbox_t *cmb, htsmsg_t *m)
+{
+  size_t len;
+  char *json = comet_serialize(m, &len);
+
+  htsmsg_destroy(m);
+  if(cmb->cmb_private_n++)
+    htsbuf_append(&cmb->cmb_private, ",", 1);
+  htsbuf_append(&cmb->cmb_private, json, len);
+  free(json);
+}
+
+
 /**
  *
  */
@@ -64,10 +140,10 @@ cmb_destroy(comet_mailbox_t *cmb)
 {
   mbdebug("mailbox[%s]: destroyed\n", cmb->cmb_boxid);
 
-  if(cmb->cmb_messages != NULL)
-    htsmsg_destroy(cmb->cmb_messages);
+  htsbuf_queue_flush(&cmb->cmb_private);
 
   LIST_REMOVE(cmb, cmb_link);
+  comet_mailbox_count--;
 
   free(cmb->cmb_boxid);
   free(cmb);
@@ -81,19 +157,38 @@ void
 comet_flush(void)
 {
   comet_mailbox_t *cmb, *next;
+  int i;
 
   pthread_mutex_lock(&comet_mutex);
 
-  for(cmb = LIST_FIRST(&mailboxes); cmb != NULL; cmb = next) {
-    next = LIST_NEXT(cmb, cmb_link);
+  for(i = 0; i < MAILBOX_HASH_WIDTH; i++) {
+    for(cmb = LIST_FIRST(&mailboxes[i]); cmb != NULL; cmb = next) {
+      next = LIST_NEXT(cmb, cmb_link);
 
-    if(cmb->cmb_last_used && cmb->cmb_last_used + 60 < dispatch_clock)
-      cmb_destroy(cmb);
+      if(cmb->cmb_last_used && cmb->cmb_last_used + 60 < dispatch_clock)
+	cmb_destroy(cmb);
+    }
   }
   pthread_mutex_unlock(&comet_mutex);
 }
 
 
+/**
+ *
+ */
+static comet_mailbox_t *
+comet_mailbox_find(const char *boxid)
+{
+  comet_mailbox_t *cmb;
+  unsigned int hash = tvh_strhash(boxid, MAILBOX_HASH_WIDTH);
+
+  LIST_FOREACH(cmb, &mailboxes[hash], cmb_link)
+    if(!strcmp(cmb->cmb_boxid, boxid))
+      break;
+  return cmb;
+}
+
+
 /**
  *
  */
@@ -125,7 +220,12 @@ comet_mailbox_create(void)
   time(&cmb->cmb_last_used);
   mailbox_tally++;
 
-  LIST_INSERT_HEAD(&mailboxes, cmb, cmb_link);
+  cmb->cmb_seq = comet_seq;
+  htsbuf_queue_init(&cmb->cmb_private, 0);
+
+  LIST_INSERT_HEAD(&mailboxes[tvh_strhash(id, MAILBOX_HASH_WIDTH)],
+		   cmb, cmb_link);
+  comet_mailbox_count++;
   return cmb;
 }
 
@@ -142,9 +242,7 @@ comet_access_update(http_connection_t *hc, comet_mailbox_t *cmb)
   htsmsg_add_u32(m, "dvr",   !http_access_verify(hc, ACCESS_RECORDER));
   htsmsg_add_u32(m, "admin", !http_access_verify(hc, ACCESS_ADMIN));
 
-  if(cmb->cmb_messages == NULL)
-    cmb->cmb_messages = htsmsg_create_list();
-  htsmsg_add_msg(cmb->cmb_messages, NULL, m);
+  comet_private_add(cmb, m);
 }
 
 /**
@@ -164,9 +262,121 @@ comet_serverIpPort(http_connection_t *hc, comet_mailbox_t *cmb)
   htsmsg_add_str(m, "ip", buf);
   htsmsg_add_u32(m, "port", ntohs(hc->hc_self->sin_port));
 
-  if(cmb->cmb_messages == NULL)
-    cmb->cmb_messages = htsmsg_create_list();
-  htsmsg_add_msg(cmb->cmb_messages, NULL, m);
+  comet_private_add(cmb, m);
+}
+
+
+/**
+ * Move everything the mailbox has not seen yet to 'hq'
+ *
+ * Returns number of messages
+ */
+static int
+comet_mailbox_collect(comet_mailbox_t *cmb, htsbuf_queue_t *hq)
+{
+  uint64_t oldest = comet_seq > COMET_RING_SIZE ?
+    comet_seq - COMET_RING_SIZE : 0;
+  comet_msg_t *cm;
+  int n = cmb->cmb_private_n;
+
+  htsbuf_appendq(hq, &cmb->cmb_private);
+  cmb->cmb_private_n = 0;
+
+  if(cmb->cmb_seq < oldest) {
+    /* Poller has been away for too long, what's gone is gone */
+    comet_lost += oldest - cmb->cmb_seq;
+    cmb->cmb_seq = oldest;
+  }
+
+  for(; cmb->cmb_seq < comet_seq; cmb->cmb_seq++) {
+    cm = &comet_ring[cmb->cmb_seq % COMET_RING_SIZE];
+    if(cm->cm_debug && !cmb->cmb_debug)
+      continue;
+    if(n++)
+      htsbuf_append(hq, ",", 1);
+    htsbuf_append(hq, cm->cm_json, cm->cm_len);
+  }
+  return n;
+}
+
+
+/**
+ * Run the parked polls of the mailbox
+ */
+static void
+comet_mailbox_wakeup(comet_mailbox_t *cmb)
+{
+  comet_wait_t *cw;
+
+  LIST_FOREACH(cw, &cmb->cmb_waits, cw_link)
+    http_wakeup(cw->cw_hc);
+}
+
+
+/**
+ * Build the reply from whatever the mailbox has got, if anything.
+ * Must be called with comet_mutex held, the reply is sent by the caller
+ * once the lock is dropped (logging ends up here)
+ *
+ * Returns 0 if there was nothing to send and 'force' wasn't set
+ */
+static int
+comet_mailbox_reply(http_connection_t *hc, comet_mailbox_t *cmb, int force)
+{
+  htsbuf_queue_t msgs;
+
+  htsbuf_queue_init(&msgs, 0);
+
+  if(!comet_mailbox_collect(cmb, &msgs) && !force)
+    return 0;
+
+  htsbuf_qprintf(&hc->hc_reply, "{\"boxid\": \"%s\",\"messages\": [",
+		 cmb->cmb_boxid);
+  htsbuf_appendq(&hc->hc_reply, &msgs);
+  htsbuf_append(&hc->hc_reply, "]}", 2);
+  return 1;
+}
+
+
+/**
+ * Parked poll, run on new messages and once a second
+ */
+static int
+comet_wait_pump(http_connection_t *hc, void *opaque)
+{
+  comet_wait_t *cw = opaque;
+  int r;
+
+  pthread_mutex_lock(&comet_mutex);
+  r = comet_mailbox_reply(hc, cw->cw_cmb, dispatch_clock - cw->cw_start >=
+			  MAILBOX_EMPTY_REPLY_TIMEOUT);
+  pthread_mutex_unlock(&comet_mutex);
+
+  if(r)
+    http_output_content(hc, "text/x-json; charset=UTF-8");
+  return r;
+}
+
+
+/**
+ *
+ */
+static void
+comet_wait_release(http_connection_t *hc, void *opaque)
+{
+  comet_wait_t *cw = opaque;
+  comet_mailbox_t *cmb = cw->cw_cmb;
+
+  pthread_mutex_lock(&comet_mutex);
+
+  LIST_REMOVE(cw, cw_link);
+  if(LIST_FIRST(&cmb->cmb_waits) == NULL) {
+    LIST_REMOVE(cmb, cmb_wait_link);
+    cmb->cmb_last_used = dispatch_clock;
+  }
+
+  pthread_mutex_unlock(&comet_mutex);
+  free(cw);
 }
 
 
@@ -180,47 +390,41 @@ comet_mailbox_poll(http_connection_t *hc, const char *remain, void *opaque)
   const char *cometid = http_arg_get(&hc->hc_req_args, "boxid");
   const char *immediate = http_arg_get(&hc->hc_req_args, "immediate");
   int im = immediate ? atoi(immediate) : 0;
-  time_t reqtime;
-  struct timespec ts;
-  htsmsg_t *m;
-
-  if(!im)
-    usleep(100000); /* Always sleep 0.1 sec to avoid comet storms */
+  comet_wait_t *cw;
 
   pthread_mutex_lock(&comet_mutex);
 
   if(cometid != NULL)
-    LIST_FOREACH(cmb, &mailboxes, cmb_link)
-      if(!strcmp(cmb->cmb_boxid, cometid))
-	break;
+    cmb = comet_mailbox_find(cometid);
     
   if(cmb == NULL) {
     cmb = comet_mailbox_create();
     comet_access_update(hc, cmb);
     comet_serverIpPort(hc, cmb);
   }
-  time(&reqtime);
-
-  ts.tv_sec = reqtime + 10;
-  ts.tv_nsec = 0;
 
-  cmb->cmb_last_used = 0; /* Make sure we're not flushed out */
+  if(comet_mailbox_reply(hc, cmb, im)) {
+    if(LIST_FIRST(&cmb->cmb_waits) == NULL)
+      cmb->cmb_last_used = dispatch_clock;
+    pthread_mutex_unlock(&comet_mutex);
+    http_output_content(hc, "text/x-json; charset=UTF-8");
+    return 0;
+  }
 
-  if(!im && cmb->cmb_messages == NULL)
-    pthread_cond_timedwait(&comet_cond, &comet_mutex, &ts);
+  /* Long poll, park it until something is posted or it times out */
+  cw = malloc(sizeof(comet_wait_t));
+  cw->cw_hc = hc;
+  cw->cw_cmb = cmb;
+  cw->cw_start = dispatch_clock;
 
-  m = htsmsg_create_map();
-  htsmsg_add_str(m, "boxid", cmb->cmb_boxid);
-  htsmsg_add_msg(m, "messages", cmb->cmb_messages ?: htsmsg_create_list());
-  cmb->cmb_messages = NULL;
-  
-  cmb->cmb_last_used = dispatch_clock;
+  if(LIST_FIRST(&cmb->cmb_waits) == NULL)
+    LIST_INSERT_HEAD(&comet_waiters, cmb, cmb_wait_link);
+  LIST_INSERT_HEAD(&cmb->cmb_waits, cw, cw_link);
+  cmb->cmb_last_used = 0; /* Make sure we're not flushed out */
 
   pthread_mutex_unlock(&comet_mutex);
 
-  htsmsg_json_serialize(m, &hc->hc_reply, 0);
-  htsmsg_destroy(m);
-  http_output_content(hc, "text/x-json; charset=UTF-8");
+  http_park(hc, comet_wait_pump, comet_wait_release, cw);
   return 0;
 }
 
@@ -231,7 +435,7 @@ comet_mailbox_poll(http_connection_t *hc, const char *remain, void *opaque)
 static int
 comet_mailbox_dbg(http_connection_t *hc, const char *remain, void *opaque)
 {
-  comet_mailbox_t *cmb = NULL; 
+  comet_mailbox_t *cmb; 
   const char *cometid = http_arg_get(&hc->hc_req_args, "boxid");
 
   if(cometid == NULL)
@@ -239,23 +443,18 @@ comet_mailbox_dbg(http_connection_t *hc, const char *remain, void *opaque)
 
   pthread_mutex_lock(&comet_mutex);
   
-  LIST_FOREACH(cmb, &mailboxes, cmb_link) {
-    if(!strcmp(cmb->cmb_boxid, cometid)) {
-      char buf[64];
-      cmb->cmb_debug = !cmb->cmb_debug;
+  if((cmb = comet_mailbox_find(cometid)) != NULL) {
+    char buf[64];
+    cmb->cmb_debug = !cmb->cmb_debug;
  
-      if(cmb->cmb_messages == NULL)
-	cmb->cmb_messages = htsmsg_create_list();
- 
-      htsmsg_t *m = htsmsg_create_map();
-      htsmsg_add_str(m, "notificationClass", "logmessage");
-      snprintf(buf, sizeof(buf), "Loglevel debug: %sabled", 
-	       cmb->cmb_debug ? "en" : "dis");
-      htsmsg_add_str(m, "logtxt", buf);
-      htsmsg_add_msg(cmb->cmb_messages, NULL, m);
-
-      pthread_cond_broadcast(&comet_cond);
-    }
+    htsmsg_t *m = htsmsg_create_map();
+    htsmsg_add_str(m, "notificationClass", "logmessage");
+    snprintf(buf, sizeof(buf), "Loglevel debug: %sabled", 
+	     cmb->cmb_debug ? "en" : "dis");
+    htsmsg_add_str(m, "logtxt", buf);
+    comet_private_add(cmb, m);
+
+    comet_mailbox_wakeup(cmb);
   }
   pthread_mutex_unlock(&comet_mutex);
 
@@ -281,19 +480,48 @@ void
 comet_mailbox_add_message(htsmsg_t *m, int isdebug)
 {
   comet_mailbox_t *cmb;
+  comet_msg_t *cm;
+  size_t len;
+  char *json;
 
+  /* Nobody to tell */
   pthread_mutex_lock(&comet_mutex);
+  if(comet_mailbox_count == 0) {
+    pthread_mutex_unlock(&comet_mutex);
+    return;
+  }
+  pthread_mutex_unlock(&comet_mutex);
 
-  LIST_FOREACH(cmb, &mailboxes, cmb_link) {
+  json = comet_serialize(m, &len);
 
-    if(isdebug && !cmb->cmb_debug)
-      continue;
+  pthread_mutex_lock(&comet_mutex);
+
+  cm = &comet_ring[comet_seq++ % COMET_RING_SIZE];
+  free(cm->cm_json);
+  cm->cm_json  = json;
+  cm->cm_len   = len;
+  cm->cm_debug = isdebug;
+
+  LIST_FOREACH(cmb, &comet_waiters, cmb_wait_link)
+    if(!isdebug || cmb->cmb_debug)
+      comet_mailbox_wakeup(cmb);
+
+  pthread_mutex_unlock(&comet_mutex);
+}
 
-    if(cmb->cmb_messages == NULL)
-      cmb->cmb_messages = htsmsg_create_list();
-    htsmsg_add_msg(cmb->cmb_messages, NULL, htsmsg_copy(m));
-  }
 
-  pthread_cond_broadcast(&comet_cond);
+/**
+ *
+ */
+void
+comet_dump(htsbuf_queue_t *hq)
+{
+  uint64_t oldest;
+
+  pthread_mutex_lock(&comet_mutex);
+  oldest = comet_seq > COMET_RING_SIZE ? comet_seq - COMET_RING_SIZE : 0;
+  htsbuf_qprintf(hq, "Mailboxes: %d  Notifications: %"PRIu64" "
+		 "(oldest kept %"PRIu64")  Lost: %u\n",
+		 comet_mailbox_count, comet_seq, oldest, comet_lost);
   pthread_mutex_unlock(&comet_mutex);
 }
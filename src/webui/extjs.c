@@ -22,6 +22,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <stdarg.h>
 
 #include <arpa/inet.h>
@@ -654,22 +655,90 @@ skip:
 /**
  *
  */
+static htsmsg_t *
+extjs_epg_entry(const epg_snap_event_t *e)
+{
+  const epg_snap_channel_t *esc = e->ese_channel;
+  htsmsg_t *m = htsmsg_create_map();
+  const char *s;
+
+  if(esc->esc_name != NULL)
+    htsmsg_add_str(m, "channel", esc->esc_name);
+  htsmsg_add_u32(m, "channelid", esc->esc_id);
+  if(esc->esc_icon != NULL)
+    htsmsg_add_str(m, "chicon", esc->esc_icon);
+
+  if(e->ese_title != NULL)
+    htsmsg_add_str(m, "title", e->ese_title);
+
+  if(e->ese_desc != NULL)
+    htsmsg_add_str(m, "description", e->ese_desc);
+
+  if(e->ese_episode != NULL)
+    htsmsg_add_str(m, "episode", e->ese_episode);
+
+  if(e->ese_ext_desc != NULL)
+    htsmsg_add_str(m, "ext_desc", e->ese_ext_desc);
+
+  if(e->ese_ext_item != NULL)
+    htsmsg_add_str(m, "ext_item", e->ese_ext_item);
+
+  if(e->ese_ext_text != NULL)
+    htsmsg_add_str(m, "ext_text", e->ese_ext_text);
+
+  htsmsg_add_u32(m, "id", e->ese_id);
+  htsmsg_add_u32(m, "start", e->ese_start);
+  htsmsg_add_u32(m, "end", e->ese_stop);
+  htsmsg_add_u32(m, "duration", e->ese_stop - e->ese_start);
+    
+  if((s = epg_content_group_get_name(e->ese_content_type)) != NULL)
+    htsmsg_add_str(m, "contentgrp", s);
+
+  if(e->ese_dvr_state != NULL)
+    htsmsg_add_str(m, "schedstate", e->ese_dvr_state);
+
+  return m;
+}
+
+/**
+ * EPG listing
+ *
+ * With 'start' and 'limit' the result is walked up to the end of the
+ * page. totalCount is exact unless a title is given, then the walk goes
+ * one event past the page, totalCount only covers that far and 'more'
+ * is set if the walk stopped early. Given a 'cursor' (empty for the
+ * first page) or
+ * a 'from'/'to' time window the reply carries the cursor for the next
+ * page instead, if any.
+ *
+ * 'title' is a regular expression, or a word query with 'words' set.
+ */
 static int
 extjs_epg(http_connection_t *hc, const char *remain, void *opaque)
 {
   htsbuf_queue_t *hq = &hc->hc_reply;
-  htsmsg_t *out, *array, *m;
-  epg_query_result_t eqr;
-  event_t *e;
-  int start = 0, end, limit, i;
+  htsmsg_t *out, *array;
+  epg_snapshot_t *es;
+  epg_snap_result_t esr;
+  epg_snap_channel_t *esc;
+  epg_snap_filter_t esf;
+  channel_tag_t *ct;
+  char next[EPG_CURSOR_SIZE];
+  int start = 0, end, limit, count, i;
   const char *s;
   const char *channel = http_arg_get(&hc->hc_req_args, "channel");
   const char *tag     = http_arg_get(&hc->hc_req_args, "tag");
   const char *cgrp    = http_arg_get(&hc->hc_req_args, "contentgrp");
   const char *title   = http_arg_get(&hc->hc_req_args, "title");
+  const char *cursor  = http_arg_get(&hc->hc_req_args, "cursor");
+  const char *from    = http_arg_get(&hc->hc_req_args, "from");
+  const char *to      = http_arg_get(&hc->hc_req_args, "to");
+  const char *words   = http_arg_get(&hc->hc_req_args, "words");
+  const char *full    = http_arg_get(&hc->hc_req_args, "fulltext");
 
   if(channel && !channel[0]) channel = NULL;
   if(tag     && !tag[0])     tag = NULL;
+  if(title   && !title[0])   title = NULL;
 
   if((s = http_arg_get(&hc->hc_req_args, "start")) != NULL)
     start = atoi(s);
@@ -679,71 +748,70 @@ extjs_epg(http_connection_t *hc, const char *remain, void *opaque)
   else
     limit = 20; /* XXX */
 
+  memset(&esf, 0, sizeof(esf));
+  esf.esf_ch_id = -1;
+  esf.esf_tag_id = -1;
+  esf.esf_content_type = cgrp ? epg_content_group_find_by_name(cgrp) : 0;
+  esf.esf_title = title;
+  esf.esf_words = words != NULL && atoi(words);
+  esf.esf_fulltext = full != NULL && atoi(full);
+  esf.esf_from = from ? atol(from) : time(NULL);
+  esf.esf_to = to ? atol(to) : 0;
+
   out = htsmsg_create_map();
   array = htsmsg_create_list();
 
   pthread_mutex_lock(&global_lock);
+  if(tag != NULL && (ct = channel_tag_find_by_name(tag, 0)) != NULL)
+    esf.esf_tag_id = ct->ct_identifier;
+  if((es = epg_snapshot_get()) == NULL)
+    es = epg_snapshot_refresh();
+  pthread_mutex_unlock(&global_lock);
 
-  epg_query(&eqr, channel, tag, cgrp, title);
-
-  epg_query_sort(&eqr);
-
-  htsmsg_add_u32(out, "totalCount", eqr.eqr_entries);
-
-
-  start = MIN(start, eqr.eqr_entries);
-  end = MIN(start + limit, eqr.eqr_entries);
-
-  for(i = start; i < end; i++) {
-    const char *s;
-
-    e = eqr.eqr_array[i];
+  if(channel != NULL && (esc = epg_snapshot_find_channel(es, channel)) != NULL)
+    esf.esf_ch_id = esc->esc_id;
 
-    m = htsmsg_create_map();
+  if(cursor != NULL || from != NULL || to != NULL) {
 
-    if(e->e_channel != NULL) {
-      htsmsg_add_str(m, "channel", e->e_channel->ch_name);
-      htsmsg_add_u32(m, "channelid", e->e_channel->ch_id);
-      if(e->e_channel->ch_icon != NULL)
-	htsmsg_add_str(m, "chicon", e->e_channel->ch_icon);
+    if(limit <= 0 ||
+       epg_snapshot_page(es, &esr, &esf, cursor, limit, next)) {
+      epg_snapshot_release(es);
+      htsmsg_destroy(out);
+      htsmsg_destroy(array);
+      return HTTP_STATUS_BAD_REQUEST;
     }
 
-    if(e->e_title != NULL)
-      htsmsg_add_str(m, "title", e->e_title);
-
-    if(e->e_desc != NULL)
-      htsmsg_add_str(m, "description", e->e_desc);
+    for(i = 0; i < esr.esr_entries; i++)
+      htsmsg_add_msg(array, NULL, extjs_epg_entry(esr.esr_array[i]));
 
-    if(e->e_episode.ee_onscreen != NULL)
-      htsmsg_add_str(m, "episode", e->e_episode.ee_onscreen);
+    if(next[0])
+      htsmsg_add_str(out, "cursor", next);
 
-    if(e->e_ext_desc != NULL)
-      htsmsg_add_str(m, "ext_desc", e->e_ext_desc);
-
-    if(e->e_ext_item != NULL)
-      htsmsg_add_str(m, "ext_item", e->e_ext_item);
-
-    if(e->e_ext_text != NULL)
-      htsmsg_add_str(m, "ext_text", e->e_ext_text);
+  } else {
 
-    htsmsg_add_u32(m, "id", e->e_id);
-    htsmsg_add_u32(m, "start", e->e_start);
-    htsmsg_add_u32(m, "end", e->e_stop);
-    htsmsg_add_u32(m, "duration", e->e_stop - e->e_start);
-    
-    if((s = epg_content_group_get_name(e->e_content_type)) != NULL)
-      htsmsg_add_str(m, "contentgrp", s);
+    /* Already in start time order */
+    start = MAX(0, MIN(start, INT_MAX / 2));
+    limit = MAX(0, MIN(limit, INT_MAX / 2));
+    count = epg_snapshot_count(es, &esf);
+    epg_snapshot_page(es, &esr, &esf, NULL,
+		      start + limit + (count < 0), NULL);
+
+    if(count < 0) {
+      htsmsg_add_u32(out, "totalCount", esr.esr_entries);
+      htsmsg_add_u32(out, "more", esr.esr_entries > start + limit);
+    } else {
+      htsmsg_add_u32(out, "totalCount", count);
+    }
 
-    dvr_entry_t *de;
-    if((de = dvr_entry_find_by_event(e)) != NULL)
-      htsmsg_add_str(m, "schedstate", dvr_entry_schedstatus(de));
+    start = MIN(start, esr.esr_entries);
+    end = MIN(start + limit, esr.esr_entries);
 
-    htsmsg_add_msg(array, NULL, m);
+    for(i = start; i < end; i++)
+      htsmsg_add_msg(array, NULL, extjs_epg_entry(esr.esr_array[i]));
   }
 
-  epg_query_free(&eqr);
-
-  pthread_mutex_unlock(&global_lock);
+  epg_snapshot_query_free(&esr);
+  epg_snapshot_release(es);
 
   htsmsg_add_msg(out, "entries", array);
 
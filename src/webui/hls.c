@@ -0,0 +1,799 @@
+/*
+ *  tvheadend, HTTP live streaming
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+#include "tvheadend.h"
+#include "atomic.h"
+#include "streaming.h"
+#include "channels.h"
+#include "subscriptions.h"
+#include "access.h"
+#include "tcp.h"
+#include "http.h"
+#include "webui.h"
+#include "tspass.h"
+
+#define HLS_DURATION  4          /* Target segment duration (sec) */
+#define HLS_SEGMENTS  8          /* Segments kept in memory */
+#define HLS_PLAYLIST  5          /* Segments listed in the playlist */
+#define HLS_MAXBYTES  (64 << 20) /* Bytes kept in memory */
+#define HLS_WAIT      15         /* Max wait for the first segment (sec) */
+#define HLS_IDLE      30         /* Lifetime without requests (sec) */
+
+#define HLS_PTS_MASK  0x1ffffffffLL
+
+/**
+ * A transport stream segment, starting with PAT/PMT and a keyframe
+ */
+typedef struct hls_segment {
+  int hs_refcount;
+  uint32_t hs_seq;
+  int hs_discont;          /* Stream restarted before this segment */
+  int64_t hs_duration;     /* usec */
+  size_t hs_len;
+  size_t hs_size;
+  uint8_t *hs_data;
+} hls_segment_t;
+
+
+LIST_HEAD(hls_list, hls);
+
+/**
+ * Segmenter of a channel, shared by all its HLS clients
+ */
+typedef struct hls {
+  LIST_ENTRY(hls) hl_link;         /* Protected by global_lock */
+  int hl_chid;
+  char *hl_channel;
+  int hl_refcount;                 /* Requests in progress */
+  time_t hl_access;                /* Last request */
+  gtimer_t hl_timer;
+
+  th_subscription_t *hl_s;
+  streaming_target_t hl_input;
+
+  /**
+   * Fields below are protected by hl_mutex
+   */
+  pthread_mutex_t hl_mutex;
+  int hl_ended;
+
+  tspass_t *hl_tp;
+  int hl_cut_pid;                  /* Segments start on this stream */
+  int hl_cut_type;
+  int hl_discont;
+
+  hls_segment_t *hl_cur;           /* Segment being filled */
+  int64_t hl_cur_pts;
+  int64_t hl_cur_time;
+
+  hls_segment_t *hl_segments[HLS_SEGMENTS];
+  uint32_t hl_first;               /* Oldest segment */
+  uint32_t hl_last;                /* Next segment to be added */
+  size_t hl_bytes;
+
+  char *hl_playlist;               /* Cached playlist */
+  size_t hl_playlist_len;
+
+  uint64_t hl_playlist_hits;
+  uint64_t hl_segment_hits;
+  uint64_t hl_sent;
+} hls_t;
+
+
+static struct hls_list hlss;
+static struct hls_list hlss_ended; /* Replaced, waiting for their requests */
+static uint32_t hls_seq_next;      /* Lowest sequence number not yet used */
+
+
+/**
+ *
+ */
+static void
+hs_unref(hls_segment_t *hs)
+{
+  if(atomic_add(&hs->hs_refcount, -1) == 1) {
+    free(hs->hs_data);
+    free(hs);
+  }
+}
+
+
+/**
+ *
+ */
+static inline hls_segment_t *
+hl_segment(hls_t *hl, uint32_t seq)
+{
+  return hl->hl_segments[seq % HLS_SEGMENTS];
+}
+
+
+/**
+ * Start of the PES payload in a packet, NULL if it does not start a PES
+ */
+static const uint8_t *
+hls_pes(const uint8_t *tsb)
+{
+  const uint8_t *p = tsb + 4;
+
+  if((tsb[1] & 0x40) == 0 || (tsb[3] & 0xc0) || (tsb[3] & 0x10) == 0)
+    return NULL;
+
+  if(tsb[3] & 0x20)
+    p += tsb[4] + 1;
+
+  if(p + 14 > tsb + 188 || p[0] != 0 || p[1] != 0 || p[2] != 1)
+    return NULL;
+  return p;
+}
+
+
+/**
+ *
+ */
+static int64_t
+hls_pes_pts(const uint8_t *p)
+{
+  if((p[7] & 0x80) == 0)
+    return PTS_UNSET;
+
+  return (int64_t)(p[9] & 0x0e) << 29 | (int64_t)p[10] << 22 |
+    (int64_t)(p[11] & 0xfe) << 14 | (int64_t)p[12] << 7 | p[13] >> 1;
+}
+
+
+/**
+ * Check if a video PES starts with a keyframe, by the random access
+ * indicator or a sequence header / IDR in the first packet
+ */
+static int
+hls_keyframe(const uint8_t *tsb, const uint8_t *p, int type)
+{
+  const uint8_t *end = tsb + 188;
+
+  if((tsb[3] & 0x20) && tsb[4] > 0 && (tsb[5] & 0x40))
+    return 1;
+
+  for(p += 9 + p[8]; p + 4 <= end; p++) {
+    if(p[0] != 0 || p[1] != 0 || p[2] != 1)
+      continue;
+
+    if(type == SCT_H264) {
+      if((p[3] & 0x1f) == 5 || (p[3] & 0x1f) == 7)
+	return 1;
+    } else if(p[3] == 0xb3 || p[3] == 0xb8) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
+/**
+ * Time since the current segment started. By PTS when both are known
+ * and it has not jumped, else by when the packets were received
+ */
+static int64_t
+hls_elapsed(hls_t *hl, int64_t pts, int64_t now)
+{
+  int64_t d = now - hl->hl_cur_time, p;
+
+  if(pts == PTS_UNSET || hl->hl_cur_pts == PTS_UNSET)
+    return d;
+
+  p = ts_rescale((pts - hl->hl_cur_pts) & HLS_PTS_MASK, 1000000);
+  return p > d + 5000000 ? d : p;
+}
+
+
+/**
+ *
+ */
+static void
+hls_build_playlist(hls_t *hl, htsbuf_queue_t *hq)
+{
+  hls_segment_t *hs;
+  uint32_t seq, first;
+  int64_t maxd = HLS_DURATION * 1000000LL;
+
+  first = hl->hl_last - MIN(hl->hl_last - hl->hl_first, HLS_PLAYLIST);
+
+  for(seq = first; seq != hl->hl_last; seq++)
+    maxd = MAX(maxd, hl_segment(hl, seq)->hs_duration);
+
+  htsbuf_qprintf(hq,
+		 "#EXTM3U\n"
+		 "#EXT-X-VERSION:3\n"
+		 "#EXT-X-TARGETDURATION:%d\n"
+		 "#EXT-X-MEDIA-SEQUENCE:%u\n",
+		 (int)((maxd + 999999) / 1000000), first);
+
+  for(seq = first; seq != hl->hl_last; seq++) {
+    hs = hl_segment(hl, seq);
+    if(hs->hs_discont)
+      htsbuf_qprintf(hq, "#EXT-X-DISCONTINUITY\n");
+    htsbuf_qprintf(hq, "#EXTINF:%d.%03d,\n%u.ts\n",
+		   (int)(hs->hs_duration / 1000000),
+		   (int)(hs->hs_duration % 1000000) / 1000, seq);
+  }
+}
+
+
+/**
+ *
+ */
+static void
+hls_add(hls_t *hl, hls_segment_t *hs)
+{
+  htsbuf_queue_t hq;
+
+  while(hl->hl_first != hl->hl_last &&
+	(hl->hl_last - hl->hl_first == HLS_SEGMENTS ||
+	 hl->hl_bytes + hs->hs_len > HLS_MAXBYTES)) {
+    hl->hl_bytes -= hl_segment(hl, hl->hl_first)->hs_len;
+    hs_unref(hl_segment(hl, hl->hl_first));
+    hl->hl_segments[hl->hl_first % HLS_SEGMENTS] = NULL;
+    hl->hl_first++;
+  }
+
+  hs->hs_seq = hl->hl_last;
+  hl->hl_segments[hl->hl_last % HLS_SEGMENTS] = hs;
+  hl->hl_last++;
+  hl->hl_bytes += hs->hs_len;
+
+  htsbuf_queue_init(&hq, 0);
+  hls_build_playlist(hl, &hq);
+  free(hl->hl_playlist);
+  hl->hl_playlist_len = hq.hq_size;
+  hl->hl_playlist = malloc(hq.hq_size);
+  htsbuf_read(&hq, hl->hl_playlist, hq.hq_size);
+}
+
+
+/**
+ * End the current segment and begin a new one with the next packet
+ */
+static void
+hls_cut(hls_t *hl, int64_t pts, int64_t now)
+{
+  hls_segment_t *hs = hl->hl_cur;
+
+  if(hs != NULL) {
+    tspass_flush(hl->hl_tp);
+    hs->hs_duration = hls_elapsed(hl, pts, now);
+    hls_add(hl, hs);
+  }
+
+  hs = calloc(1, sizeof(hls_segment_t));
+  hs->hs_refcount = 1;
+  hs->hs_discont = hl->hl_discont;
+  hl->hl_discont = 0;
+  hl->hl_cur = hs;
+  hl->hl_cur_pts = pts;
+  hl->hl_cur_time = now;
+  tspass_sync(hl->hl_tp);
+}
+
+
+/**
+ * tspass output, appended to the current segment
+ */
+static void
+hls_output(void *opaque, const struct iovec *iov, int iovcnt)
+{
+  hls_t *hl = opaque;
+  hls_segment_t *hs = hl->hl_cur;
+  int i;
+
+  for(i = 0; i < iovcnt; i++) {
+    if(hs->hs_len + iov[i].iov_len > hs->hs_size) {
+      hs->hs_size = MAX(hs->hs_size * 2, 65536);
+      hs->hs_data = realloc(hs->hs_data, hs->hs_size);
+    }
+    memcpy(hs->hs_data + hs->hs_len, iov[i].iov_base, iov[i].iov_len);
+    hs->hs_len += iov[i].iov_len;
+  }
+}
+
+
+/**
+ *
+ */
+static void
+hls_start(hls_t *hl, const streaming_start_t *ss)
+{
+  const streaming_start_component_t *ssc;
+  int i;
+
+  /* What we have is kept, the next segment starts afresh */
+  if(hl->hl_cur != NULL) {
+    tspass_flush(hl->hl_tp);
+    if(hl->hl_cur->hs_len > 0) {
+      hl->hl_cur->hs_duration = getmonoclock() - hl->hl_cur_time;
+      hls_add(hl, hl->hl_cur);
+    } else {
+      hs_unref(hl->hl_cur);
+    }
+    hl->hl_cur = NULL;
+  }
+  hl->hl_discont = hl->hl_last != hl->hl_first;
+
+  if(hl->hl_tp == NULL)
+    hl->hl_tp = tspass_create_output(hls_output, hl);
+  tspass_start(hl->hl_tp, ss);
+
+  /* Segments start on video keyframes, or any audio frame */
+  hl->hl_cut_pid = -1;
+  for(i = 0; i < ss->ss_num_components; i++) {
+    ssc = &ss->ss_components[i];
+    if(SCT_ISVIDEO(ssc->ssc_type) ||
+       (hl->hl_cut_pid == -1 && SCT_ISAUDIO(ssc->ssc_type))) {
+      hl->hl_cut_pid = ssc->ssc_pid;
+      hl->hl_cut_type = ssc->ssc_type;
+      if(SCT_ISVIDEO(ssc->ssc_type))
+	break;
+    }
+  }
+}
+
+
+/**
+ * Input from the raw subscription
+ */
+static void
+hls_input(void *opaque, streaming_message_t *sm)
+{
+  hls_t *hl = opaque;
+  const uint8_t *tsb, *p;
+  int64_t pts, now;
+
+  pthread_mutex_lock(&hl->hl_mutex);
+
+  switch(sm->sm_type) {
+  case SMT_MPEGTS:
+    tsb = sm->sm_data;
+    if(hl->hl_tp == NULL ||
+       ((tsb[1] & 0x1f) << 8 | tsb[2]) != hl->hl_cut_pid ||
+       (p = hls_pes(tsb)) == NULL ||
+       (SCT_ISVIDEO(hl->hl_cut_type) &&
+	!hls_keyframe(tsb, p, hl->hl_cut_type))) {
+
+      if(hl->hl_cur != NULL)
+	tspass_input(hl->hl_tp, sm);
+      else
+	streaming_msg_free(sm);
+      break;
+    }
+
+    pts = hls_pes_pts(p);
+    now = getmonoclock();
+
+    if(hl->hl_cur == NULL ||
+       hls_elapsed(hl, pts, now) >= HLS_DURATION * 1000000LL)
+      hls_cut(hl, pts, now);
+
+    tspass_input(hl->hl_tp, sm);
+    break;
+
+  case SMT_START:
+    hl->hl_ended = 0;
+    hls_start(hl, sm->sm_data);
+    streaming_msg_free(sm);
+    break;
+
+  case SMT_STOP:
+  case SMT_NOSTART:
+  case SMT_EXIT:
+    hl->hl_ended = 1;
+    streaming_msg_free(sm);
+    break;
+
+  default:
+    streaming_msg_free(sm);
+    break;
+  }
+
+  pthread_mutex_unlock(&hl->hl_mutex);
+}
+
+
+/**
+ *
+ */
+static void
+hls_destroy(hls_t *hl)
+{
+  LIST_REMOVE(hl, hl_link);
+  gtimer_disarm(&hl->hl_timer);
+
+  if(hl->hl_s != NULL)
+    subscription_unsubscribe(hl->hl_s);
+
+  hls_seq_next = MAX(hls_seq_next, hl->hl_last);
+
+  while(hl->hl_first != hl->hl_last) {
+    hs_unref(hl_segment(hl, hl->hl_first));
+    hl->hl_first++;
+  }
+  if(hl->hl_cur != NULL)
+    hs_unref(hl->hl_cur);
+  if(hl->hl_tp != NULL)
+    tspass_destroy(hl->hl_tp);
+
+  tvhlog(LOG_INFO, "HLS", "\"%s\": Segmenter destroyed, %"PRIu64" playlist "
+	 "and %"PRIu64" segment requests, %"PRIu64" kB sent",
+	 hl->hl_channel, hl->hl_playlist_hits, hl->hl_segment_hits,
+	 hl->hl_sent >> 10);
+
+  pthread_mutex_destroy(&hl->hl_mutex);
+  free(hl->hl_playlist);
+  free(hl->hl_channel);
+  free(hl);
+}
+
+
+/**
+ * Segmenters live as long as they are requested
+ */
+static void
+hls_idle(void *aux)
+{
+  hls_t *hl = aux;
+
+  if(hl->hl_refcount == 0 && dispatch_clock - hl->hl_access >= HLS_IDLE)
+    hls_destroy(hl);
+  else
+    gtimer_arm(&hl->hl_timer, hls_idle, hl, 5);
+}
+
+
+/**
+ *
+ */
+static hls_t *
+hls_create(channel_t *ch)
+{
+  hls_t *hl = calloc(1, sizeof(hls_t));
+
+  hl->hl_chid = ch->ch_id;
+  hl->hl_channel = strdup(ch->ch_name);
+  hl->hl_cut_pid = -1;
+
+  /**
+   * Segment URLs must not be reused by a later segmenter, players
+   * and caches would take the old segments for the new ones.
+   * Segments are longer than a second, so the wall clock stays
+   * ahead of earlier runs
+   */
+  hls_seq_next = MAX(hls_seq_next, (uint32_t)dispatch_clock);
+  hl->hl_first = hl->hl_last = hls_seq_next;
+
+  pthread_mutex_init(&hl->hl_mutex, NULL);
+
+  LIST_INSERT_HEAD(&hlss, hl, hl_link);
+  gtimer_arm(&hl->hl_timer, hls_idle, hl, 5);
+
+  streaming_target_init(&hl->hl_input, hls_input, hl, 0);
+  hl->hl_s = subscription_create_from_channel(ch, 100, "HLS",
+					      &hl->hl_input,
+					      SUBSCRIPTION_RAW_MPEGTS);
+  if(hl->hl_s == NULL)
+    hl->hl_ended = 1;
+
+  tvhlog(LOG_INFO, "HLS", "\"%s\": Segmenter created", hl->hl_channel);
+  return hl;
+}
+
+
+/**
+ * Find the segmenter of a channel and hold it for a request.
+ * Called with global_lock held
+ */
+static hls_t *
+hls_get(channel_t *ch, int create)
+{
+  hls_t *hl;
+
+  LIST_FOREACH(hl, &hlss, hl_link)
+    if(hl->hl_chid == ch->ch_id)
+      break;
+
+  /* Playlist requests start over if the subscription has ended */
+  if(hl != NULL && create) {
+    pthread_mutex_lock(&hl->hl_mutex);
+    if(hl->hl_ended) {
+      hls_seq_next = MAX(hls_seq_next, hl->hl_last);
+      pthread_mutex_unlock(&hl->hl_mutex);
+
+      tvhlog(LOG_INFO, "HLS", "\"%s\": Subscription ended, restarting",
+	     hl->hl_channel);
+      LIST_REMOVE(hl, hl_link);
+      LIST_INSERT_HEAD(&hlss_ended, hl, hl_link);
+      hl->hl_access = 0;
+      hl = NULL;
+    } else {
+      pthread_mutex_unlock(&hl->hl_mutex);
+    }
+  }
+
+  if(hl == NULL) {
+    if(!create)
+      return NULL;
+    hl = hls_create(ch);
+  }
+
+  hl->hl_refcount++;
+  hl->hl_access = dispatch_clock;
+  return hl;
+}
+
+
+/**
+ * Reply with the playlist. Returns 0 if there is nothing to list yet
+ */
+static int
+hls_send_playlist(http_connection_t *hc, hls_t *hl)
+{
+  pthread_mutex_lock(&hl->hl_mutex);
+
+  if(hl->hl_first == hl->hl_last) {
+    pthread_mutex_unlock(&hl->hl_mutex);
+    return 0;
+  }
+
+  htsbuf_append(&hc->hc_reply, hl->hl_playlist, hl->hl_playlist_len);
+  hl->hl_playlist_hits++;
+
+  pthread_mutex_unlock(&hl->hl_mutex);
+
+  http_send_header(hc, HTTP_STATUS_OK, "application/vnd.apple.mpegurl",
+		   hc->hc_reply.hq_size, NULL, NULL, 1, NULL, NULL);
+  http_push(hc, &hc->hc_reply);
+  return 1;
+}
+
+
+/**
+ * Playlist request parked until the first segment is done
+ */
+typedef struct hls_wait {
+  hls_t *hw_hl;
+  time_t hw_start;
+} hls_wait_t;
+
+
+/**
+ * Checked once a second by the event loop
+ */
+static int
+hls_wait_pump(http_connection_t *hc, void *opaque)
+{
+  hls_wait_t *hw = opaque;
+  hls_t *hl = hw->hw_hl;
+  int ended;
+
+  if(hls_send_playlist(hc, hl))
+    return 1;
+
+  pthread_mutex_lock(&hl->hl_mutex);
+  ended = hl->hl_ended;
+  pthread_mutex_unlock(&hl->hl_mutex);
+
+  if(!ended && dispatch_clock - hw->hw_start < HLS_WAIT)
+    return 0;
+
+  http_error(hc, HTTP_STATUS_UNAVAILABLE);
+  return 1;
+}
+
+
+/**
+ *
+ */
+static void
+hls_wait_release(http_connection_t *hc, void *opaque)
+{
+  hls_wait_t *hw = opaque;
+
+  pthread_mutex_lock(&global_lock);
+  hw->hw_hl->hl_refcount--;
+  pthread_mutex_unlock(&global_lock);
+  free(hw);
+}
+
+
+/**
+ *
+ */
+static int
+hls_send_segment(http_connection_t *hc, hls_t *hl, uint32_t seq)
+{
+  hls_segment_t *hs = NULL;
+
+  pthread_mutex_lock(&hl->hl_mutex);
+  if(seq - hl->hl_first < hl->hl_last - hl->hl_first) {
+    hs = hl_segment(hl, seq);
+    atomic_add(&hs->hs_refcount, 1);
+    hl->hl_segment_hits++;
+    hl->hl_sent += hs->hs_len;
+  }
+  pthread_mutex_unlock(&hl->hl_mutex);
+
+  if(hs == NULL)
+    return HTTP_STATUS_NOT_FOUND;
+
+  /* Segments never change, they can be cached for as long as wanted */
+  http_send_header(hc, HTTP_STATUS_OK, "video/MP2T", hs->hs_len,
+		   NULL, NULL, 3600, NULL, NULL);
+  http_write(hc, hs->hs_data, hs->hs_len);
+  hs_unref(hs);
+  return 0;
+}
+
+
+/**
+ * Serve the playlist or a segment, components are "channelid", <chid>
+ * and the file name. With verify set the ticket must be valid for it.
+ */
+static int
+hls_serve(http_connection_t *hc, char **components, const char *ticket,
+	  int verify)
+{
+  char resource[128], *s;
+  channel_t *ch;
+  hls_t *hl;
+  hls_wait_t *hw;
+  uint32_t seq = 0;
+  int playlist, r = 0;
+
+  if(strcmp(components[0], "channelid"))
+    return HTTP_STATUS_BAD_REQUEST;
+
+  if(!(playlist = !strcmp(components[2], "index.m3u8"))) {
+    seq = strtoul(components[2], &s, 10);
+    if(s == components[2] || strcmp(s, ".ts"))
+      return HTTP_STATUS_NOT_FOUND;
+  }
+
+  pthread_mutex_lock(&global_lock);
+  if(verify) {
+    snprintf(resource, sizeof(resource), "/hls/channelid/%s/%s",
+	     components[1], components[2]);
+    if(access_ticket_verify(ticket, resource)) {
+      pthread_mutex_unlock(&global_lock);
+      return HTTP_STATUS_UNAUTHORIZED;
+    }
+  }
+  hl = (ch = channel_find_by_identifier(atoi(components[1]))) != NULL ?
+    hls_get(ch, playlist) : NULL;
+  if(hl != NULL && ticket != NULL)
+    access_ticket_refresh(ticket);
+  pthread_mutex_unlock(&global_lock);
+
+  if(hl == NULL)
+    return HTTP_STATUS_NOT_FOUND;
+
+  if(playlist && !hls_send_playlist(hc, hl)) {
+    /* Segmenter just started, wait for it in the event loop */
+    hw = malloc(sizeof(hls_wait_t));
+    hw->hw_hl = hl;
+    hw->hw_start = dispatch_clock;
+    http_park(hc, hls_wait_pump, hls_wait_release, hw);
+    return 0;
+  }
+
+  if(!playlist)
+    r = hls_send_segment(hc, hl, seq);
+
+  pthread_mutex_lock(&global_lock);
+  hl->hl_refcount--;
+  pthread_mutex_unlock(&global_lock);
+  return r;
+}
+
+
+/**
+ * http://tvheadend/hls/channelid/<chid>/index.m3u8
+ * http://tvheadend/hls/channelid/<chid>/<seq>.ts
+ */
+static int
+page_hls(http_connection_t *hc, const char *remain, void *opaque)
+{
+  char *components[3];
+
+  if(remain == NULL ||
+     http_tokenize((char *)remain, components, 3, '/') != 3)
+    return HTTP_STATUS_BAD_REQUEST;
+
+  return hls_serve(hc, components,
+		   http_arg_get(&hc->hc_req_args, "ticket"), 0);
+}
+
+
+/**
+ * http://tvheadend/hls/ticket/<ticket>/channelid/<chid>/index.m3u8
+ * http://tvheadend/hls/ticket/<ticket>/channelid/<chid>/<seq>.ts
+ *
+ * The ticket is part of the path so the relative segment URIs in the
+ * playlist carry it along, the playlist itself stays the same for all
+ * viewers. Registered without an access mask, the ticket is checked
+ * by hls_serve()
+ */
+static int
+page_hls_ticket(http_connection_t *hc, const char *remain, void *opaque)
+{
+  char *components[4];
+
+  if(remain == NULL ||
+     http_tokenize((char *)remain, components, 4, '/') != 4)
+    return HTTP_STATUS_BAD_REQUEST;
+
+  return hls_serve(hc, components + 1, components[0], 1);
+}
+
+
+/**
+ *
+ */
+void
+hls_dump(htsbuf_queue_t *hq)
+{
+  hls_t *hl;
+  hls_segment_t *hs;
+  uint32_t seq;
+  int64_t d;
+
+  lock_assert(&global_lock);
+
+  LIST_FOREACH(hl, &hlss, hl_link) {
+    pthread_mutex_lock(&hl->hl_mutex);
+    d = 0;
+    for(seq = hl->hl_first; seq != hl->hl_last; seq++)
+      d += hl_segment(hl, seq)->hs_duration;
+    hs = hl->hl_first != hl->hl_last ? hl_segment(hl, hl->hl_last - 1) : NULL;
+
+    htsbuf_qprintf(hq, "  \"%s\": segments %u-%u, %"PRId64" s, %zu kB, "
+		   "last %zu kB, idle %d s%s\n",
+		   hl->hl_channel, hl->hl_first, hl->hl_last,
+		   d / 1000000, hl->hl_bytes >> 10, hs ? hs->hs_len >> 10 : 0,
+		   (int)(dispatch_clock - hl->hl_access),
+		   hl->hl_ended ? ", ended" : "");
+    htsbuf_qprintf(hq, "    %"PRIu64" playlist and %"PRIu64" segment "
+		   "requests, %"PRIu64" kB sent\n",
+		   hl->hl_playlist_hits, hl->hl_segment_hits, hl->hl_sent >> 10);
+    pthread_mutex_unlock(&hl->hl_mutex);
+  }
+}
+
+
+/**
+ *
+ */
+void
+hls_init(void)
+{
+  http_path_add("/hls", NULL, page_hls, ACCESS_STREAMING);
+  http_path_add("/hls/ticket", NULL, page_hls_ticket, 0);
+}
@@ -30,6 +30,10 @@
 #include "epg.h"
 #include "xmltv.h"
 #include "psi.h"
+#include "csa.h"
+#include "cwc.h"
+#include "htsp.h"
+#include "timeshift.h"
 #if ENABLE_LINUXDVB
 #include "dvr/dvr.h"
 #include "dvb/dvb.h"
@@ -155,8 +159,7 @@ page_statedump(http_connection_t *hc, const char *remain, void *opaque)
 {
   htsbuf_queue_t *hq = &hc->hc_reply;
 
-  scopedgloballock();
- 
+  pthread_mutex_lock(&global_lock);
 
   htsbuf_qprintf(hq, "Tvheadend %s  Binary SHA1: "
 		 "%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x"
@@ -189,6 +192,56 @@ page_statedump(http_connection_t *hc, const char *remain, void *opaque)
   dumpdvbadapters(hq);
 #endif 
 
+  pthread_mutex_unlock(&global_lock);
+
+  /* These only need their own module locks */
+  outputtitle(hq, 0, "CSA descrambling");
+  csa_dump(hq);
+
+  outputtitle(hq, 0, "ECM cache");
+  cwc_ecm_cache_dump(hq);
+
+  outputtitle(hq, 0, "CWC connections");
+  cwc_io_dump(hq);
+
+  outputtitle(hq, 0, "CWC key timing");
+  cwc_key_timing_dump(hq);
+
+  outputtitle(hq, 0, "CWC EMM forwarding");
+  cwc_emm_dump(hq);
+
+  outputtitle(hq, 0, "HTSP methods");
+  htsp_method_dump(hq);
+
+  /* These walk lists protected by global_lock */
+  pthread_mutex_lock(&global_lock);
+
+  outputtitle(hq, 0, "EPG snapshot");
+  epg_snapshot_dump(hq);
+
+  outputtitle(hq, 0, "HTSP sync");
+  htsp_sync_dump(hq);
+
+  outputtitle(hq, 0, "Timeshift");
+  timeshift_dump(hq);
+
+  outputtitle(hq, 0, "Shared HTTP streams");
+  streamshare_dump(hq);
+
+  outputtitle(hq, 0, "HLS");
+  hls_dump(hq);
+
+  pthread_mutex_unlock(&global_lock);
+
+  outputtitle(hq, 0, "HTTP server");
+  http_server_dump(hq);
+
+  outputtitle(hq, 0, "Comet");
+  comet_dump(hq);
+
+  outputtitle(hq, 0, "Recordings in progress");
+  dvr_live_dump(hq);
+
   http_output_content(hc, "text/plain; charset=UTF-8");
   return 0;
 }
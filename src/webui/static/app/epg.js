@@ -393,6 +393,11 @@ tvheadend.epg = function() {
 
     function createAutoRec() {
 
+	/* Title searches are only counted as far as they have been looked at */
+	var reply = epgStore.reader.jsonData;
+	var count = (reply && reply.more ? 'more than ' : '') +
+	    epgStore.getTotalCount();
+
 	var title = epgStore.baseParams.title ?
 	    epgStore.baseParams.title      : "<i>Don't care</i>";
 	var channel = epgStore.baseParams.channel ?
@@ -413,7 +418,7 @@ tvheadend.epg = function() {
 			       '<div class="x-smallhdr">Content Group:</div>' + contentgrp + '<br>' +
 			       '<br>' +
 			       'Currently this will match (and record) ' + 
-			       epgStore.getTotalCount() + ' events. ' +
+			       count + ' events. ' +
 			       'Are you sure?',
 
 			       function(button) {
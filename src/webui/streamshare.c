@@ -0,0 +1,626 @@
+/*
+ *  tvheadend, shared HTTP stream output
+ *  Copyright (C) 2012 Andreas man
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tvheadend.h"
+#include "atomic.h"
+#include "streaming.h"
+#include "channels.h"
+#include "service.h"
+#include "epg.h"
+#include "subscriptions.h"
+#include "http.h"
+#include "webui.h"
+#include "dvr/mkmux.h"
+#include "plumbing/tsfix.h"
+#include "plumbing/globalheaders.h"
+
+#define STREAMSHARE_CHUNKS    1024      /* Chunks kept for readers */
+#define STREAMSHARE_MAXBYTES  (8 << 20) /* Bytes kept for readers */
+
+/**
+ * One piece of muxed output, shared by all readers
+ */
+typedef struct streamshare_chunk {
+  int shc_refcount;
+  int shc_flags;           /* MK_OUTPUT_ flags */
+  size_t shc_len;
+  uint8_t shc_data[0];
+} streamshare_chunk_t;
+
+
+LIST_HEAD(streamshare_list, streamshare);
+LIST_HEAD(streamshare_reader_list, streamshare_reader);
+
+/**
+ * Matroska output of a channel, muxed once for all HTTP readers
+ */
+typedef struct streamshare {
+  LIST_ENTRY(streamshare) sh_link;   /* Protected by global_lock */
+  int sh_linked;
+  int sh_chid;
+  char *sh_channel;
+  int sh_nreaders;
+
+  th_subscription_t *sh_s;
+  streaming_queue_t sh_sq;
+  streaming_target_t *sh_gh;
+  streaming_target_t *sh_tsfix;
+  pthread_t sh_tid;
+  int sh_running;                    /* Protected by sq_mutex */
+
+  /**
+   * Fields below are protected by sh_mutex
+   */
+  pthread_mutex_t sh_mutex;
+  int sh_ended;
+  int sh_radio;
+
+  struct streamshare_reader_list sh_readers;
+
+  streamshare_chunk_t *sh_chunks[STREAMSHARE_CHUNKS];
+  uint64_t sh_first;                 /* Oldest chunk */
+  uint64_t sh_last;                  /* Next chunk to be added */
+  uint64_t sh_sync;                  /* Newest sync point, if >= sh_first */
+  size_t sh_bytes;
+  streamshare_chunk_t *sh_header;    /* Current stream header */
+  uint64_t sh_header_seq;
+
+  uint64_t sh_muxed;
+  uint64_t sh_sent;
+} streamshare_t;
+
+
+/**
+ *
+ */
+struct streamshare_reader {
+  LIST_ENTRY(streamshare_reader) shr_link;
+  streamshare_t *shr_sh;
+  int shr_id;
+  http_connection_t *shr_hc;
+  uint64_t shr_pos;                  /* Next chunk to send */
+  uint64_t shr_header_seq;           /* Stream header the client has */
+  int shr_resyncs;
+  int shr_synced;
+  int shr_started;
+  time_t shr_last;                   /* Last chunk sent */
+};
+
+
+static struct streamshare_list streamshares;
+static int streamshare_reader_tally;
+
+
+/**
+ *
+ */
+static void
+shc_unref(streamshare_chunk_t *shc)
+{
+  if(atomic_add(&shc->shc_refcount, -1) == 1)
+    free(shc);
+}
+
+
+/**
+ *
+ */
+static inline streamshare_chunk_t *
+sh_chunk(streamshare_t *sh, uint64_t seq)
+{
+  return sh->sh_chunks[seq % STREAMSHARE_CHUNKS];
+}
+
+
+/**
+ * Have the readers pick up new output. sh_mutex is held
+ */
+static void
+sh_wakeup(streamshare_t *sh)
+{
+  streamshare_reader_t *shr;
+
+  LIST_FOREACH(shr, &sh->sh_readers, shr_link)
+    if(shr->shr_hc != NULL)
+      http_wakeup(shr->shr_hc);
+}
+
+
+/**
+ *
+ */
+static void
+sh_expire_one(streamshare_t *sh)
+{
+  streamshare_chunk_t *shc = sh_chunk(sh, sh->sh_first);
+
+  sh->sh_chunks[sh->sh_first % STREAMSHARE_CHUNKS] = NULL;
+  sh->sh_first++;
+  sh->sh_bytes -= shc->shc_len;
+  shc_unref(shc);
+}
+
+
+/**
+ * Muxer output, called from the share thread
+ */
+static void
+sh_output(void *opaque, htsbuf_queue_t *q, int flags)
+{
+  streamshare_t *sh = opaque;
+  streamshare_chunk_t *shc;
+
+  shc = malloc(sizeof(streamshare_chunk_t) + q->hq_size);
+  shc->shc_refcount = 1;
+  shc->shc_flags = flags;
+  shc->shc_len = q->hq_size;
+  htsbuf_read(q, shc->shc_data, shc->shc_len);
+
+  pthread_mutex_lock(&sh->sh_mutex);
+
+  while(sh->sh_first < sh->sh_last &&
+	(sh->sh_last - sh->sh_first == STREAMSHARE_CHUNKS ||
+	 sh->sh_bytes + shc->shc_len > STREAMSHARE_MAXBYTES))
+    sh_expire_one(sh);
+
+  if(flags & MK_OUTPUT_HEADER) {
+    if(sh->sh_header != NULL)
+      shc_unref(sh->sh_header);
+    atomic_add(&shc->shc_refcount, 1);
+    sh->sh_header = shc;
+    sh->sh_header_seq = sh->sh_last;
+  }
+
+  if(flags & (MK_OUTPUT_HEADER | MK_OUTPUT_SYNC))
+    sh->sh_sync = sh->sh_last;
+
+  sh->sh_chunks[sh->sh_last % STREAMSHARE_CHUNKS] = shc;
+  sh->sh_last++;
+  sh->sh_bytes += shc->shc_len;
+  sh->sh_muxed += shc->shc_len;
+
+  sh_wakeup(sh);
+  pthread_mutex_unlock(&sh->sh_mutex);
+}
+
+
+/**
+ *
+ */
+static void
+sh_end(streamshare_t *sh)
+{
+  pthread_mutex_lock(&sh->sh_mutex);
+  sh->sh_ended = 1;
+  sh_wakeup(sh);
+  pthread_mutex_unlock(&sh->sh_mutex);
+}
+
+
+/**
+ * Muxes everything the subscription delivers
+ */
+static void *
+streamshare_thread(void *aux)
+{
+  streamshare_t *sh = aux;
+  streaming_queue_t *sq = &sh->sh_sq;
+  streaming_message_t *sm;
+  mk_mux_t *mkm = NULL;
+  th_subscription_t *s = sh->sh_s;
+  event_t *e;
+  int event_id = -1;
+
+  pthread_mutex_lock(&sq->sq_mutex);
+
+  while(sh->sh_running) {
+    if((sm = TAILQ_FIRST(&sq->sq_queue)) == NULL) {
+      pthread_cond_wait(&sq->sq_cond, &sq->sq_mutex);
+      continue;
+    }
+    TAILQ_REMOVE(&sq->sq_queue, sm, sm_link);
+    pthread_mutex_unlock(&sq->sq_mutex);
+
+    switch(sm->sm_type) {
+    case SMT_PACKET:
+      if(mkm == NULL)
+	break;
+
+      mk_mux_write_pkt(mkm, sm->sm_data);
+      sm->sm_data = NULL;
+
+      e = s->ths_channel ? s->ths_channel->ch_epg_current : NULL;
+      if(e && event_id != e->e_id) {
+	event_id = e->e_id;
+	mk_mux_append_meta(mkm, e);
+      }
+      break;
+
+    case SMT_START:
+      tvhlog(LOG_DEBUG, "webui", "\"%s\": Start shared stream",
+	     sh->sh_channel);
+      if(mkm != NULL)
+	mk_mux_close(mkm);
+
+      pthread_mutex_lock(&sh->sh_mutex);
+      sh->sh_radio = s->ths_service != NULL &&
+	s->ths_service->s_servicetype == ST_RADIO;
+      pthread_mutex_unlock(&sh->sh_mutex);
+
+      mkm = mk_mux_output_create(sm->sm_data, s->ths_channel, sh_output, sh);
+      break;
+
+    case SMT_NOSTART:
+      tvhlog(LOG_DEBUG, "webui", "\"%s\": Couldn't start shared stream",
+	     sh->sh_channel);
+      sh_end(sh);
+      break;
+
+    case SMT_STOP:
+    case SMT_EXIT:
+      sh_end(sh);
+      break;
+
+    default:
+      break;
+    }
+    streaming_msg_free(sm);
+    pthread_mutex_lock(&sq->sq_mutex);
+  }
+
+  pthread_mutex_unlock(&sq->sq_mutex);
+
+  if(mkm != NULL)
+    mk_mux_close(mkm);
+  return NULL;
+}
+
+
+/**
+ *
+ */
+static streamshare_t *
+streamshare_create(channel_t *ch, int weight, const char *name)
+{
+  streamshare_t *sh = calloc(1, sizeof(streamshare_t));
+
+  sh->sh_chid = ch->ch_id;
+  sh->sh_channel = strdup(ch->ch_name);
+
+  pthread_mutex_init(&sh->sh_mutex, NULL);
+
+  streaming_queue_init(&sh->sh_sq, 0);
+  sh->sh_gh = globalheaders_create(&sh->sh_sq.sq_st);
+  sh->sh_tsfix = tsfix_create(sh->sh_gh);
+
+  LIST_INSERT_HEAD(&streamshares, sh, sh_link);
+  sh->sh_linked = 1;
+
+  sh->sh_s = subscription_create_from_channel(ch, weight, name,
+					      sh->sh_tsfix, 0);
+  if(sh->sh_s == NULL)
+    sh->sh_ended = 1;
+
+  sh->sh_running = 1;
+  pthread_create(&sh->sh_tid, NULL, streamshare_thread, sh);
+
+  tvhlog(LOG_INFO, "webui", "\"%s\": Shared stream created", sh->sh_channel);
+  return sh;
+}
+
+
+/**
+ *
+ */
+static void
+streamshare_destroy(streamshare_t *sh)
+{
+  if(sh->sh_linked)
+    LIST_REMOVE(sh, sh_link);
+
+  if(sh->sh_s != NULL)
+    subscription_unsubscribe(sh->sh_s);
+
+  pthread_mutex_lock(&sh->sh_sq.sq_mutex);
+  sh->sh_running = 0;
+  pthread_cond_signal(&sh->sh_sq.sq_cond);
+  pthread_mutex_unlock(&sh->sh_sq.sq_mutex);
+  pthread_join(sh->sh_tid, NULL);
+
+  globalheaders_destroy(sh->sh_gh);
+  tsfix_destroy(sh->sh_tsfix);
+  streaming_queue_deinit(&sh->sh_sq);
+
+  while(sh->sh_first < sh->sh_last)
+    sh_expire_one(sh);
+  if(sh->sh_header != NULL)
+    shc_unref(sh->sh_header);
+
+  tvhlog(LOG_INFO, "webui", "\"%s\": Shared stream destroyed, "
+	 "%"PRIu64" kB muxed, %"PRIu64" kB sent",
+	 sh->sh_channel, sh->sh_muxed >> 10, sh->sh_sent >> 10);
+
+  pthread_mutex_destroy(&sh->sh_mutex);
+  free(sh->sh_channel);
+  free(sh);
+}
+
+
+/**
+ * Attach a reader to the shared output of a channel, creating it if
+ * needed. Called with global_lock held
+ */
+streamshare_reader_t *
+streamshare_reader_create(channel_t *ch, int weight, const char *name)
+{
+  streamshare_t *sh;
+  streamshare_reader_t *shr;
+
+  lock_assert(&global_lock);
+
+  LIST_FOREACH(sh, &streamshares, sh_link) {
+    if(sh->sh_chid != ch->ch_id)
+      continue;
+
+    /* A share whose subscription has ended is left to its readers */
+    pthread_mutex_lock(&sh->sh_mutex);
+    if(sh->sh_ended) {
+      LIST_REMOVE(sh, sh_link);
+      sh->sh_linked = 0;
+    }
+    pthread_mutex_unlock(&sh->sh_mutex);
+    if(sh->sh_linked)
+      break;
+  }
+
+  if(sh == NULL)
+    sh = streamshare_create(ch, weight, name);
+
+  shr = calloc(1, sizeof(streamshare_reader_t));
+  shr->shr_sh = sh;
+  shr->shr_id = ++streamshare_reader_tally;
+
+  pthread_mutex_lock(&sh->sh_mutex);
+  LIST_INSERT_HEAD(&sh->sh_readers, shr, shr_link);
+  sh->sh_nreaders++;
+  pthread_mutex_unlock(&sh->sh_mutex);
+  return shr;
+}
+
+
+/**
+ * Detach a reader, the share goes away with its last reader.
+ * Called with global_lock held
+ */
+void
+streamshare_reader_destroy(streamshare_reader_t *shr)
+{
+  streamshare_t *sh = shr->shr_sh;
+
+  lock_assert(&global_lock);
+
+  pthread_mutex_lock(&sh->sh_mutex);
+  LIST_REMOVE(shr, shr_link);
+  sh->sh_nreaders--;
+  pthread_mutex_unlock(&sh->sh_mutex);
+  free(shr);
+
+  if(sh->sh_nreaders == 0)
+    streamshare_destroy(sh);
+}
+
+
+/**
+ * Pick the chunk a reader starts from when it joins: the newest sync
+ * point, preceded by the stream header unless that is where the sync
+ * point is. '*hdrp' is set to the header to send first, referenced.
+ * Returns 0 if there is no sync point yet
+ */
+static int
+shr_resync(streamshare_t *sh, streamshare_reader_t *shr,
+	   streamshare_chunk_t **hdrp)
+{
+  *hdrp = NULL;
+
+  if(sh->sh_header == NULL || sh->sh_sync < sh->sh_first ||
+     sh->sh_sync >= sh->sh_last)
+    return 0;
+
+  shr->shr_pos = sh->sh_sync;
+  shr->shr_header_seq = sh->sh_header_seq;
+  if(sh->sh_sync != sh->sh_header_seq) {
+    *hdrp = sh->sh_header;
+    atomic_add(&sh->sh_header->shc_refcount, 1);
+  }
+  return 1;
+}
+
+
+/**
+ * Move a reader that has fallen out of the ring to the newest cluster.
+ * The client already has the stream header and a second one mid-stream
+ * is not valid Matroska, so this only works while the header is the
+ * same. Returns -1 if it changed, 0 if there is no cluster to continue
+ * from yet
+ */
+static int
+shr_skip(streamshare_t *sh, streamshare_reader_t *shr)
+{
+  if(shr->shr_header_seq != sh->sh_header_seq)
+    return -1;
+
+  if(sh->sh_sync < sh->sh_first || sh->sh_sync >= sh->sh_last)
+    return 0;
+
+  shr->shr_pos = sh->sh_sync;
+  shr->shr_resyncs++;
+  return 1;
+}
+
+
+/**
+ * Queue what the reader has not got yet, until its connection is full.
+ * Runs on the HTTP worker pool when the share has new output, the
+ * connection has drained and once a second
+ */
+static int
+shr_pump(http_connection_t *hc, void *opaque)
+{
+  streamshare_reader_t *shr = opaque;
+  streamshare_t *sh = shr->shr_sh;
+  streamshare_chunk_t *shc, *hdr;
+  int r = 0, radio;
+  size_t sent;
+
+  pthread_mutex_lock(&sh->sh_mutex);
+
+  while(r == 0) {
+    if(sh->sh_ended) {
+      r = 1;
+      break;
+    }
+
+    hdr = NULL;
+    if(!shr->shr_synced) {
+      shr->shr_synced = shr_resync(sh, shr, &hdr);
+    } else if(shr->shr_pos < sh->sh_first) {
+      if((r = shr_skip(sh, shr)) < 0) {
+	tvhlog(LOG_DEBUG, "webui", "\"%s\": Reader %d fell behind "
+	       "a stream restart, closing", sh->sh_channel, shr->shr_id);
+	break;
+      }
+      if(r > 0)
+	tvhlog(LOG_DEBUG, "webui", "\"%s\": Reader %d fell behind, "
+	       "skipping to the latest cluster", sh->sh_channel, shr->shr_id);
+      r = 0;
+    }
+
+    if(!shr->shr_synced || shr->shr_pos < sh->sh_first ||
+       shr->shr_pos >= sh->sh_last) {
+      if(dispatch_clock - shr->shr_last >= 20) {
+	tvhlog(LOG_WARNING, "webui",  "Timeout waiting for packets");
+	r = -1;
+      }
+      break;
+    }
+
+    shr->shr_last = dispatch_clock;
+    if(sh_chunk(sh, shr->shr_pos)->shc_flags & MK_OUTPUT_HEADER)
+      shr->shr_header_seq = shr->shr_pos;
+    shc = sh_chunk(sh, shr->shr_pos++);
+    atomic_add(&shc->shc_refcount, 1);
+    radio = sh->sh_radio;
+
+    pthread_mutex_unlock(&sh->sh_mutex);
+
+    if(!shr->shr_started) {
+      if(radio)
+	http_output_content(hc, "audio/x-matroska");
+      else
+	http_output_content(hc, "video/x-matroska");
+      shr->shr_started = 1;
+    }
+
+    sent = 0;
+    if(hdr != NULL) {
+      r = http_write(hc, hdr->shc_data, hdr->shc_len);
+      sent += hdr->shc_len;
+      shc_unref(hdr);
+    }
+    if(r >= 0) {
+      r = http_write(hc, shc->shc_data, shc->shc_len);
+      sent += shc->shc_len;
+    }
+    shc_unref(shc);
+
+    pthread_mutex_lock(&sh->sh_mutex);
+    sh->sh_sent += sent;
+
+    /* Full, continued once the connection has drained */
+    if(r > 0) {
+      r = 0;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&sh->sh_mutex);
+  return r;
+}
+
+
+/**
+ *
+ */
+static void
+shr_release(http_connection_t *hc, void *opaque)
+{
+  pthread_mutex_lock(&global_lock);
+  streamshare_reader_destroy(opaque);
+  pthread_mutex_unlock(&global_lock);
+}
+
+
+/**
+ * Send the shared output to a HTTP client until either goes away.
+ * The reader is destroyed with the connection
+ */
+void
+streamshare_serve(streamshare_reader_t *shr, http_connection_t *hc)
+{
+  streamshare_t *sh = shr->shr_sh;
+
+  pthread_mutex_lock(&sh->sh_mutex);
+  shr->shr_hc = hc;
+  shr->shr_last = dispatch_clock;
+  pthread_mutex_unlock(&sh->sh_mutex);
+
+  http_park(hc, shr_pump, shr_release, shr);
+}
+
+
+/**
+ *
+ */
+void
+streamshare_dump(htsbuf_queue_t *hq)
+{
+  streamshare_t *sh;
+  streamshare_reader_t *shr;
+
+  lock_assert(&global_lock);
+
+  LIST_FOREACH(sh, &streamshares, sh_link) {
+    pthread_mutex_lock(&sh->sh_mutex);
+    htsbuf_qprintf(hq, "  \"%s\": %d readers, %"PRIu64" chunks, %zu kB, "
+		   "%"PRIu64" kB muxed, %"PRIu64" kB sent%s\n",
+		   sh->sh_channel, sh->sh_nreaders, sh->sh_last - sh->sh_first,
+		   sh->sh_bytes >> 10, sh->sh_muxed >> 10, sh->sh_sent >> 10,
+		   sh->sh_ended ? ", ended" : "");
+    LIST_FOREACH(shr, &sh->sh_readers, shr_link)
+      htsbuf_qprintf(hq, "    Reader %d: %"PRIu64" chunks behind, "
+		     "%d resyncs\n", shr->shr_id,
+		     shr->shr_pos < sh->sh_last ? sh->sh_last - shr->shr_pos : 0,
+		     shr->shr_resyncs);
+    pthread_mutex_unlock(&sh->sh_mutex);
+  }
+}
@@ -27,7 +27,6 @@
 #include <string.h>
 
 #include <sys/stat.h>
-#include <sys/sendfile.h>
 
 #include "tvheadend.h"
 #include "access.h"
@@ -35,6 +34,7 @@
 #include "webui.h"
 #include "dvr/dvr.h"
 #include "dvr/mkmux.h"
+#include "tspass.h"
 #include "filebundle.h"
 #include "psi.h"
 #include "plumbing/tsfix.h"
@@ -78,6 +78,9 @@ page_root(http_connection_t *hc, const char *remain, void *opaque)
   return 0;
 }
 
+static const char *staticenc[2] = { "br", "gzip" };
+static const char *staticext[2] = { "br", "gz" };
+
 /**
  * Static download of a file from the filesystem
  */
@@ -86,10 +89,11 @@ page_static_file(http_connection_t *hc, const char *remain, void *opaque)
 {
   const char *base = opaque;
 
-  int fd;
-  char path[500];
-  struct stat st;
-  const char *content = NULL, *postfix;
+  int fd, i;
+  char path[500], cpath[sizeof(path)], etag[64];
+  struct stat st, cst;
+  const char *content = NULL, *postfix, *encoding = NULL;
+  time_t mtime;
 
   if(remain == NULL)
     return 404;
@@ -104,127 +108,349 @@ page_static_file(http_connection_t *hc, const char *remain, void *opaque)
       content = "text/javascript; charset=UTF-8";
   }
 
-  snprintf(path, sizeof(path), "%s/%s", base, remain);
+  if(snprintf(path, sizeof(path), "%s/%s", base, remain) >= sizeof(path))
+    return 404;
 
-  if((fd = tvh_open(path, O_RDONLY, 0)) < 0) {
+  if(stat(path, &st) < 0) {
     tvhlog(LOG_ERR, "webui", 
-	   "Unable to open file %s -- %s", path, strerror(errno));
+	   "Unable to stat file %s -- %s", path, strerror(errno));
     return 404;
   }
-  if(fstat(fd, &st) < 0) {
+  mtime = st.st_mtime;
+  snprintf(etag, sizeof(etag), "%lx-%"PRIx64, (long)mtime,
+	   (int64_t)st.st_size);
+
+  /* Precompressed variants next to the file, unless outdated */
+  for(i = 0; i < 2; i++) {
+    if(snprintf(cpath, sizeof(cpath), "%s.%s", path, staticext[i]) >=
+       sizeof(cpath))
+      continue;
+    if(http_accept_encoding(hc, staticenc[i]) &&
+       !stat(cpath, &cst) && cst.st_mtime >= mtime) {
+      encoding = staticenc[i];
+      snprintf(etag + strlen(etag), sizeof(etag) - strlen(etag),
+	       "-%s", staticext[i]);
+      snprintf(path, sizeof(path), "%s", cpath);
+      st = cst;
+      break;
+    }
+  }
+
+  if(http_not_modified(hc, etag, mtime)) {
+    http_send_header_static(hc, HTTP_STATUS_NOT_MODIFIED, NULL, 0, NULL,
+			    etag, mtime, 10);
+    return 0;
+  }
+
+  if((fd = tvh_open(path, O_RDONLY, 0)) < 0) {
     tvhlog(LOG_ERR, "webui", 
-	   "Unable to stat file %s -- %s", path, strerror(errno));
-    close(fd);
+	   "Unable to open file %s -- %s", path, strerror(errno));
     return 404;
   }
 
-  http_send_header(hc, 200, content, st.st_size, NULL, NULL, 10, 0, NULL);
-  sendfile(hc->hc_fd, fd, NULL, st.st_size);
-  close(fd);
+  http_send_header_static(hc, 200, content, st.st_size, encoding,
+			  etag, mtime, 10);
+  http_send_file(hc, fd, 0, st.st_size);
   return 0;
 }
 
 /**
- * HTTP stream loop
+ * A stream to a HTTP client. The subscription queues its messages and
+ * wakes up the connection, they are muxed on the worker pool and the
+ * output is written by the HTTP event loop
+ */
+typedef struct http_stream {
+  http_connection_t *hs_hc;
+  streaming_target_t hs_input;
+  streaming_target_t *hs_gh;
+  streaming_target_t *hs_tsfix;
+  th_subscription_t *hs_s;
+  int hs_raw;
+
+  pthread_mutex_t hs_mutex;
+  struct streaming_message_queue hs_queue;  /* Protected by hs_mutex */
+
+  mk_mux_t *hs_mkm;
+  tspass_t *hs_tp;
+  uint32_t hs_event_id;
+  int hs_started;
+  int hs_error;
+  time_t hs_last;                           /* Last message */
+} http_stream_t;
+
+
+/**
+ * Subscription output, must not block
  */
 static void
-http_stream_run(http_connection_t *hc, streaming_queue_t *sq, th_subscription_t *s)
+http_stream_input(void *opaque, streaming_message_t *sm)
 {
-  streaming_message_t *sm;
-  int run = 1;
-  mk_mux_t *mkm = NULL;
-  uint32_t event_id = 0;
-  int timeouts = 0;
-
-  while(run) {
-    pthread_mutex_lock(&sq->sq_mutex);
-    sm = TAILQ_FIRST(&sq->sq_queue);
-    if(sm == NULL) {      
-      struct timespec ts;
-      struct timeval  tp;
-      
-      gettimeofday(&tp, NULL);
-      ts.tv_sec  = tp.tv_sec + 1;
-      ts.tv_nsec = tp.tv_usec * 1000;
-
-      if(pthread_cond_timedwait(&sq->sq_cond, &sq->sq_mutex, &ts) == ETIMEDOUT) {
-          int err = 0;
-          socklen_t errlen = sizeof(err);  
-
-          timeouts++;
-
-          //Check socket status
-          getsockopt(hc->hc_fd, SOL_SOCKET, SO_ERROR, (char *)&err, &errlen);  
-          if(err) {
-	    tvhlog(LOG_DEBUG, "webui",  "Client hung up, exit streaming");
-	    run = 0;
-          }else if(timeouts >= 20) {
-	    tvhlog(LOG_WARNING, "webui",  "Timeout waiting for packets");
-	    run = 0;
-          }
-      }
-      pthread_mutex_unlock(&sq->sq_mutex);
-      continue;
-    }
+  http_stream_t *hs = opaque;
 
-    timeouts = 0; //Reset timeout counter
-    TAILQ_REMOVE(&sq->sq_queue, sm, sm_link);
-    pthread_mutex_unlock(&sq->sq_mutex);
+  pthread_mutex_lock(&hs->hs_mutex);
+  TAILQ_INSERT_TAIL(&hs->hs_queue, sm, sm_link);
+  pthread_mutex_unlock(&hs->hs_mutex);
 
-    switch(sm->sm_type) {
-    case SMT_PACKET: {
-      if(!mkm)
-	break;
+  http_wakeup(hs->hs_hc);
+}
 
-      run = !mk_mux_write_pkt(mkm, sm->sm_data);
-      sm->sm_data = NULL;
 
-      event_t *e = NULL;
-      if(s->ths_channel)
-	e = s->ths_channel->ch_epg_current;
+/**
+ *
+ */
+static void
+http_stream_output_mkv(void *opaque, htsbuf_queue_t *q, int flags)
+{
+  http_stream_t *hs = opaque;
 
-      if(e && event_id != e->e_id) {
-	event_id = e->e_id;
-	run = !mk_mux_append_meta(mkm, e);
-      }
+  if(http_push(hs->hs_hc, q) < 0)
+    hs->hs_error = 1;
+}
+
+
+/**
+ * The packets go out without a copy as long as the client keeps up
+ */
+static void
+http_stream_output_ts(void *opaque, const struct iovec *iov, int iovcnt)
+{
+  http_stream_t *hs = opaque;
+
+  if(http_writev(hs->hs_hc, iov, iovcnt) < 0)
+    hs->hs_error = 1;
+}
+
+
+/**
+ * Matroska output. Returns 0 when the stream has ended
+ */
+static int
+http_stream_mkv(http_stream_t *hs, streaming_message_t *sm)
+{
+  http_connection_t *hc = hs->hs_hc;
+  th_subscription_t *s = hs->hs_s;
+  event_t *e;
+
+  switch(sm->sm_type) {
+  case SMT_PACKET:
+    if(hs->hs_mkm == NULL)
       break;
+
+    mk_mux_write_pkt(hs->hs_mkm, sm->sm_data);
+    sm->sm_data = NULL;
+
+    e = s->ths_channel ? s->ths_channel->ch_epg_current : NULL;
+    if(e && hs->hs_event_id != e->e_id) {
+      hs->hs_event_id = e->e_id;
+      mk_mux_append_meta(hs->hs_mkm, e);
     }
+    break;
 
-    case SMT_START: {
-      tvhlog(LOG_DEBUG, "webui",  "Start streaming %s", hc->hc_url_orig);
+  case SMT_START:
+    tvhlog(LOG_DEBUG, "webui",  "Start streaming %s", hc->hc_url_orig);
 
+    if(!hs->hs_started) {
       if(s->ths_service->s_servicetype == ST_RADIO)
 	http_output_content(hc, "audio/x-matroska");
       else
 	http_output_content(hc, "video/x-matroska");
+      hs->hs_started = 1;
+    }
 
-      mkm = mk_mux_stream_create(hc->hc_fd, sm->sm_data, s->ths_channel);
-      break;
+    if(hs->hs_mkm != NULL)
+      mk_mux_close(hs->hs_mkm);
+    hs->hs_mkm = mk_mux_output_create(sm->sm_data, s->ths_channel,
+				      http_stream_output_mkv, hs);
+    break;
+
+  case SMT_NOSTART:
+    tvhlog(LOG_DEBUG, "webui",  "Couldn't start stream for %s",
+	   hc->hc_url_orig);
+    return 0;
+
+  case SMT_STOP:
+  case SMT_EXIT:
+    return 0;
+
+  default:
+    break;
+  }
+  streaming_msg_free(sm);
+  return 1;
+}
+
+
+/**
+ * Raw transport stream output, everything the pump has taken is
+ * written as one batch. Returns 0 when the stream has ended
+ */
+static int
+http_stream_ts(http_stream_t *hs, streaming_message_t *sm)
+{
+  http_connection_t *hc = hs->hs_hc;
+
+  switch(sm->sm_type) {
+  case SMT_MPEGTS:
+    if(hs->hs_tp != NULL) {
+      tspass_input(hs->hs_tp, sm);
+      return 1;
     }
-    case SMT_STOP:
-      run = 0;
-      break;
+    break;
 
-    case SMT_SERVICE_STATUS:
-      break;
+  case SMT_START:
+    tvhlog(LOG_DEBUG, "webui",  "Start streaming %s", hc->hc_url_orig);
+    if(hs->hs_tp == NULL) {
+      http_output_content(hc, "video/mp2t");
+      hs->hs_tp = tspass_create_output(http_stream_output_ts, hs);
+    }
+    tspass_start(hs->hs_tp, sm->sm_data);
+    break;
 
-    case SMT_NOSTART:
-      tvhlog(LOG_DEBUG, "webui",  "Couldn't start stream for %s", hc->hc_url_orig);
-      run = 0;
-      break;
+  case SMT_NOSTART:
+    tvhlog(LOG_DEBUG, "webui",  "Couldn't start stream for %s",
+	   hc->hc_url_orig);
+    return 0;
 
-    case SMT_MPEGTS:
-      break;
+  case SMT_STOP:
+  case SMT_EXIT:
+    return 0;
 
-    case SMT_EXIT:
-      run = 0;
-      break;
+  default:
+    break;
+  }
+  streaming_msg_free(sm);
+  return 1;
+}
+
+
+/**
+ * Mux what the subscription has delivered
+ */
+static int
+http_stream_pump(http_connection_t *hc, void *opaque)
+{
+  http_stream_t *hs = opaque;
+  struct streaming_message_queue q;
+  streaming_message_t *sm;
+  int run = 1;
+
+  TAILQ_INIT(&q);
+
+  pthread_mutex_lock(&hs->hs_mutex);
+  if(TAILQ_FIRST(&hs->hs_queue) != NULL) {
+    TAILQ_MOVE(&q, &hs->hs_queue, sm_link);
+    TAILQ_INIT(&hs->hs_queue);
+  }
+  pthread_mutex_unlock(&hs->hs_mutex);
+
+  if(TAILQ_FIRST(&q) == NULL) {
+    if(dispatch_clock - hs->hs_last < 20)
+      return 0;
+    tvhlog(LOG_WARNING, "webui",  "Timeout waiting for packets");
+    return -1;
+  }
+  hs->hs_last = dispatch_clock;
+
+  while(run && (sm = TAILQ_FIRST(&q)) != NULL) {
+    TAILQ_REMOVE(&q, sm, sm_link);
+    run = hs->hs_raw ? http_stream_ts(hs, sm) : http_stream_mkv(hs, sm);
+  }
+
+  if(sm != NULL) {
+    streaming_msg_free(sm);
+    while((sm = TAILQ_FIRST(&q)) != NULL) {
+      TAILQ_REMOVE(&q, sm, sm_link);
+      streaming_msg_free(sm);
     }
+  }
+
+  if(hs->hs_tp != NULL)
+    tspass_flush(hs->hs_tp);
+
+  if(hs->hs_error)
+    return -1;
+  return run ? 0 : 1;
+}
+
+
+/**
+ * Connection is done with the stream
+ */
+static void
+http_stream_release(http_connection_t *hc, void *opaque)
+{
+  http_stream_t *hs = opaque;
+  streaming_message_t *sm;
+
+  if(hs->hs_s != NULL) {
+    pthread_mutex_lock(&global_lock);
+    subscription_unsubscribe(hs->hs_s);
+    pthread_mutex_unlock(&global_lock);
+  }
+
+  if(hs->hs_mkm != NULL)
+    mk_mux_close(hs->hs_mkm);
+  if(hs->hs_tp != NULL)
+    tspass_destroy(hs->hs_tp);
+
+  if(!hs->hs_raw) {
+    globalheaders_destroy(hs->hs_gh);
+    tsfix_destroy(hs->hs_tsfix);
+  }
+
+  while((sm = TAILQ_FIRST(&hs->hs_queue)) != NULL) {
+    TAILQ_REMOVE(&hs->hs_queue, sm, sm_link);
     streaming_msg_free(sm);
   }
+  pthread_mutex_destroy(&hs->hs_mutex);
+  free(hs);
+}
+
+
+/**
+ * Subscribe to a channel or service and park the connection, which
+ * then streams until either end goes away
+ *
+ * Raw transport stream output skips the parsed packet chain entirely
+ */
+static int
+http_stream_start(http_connection_t *hc, channel_t *ch, service_t *t,
+		  int raw)
+{
+  http_stream_t *hs = calloc(1, sizeof(http_stream_t));
+  streaming_target_t *st;
+
+  hs->hs_hc = hc;
+  hs->hs_raw = raw;
+  hs->hs_last = dispatch_clock;
+  pthread_mutex_init(&hs->hs_mutex, NULL);
+  TAILQ_INIT(&hs->hs_queue);
+
+  streaming_target_init(&hs->hs_input, http_stream_input, hs, 0);
+  st = &hs->hs_input;
+  if(!raw) {
+    hs->hs_gh = globalheaders_create(st);
+    hs->hs_tsfix = st = tsfix_create(hs->hs_gh);
+  }
+
+  pthread_mutex_lock(&global_lock);
+  if(ch != NULL)
+    hs->hs_s = subscription_create_from_channel(ch, 100, "HTTP", st,
+						raw ? SUBSCRIPTION_RAW_MPEGTS :
+						0);
+  else
+    hs->hs_s = subscription_create_from_service(t, "HTTP", st,
+						raw ? SUBSCRIPTION_RAW_MPEGTS :
+						0);
+  pthread_mutex_unlock(&global_lock);
 
-  if(mkm)
-    mk_mux_close(mkm);
+  if(hs->hs_s == NULL) {
+    http_stream_release(hc, hs);
+    return 0;
+  }
+
+  http_park(hc, http_stream_pump, http_stream_release, hs);
+  return 0;
 }
 
 /**
@@ -239,6 +465,7 @@ http_stream_playlist(http_connection_t *hc, channel_t *channel)
 
   channel_t *ch = NULL;
   const char *host = http_arg_get(&hc->hc_args, "Host");
+  const char *mux = http_arg_get(&hc->hc_req_args, "mux");
   
   pthread_mutex_lock(&global_lock);
 
@@ -247,9 +474,18 @@ http_stream_playlist(http_connection_t *hc, channel_t *channel)
     if (channel == NULL || ch == channel) {
       htsbuf_qprintf(hq, "#EXTINF:-1,%s\n", ch->ch_name);
 
+      if(mux != NULL && !strcmp(mux, "hls")) {
+	snprintf(buf, sizeof(buf), "/hls/channelid/%d/", ch->ch_id);
+	ticket_id = access_ticket_create(buf);
+	htsbuf_qprintf(hq, "http://%s/hls/ticket/%s/channelid/%d/index.m3u8\n",
+		       host, ticket_id, ch->ch_id);
+	continue;
+      }
+
       snprintf(buf, sizeof(buf), "/stream/channelid/%d", ch->ch_id);
       ticket_id = access_ticket_create(buf);
-      htsbuf_qprintf(hq, "http://%s%s?ticket=%s\n", host, buf, ticket_id);
+      htsbuf_qprintf(hq, "http://%s%s?ticket=%s%s\n", host, buf, ticket_id,
+		     mux != NULL && !strcmp(mux, "ts") ? "&mux=ts" : "");
     }
   }
 
@@ -356,82 +592,33 @@ page_http_playlist(http_connection_t *hc, const char *remain, void *opaque)
 }
 
 /**
- * Subscribes to a service and starts the streaming loop
- */
-static int
-http_stream_service(http_connection_t *hc, service_t *service)
-{
-  streaming_queue_t sq;
-  th_subscription_t *s;
-  streaming_target_t *gh;
-  streaming_target_t *tsfix;
-
-  streaming_queue_init(&sq, 0);
-  gh = globalheaders_create(&sq.sq_st);
-  tsfix = tsfix_create(gh);
-
-  pthread_mutex_lock(&global_lock);
-  s = subscription_create_from_service(service,
-                                       "HTTP", tsfix,
-                                       0);
-
-  pthread_mutex_unlock(&global_lock);
-
-  if(s) {
-    http_stream_run(hc, &sq, s);
-    pthread_mutex_lock(&global_lock);
-    subscription_unsubscribe(s);
-    pthread_mutex_unlock(&global_lock);
-  }
-
-  globalheaders_destroy(gh);
-  tsfix_destroy(tsfix);
-  streaming_queue_deinit(&sq);
-
-  return 0;
-}
-
-/**
- * Subscribes to a channel and starts the streaming loop
+ * Subscribes to a channel and starts streaming
+ *
+ * Matroska output is shared by all clients of the channel
  */
 static int
-http_stream_channel(http_connection_t *hc, channel_t *ch)
+http_stream_channel(http_connection_t *hc, channel_t *ch, int raw)
 {
-  streaming_queue_t sq;
-  th_subscription_t *s;
-  streaming_target_t *gh;
-  streaming_target_t *tsfix;
-  int priority = 100;
+  streamshare_reader_t *shr;
 
-  streaming_queue_init(&sq, 0);
-  gh = globalheaders_create(&sq.sq_st);
-  tsfix = tsfix_create(gh);
+  if(raw)
+    return http_stream_start(hc, ch, NULL, 1);
 
   pthread_mutex_lock(&global_lock);
-  s = subscription_create_from_channel(ch, priority, 
-                                       "HTTP", tsfix,
-                                       0);
+  shr = streamshare_reader_create(ch, 100, "HTTP");
   pthread_mutex_unlock(&global_lock);
 
-  if(s) {
-    http_stream_run(hc, &sq, s);
-    pthread_mutex_lock(&global_lock);
-    subscription_unsubscribe(s);
-    pthread_mutex_unlock(&global_lock);
-  }
-
-  globalheaders_destroy(gh);
-  tsfix_destroy(tsfix);
-  streaming_queue_deinit(&sq);
-
+  streamshare_serve(shr, hc);
   return 0;
 }
 
-
 /**
  * Handle the http request. http://tvheadend/stream/channelid/<chid>
  *                          http://tvheadend/stream/channel/<chname>
  *                          http://tvheadend/stream/service/<servicename>
+ *
+ * Matroska is sent unless '?mux=ts' is given or the name ends
+ * with '.ts', then the raw transport stream is passed through
  */
 static int
 http_stream(http_connection_t *hc, const char *remain, void *opaque)
@@ -439,6 +626,9 @@ http_stream(http_connection_t *hc, const char *remain, void *opaque)
   char *components[2];
   channel_t *ch = NULL;
   service_t *service = NULL;
+  const char *mux;
+  int raw = 0;
+  size_t l;
 
   hc->hc_keep_alive = 0;
 
@@ -454,6 +644,14 @@ http_stream(http_connection_t *hc, const char *remain, void *opaque)
 
   http_deescape(components[1]);
 
+  if((mux = http_arg_get(&hc->hc_req_args, "mux")) != NULL) {
+    raw = !strcmp(mux, "ts");
+  } else if((l = strlen(components[1])) > 3 &&
+	    !strcmp(components[1] + l - 3, ".ts")) {
+    components[1][l - 3] = 0;
+    raw = 1;
+  }
+
   pthread_mutex_lock(&global_lock);
 
   if(!strcmp(components[0], "channelid")) {
@@ -467,9 +665,9 @@ http_stream(http_connection_t *hc, const char *remain, void *opaque)
   pthread_mutex_unlock(&global_lock);
 
   if(ch != NULL) {
-    return http_stream_channel(hc, ch);
+    return http_stream_channel(hc, ch, raw);
   } else if(service != NULL) {
-    return http_stream_service(hc, service);
+    return http_stream_start(hc, NULL, service, raw);
   } else {
     http_error(hc, HTTP_STATUS_BAD_REQUEST);
     return HTTP_STATUS_BAD_REQUEST;
@@ -485,7 +683,10 @@ page_static_bundle(http_connection_t *hc, const char *remain, void *opaque)
 {
   const struct filebundle *fb = opaque;
   const struct filebundle_entry *fbe;
-  const char *content = NULL, *postfix;
+  const char *content = NULL, *postfix, *encoding;
+  const unsigned char *data;
+  char etag[64];
+  int size;
 
   if(remain == NULL)
     return 404;
@@ -500,12 +701,29 @@ page_static_bundle(http_connection_t *hc, const char *remain, void *opaque)
   for(fbe = fb->entries; fbe->filename != NULL; fbe++) {
     if(!strcmp(fbe->filename, remain)) {
 
-      http_send_header(hc, 200, content, fbe->size, 
-		       fbe->original_size == -1 ? NULL : "gzip", NULL, 10, 0,
-		       NULL);
-      /* ignore return value */
-      if(write(hc->hc_fd, fbe->data, fbe->size) != fbe->size)
-	return -1;
+      if(fbe->br_data != NULL && http_accept_encoding(hc, "br")) {
+	data = fbe->br_data;
+	size = fbe->br_size;
+	encoding = "br";
+      } else {
+	data = fbe->data;
+	size = fbe->size;
+	encoding = fbe->original_size == -1 ? NULL : "gzip";
+      }
+
+      /* Each variant needs its own entity tag */
+      snprintf(etag, sizeof(etag), "%s%s%s", fbe->etag,
+	       encoding ? "-" : "", encoding ?: "");
+
+      if(http_not_modified(hc, etag, fbe->mtime)) {
+	http_send_header_static(hc, HTTP_STATUS_NOT_MODIFIED, NULL, 0, NULL,
+				etag, fbe->mtime, 10);
+	return 0;
+      }
+
+      http_send_header_static(hc, 200, content, size, encoding,
+			      etag, fbe->mtime, 10);
+      http_write(hc, data, size);
       return 0;
     }
   }
@@ -513,6 +731,137 @@ page_static_bundle(http_connection_t *hc, const char *remain, void *opaque)
 }
 
 
+/**
+ * Reader of a recording that is still being written
+ */
+typedef struct dvrfile_live {
+  dvr_live_t *dfl_dl;
+  dvr_live_reader_t dfl_reader;
+  int dfl_fd;              /* Owned by the connection */
+  off_t dfl_start;
+  int64_t dfl_end;         /* Last byte wanted, -1 for all */
+} dvrfile_live_t;
+
+
+/**
+ * Send what has been written since last time, runs when the recording
+ * has grown or is done
+ */
+static int
+dvrfile_live_pump(http_connection_t *hc, void *opaque)
+{
+  dvrfile_live_t *dfl = opaque;
+  off_t size;
+  int done;
+
+  size = dvr_live_size(dfl->dfl_dl, &done);
+  if(dfl->dfl_end >= 0 && size > dfl->dfl_end + 1)
+    size = dfl->dfl_end + 1;
+
+  if(size > dfl->dfl_start &&
+     http_send_file(hc, dfl->dfl_fd, dfl->dfl_start, size) < 0)
+    return -1;
+
+  if(dfl->dfl_end >= 0 && size > dfl->dfl_end)
+    return 1;
+  if(done && dfl->dfl_end >= 0)
+    return -1; /* Recording ended short of the range, can't be reused */
+  return done;
+}
+
+
+/**
+ *
+ */
+static void
+dvrfile_live_release(http_connection_t *hc, void *opaque)
+{
+  dvrfile_live_t *dfl = opaque;
+
+  dvr_live_unfollow(dfl->dfl_dl, &dfl->dfl_reader);
+  dvr_live_release(dfl->dfl_dl);
+  free(dfl);
+}
+
+
+/**
+ * Play a recording that is still being written. Without a range (or
+ * with "bytes=0-") the reply follows the file as it grows and ends when
+ * the recording does. Closed ranges are sent as they get written, open
+ * ranges get what has been written so far. Suffix ranges are ignored
+ */
+static int
+page_dvrfile_live(http_connection_t *hc, int fd, dvr_live_t *dl,
+		  const char *content)
+{
+  const char *range = http_arg_get(&hc->hc_args, "Range");
+  char range_buf[255];
+  int64_t start = 0, end = -1;
+  off_t size, content_len = 0;
+  int done, rc = HTTP_STATUS_OK;
+  dvrfile_live_t *dfl;
+
+  size = dvr_live_size(dl, &done);
+
+  if(range != NULL &&
+     (sscanf(range, "bytes=%"SCNd64"-%"SCNd64, &start, &end) < 1 ||
+      start < 0 || (start == 0 && end < 0))) {
+    range = NULL;
+    start = 0;
+    end = -1;
+  }
+
+  if(range != NULL && end < 0) {
+    if(start >= size) {
+      close(fd);
+      dvr_live_release(dl);
+      return HTTP_STATUS_RANGE_NOT_SATISFIABLE;
+    }
+    end = size - 1;
+  }
+
+  if(end >= 0 && end < start) {
+    close(fd);
+    dvr_live_release(dl);
+    return HTTP_STATUS_BAD_REQUEST;
+  }
+
+  if(end >= 0) {
+    content_len = end - start + 1;
+  } else {
+    /* Length is not known until the recording is done */
+    hc->hc_keep_alive = 0;
+  }
+
+  if(range != NULL) {
+    rc = HTTP_STATUS_PARTIAL_CONTENT;
+    snprintf(range_buf, sizeof(range_buf), "bytes %"PRId64"-%"PRId64"/*",
+	     start, end);
+  }
+
+  http_send_header(hc, rc, content, content_len, NULL, NULL, 0,
+		   range != NULL ? range_buf : NULL, NULL);
+
+  if(hc->hc_no_output) {
+    close(fd);
+    dvr_live_release(dl);
+    return 0;
+  }
+
+  /* Nothing to send yet, the pump moves the end as the file grows */
+  http_send_file(hc, fd, start, start);
+
+  dfl = calloc(1, sizeof(dvrfile_live_t));
+  dfl->dfl_dl = dl;
+  dfl->dfl_fd = fd;
+  dfl->dfl_start = start;
+  dfl->dfl_end = end;
+  dfl->dfl_reader.dlr_hc = hc;
+  http_park(hc, dvrfile_live_pump, dvrfile_live_release, dfl);
+  dvr_live_follow(dl, &dfl->dfl_reader);
+  return 0;
+}
+
 /**
  * Download a recorded file
  */
@@ -523,11 +872,11 @@ page_dvrfile(http_connection_t *hc, const char *remain, void *opaque)
   struct stat st;
   const char *content = NULL, *postfix, *range;
   dvr_entry_t *de;
+  dvr_live_t *dl;
   char *fname;
   char range_buf[255];
   char disposition[256];
-  off_t content_len, file_start, file_end, chunk;
-  ssize_t r;
+  off_t content_len, file_start, file_end;
   
   if(remain == NULL)
     return 404;
@@ -541,6 +890,7 @@ page_dvrfile(http_connection_t *hc, const char *remain, void *opaque)
   }
 
   fname = strdup(de->de_filename);
+  dl = dvr_live_find(de->de_id);
   pthread_mutex_unlock(&global_lock);
 
   postfix = strrchr(remain, '.');
@@ -552,14 +902,17 @@ page_dvrfile(http_connection_t *hc, const char *remain, void *opaque)
 
   fd = tvh_open(fname, O_RDONLY, 0);
   free(fname);
-  if(fd < 0)
-    return 404;
-
-  if(fstat(fd, &st) < 0) {
-    close(fd);
+  if(fd < 0 || fstat(fd, &st) < 0) {
+    if(fd >= 0)
+      close(fd);
+    if(dl != NULL)
+      dvr_live_release(dl);
     return 404;
   }
 
+  if(dl != NULL)
+    return page_dvrfile_live(hc, fd, dl, content);
+
   file_start = 0;
   file_end = st.st_size-1;
   
@@ -587,9 +940,6 @@ page_dvrfile(http_connection_t *hc, const char *remain, void *opaque)
   sprintf(range_buf, "bytes %"PRId64"-%"PRId64"/%"PRId64"",
 	  file_start, file_end, st.st_size);
 
-  if(file_start > 0)
-    lseek(fd, file_start, SEEK_SET);
-
   if(de->de_title != NULL) {
     snprintf(disposition, sizeof(disposition),
 	     "attachment; filename=%s.mkv", de->de_title);
@@ -609,18 +959,7 @@ page_dvrfile(http_connection_t *hc, const char *remain, void *opaque)
 		   range ? range_buf : NULL,
 		   disposition[0] ? disposition : NULL);
 
-  if(!hc->hc_no_output) {
-    while(content_len > 0) {
-      chunk = MIN(1024 * 1024 * 1024, content_len);
-      r = sendfile(hc->hc_fd, fd, NULL, chunk);
-      if(r == -1) {
-	close(fd);
-	return -1;
-      }
-      content_len -= r;
-    }
-  }
-  close(fd);
+  http_send_file(hc, fd, file_start, file_start + content_len);
   return 0;
 }
 
@@ -699,5 +1038,6 @@ webui_init(const char *contentpath)
   simpleui_start();
   extjs_start();
   comet_init();
+  hls_init();
 
 }
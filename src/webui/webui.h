@@ -20,6 +20,10 @@
 #define WEBUI_H_
 
 #include "htsmsg.h"
+#include "htsbuf.h"
+
+struct channel;
+struct http_connection;
 
 void webui_init(const char *contentpath);
 
@@ -51,5 +55,36 @@ void comet_mailbox_add_message(htsmsg_t *m, int isdebug);
 
 void comet_flush(void);
 
+void comet_dump(htsbuf_queue_t *hq);
+
+
+/**
+ * Matroska output of a channel shared by all its HTTP clients. The
+ * stream is muxed once into a ring of chunks and every client sends
+ * from its own position in the ring. Clients joining late, or falling
+ * too far behind, continue from the latest cluster starting with a
+ * keyframe
+ */
+typedef struct streamshare_reader streamshare_reader_t;
+
+streamshare_reader_t *streamshare_reader_create(struct channel *ch,
+						int weight,
+						const char *name);
+
+void streamshare_reader_destroy(streamshare_reader_t *shr);
+
+void streamshare_serve(streamshare_reader_t *shr,
+		       struct http_connection *hc);
+
+void streamshare_dump(htsbuf_queue_t *hq);
+
+
+/**
+ * HTTP live streaming, http://tvheadend/hls/channelid/<chid>/index.m3u8
+ */
+void hls_init(void);
+
+void hls_dump(htsbuf_queue_t *hq);
+
 
 #endif /* WEBUI_H_ */